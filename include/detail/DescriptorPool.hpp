@@ -69,6 +69,11 @@ namespace mcs::vulkan
                 device_ = {};
             }
         }
+        // NOTE: 一次释放从该池分配的所有描述符集
+        constexpr void reset() const
+        {
+            device_->resetDescriptorPool(value_, 0);
+        }
         constexpr void freeDescriptorSets(
             uint32_t descriptorSetCount,
             const VkDescriptorSet *pDescriptorSets) const noexcept
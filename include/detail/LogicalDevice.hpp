@@ -189,6 +189,48 @@ namespace mcs::vulkan
             table_.vkDestroyPipeline(value_, pipelines, allocator);
         }
 
+        [[nodiscard]] constexpr VkPipelineCache createPipelineCache(
+            const VkPipelineCacheCreateInfo &createInfo,
+            const VkAllocationCallbacks *allocator) const
+        {
+            MCS_ASSERT(table_.vkCreatePipelineCache != nullptr);
+            VkPipelineCache pipelineCache; // NOLINT
+            check_vkresult(table_.vkCreatePipelineCache(value_, &createInfo, allocator,
+                                                        &pipelineCache));
+            return pipelineCache;
+        }
+
+        constexpr void destroyPipelineCache(
+            VkPipelineCache pipelineCache,
+            const VkAllocationCallbacks *allocator) const noexcept
+        {
+            MCS_ASSERT(table_.vkDestroyPipelineCache != nullptr);
+            table_.vkDestroyPipelineCache(value_, pipelineCache, allocator);
+        }
+
+        [[nodiscard]] constexpr std::vector<uint8_t> getPipelineCacheData(
+            VkPipelineCache pipelineCache) const
+        {
+            MCS_ASSERT(table_.vkGetPipelineCacheData != nullptr);
+            size_t dataSize = 0;
+            check_vkresult(
+                table_.vkGetPipelineCacheData(value_, pipelineCache, &dataSize, nullptr));
+            std::vector<uint8_t> data(dataSize);
+            check_vkresult(table_.vkGetPipelineCacheData(value_, pipelineCache, &dataSize,
+                                                         data.data()));
+            data.resize(dataSize);
+            return data;
+        }
+
+        constexpr void mergePipelineCaches(VkPipelineCache dstCache,
+                                           uint32_t srcCacheCount,
+                                           const VkPipelineCache *srcCaches) const
+        {
+            MCS_ASSERT(table_.vkMergePipelineCaches != nullptr);
+            check_vkresult(
+                table_.vkMergePipelineCaches(value_, dstCache, srcCacheCount, srcCaches));
+        }
+
         constexpr void waitIdle() const
         {
             MCS_ASSERT(table_.vkDeviceWaitIdle != nullptr);
@@ -564,6 +606,22 @@ namespace mcs::vulkan
             return descriptorSet;
         }
 
+        // NOTE: 不抛异常，池耗尽(VK_ERROR_OUT_OF_POOL_MEMORY 等)由调用方处理
+        [[nodiscard]] constexpr VkResult allocateDescriptorSets(
+            const VkDescriptorSetAllocateInfo &allocateInfo,
+            VkDescriptorSet *descriptorSets) const noexcept
+        {
+            MCS_ASSERT(table_.vkAllocateDescriptorSets != nullptr);
+            return table_.vkAllocateDescriptorSets(value_, &allocateInfo, descriptorSets);
+        }
+
+        constexpr void resetDescriptorPool(VkDescriptorPool descriptorPool,
+                                           VkDescriptorPoolResetFlags flags) const
+        {
+            MCS_ASSERT(table_.vkResetDescriptorPool != nullptr);
+            check_vkresult(table_.vkResetDescriptorPool(value_, descriptorPool, flags));
+        }
+
         constexpr void updateDescriptorSets(
             uint32_t descriptorWriteCount, const VkWriteDescriptorSet *descriptorWrites,
             uint32_t descriptorCopyCount,
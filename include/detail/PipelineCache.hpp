@@ -0,0 +1,160 @@
+#pragma once
+
+#include "LogicalDevice.hpp"
+#include "utils/make_vk_exception.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan
+{
+    /**
+     * NOTE: VkPipelineCache 的 RAII 包装。设置了 path 时，析构前把缓存数据写回该文件，
+     * 下次启动由 tool::create_pipeline_cache 读入，管线直接从驱动缓存创建，不再从 SPIR-V 编译。
+     */
+    class PipelineCache
+    {
+        using value_type = VkPipelineCache;
+        const LogicalDevice *device_{};
+        value_type value_{};
+        std::string path_;
+        bool loaded_{false};
+
+      public:
+        constexpr operator bool() const noexcept // NOLINT
+        {
+            return value_ != nullptr;
+        }
+        constexpr value_type &operator*() noexcept
+        {
+            return value_;
+        }
+        constexpr const value_type &operator*() const noexcept
+        {
+            return value_;
+        }
+        [[nodiscard]] auto *device() const noexcept
+        {
+            return device_;
+        }
+        // NOTE: 写回的文件，空表示不写回
+        [[nodiscard]] const std::string &path() const noexcept
+        {
+            return path_;
+        }
+        // NOTE: 创建时是否用上了磁盘中的缓存
+        [[nodiscard]] bool loaded() const noexcept
+        {
+            return loaded_;
+        }
+
+        PipelineCache() = default;
+        constexpr PipelineCache(const LogicalDevice &device, value_type value,
+                                std::string path = {}, bool loaded = false) noexcept
+            : device_{&device}, value_{value}, path_{std::move(path)}, loaded_{loaded}
+        {
+        }
+        constexpr ~PipelineCache() noexcept
+        {
+            destroy();
+        }
+        constexpr PipelineCache(PipelineCache &&o) noexcept
+            : device_(std::exchange(o.device_, {})), value_{std::exchange(o.value_, {})},
+              path_{std::move(o.path_)}, loaded_{std::exchange(o.loaded_, false)}
+        {
+        }
+        constexpr PipelineCache &operator=(PipelineCache &&o) noexcept
+        {
+            if (&o != this)
+            {
+                destroy();
+                device_ = std::exchange(o.device_, {});
+                value_ = std::exchange(o.value_, {});
+                path_ = std::move(o.path_);
+                loaded_ = std::exchange(o.loaded_, false);
+            }
+            return *this;
+        }
+        PipelineCache(const PipelineCache &) = delete;
+        PipelineCache &operator=(const PipelineCache &) = delete;
+
+        // NOTE: 写回失败只放弃这次保存，缓存本身只是加速手段
+        constexpr void destroy() noexcept
+        {
+            if (value_ != nullptr)
+            {
+                if (!path_.empty())
+                {
+                    try
+                    {
+                        save(path_);
+                    }
+                    catch (...) // NOLINT
+                    {
+                    }
+                }
+                device_->destroyPipelineCache(value_, device_->allocator());
+                value_ = {};
+                device_ = {};
+                path_.clear();
+                loaded_ = false;
+            }
+        }
+
+        [[nodiscard]] std::vector<uint8_t> data() const
+        {
+            return device_->getPipelineCacheData(value_);
+        }
+
+        // NOTE: 把其他缓存(如各线程各自使用的缓存)并入当前缓存
+        void merge(std::span<const VkPipelineCache> caches) const
+        {
+            if (!caches.empty())
+                device_->mergePipelineCaches(value_, static_cast<uint32_t>(caches.size()),
+                                             caches.data());
+        }
+
+        // NOTE: 先写临时文件再改名，进程中途退出不会留下半个缓存文件
+        void save(const std::string &path) const
+        {
+            const auto bytes = data();
+            const std::string temp = path + ".tmp";
+            {
+                std::ofstream out{temp, std::ios::binary | std::ios::trunc};
+                if (!out)
+                    throw make_vk_exception("failed to open pipeline cache file: " +
+                                            temp);
+                out.write(reinterpret_cast<const char *>(bytes.data()), // NOLINT
+                          static_cast<std::streamsize>(bytes.size()));
+                if (!out)
+                    throw make_vk_exception("failed to write pipeline cache file: " +
+                                            temp);
+            }
+            std::filesystem::rename(temp, path);
+        }
+
+        // NOTE: 缓存头必须与当前设备一致，驱动升级(UUID 变化)后旧缓存作废
+        [[nodiscard]] static bool compatible(const PhysicalDevice &physicalDevice,
+                                             std::span<const uint8_t> bytes) noexcept
+        {
+            VkPipelineCacheHeaderVersionOne header{};
+            if (bytes.size() < sizeof(header))
+                return false;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            const auto properties = physicalDevice.getProperties();
+            return header.headerSize >= sizeof(header) &&
+                   header.headerSize <= bytes.size() &&
+                   header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                   header.vendorID == properties.vendorID &&
+                   header.deviceID == properties.deviceID &&
+                   std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID,
+                               VK_UUID_SIZE) == 0;
+        }
+    };
+
+}; // namespace mcs::vulkan
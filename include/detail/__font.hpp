@@ -16,13 +16,25 @@
 #include "font/GlyphInfo.hpp"
 #include "font/FontFactory.hpp"
 #include "font/FontSelector.hpp"
+#include "font/msdf/shelf_packer.hpp"
 
 // core
 #include "font/utf8proc/normalize.hpp"
 #include "font/bidi/analyze.hpp"
 #include "font/assign_fonts.hpp"
 #include "font/libunibreak/analyze_line_breaks.hpp"
+#include "font/libunibreak/line_breaker.hpp"
 #include "font/harfbuzz/shape.hpp"
+#include "font/text_layout.hpp"
+#include "font/text_arena.hpp"
+#include "font/layout_text.hpp"
+#include "font/line_fitter.hpp"
+#include "font/cluster_index.hpp"
+#include "font/text_document.hpp"
+#include "font/text_view.hpp"
+#include "font/shared_selector.hpp"
+#include "font/shape_batch.hpp"
+#include "font/glyph_instance.hpp"
 
 // gen
 #include "font/GenFontContext.hpp"
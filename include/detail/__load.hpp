@@ -1,3 +1,6 @@
 #pragma once
 #include "load/image_source.hpp"
-#include "load/raw_stbi_image.hpp"
\ No newline at end of file
+#include "load/raw_stbi_image.hpp"
+#include "load/ktx2_image.hpp"
+#include "load/decode_queue.hpp"
+#include "load/mip_chain.hpp"
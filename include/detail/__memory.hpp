@@ -1,4 +1,6 @@
 #pragma once
+#include "memory/tlsf_allocator.hpp"
+#include "memory/device_memory_arena.hpp"
 #include "memory/buffer_base.hpp"
 #include "memory/auto_map_buffer.hpp"
 #include "memory/create_buffer.hpp"
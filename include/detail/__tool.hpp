@@ -12,10 +12,13 @@
 #include "tool/create_swapchain.hpp"
 #include "tool/create_pipeline_layout.hpp"
 #include "tool/create_graphics_pipeline.hpp"
+#include "tool/create_pipeline_cache.hpp"
+#include "tool/create_graphics_pipelines.hpp"
 #include "tool/create_command_pool.hpp"
 #include "tool/frame_context.hpp"
 #include "tool/simple_copy_buffer.hpp"
 #include "tool/create_descriptor_set_layout.hpp"
 #include "tool/create_descriptor_pool.hpp"
+#include "tool/descriptor_allocator.hpp"
 #include "tool/create_sampler.hpp"
 #include "tool/resource_manager.hpp"
\ No newline at end of file
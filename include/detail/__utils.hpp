@@ -1,3 +1,6 @@
 #pragma once
 #include "./utils/macro_function.hpp"
-#include "./utils/match.hpp"
\ No newline at end of file
+#include "./utils/match.hpp"
+#include "./utils/thread_pool.hpp"
+#include "./utils/fenwick_tree.hpp"
+#include "./utils/mapped_file.hpp"
@@ -6,4 +6,5 @@
 #include "./vma/create_resources.hpp"
 #include "./vma/create_image.hpp"
 #include "./vma/create_texture_image.hpp"
-#include "./vma/auto_map_buffer.hpp"
\ No newline at end of file
+#include "./vma/auto_map_buffer.hpp"
+#include "./vma/upload_queue.hpp"
\ No newline at end of file
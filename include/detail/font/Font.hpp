@@ -2,7 +2,7 @@
 
 #include "__json_import.hpp"
 #include "../utils/make_vk_exception.hpp"
-#include <fstream>
+#include "../utils/mapped_file.hpp"
 #include <variant>
 
 namespace mcs::vulkan::font
@@ -292,7 +292,10 @@ namespace mcs::vulkan::font
 
         constexpr static Font make(const std::string &jsonPath)
         {
-            auto data = font::json_type ::parse(std::ifstream(jsonPath));
+            // NOTE: 直接解析映射的页面，不经过 ifstream 的缓冲
+            const mapped_file file{jsonPath};
+            const auto text = file.as<char>();
+            auto data = font::json_type ::parse(text.begin(), text.end());
             if (data.contains("variants"))
                 throw make_vk_exception(".......[TODO] unsuported now.");
             return {.atlas = Atlas::make(data),
@@ -10,6 +10,7 @@
 #include "harfbuzz/font.hpp"
 #include "texture_bind_sampler.hpp"
 #include <cassert>
+#include <concepts>
 #include <variant>
 
 namespace mcs::vulkan::font
@@ -32,11 +33,25 @@ namespace mcs::vulkan::font
         FontMetadata meta_data;
         // NOLINTEND
 
-        constexpr FontContext(const std::string &jsonPath,
-                              const FontTexture::msdf_info &info, freetype::face &&face,
+        // NOTE: info 为 FontTexture::msdf_info 或 FontTexture::ktx2_info
+        template <typename TextureInfo>
+            requires std::constructible_from<FontTexture, const TextureInfo &>
+        constexpr FontContext(const std::string &jsonPath, const TextureInfo &info,
+                              freetype::face &&face,
                               FontType type, texture_bind_sampler bind,
                               FontMetadata meta_data)
-            : name(jsonPath), font(Font::make(jsonPath)), texture(info),
+            : FontContext(jsonPath, Font::make(jsonPath), info, std::move(face), type,
+                          bind, std::move(meta_data))
+        {
+        }
+        // NOTE: font 已在别处解析(font_source::decode)
+        template <typename TextureInfo>
+            requires std::constructible_from<FontTexture, const TextureInfo &>
+        constexpr FontContext(const std::string &jsonPath, Font font,
+                              const TextureInfo &info, freetype::face &&face,
+                              FontType type, texture_bind_sampler bind,
+                              FontMetadata meta_data)
+            : name(jsonPath), font(std::move(font)), texture(info),
               face(std::move(face)), type(type), bind(bind),
               meta_data{std::move(meta_data)}
         {
@@ -2,6 +2,7 @@
 
 #include "FontContext.hpp"
 #include "FontInfo.hpp"
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <variant>
@@ -9,6 +10,7 @@
 
 #include "./freetype/face.hpp"
 #include "font_registration.hpp"
+#include "font_source.hpp"
 
 namespace mcs::vulkan::font
 {
@@ -24,29 +26,43 @@ namespace mcs::vulkan::font
         using value_type = std::unique_ptr<FontContext>;
         const FontContext *make(FontInfo info)
         {
-            using stbi_image_type = texture_info::stbi_image_type;
+            return make(font_source::decode(std::move(info)));
+        }
+
+        // NOTE: 解码已经完成(可能在其他线程)，这里只创建 FT_Face 与纹理
+        const FontContext *make(font_source source)
+        {
+            auto &info = source.info;
             const auto &registration = info.registration;
-            if (std::holds_alternative<stbi_image_type>(
-                    registration.texture_info.image_variant))
-            {
-                using image_type = stbi_image_type::type;
-                const auto &image =
-                    std::get<stbi_image_type>(registration.texture_info.image_variant);
+            freetype::face face{library_, std::move(source.face_file),
+                                info.meta_data.face_index};
+            const auto emplace = [&](const auto &texture) {
                 fonts_.emplace_back(std::make_unique<FontContext>(
-                    registration.json_path,
-                    FontTexture::msdf_info{
-                        .image = image_type{image.image_path.data(), image.image_format},
-                        .allocation = allocator_},
-                    freetype::face{library_, registration.font_path,
-                                   info.meta_data.face_index},
-                    registration.type, registration.texture_info.bind,
+                    registration.json_path, std::move(source.font), texture,
+                    std::move(face), registration.type, registration.texture_info.bind,
                     std::move(info.meta_data)));
                 return fonts_.back().get();
-            }
+            };
+            if (auto *image = std::get_if<load::raw_stbi_image>(&source.image))
+                return emplace(FontTexture::msdf_info{.image = std::move(*image),
+                                                      .allocation = allocator_});
+            if (auto *image = std::get_if<load::ktx2_image>(&source.image))
+                return emplace(FontTexture::ktx2_info{.image = std::move(*image),
+                                                      .allocation = allocator_});
             return nullptr;
         }
 
+        friend class FontSelector;
+
       private:
+        void removeFont(const FontContext *font)
+        {
+            if (auto it = std::ranges::find_if(
+                    fonts_, [font](const auto &ptr) { return ptr.get() == font; });
+                it != fonts_.end())
+                fonts_.erase(it); // 释放 unique_ptr，即销毁 FontContext
+        }
+
         std::vector<value_type> fonts_;
         FontAllocationContext allocator_;
         FT_Library library_;
@@ -2,6 +2,10 @@
 
 #include "FontContext.hpp"
 #include "FontFactory.hpp"
+#include "font_source.hpp"
+#include "select_cache.hpp"
+#include "../load/decode_queue.hpp"
+#include "../utils/thread_pool.hpp"
 #include <cassert>
 #include <optional>
 #include <string_view>
@@ -52,6 +56,7 @@ namespace mcs::vulkan::font
                     {
                         selectable_.push_back(newFont);
                         candidate_.erase(it);
+                        cache_.clear(); // NOTE: 新字体可能改变其他码点的匹配
                         if (newFont->has_glyph(codepoint))
                             return newFont;
                     }
@@ -105,7 +110,7 @@ namespace mcs::vulkan::font
       public:
         using select_result_type = select_result;
         using font_context_type = FontContext;
-        // TODO(mcs): 可补充字体排序权重、缓存匹配结果、处理多语言回退顺序
+        // TODO(mcs): 可补充字体排序权重、处理多语言回退顺序
         /*
         字体选择的核心是确定哪个字体能够提供该字符（码点）的合理字形，而具体字形形状、变体、合字等是通过
         HarfBuzz 的 shaping
@@ -113,6 +118,15 @@ namespace mcs::vulkan::font
         */
         [[nodiscard]] constexpr auto selectFont(char32_t codepoint, hb_script_t script)
             -> select_result
+        {
+            if (const auto *hit = cache_.find(codepoint, script))
+                return *hit;
+            auto ret = resolveFont(codepoint, script);
+            cache_.insert(codepoint, script, ret);
+            return ret;
+        }
+        [[nodiscard]] constexpr auto resolveFont(char32_t codepoint, hb_script_t script)
+            -> select_result
         {
             // 完全匹配
             if (auto ret = findOrLoad(preferenceTag(), script, codepoint))
@@ -176,12 +190,14 @@ namespace mcs::vulkan::font
         constexpr auto &&setPreferenceTag(hb_tag_t preferenceTag) noexcept
         {
             language_ = harfbuzz::make_language_type(preferenceTag);
+            cache_.clear();
             return *this;
         }
         // NOTE: 语言 地区
         constexpr auto &&setPreferenceLanguage(const std::string_view &bcp47) noexcept
         {
             language_ = harfbuzz::make_language_type(harfbuzz::bcp47_to_tag(bcp47));
+            cache_.clear();
             return std::move(*this);
         }
         constexpr auto &&load(FontInfo info)
@@ -189,6 +205,7 @@ namespace mcs::vulkan::font
             const FontContext *newFont = factory_->make(std::move(info));
             MCS_ASSERT(newFont != nullptr);
             selectable_.emplace_back(newFont);
+            cache_.clear();
             return std::move(*this);
         }
 
@@ -199,13 +216,51 @@ namespace mcs::vulkan::font
             return std::move(*this);
         }
 
+        // NOTE: JSON 解析、图集解码、字体文件读取在 pool 中并行；FT_Face 与纹理按完成顺序
+        // 在当前线程创建，selectable_ 仍保持 infos 的顺序
+        auto &&load(std::vector<FontInfo> infos, thread_pool &pool)
+        {
+            load::decode_queue<font_source> decoder{pool};
+            for (auto &info : infos)
+                decoder.submit([info = std::move(info)]() mutable {
+                    return font_source::decode(std::move(info));
+                });
+            std::vector<const FontContext *> loaded(infos.size(), nullptr);
+            try
+            {
+                while (!decoder.empty())
+                    for (auto &[index, source] : decoder.take())
+                        loaded[index] = factory_->make(std::move(source));
+            }
+            catch (...)
+            {
+                // NOTE: 已创建的字体还没进入 selectable_，交还 factory 销毁后再抛出
+                for (const auto *newFont : loaded)
+                    if (newFont != nullptr)
+                        factory_->removeFont(newFont);
+                throw;
+            }
+            for (const auto *newFont : loaded)
+            {
+                MCS_ASSERT(newFont != nullptr);
+                selectable_.emplace_back(newFont);
+            }
+            cache_.clear();
+            return std::move(*this);
+        }
+
         [[nodiscard]] constexpr const auto &candidate() const noexcept
         {
             return candidate_;
         }
+        [[nodiscard]] constexpr const auto &selectCache() const noexcept
+        {
+            return cache_;
+        }
         constexpr auto &&setCandidate(std::vector<FontInfo> candidate) noexcept
         {
             candidate_ = std::move(candidate);
+            cache_.clear();
             return std::move(*this);
         }
 
@@ -251,5 +306,6 @@ namespace mcs::vulkan::font
         std::vector<const FontContext *> selectable_; // NOTE: 已经排好序
         std::vector<FontInfo> candidate_;
         const FontContext *notdefFont_;
+        select_cache<select_result> cache_;
     };
 }; // namespace mcs::vulkan::font
\ No newline at end of file
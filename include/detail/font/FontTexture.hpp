@@ -4,6 +4,7 @@
 #include "../vma/create_texture_image.hpp"
 #include "../vma/create_image.hpp"
 #include "../load/raw_stbi_image.hpp"
+#include "../load/ktx2_image.hpp"
 
 #include "FontAllocationContext.hpp"
 
@@ -12,6 +13,7 @@ namespace mcs::vulkan::font
     class FontTexture
     {
         using raw_stbi_image = load::raw_stbi_image;
+        using ktx2_image = load::ktx2_image;
         using texture_image_base = vma::resource;
         using create_image = vma::create_image;
         using create_texture_image = vma::create_texture_image;
@@ -23,19 +25,44 @@ namespace mcs::vulkan::font
             raw_stbi_image image;
             FontAllocationContext allocation;
         }; // NOLINTEND
+        // NOTE: KTX2 已经是 GPU 格式，直接上传，格式取自文件
+        struct ktx2_info // NOLINTBEGIN
+        {
+            ktx2_image image;
+            FontAllocationContext allocation;
+        }; // NOLINTEND
         explicit FontTexture(const msdf_info &info)
+            : texture_{build(info.allocation, info.image.width(), info.image.height(),
+                             VK_FORMAT_R8G8B8A8_UNORM,
+                             std::span<const unsigned char>{info.image.data(),
+                                                            info.image.size()})}
+        {
+        }
+        explicit FontTexture(const ktx2_info &info)
+            : texture_{build(info.allocation, info.image.width(), info.image.height(),
+                             info.image.format(),
+                             std::span<const unsigned char>{info.image.data(),
+                                                            info.image.size()})}
+        {
+        }
+        [[nodiscard]] const texture_image_base &view() const noexcept
+        {
+            return texture_;
+        }
+
+      private:
+        static texture_image_base build(FontAllocationContext allocation, int width,
+                                        int height, VkFormat format,
+                                        std::span<const unsigned char> pixels)
         {
-            const auto &[raw_data, allocation] = info;
             const auto [allocator, device, pool, queue] = allocation;
-            auto width = raw_data.width();
-            auto height = raw_data.height();
             uint32_t mipLevels = 1; // 字体无需 mipmap
             auto create_texture = create_texture_image{
                 *pool, *queue,
                 create_image{*device, allocator}
                     .setCreateInfo(
                         {.imageType = VK_IMAGE_TYPE_2D,
-                         .format = VK_FORMAT_R8G8B8A8_UNORM,
+                         .format = format,
                          .extent = {static_cast<uint32_t>(width),
                                     static_cast<uint32_t>(height), 1},
                          .mipLevels = mipLevels,
@@ -56,12 +83,7 @@ namespace mcs::vulkan::font
                                               .levelCount = mipLevels,
                                               .baseArrayLayer = 0,
                                               .layerCount = 1}})};
-            texture_ = create_texture.build(
-                std::span<const unsigned char>{raw_data.data(), raw_data.size()});
-        }
-        [[nodiscard]] const texture_image_base &view() const noexcept
-        {
-            return texture_;
+            return create_texture.build(pixels);
         }
     };
 }; // namespace mcs::vulkan::font
\ No newline at end of file
@@ -28,8 +28,12 @@ namespace mcs::vulkan::font
         const FontContext *make(FontInfo info)
         {
             using stbi_image_type = texture_info::stbi_image_type;
+            using ktx2_image_type = texture_info::ktx2_image_type;
             const auto &registration = info.registration;
+            // NOTE: 纹理由 make_ 创建，ktx2 需要 make_ 自己处理(用文件里的 VkFormat)
             if (std::holds_alternative<stbi_image_type>(
+                    registration.texture_info.image_variant) ||
+                std::holds_alternative<ktx2_image_type>(
                     registration.texture_info.image_variant))
             {
                 auto bind_texture = make_(info);
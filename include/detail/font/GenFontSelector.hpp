@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FontInfo.hpp"
+#include "select_cache.hpp"
 #include "harfbuzz/tag_to_language.hpp"
 #include "harfbuzz/script_to_language.hpp"
 #include "harfbuzz/make_language_type.hpp"
@@ -47,6 +48,7 @@ namespace mcs::vulkan::font
                     {
                         selectable_.push_back(newFont);
                         candidate_.erase(it);
+                        cache_.clear(); // NOTE: 新字体可能改变其他码点的匹配
                         if (newFont->has_glyph(codepoint))
                             return newFont;
                     }
@@ -100,7 +102,7 @@ namespace mcs::vulkan::font
         using select_result_type = select_result;
         using font_context_type = FontContext;
         using language_type = harfbuzz::language_type;
-        // TODO(mcs): 可补充字体排序权重、缓存匹配结果、处理多语言回退顺序
+        // TODO(mcs): 可补充字体排序权重、处理多语言回退顺序
         /*
         字体选择的核心是确定哪个字体能够提供该字符（码点）的合理字形，而具体字形形状、变体、合字等是通过
         HarfBuzz 的 shaping
@@ -108,6 +110,15 @@ namespace mcs::vulkan::font
         */
         [[nodiscard]] constexpr auto selectFont(char32_t codepoint, hb_script_t script)
             -> select_result
+        {
+            if (const auto *hit = cache_.find(codepoint, script))
+                return *hit;
+            auto ret = resolveFont(codepoint, script);
+            cache_.insert(codepoint, script, ret);
+            return ret;
+        }
+        [[nodiscard]] constexpr auto resolveFont(char32_t codepoint, hb_script_t script)
+            -> select_result
         {
             // 完全匹配
             if (auto ret = findOrLoad(preferenceTag(), script, codepoint))
@@ -172,6 +183,7 @@ namespace mcs::vulkan::font
                                           hb_tag_t preferenceTag) noexcept
         {
             self.language_ = harfbuzz::make_language_type(preferenceTag);
+            self.cache_.clear();
             return std::forward<decltype(self)>(self);
         }
         // NOTE: 语言 地区
@@ -179,6 +191,7 @@ namespace mcs::vulkan::font
                                                const std::string_view &bcp47) noexcept
         {
             self.language_ = harfbuzz::make_language_type(harfbuzz::bcp47_to_tag(bcp47));
+            self.cache_.clear();
             return std::forward<decltype(self)>(self);
         }
         constexpr auto &&load(this auto &&self, FontInfo info)
@@ -186,6 +199,7 @@ namespace mcs::vulkan::font
             const FontContext *newFont = self.factory_->make(std::move(info));
             mcs::vulkan::MCS_ASSERT(newFont != nullptr);
             self.selectable_.emplace_back(newFont);
+            self.cache_.clear();
             return std::forward<decltype(self)>(self);
         }
 
@@ -200,10 +214,15 @@ namespace mcs::vulkan::font
         {
             return candidate_;
         }
+        [[nodiscard]] constexpr const auto &selectCache() const noexcept
+        {
+            return cache_;
+        }
         constexpr auto &&setCandidate(this auto &&self,
                                       std::vector<FontInfo> candidate) noexcept
         {
             self.candidate_ = std::move(candidate);
+            self.cache_.clear();
             return std::forward<decltype(self)>(self);
         }
 
@@ -249,6 +268,7 @@ namespace mcs::vulkan::font
             if (it == selectable_.end())
                 return false;
             selectable_.erase(it);
+            cache_.clear();
 
             // 2. 更新 notdefFont_
             if (notdefFont_ == font)
@@ -275,5 +295,6 @@ namespace mcs::vulkan::font
         std::vector<const FontContext *> selectable_; // NOTE: 已经排好序
         std::vector<FontInfo> candidate_;
         const FontContext *notdefFont_;
+        select_cache<select_result> cache_;
     };
 }; // namespace mcs::vulkan::font
\ No newline at end of file
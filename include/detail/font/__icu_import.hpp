@@ -0,0 +1,5 @@
+#pragma once
+
+#include <unicode/brkiter.h>
+#include <unicode/locid.h>
+#include <unicode/utext.h>
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <format>
 #include <print>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -11,9 +12,11 @@
 #include "harfbuzz/script_to_string.hpp"
 
 #include "bidi/visual_result.hpp"
+#include "bidi/visual_buffer.hpp"
 
 #include "shape_info.hpp"
 #include "shape_run.hpp"
+#include "run_range.hpp"
 
 namespace mcs::vulkan::font
 {
@@ -56,6 +59,52 @@ namespace mcs::vulkan::font
             return false;
         } // NOLINTEND
 
+        // NOTE: [left, logical_end) 同一 script，继续按 字体/语言 分割，结果追加到 runs
+        template <typename FontSelector, typename shape_info_type>
+        static constexpr void assign_script_fonts(std::span<const uint32_t> codepoints,
+                                                  hb_script_t script, size_t left,
+                                                  size_t logical_end,
+                                                  FontSelector &selector,
+                                                  std::vector<shape_info_type> &runs)
+        {
+            if (left >= logical_end)
+                return;
+            // TODO(mcs):selectFont()目前从左到右第一个满足就被选中.getFallbackLanguage()
+            auto current = select_font_with_callback(selector, codepoints[left], script);
+            // NOTE: 继续按 语言分割
+            while (left < logical_end)
+            {
+                auto [font, lang] = current;
+
+                size_t right = left;
+                // NOTE: 直到 right + 1 不同。不同的那个结果留给下一段，避免重复查询
+                while (right + 1 < logical_end)
+                {
+                    current = select_font_with_callback(
+                        selector, codepoints[right + 1], script);
+                    if (current.font == font && current.language == lang)
+                    {
+                        ++right;
+                        continue;
+                    }
+                    break;
+                }
+
+                if (right == left && skip_show_characters(codepoints[left]))
+                {
+                    left += 1;
+                    continue;
+                }
+                runs.emplace_back(
+                    shape_info{.logical_start = left,
+                               .length = static_cast<int>(right + 1 - left),
+                               .script = script,
+                               .language = lang,
+                               .font = font});
+                left = right + 1;
+            }
+        }
+
     }; // namespace detail
 
     /**
@@ -96,40 +145,8 @@ run；否则，即使方向一致，也需要进一步按脚本或字体支持
                 size_t left = bidi_run.offset + script_info.offset;
                 auto logical_end = left + script_info.length;
 
-                // NOTE: 继续按 语言分割
-                while (left < logical_end)
-                {
-                    // TODO(mcs):selectFont()目前从左到右第一个满足就被选中.getFallbackLanguage()
-                    auto [font, lang] = detail::select_font_with_callback(
-                        selector, codepoints[left], script);
-
-                    size_t right = left;
-                    // NOTE: 直到 right + 1 不同
-                    while (right + 1 < logical_end)
-                    {
-                        if (auto [cur_font, cur_lang] = detail::select_font_with_callback(
-                                selector, codepoints[right + 1], script);
-                            cur_font == font && cur_lang == lang)
-                        {
-                            ++right;
-                            continue;
-                        }
-                        break;
-                    }
-
-                    if (right == left && detail::skip_show_characters(codepoints[left]))
-                    {
-                        left += 1;
-                        continue;
-                    }
-                    runs.emplace_back(
-                        shape_info{.logical_start = left,
-                                   .length = static_cast<int>(right + 1 - left),
-                                   .script = script,
-                                   .language = lang,
-                                   .font = font});
-                    left = right + 1;
-                }
+                detail::assign_script_fonts(std::span<const uint32_t>{codepoints}, script,
+                                            left, logical_end, selector, runs);
             }
             result.emplace_back(
                 shape_run{.direction = bidi_run.direction(), .runs = std::move(runs)});
@@ -137,6 +154,37 @@ run；否则，即使方向一致，也需要进一步按脚本或字体支持
         return result;
     }
 
+    // NOTE: 扁平版本，写入 infos（先 clear）；每个 bidi run 对应 ranges 中的一段
+    template <typename FontSelector>
+        requires(requires(FontSelector &selector, char32_t codepoint,
+                          hb_script_t script) {
+            detail::select_font_with_callback(selector, codepoint, script);
+            typename FontSelector::select_result_type;
+            typename FontSelector::font_context_type;
+        })
+    constexpr static void assign_fonts(
+        std::span<const uint32_t> codepoints, const bidi::visual_buffer &visual,
+        FontSelector &selector,
+        std::vector<shape_info<typename FontSelector::font_context_type>> &infos,
+        std::vector<run_range> &ranges)
+    {
+        infos.clear();
+        ranges.clear();
+        for (const auto &bidi_run : visual.runs)
+        {
+            const size_t first = infos.size();
+            for (const auto &script_info : visual.script(bidi_run))
+            {
+                size_t left = bidi_run.offset + script_info.offset;
+                detail::assign_script_fonts(codepoints, script_info.script, left,
+                                            left + script_info.length, selector, infos);
+            }
+            ranges.emplace_back(run_range{.direction = bidi_run.direction(),
+                                          .first = first,
+                                          .count = infos.size() - first});
+        }
+    }
+
     template <typename shape_run>
     constexpr static void print_text_runs(const std::vector<shape_run> &runs)
     {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "visual_result.hpp"
+#include "visual_buffer.hpp"
 #include "segment_scripts_for_run.hpp"
 
 #include "../harfbuzz/script_to_string.hpp"
@@ -20,80 +21,116 @@
 
 namespace mcs::vulkan::font::bidi
 {
-    // 双向分析 (UAX #9) ─→ 逻辑顺序字符信息 + 镜像映射 + 方向运行
-    static constexpr visual_result analyze(std::vector<uint32_t> codepoints,
-                                           int base_level)
+    namespace detail
     {
-        using SBAlgorithmPtr =
-            unique_handle<SBAlgorithmRef, [](SBAlgorithmRef value) constexpr noexcept {
-                SBAlgorithmRelease(value);
-            }>;
-        using SBParagraphPtr =
-            unique_handle<SBParagraphRef, [](SBParagraphRef value) constexpr noexcept {
-                SBParagraphRelease(value);
-            }>;
-        using SBLinePtr =
-            unique_handle<SBLineRef, [](SBLineRef value) constexpr noexcept {
-                SBLineRelease(value);
-            }>;
-
-        SBCodepointSequence codepointSequence{SBStringEncodingUTF32, codepoints.data(),
-                                              codepoints.size()};
-        auto RAIIAlog = SBAlgorithmPtr{SBAlgorithmCreate(&codepointSequence)};
-        SBAlgorithmRef bidiAlgorithm = RAIIAlog.get();
-        if (bidiAlgorithm == nullptr)
-            return {};
-
-        std::vector<visual_run> visual_bidi_runs;
-        SBUInteger offset = 0;
-        const SBUInteger totalLength = codepoints.size(); // NOLINT
-        while (offset < totalLength)
+        // NOTE: 逐段落逐 run 回调 on_run(const SBRun &)，返回 false 表示算法创建失败
+        static constexpr bool for_each_visual_run(std::span<const uint32_t> codepoints,
+                                                  int base_level, auto &&on_run)
         {
-            // 获取当前段落的实际长度（不含分隔符）和分隔符长度
-            SBUInteger actualLength, separatorLength; // NOLINT
-            SBAlgorithmGetParagraphBoundary(bidiAlgorithm, offset, INT32_MAX,
-                                            &actualLength, &separatorLength);
-            if (actualLength == 0)
-                break;
-
-            // 创建段落：绝对偏移 offset，长度 actualLength
-            auto RAIIParagraph = SBParagraphPtr{SBAlgorithmCreateParagraph(
-                bidiAlgorithm, offset, actualLength, static_cast<SBLevel>(base_level))};
-            SBParagraphRef paragraph = RAIIParagraph.get();
-            if (paragraph == nullptr)
-                break;
-
-            // 创建行：使用绝对偏移 offset，长度 actualLength
-            auto RAIILine =
-                SBLinePtr{SBParagraphCreateLine(paragraph, offset, actualLength)};
-            SBLineRef line = RAIILine.get();
-            if (line == nullptr)
-                break;
-
-            SBUInteger runCount = SBLineGetRunCount(line);
-            const SBRun *runArray = SBLineGetRunsPtr(line);
-            for (SBUInteger i = 0; i < runCount; ++i)
+            using SBAlgorithmPtr =
+                unique_handle<SBAlgorithmRef,
+                              [](SBAlgorithmRef value) constexpr noexcept {
+                                  SBAlgorithmRelease(value);
+                              }>;
+            using SBParagraphPtr =
+                unique_handle<SBParagraphRef,
+                              [](SBParagraphRef value) constexpr noexcept {
+                                  SBParagraphRelease(value);
+                              }>;
+            using SBLinePtr =
+                unique_handle<SBLineRef, [](SBLineRef value) constexpr noexcept {
+                    SBLineRelease(value);
+                }>;
+
+            SBCodepointSequence codepointSequence{
+                SBStringEncodingUTF32, codepoints.data(), codepoints.size()};
+            auto RAIIAlog = SBAlgorithmPtr{SBAlgorithmCreate(&codepointSequence)};
+            SBAlgorithmRef bidiAlgorithm = RAIIAlog.get();
+            if (bidiAlgorithm == nullptr)
+                return false;
+
+            SBUInteger offset = 0;
+            const SBUInteger totalLength = codepoints.size(); // NOLINT
+            while (offset < totalLength)
             {
-                visual_bidi_runs.emplace_back(visual_run{
-                    .offset = runArray[i].offset,
-                    .length = runArray[i].length,
-                    .level = runArray[i].level,
-                    .script = segment_scripts_for_run(std::span{
-                        codepoints.data() + runArray[i].offset, runArray[i].length})});
-            }
+                // 获取当前段落的实际长度（不含分隔符）和分隔符长度
+                SBUInteger actualLength, separatorLength; // NOLINT
+                SBAlgorithmGetParagraphBoundary(bidiAlgorithm, offset, INT32_MAX,
+                                                &actualLength, &separatorLength);
+                if (actualLength == 0)
+                    break;
+
+                // 创建段落：绝对偏移 offset，长度 actualLength
+                auto RAIIParagraph = SBParagraphPtr{
+                    SBAlgorithmCreateParagraph(bidiAlgorithm, offset, actualLength,
+                                               static_cast<SBLevel>(base_level))};
+                SBParagraphRef paragraph = RAIIParagraph.get();
+                if (paragraph == nullptr)
+                    break;
+
+                // 创建行：使用绝对偏移 offset，长度 actualLength
+                auto RAIILine =
+                    SBLinePtr{SBParagraphCreateLine(paragraph, offset, actualLength)};
+                SBLineRef line = RAIILine.get();
+                if (line == nullptr)
+                    break;
+
+                SBUInteger runCount = SBLineGetRunCount(line);
+                const SBRun *runArray = SBLineGetRunsPtr(line);
+                for (SBUInteger i = 0; i < runCount; ++i)
+                    on_run(runArray[i]);
 
-            // 镜像部分保持注释（未启用）
-            // ...
+                // 镜像部分保持注释（未启用）
+                // ...
 
-            // separatorLength = 2，说明分隔符 \r\n 的长度为 2 字节. actualLength 已经包含\r\n 了
-            // 移动到下一段落
-            offset += actualLength;
+                // separatorLength = 2，说明分隔符 \r\n 的长度为 2 字节. actualLength 已经包含\r\n 了
+                // 移动到下一段落
+                offset += actualLength;
+            }
+            return true;
         }
+    }; // namespace detail
+
+    // 双向分析 (UAX #9) ─→ 逻辑顺序字符信息 + 镜像映射 + 方向运行
+    static constexpr visual_result analyze(std::span<const uint32_t> codepoints,
+                                           int base_level)
+    {
+        std::vector<visual_run> visual_bidi_runs;
+        if (!detail::for_each_visual_run(
+                codepoints, base_level, [&](const SBRun &run) constexpr {
+                    visual_bidi_runs.emplace_back(visual_run{
+                        .offset = run.offset,
+                        .length = run.length,
+                        .level = run.level,
+                        .script = segment_scripts_for_run(
+                            codepoints.subspan(run.offset, run.length))});
+                }))
+            return {};
 
         // 注意：这里返回的 mirrored_codepoints 与原 codepoints 相同（未镜像）
-        return {.mirrored_codepoints = std::move(codepoints),
+        return {.mirrored_codepoints = {codepoints.begin(), codepoints.end()},
                 .visual_bidi_runs = std::move(visual_bidi_runs)};
     }
+
+    // NOTE: 写入 out（先 clear），不拷贝码点：未启用镜像，直接使用输入的 codepoints
+    static constexpr void analyze(std::span<const uint32_t> codepoints, int base_level,
+                                  visual_buffer &out, SBScriptLocatorRef locator)
+    {
+        out.clear();
+        detail::for_each_visual_run(
+            codepoints, base_level, [&](const SBRun &run) constexpr {
+                const size_t first = out.scripts.size();
+                segment_scripts_for_run(codepoints.subspan(run.offset, run.length),
+                                        locator, out.scripts);
+                out.runs.emplace_back(
+                    visual_buffer::run{.offset = run.offset,
+                                       .length = run.length,
+                                       .level = run.level,
+                                       .script_first = first,
+                                       .script_count = out.scripts.size() - first});
+            });
+    }
+
     static constexpr void print_bidi_result(const std::vector<uint32_t> &codepoints,
                                             const visual_result &visual_result)
     {
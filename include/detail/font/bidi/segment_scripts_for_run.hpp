@@ -10,32 +10,37 @@
 
 namespace mcs::vulkan::font::bidi
 {
-    constexpr static auto segment_scripts_for_run(std::span<const uint32_t> codepoints)
-        -> std::vector<bidi_script>
+    // NOTE: 复用 locator，结果追加到 output
+    constexpr static void segment_scripts_for_run(std::span<const uint32_t> codepoints,
+                                                  SBScriptLocatorRef locator,
+                                                  std::vector<bidi_script> &output)
     {
-        using SBScriptLocatorPtr =
-            unique_handle<SBScriptLocatorRef,
-                          [](SBScriptLocatorRef value) constexpr noexcept {
-                              SBScriptLocatorRelease(value);
-                          }>;
-
         SBCodepointSequence sequence{.stringEncoding = SBStringEncodingUTF32,
                                      .stringBuffer = codepoints.data(),
                                      .stringLength = codepoints.size()};
-
-        SBScriptLocatorPtr RAIIlocator = SBScriptLocatorPtr{SBScriptLocatorCreate()};
-        auto *locator = RAIIlocator.get();
         const SBScriptAgent *agent = SBScriptLocatorGetAgent(locator);
 
         SBScriptLocatorLoadCodepoints(locator, &sequence);
-
-        std::vector<bidi_script> output;
-        output.reserve(1);
         while (SBScriptLocatorMoveNext(locator) != 0)
             output.emplace_back(
                 bidi_script{.offset = agent->offset,
                             .length = agent->length,
                             .script = sb_script_to_hb_script(agent->script)});
+    }
+
+    constexpr static auto segment_scripts_for_run(std::span<const uint32_t> codepoints)
+        -> std::vector<bidi_script>
+    {
+        using SBScriptLocatorPtr =
+            unique_handle<SBScriptLocatorRef,
+                          [](SBScriptLocatorRef value) constexpr noexcept {
+                              SBScriptLocatorRelease(value);
+                          }>;
+        SBScriptLocatorPtr RAIIlocator = SBScriptLocatorPtr{SBScriptLocatorCreate()};
+
+        std::vector<bidi_script> output;
+        output.reserve(1);
+        segment_scripts_for_run(codepoints, RAIIlocator.get(), output);
         return output;
     }
 }; // namespace mcs::vulkan::font::bidi
\ No newline at end of file
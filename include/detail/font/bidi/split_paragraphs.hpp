@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../__bidi_import.hpp"
+#include "../../utils/unique_handle.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace mcs::vulkan::font::bidi
+{
+    struct paragraph_boundary // NOLINTBEGIN
+    {
+        size_t offset;           // UTF-8 字节偏移
+        size_t length;           // 含分隔符
+        size_t separator_length; // 0 表示文本结尾处没有分隔符
+    }; // NOLINTEND
+
+    /**
+     * NOTE: 按 UAX #9 的段落分隔符(B 类: LF CR CRLF NEL PS ...)切分 UTF-8 文本。
+     * 与 analyze 使用同一个 SBAlgorithmGetParagraphBoundary，保证两者段落一致。
+     * NFC 不会合成/拆分分隔符，因此可以直接在原始 UTF-8 上切分。
+     */
+    static constexpr void split_paragraphs(std::string_view utf8,
+                                           std::vector<paragraph_boundary> &out)
+    {
+        using SBAlgorithmPtr =
+            unique_handle<SBAlgorithmRef, [](SBAlgorithmRef value) constexpr noexcept {
+                SBAlgorithmRelease(value);
+            }>;
+        out.clear();
+        if (utf8.empty())
+            return;
+
+        SBCodepointSequence sequence{SBStringEncodingUTF8, utf8.data(), utf8.size()};
+        auto RAIIAlog = SBAlgorithmPtr{SBAlgorithmCreate(&sequence)};
+        if (!RAIIAlog)
+        {
+            out.emplace_back(paragraph_boundary{
+                .offset = 0, .length = utf8.size(), .separator_length = 0});
+            return;
+        }
+        SBUInteger offset = 0;
+        while (offset < utf8.size())
+        {
+            SBUInteger actualLength, separatorLength; // NOLINT
+            SBAlgorithmGetParagraphBoundary(RAIIAlog.get(), offset, INT32_MAX,
+                                            &actualLength, &separatorLength);
+            if (actualLength == 0)
+                break;
+            out.emplace_back(paragraph_boundary{.offset = offset,
+                                                .length = actualLength,
+                                                .separator_length = separatorLength});
+            offset += actualLength;
+        }
+    }
+}; // namespace mcs::vulkan::font::bidi
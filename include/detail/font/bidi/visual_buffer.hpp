@@ -0,0 +1,45 @@
+#pragma once
+
+#include "bidi_script.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mcs::vulkan::font::bidi
+{
+    /**
+     * NOTE: visual_result 的扁平版本，供 text_arena 复用。
+     * run.script 不再是独立的 vector，而是 scripts 中的 [script_first, +script_count)。
+     * clear() 只清空内容，保留容量。
+     */
+    struct visual_buffer // NOLINTBEGIN
+    {
+        struct run
+        {
+            size_t offset;
+            size_t length;
+            uint8_t level;
+            size_t script_first;
+            size_t script_count;
+
+            [[nodiscard]] constexpr hb_direction_t direction() const noexcept
+            {
+                return ((level % 2) != 0) ? HB_DIRECTION_RTL : HB_DIRECTION_LTR;
+            }
+        };
+
+        std::vector<run> runs;
+        std::vector<bidi_script> scripts;
+
+        [[nodiscard]] constexpr std::span<const bidi_script> script(
+            const run &r) const noexcept
+        {
+            return std::span{scripts}.subspan(r.script_first, r.script_count);
+        }
+        constexpr void clear() noexcept
+        {
+            runs.clear();
+            scripts.clear();
+        }
+    }; // NOLINTEND
+}; // namespace mcs::vulkan::font::bidi
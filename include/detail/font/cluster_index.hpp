@@ -0,0 +1,238 @@
+#pragma once
+
+#include "text_layout.hpp"
+#include "__utf8proc_import.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 一行文本的字素簇(UAX #29，utf8proc)索引，供光标、命中测试与选区使用。
+     * build() 一次建立，之后的查询都是二分查找：
+     * - 逻辑方向: codepoint -> 字素簇 -> glyph 区间 / x 范围
+     * - 视觉方向: x -> 字素簇 -> 光标位置(codepoint 下标)
+     * 多个字素簇共用一个 glyph(连字)时平分其 advance。
+     * x 从行首(视觉最左)开始，单位与 shape_result::advance_x 相同(em)。
+     */
+    class cluster_index
+    {
+      public:
+        struct grapheme // NOLINTBEGIN
+        {
+            size_t first; // codepoint 区间 [first, first + count)
+            size_t count;
+            size_t glyph_first; // layout.glyphs 中的区间，连字时与相邻字素簇相同
+            size_t glyph_count;
+            double x; // 视觉左边缘
+            double width;
+            bool rtl;
+
+            // NOTE: 逻辑起点一侧的边缘
+            [[nodiscard]] constexpr double leading() const noexcept
+            {
+                return rtl ? x + width : x;
+            }
+            [[nodiscard]] constexpr double trailing() const noexcept
+            {
+                return rtl ? x : x + width;
+            }
+        }; // NOLINTEND
+
+        // NOTE: 单行段落，visual runs 即 layout.glyph_ranges
+        template <typename FontContext>
+        constexpr void build(const text_layout<FontContext> &layout)
+        {
+            build(layout, layout.glyph_ranges, 0, layout.codepoints.size());
+        }
+
+        // NOTE: 折行后的一行：runs 为 line_fitter::reorder 的输出
+        template <typename FontContext>
+        constexpr void build(const text_layout<FontContext> &layout,
+                             std::span<const run_range> runs, size_t first, size_t last)
+        {
+            graphemes_.clear();
+            visual_.clear();
+            visualX_.clear();
+            first_ = first;
+            width_ = 0.0;
+            if (first >= last)
+                return;
+
+            // 1. 字素簇边界
+            const auto &codepoints = layout.codepoints;
+            owner_.assign(last - first, 0);
+            utf8proc_int32_t state = 0;
+            for (size_t i = first; i < last; ++i)
+            {
+                if (i == first ||
+                    utf8proc_grapheme_break_stateful(
+                        static_cast<utf8proc_int32_t>(codepoints[i - 1]),
+                        static_cast<utf8proc_int32_t>(codepoints[i]), &state))
+                    graphemes_.emplace_back(grapheme{.first = i,
+                                                     .count = 0,
+                                                     .glyph_first = NONE,
+                                                     .glyph_count = 0,
+                                                     .x = INF,
+                                                     .width = 0.0,
+                                                     .rtl = false});
+                ++graphemes_.back().count;
+                owner_[i - first] = static_cast<uint32_t>(graphemes_.size() - 1);
+            }
+
+            // 2. 按视觉顺序累加 advance，glyph 归属于其 cluster 所在的字素簇
+            double pen = 0.0;
+            for (const auto &run : runs)
+            {
+                for (size_t gi = run.first; gi < run.first + run.count; ++gi)
+                {
+                    const auto &glyph = layout.glyphs[gi];
+                    const double advance = glyph.advance_x;
+                    if (glyph.logical_idx >= first && glyph.logical_idx < last)
+                    {
+                        auto &g = graphemes_[owner_[glyph.logical_idx - first]];
+                        const size_t glyph_last =
+                            g.glyph_count == 0 ? gi + 1
+                                               : std::max(g.glyph_first + g.glyph_count,
+                                                          gi + 1);
+                        const double right = g.x == INF
+                                                 ? pen + advance
+                                                 : std::max(g.x + g.width, pen + advance);
+                        g.glyph_first = std::min(g.glyph_first, gi);
+                        g.glyph_count = glyph_last - g.glyph_first;
+                        g.x = std::min(g.x, pen);
+                        g.width = right - g.x;
+                        g.rtl = glyph.is_rtl();
+                    }
+                    pen += advance;
+                }
+            }
+            width_ = pen;
+
+            // 3. 没有 glyph 的字素簇(被连字吞并)与前面的字素簇平分其范围
+            for (size_t begin = 0; begin < graphemes_.size();)
+            {
+                size_t end = begin + 1;
+                while (end < graphemes_.size() && graphemes_[end].glyph_count == 0)
+                    ++end;
+                splitLigature(begin, end);
+                begin = end;
+            }
+
+            // 4. 视觉顺序，x 单调不减
+            visual_.resize(graphemes_.size());
+            for (size_t i = 0; i < visual_.size(); ++i)
+                visual_[i] = static_cast<uint32_t>(i);
+            std::ranges::stable_sort(visual_, {},
+                                     [&](uint32_t index) { return graphemes_[index].x; });
+            visualX_.resize(visual_.size());
+            for (size_t i = 0; i < visual_.size(); ++i)
+                visualX_[i] = graphemes_[visual_[i]].x;
+        }
+
+        [[nodiscard]] constexpr std::span<const grapheme> graphemes() const noexcept
+        {
+            return graphemes_;
+        }
+        [[nodiscard]] constexpr double width() const noexcept
+        {
+            return width_;
+        }
+
+        // NOTE: 包含 codepoint 的字素簇(逻辑下标)
+        [[nodiscard]] constexpr size_t grapheme_at(size_t codepoint) const noexcept
+        {
+            auto it =
+                std::ranges::upper_bound(graphemes_, codepoint, {}, &grapheme::first);
+            return it == graphemes_.begin()
+                       ? 0
+                       : static_cast<size_t>(it - graphemes_.begin()) - 1;
+        }
+
+        // NOTE: 光标(位于 codepoint 之前)的 x；codepoint 取行尾时位于最后一个字素簇之后
+        [[nodiscard]] constexpr double caret_x(size_t codepoint) const noexcept
+        {
+            if (graphemes_.empty())
+                return 0.0;
+            const auto &last = graphemes_.back();
+            if (codepoint >= last.first + last.count)
+                return last.trailing();
+            return graphemes_[grapheme_at(codepoint)].leading();
+        }
+
+        // NOTE: x 处最近的光标位置(codepoint 下标)，O(log n)
+        [[nodiscard]] constexpr size_t hit_test(double x) const noexcept
+        {
+            if (graphemes_.empty())
+                return first_;
+            auto it = std::ranges::upper_bound(visualX_, x);
+            const size_t slot = it == visualX_.begin()
+                                    ? 0
+                                    : static_cast<size_t>(it - visualX_.begin()) - 1;
+            const auto &g = graphemes_[visual_[slot]];
+            const bool right_half = x >= g.x + (g.width / 2);
+            return right_half != g.rtl ? g.first + g.count : g.first;
+        }
+
+        // NOTE: 按字素簇移动光标，不会停在组合字符、emoji 序列中间
+        [[nodiscard]] constexpr size_t next_caret(size_t codepoint) const noexcept
+        {
+            if (graphemes_.empty())
+                return codepoint;
+            const auto &g = graphemes_[grapheme_at(codepoint)];
+            return std::max(codepoint, g.first + g.count);
+        }
+        [[nodiscard]] constexpr size_t prev_caret(size_t codepoint) const noexcept
+        {
+            if (graphemes_.empty() || codepoint <= graphemes_.front().first)
+                return codepoint;
+            return graphemes_[grapheme_at(codepoint - 1)].first;
+        }
+
+      private:
+        static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+        static constexpr double INF = std::numeric_limits<double>::infinity();
+
+        std::vector<grapheme> graphemes_; // 逻辑顺序
+        std::vector<uint32_t> visual_;    // 视觉顺序的字素簇下标
+        std::vector<double> visualX_;     // visual_ 对应的 x，二分查找用
+        std::vector<uint32_t> owner_;     // codepoint -> 字素簇，构建时的临时空间
+        size_t first_{0};
+        double width_{0.0};
+
+        // NOTE: [begin, end) 中只有 begin 有 glyph，视觉上按书写方向依次平分
+        constexpr void splitLigature(size_t begin, size_t end) noexcept
+        {
+            const grapheme owner = graphemes_[begin];
+            if (owner.glyph_count == 0)
+            {
+                // 行首就没有 glyph(例如被裁掉)：零宽，放在 0
+                for (size_t i = begin; i < end; ++i)
+                    graphemes_[i].x = 0.0;
+                return;
+            }
+            const size_t parts = end - begin;
+            if (parts == 1)
+                return;
+            const double part = owner.width / static_cast<double>(parts);
+            const double left = owner.x;
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto &g = graphemes_[i];
+                const auto k = static_cast<double>(i - begin);
+                g.glyph_first = owner.glyph_first;
+                g.glyph_count = owner.glyph_count;
+                g.rtl = owner.rtl;
+                g.width = part;
+                // NOTE: RTL 时逻辑上第一个字素簇在最右
+                const double slot = owner.rtl ? static_cast<double>(parts - 1) - k : k;
+                g.x = left + (part * slot);
+            }
+        }
+    };
+}; // namespace mcs::vulkan::font
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Font.hpp"
+#include "FontInfo.hpp"
+#include "../load/raw_stbi_image.hpp"
+#include "../load/ktx2_image.hpp"
+#include "../utils/mapped_file.hpp"
+
+#include <utility>
+#include <variant>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 加载字体中与 GPU、FT_Library 无关的部分：解析图集 JSON、解码图集图像、
+     * 映射字体文件并预读。可在任意线程执行(load::decode_queue)，
+     * 之后由 FontFactory::make 在调用线程创建 FT_Face、HarfBuzz 字体与纹理。
+     */
+    struct font_source // NOLINTBEGIN
+    {
+        FontInfo info;
+        Font font;
+        mapped_file face_file;
+        std::variant<load::raw_stbi_image, load::ktx2_image> image;
+
+        static font_source decode(FontInfo info)
+        {
+            using stbi_image_type = texture_info::stbi_image_type;
+            using ktx2_image_type = texture_info::ktx2_image_type;
+            font_source source{.info = std::move(info)};
+            const auto &registration = source.info.registration;
+            source.font = Font::make(registration.json_path);
+
+            const auto &variant = registration.texture_info.image_variant;
+            if (const auto *image = std::get_if<stbi_image_type>(&variant))
+                source.image.emplace<load::raw_stbi_image>(image->image_path.data(),
+                                                           image->image_format);
+            else
+                source.image.emplace<load::ktx2_image>(
+                    std::get<ktx2_image_type>(variant).image_path.data());
+
+            source.face_file = mapped_file{registration.font_path};
+            source.face_file.prefault();
+            return source;
+        }
+    }; // NOLINTEND
+}; // namespace mcs::vulkan::font
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "../__freetype_import.hpp"
+#include "../../utils/mapped_file.hpp"
 #include <span>
 #include <string>
+#include <utility>
 
 namespace mcs::vulkan::font::freetype
 {
@@ -21,7 +23,10 @@ namespace mcs::vulkan::font::freetype
             return value_;
         }
         face(const face &) = delete;
-        face(face &&o) noexcept : value_{std::exchange(o.value_, {})} {}
+        face(face &&o) noexcept
+            : value_{std::exchange(o.value_, {})}, source_{std::move(o.source_)}
+        {
+        }
         face &operator=(const face &) = delete;
         face &operator=(face &&o) noexcept
         {
@@ -29,13 +34,21 @@ namespace mcs::vulkan::font::freetype
             {
                 destroy();
                 value_ = std::exchange(o.value_, {});
+                source_ = std::move(o.source_);
             }
             return *this;
         }
         // a. From a Font File
-        constexpr face(FT_Library library, const std::string &fontPath,
-                       FT_Long face_index = 0)
+        // NOTE: 走 b，能 mmap 时字体数据留在页缓存里按需读取；
+        //  否则复用 mapped_file 已读入的缓冲，不让 FreeType 再读一遍文件
+        face(FT_Library library, const std::string &fontPath, FT_Long face_index = 0)
         {
+            mapped_file file{fontPath};
+            if (!file.empty())
+            {
+                *this = face{library, std::move(file), face_index};
+                return;
+            }
             /*
             face_index:
             某些字体格式允许在单个文件中嵌入多个字体。此索引告诉您要加载哪个面。
@@ -64,6 +77,12 @@ namespace mcs::vulkan::font::freetype
             if (error != FT_Err_Ok)
                 throw std::runtime_error{"init FT_Face From Memory error."};
         }
+        // NOTE: 由 face 持有映射，生命周期与 FT_Face 一致
+        face(FT_Library library, mapped_file &&file, FT_Long face_index = 0)
+            : face{library, file.as<FT_Byte>(), face_index}
+        {
+            source_ = std::move(file);
+        }
         // c. From Other Sources (Compressed Files, Network, etc.)
 
         constexpr void destroy() noexcept
@@ -73,6 +92,7 @@ namespace mcs::vulkan::font::freetype
                 FT_Done_Face(value_);
                 value_ = nullptr;
             }
+            source_.destroy(); // FT_Done_Face 之后才能释放字体数据
         }
         constexpr ~face() noexcept
         {
@@ -81,5 +101,6 @@ namespace mcs::vulkan::font::freetype
 
       private:
         FT_Face value_{}; /* handle to face object */
+        mapped_file source_;
     };
 }; // namespace mcs::vulkan::font::freetype
\ No newline at end of file
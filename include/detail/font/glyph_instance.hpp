@@ -0,0 +1,203 @@
+#pragma once
+
+#include "harfbuzz/shape_result.hpp"
+#include "FontType.hpp"
+#include "../utils/mcs_assert.hpp"
+#include "../utils/safe_reinterpret_cast.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MCS_GLYPH_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MCS_GLYPH_NEON
+#endif
+
+namespace mcs::vulkan::font
+{
+    // NOTE: size 以 em 为单位量化到 [0, GLYPH_EM_RANGE]，精度约 6e-5 em
+    constexpr float GLYPH_EM_RANGE = 4.0F;
+
+    /**
+     * NOTE: 上传给 GPU 的紧凑字形实例，32 字节(原先 shader_data::Glyph 为 124 字节)。
+     * shader 端解包:
+     *   size = unpackUnorm2x16(size) * GLYPH_EM_RANGE * em_size
+     *   uv   = unpackUnorm2x16(uv[0]), unpackUnorm2x16(uv[1])   // (l, t), (r, b)
+     *   color = unpackUnorm4x8(color)
+     *   texture = packed & 0xFFFF, sampler = (packed >> 16) & 0xFF,
+     *   font_type = (packed >> 24) & 0xF, flags = packed >> 28
+     * 距离场范围(pxRange)按 texture 下标从字体表中取，不放在实例里。
+     */
+    struct glyph_instance // NOLINTBEGIN
+    {
+        float x; // 字形矩形左上角，目标坐标系(y 向下)
+        float y;
+        std::array<uint16_t, 2> size; // unorm16: 宽高(em) / GLYPH_EM_RANGE
+        std::array<uint16_t, 4> uv;   // unorm16: left, top, right, bottom
+        uint32_t color;               // RGBA8，R 在最低字节
+        float em_size;                // 每 em 的目标单位数
+        uint32_t packed;              // texture:16 | sampler:8 | font_type:4 | flags:4
+
+        static constexpr uint32_t FLAG_MODULATE = 1;
+
+        [[nodiscard]] static constexpr uint32_t pack(uint32_t texture, uint32_t sampler,
+                                                     FontType type,
+                                                     uint32_t flags) noexcept
+        {
+            return (texture & 0xFFFFU) | ((sampler & 0xFFU) << 16U) |
+                   ((static_cast<uint32_t>(type) & 0xFU) << 24U) |
+                   ((flags & 0xFU) << 28U);
+        }
+        [[nodiscard]] constexpr uint32_t texture_index() const noexcept
+        {
+            return packed & 0xFFFFU;
+        }
+        [[nodiscard]] constexpr uint32_t sampler_index() const noexcept
+        {
+            return (packed >> 16U) & 0xFFU;
+        }
+        [[nodiscard]] constexpr FontType font_type() const noexcept
+        {
+            return static_cast<FontType>((packed >> 24U) & 0xFU);
+        }
+        [[nodiscard]] constexpr uint32_t flags() const noexcept
+        {
+            return packed >> 28U;
+        }
+    }; // NOLINTEND
+    static_assert(sizeof(glyph_instance) == 32);
+
+    // NOTE: 一行的书写位置，pack_glyph_instances 推进 x
+    struct glyph_pen // NOLINTBEGIN
+    {
+        float x;
+        float baseline;
+        float em_size;
+        uint32_t color = 0xFFFFFFFFU;
+        uint32_t flags = glyph_instance::FLAG_MODULATE;
+    }; // NOLINTEND
+
+    namespace detail
+    {
+        constexpr float UNORM16_MAX = 65535.0F;
+
+        // NOTE: in = {size.x, size.y, uv.l, uv.t, uv.r, uv.b}，已除以各自范围
+        using quantized = std::array<uint16_t, 6>;
+
+        inline quantized quantize_unorm16_scalar(const std::array<float, 6> &in) noexcept
+        {
+            quantized out; // NOLINT
+            for (size_t i = 0; i < in.size(); ++i)
+                out[i] = static_cast<uint16_t>(
+                    std::lround(std::clamp(in[i], 0.0F, 1.0F) * UNORM16_MAX));
+            return out;
+        }
+
+        // NOTE: 6 个值一次量化(两个 128 位寄存器)
+        inline quantized quantize_unorm16(const std::array<float, 6> &in) noexcept
+        {
+            quantized out; // NOLINT
+#if defined(MCS_GLYPH_SSE2)
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0F);
+            const __m128 scale = _mm_set1_ps(UNORM16_MAX);
+            __m128 a = _mm_loadu_ps(in.data());
+            __m128 b = _mm_set_ps(0.0F, 0.0F, in[5], in[4]);
+            a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(a, zero), one), scale);
+            b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, zero), one), scale);
+            // NOTE: SSE2 没有 packus_epi32，先偏移到有符号范围再 packs，最后翻转符号位
+            const __m128i bias = _mm_set1_epi32(0x8000);
+            const __m128i ia = _mm_sub_epi32(_mm_cvtps_epi32(a), bias);
+            const __m128i ib = _mm_sub_epi32(_mm_cvtps_epi32(b), bias);
+            const __m128i packed =
+                _mm_xor_si128(_mm_packs_epi32(ia, ib), _mm_set1_epi16(-0x8000));
+            std::array<uint16_t, 8> tmp; // NOLINT
+            _mm_storeu_si128(safe_reinterpret_cast<__m128i *>(tmp.data()), packed);
+            std::memcpy(out.data(), tmp.data(), sizeof(out));
+#elif defined(MCS_GLYPH_NEON)
+            const float32x4_t zero = vdupq_n_f32(0.0F);
+            const float32x4_t one = vdupq_n_f32(1.0F);
+            const std::array<float, 4> tail{in[4], in[5], 0.0F, 0.0F};
+            float32x4_t a = vld1q_f32(in.data());
+            float32x4_t b = vld1q_f32(tail.data());
+            a = vmulq_n_f32(vminq_f32(vmaxq_f32(a, zero), one), UNORM16_MAX);
+            b = vmulq_n_f32(vminq_f32(vmaxq_f32(b, zero), one), UNORM16_MAX);
+            vst1_u16(out.data(), vqmovun_s32(vcvtnq_s32_f32(a)));
+            const uint16x4_t hi = vqmovun_s32(vcvtnq_s32_f32(b));
+            out[4] = vget_lane_u16(hi, 0);
+            out[5] = vget_lane_u16(hi, 1);
+#else
+            out = quantize_unorm16_scalar(in);
+#endif
+            return out;
+        }
+    }; // namespace detail
+
+    /**
+     * NOTE: shape_result(逻辑上一行、视觉顺序) -> glyph_instance，写入 out(可以是映射的显存)。
+     * - 空白字形(plane_bounds 全 0)只推进 pen，不产生实例；返回写入的实例数
+     * - plane_bounds 与 test_dod21 相同按 yOrigin = "top"(y 向下)解释
+     * - 每个实例先在栈上组装，再整块 memcpy，避免对 write-combined 内存的零散写
+     * - 同一字体的连续字形复用上一次的 packed，只在 font_ctx 变化时重新打包
+     * out 的容量必须不小于 glyphs.size()。
+     */
+    template <typename FontContext>
+    size_t pack_glyph_instances(
+        std::span<const harfbuzz::shape_result<FontContext>> glyphs, glyph_pen &pen,
+        std::span<glyph_instance> out) noexcept
+    {
+        MCS_ASSERT(out.size() >= glyphs.size());
+        using bounds_type = Font::Bounds;
+        const float em = pen.em_size;
+        const float inv_range = 1.0F / GLYPH_EM_RANGE;
+        const FontContext *last_font = nullptr;
+        uint32_t packed = 0;
+        size_t count = 0;
+        for (const auto &g : glyphs)
+        {
+            const float advance = static_cast<float>(g.advance_x) * em;
+            if (g.plane_bounds == bounds_type{})
+            {
+                pen.x += advance;
+                continue;
+            }
+            if (g.font_ctx != last_font)
+            {
+                last_font = g.font_ctx;
+                packed = glyph_instance::pack(last_font->bind.texture_index,
+                                              last_font->bind.sampler_index,
+                                              last_font->type, pen.flags);
+            }
+
+            const auto &plane = g.plane_bounds;
+            const auto &uv = g.uv_bounds;
+            const float top = static_cast<float>(std::min(plane.top, plane.bottom));
+            const float width = static_cast<float>(plane.right - plane.left);
+            const float height = static_cast<float>(std::abs(plane.bottom - plane.top));
+
+            glyph_instance instance; // NOLINT
+            instance.x = pen.x + (static_cast<float>(g.offset_x + plane.left) * em);
+            instance.y = pen.baseline + ((top - static_cast<float>(g.offset_y)) * em);
+            const auto q = detail::quantize_unorm16(
+                {width * inv_range, height * inv_range, static_cast<float>(uv.left),
+                 static_cast<float>(uv.top), static_cast<float>(uv.right),
+                 static_cast<float>(uv.bottom)});
+            instance.size = {q[0], q[1]};
+            instance.uv = {q[2], q[3], q[4], q[5]};
+            instance.color = pen.color;
+            instance.em_size = em;
+            instance.packed = packed;
+            std::memcpy(&out[count++], &instance, sizeof(instance));
+            pen.x += advance;
+        }
+        return count;
+    }
+}; // namespace mcs::vulkan::font
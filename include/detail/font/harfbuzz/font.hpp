@@ -1,6 +1,7 @@
 #pragma once
 #include "../__harfbuzz_import.hpp"
 #include "../../utils/make_vk_exception.hpp"
+#include "shape_plan_cache.hpp"
 
 namespace mcs::vulkan::font::harfbuzz
 {
@@ -43,6 +44,8 @@ namespace mcs::vulkan::font::harfbuzz
         {
             if (value_ != nullptr)
             {
+                // NOTE: 各线程的 plan 缓存还持有引用，让它们在下一次使用时释放
+                shape_plan_cache::invalidate_all();
                 hb_font_destroy(value_);
                 value_ = nullptr;
             }
@@ -5,9 +5,11 @@
 #include <cstdint>
 #include <print>
 #include <ranges>
+#include <span>
 #include <vector>
 
 #include "../shape_run.hpp"
+#include "../run_range.hpp"
 
 #include "../../utils/unique_handle.hpp"
 #include "../../utils/mcslog.hpp"
@@ -16,6 +18,7 @@
 
 #include "hb.h"
 #include "shape_result.hpp"
+#include "shape_plan_cache.hpp"
 
 namespace mcs::vulkan::font::harfbuzz
 {
@@ -30,8 +33,8 @@ namespace mcs::vulkan::font::harfbuzz
 
         template <typename shape_info>
         static constexpr glyph_info get_glyph_info(
-            const std::vector<uint32_t> &logical_codepoints, hb_buffer_t *buf,
-            hb_direction_t direction, const shape_info &run)
+            std::span<const uint32_t> logical_codepoints, hb_buffer_t *buf,
+            hb_direction_t direction, const shape_info &run, shape_plan_cache &plans)
         {
             // NOTE: 这里修改传递的是 logical_codepoints_with_mirror 就行，是吗？
             hb_buffer_add_utf32(buf, logical_codepoints.data() + run.logical_start,
@@ -42,7 +45,7 @@ namespace mcs::vulkan::font::harfbuzz
             hb_buffer_set_language(buf, run.language);
 
             assert(run.font != nullptr);
-            hb_shape(*run.font->hb_font, buf, nullptr, 0);
+            plans.execute(*run.font->hb_font, buf);
 
             // NOTE: 开始收集信息
             unsigned int glyph_count; // NOLINT
@@ -55,7 +58,7 @@ namespace mcs::vulkan::font::harfbuzz
             requires(requires() { typename FontContext::glyph_info_type; })
         static constexpr void add_shape_result(
             std::vector<shape_result<FontContext>> &run_result,
-            const std::vector<uint32_t> &logical_codepoints, hb_direction_t direction,
+            std::span<const uint32_t> logical_codepoints, hb_direction_t direction,
             const shape_info<FontContext> &run, const glyph_info &glyph_info)
         {
             using GlyphInfo = FontContext::glyph_info_type;
@@ -117,20 +120,21 @@ namespace mcs::vulkan::font::harfbuzz
         static constexpr void replacement_shape_result(
             std::vector<shape_result<FontContext>> &run_result, hb_buffer_t *buf,
             hb_direction_t direction, const shape_info<FontContext> &run,
-            const FontContext *font)
+            const FontContext *font, shape_plan_cache &plans)
         {
             assert(font->glyph_index_to_glyphs.contains(0));
 
             using GlyphInfo = FontContext::glyph_info_type;
 
-            std::vector<uint32_t> logical_codepoints(run.length, 0);
-            hb_buffer_add_utf32(buf, logical_codepoints.data(), run.length, 0,
-                                run.length);
+            // NOTE: 逐个添加 U+0000，避免临时 vector
+            for (int i = 0; i < run.length; ++i)
+                hb_buffer_add(buf, 0, static_cast<unsigned int>(i));
+            hb_buffer_set_content_type(buf, HB_BUFFER_CONTENT_TYPE_UNICODE);
             // If you know the direction, script, and language
             hb_buffer_set_direction(buf, direction);
             hb_buffer_set_script(buf, HB_SCRIPT_COMMON);
             hb_buffer_set_language(buf, hb_language_get_default());
-            hb_shape(*font->hb_font, buf, nullptr, 0);
+            plans.execute(*font->hb_font, buf);
 
             unsigned int glyph_count; // NOLINT
             auto *info = hb_buffer_get_glyph_infos(buf, &glyph_count);
@@ -173,13 +177,47 @@ namespace mcs::vulkan::font::harfbuzz
             }
         }
 
+        // NOTE: 同一 bidi run 内的 shape_info 依次 shape，结果追加到 out。RTL 逆序
+        template <typename FontContext>
+        static constexpr void shape_runs(std::span<const uint32_t> logical_codepoints,
+                                         hb_direction_t direction,
+                                         std::span<const shape_info<FontContext>> runs,
+                                         hb_buffer_t *buf, const FontContext *notdefFont,
+                                         shape_plan_cache &plans,
+                                         std::vector<shape_result<FontContext>> &out)
+        {
+            auto shape_one = [&](const shape_info<FontContext> &run) {
+                hb_buffer_reset(buf);
+                if (run.font == nullptr)
+                {
+                    replacement_shape_result(out, buf, direction, run, notdefFont, plans);
+                    return;
+                }
+                add_shape_result(out, logical_codepoints, direction, run,
+                                 get_glyph_info(logical_codepoints, buf, direction, run,
+                                                plans));
+            };
+            if (direction == HB_DIRECTION_LTR)
+            {
+                for (const auto &run : runs)
+                    shape_one(run);
+            }
+            else
+            {
+                for (const auto &run : runs | std::ranges::views::reverse)
+                    shape_one(run);
+            }
+        }
+
     }; // namespace detail
 
     template <typename FontContext>
         requires(requires(std::vector<shape_result<FontContext>> &run_result,
                           hb_buffer_t *buf, hb_direction_t direction,
-                          const shape_info<FontContext> &run, const FontContext *font) {
-            detail::replacement_shape_result(run_result, buf, direction, run, font);
+                          const shape_info<FontContext> &run, const FontContext *font,
+                          shape_plan_cache &plans) {
+            detail::replacement_shape_result(run_result, buf, direction, run, font,
+                                             plans);
             typename FontContext::glyph_info_type;
         })
     static constexpr auto shape(
@@ -194,51 +232,49 @@ namespace mcs::vulkan::font::harfbuzz
 
         HBBufferPtr raii_buf = HBBufferPtr{hb_buffer_create()};
         hb_buffer_t *buf = raii_buf.get();
+        shape_plan_cache plans;
 
         std::vector<std::vector<shape_result_type>> result;
         result.reserve(shape_runs.size());
 
         for (const auto &shape_run : shape_runs)
         {
-            hb_direction_t direction = shape_run.direction;
             std::vector<shape_result_type> run_result;
-            if (direction == HB_DIRECTION_LTR)
-            {
-                for (const auto &run : shape_run.runs)
-                {
-                    hb_buffer_reset(buf);
-                    if (run.font == nullptr)
-                    {
-                        detail::replacement_shape_result(run_result, buf, direction, run,
-                                                         notdefFont);
-                        continue;
-                    }
-                    detail::add_shape_result(
-                        run_result, logical_codepoints, direction, run,
-                        detail::get_glyph_info(logical_codepoints, buf, direction, run));
-                }
-            }
-            else
-            {
-                for (const auto &run : shape_run.runs | std::ranges::views::reverse)
-                {
-                    hb_buffer_reset(buf);
-                    if (run.font == nullptr)
-                    {
-                        detail::replacement_shape_result(run_result, buf, direction, run,
-                                                         notdefFont);
-                        continue;
-                    }
-                    detail::add_shape_result(
-                        run_result, logical_codepoints, direction, run,
-                        detail::get_glyph_info(logical_codepoints, buf, direction, run));
-                }
-            }
+            detail::shape_runs(std::span<const uint32_t>{logical_codepoints},
+                               shape_run.direction,
+                               std::span<const shape_info<FontContext>>{shape_run.runs},
+                               buf, notdefFont, plans, run_result);
             result.emplace_back(std::move(run_result));
         }
 
         return result;
     }
+
+    // NOTE: 扁平版本，调用方提供可复用的 buf 与 plan 缓存；glyphs/glyph_ranges 先 clear
+    template <typename FontContext>
+        requires(requires() { typename FontContext::glyph_info_type; })
+    static constexpr void shape(std::span<const uint32_t> logical_codepoints,
+                                std::span<const shape_info<FontContext>> infos,
+                                std::span<const run_range> ranges,
+                                const FontContext *notdefFont, hb_buffer_t *buf,
+                                shape_plan_cache &plans,
+                                std::vector<shape_result<FontContext>> &glyphs,
+                                std::vector<run_range> &glyph_ranges)
+    {
+        glyphs.clear();
+        glyph_ranges.clear();
+        for (const auto &range : ranges)
+        {
+            const size_t first = glyphs.size();
+            detail::shape_runs(logical_codepoints, range.direction,
+                               infos.subspan(range.first, range.count), buf, notdefFont,
+                               plans, glyphs);
+            glyph_ranges.emplace_back(run_range{.direction = range.direction,
+                                                .first = first,
+                                                .count = glyphs.size() - first});
+        }
+    }
+
     template <typename FontContext>
     static constexpr void print_shape_result(
         const std::vector<uint32_t> &logical_codepoints,
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../../utils/unique_handle.hpp"
+
+#include "hb.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mcs::vulkan::font::harfbuzz
+{
+    /**
+     * NOTE: 显式持有 hb_shape_plan_t，
+     * key = (font, 变体坐标, script, language, direction, features)。
+     * hb_shape 每次都会在 face 的 plan 链表中查找/引用计数，复杂脚本(阿拉伯、天城文)还要
+     * 编译 GSUB/GPOS lookup；这里查一次之后直接 hb_shape_plan_execute。
+     * 持有 hb_font 引用，font 在缓存 clear 之前不会被释放，地址不会被复用。
+     * 非线程安全：每个线程一份（放在 text_arena 中），plan 本身可跨线程共享执行。
+     * 字体被卸载时 erase 只能清理当前线程的缓存；invalidate_all 让所有线程的缓存
+     * 在下一次 get 时整体清空，释放对已卸载字体的引用。
+     */
+    class shape_plan_cache
+    {
+        using hb_font_ref =
+            unique_handle<hb_font_t *, [](hb_font_t *value) noexcept {
+                hb_font_destroy(value);
+            }>;
+        using hb_plan_ref =
+            unique_handle<hb_shape_plan_t *, [](hb_shape_plan_t *value) noexcept {
+                hb_shape_plan_destroy(value);
+            }>;
+        struct entry
+        {
+            hb_font_ref font;
+            hb_segment_properties_t props;
+            std::vector<hb_feature_t> features;
+            std::vector<int> coords; // 归一化变体坐标，同一 hb_font 可以被改变
+            hb_plan_ref plan;
+        };
+
+        static std::atomic<uint64_t> &generation() noexcept
+        {
+            static std::atomic<uint64_t> value{0};
+            return value;
+        }
+
+        static constexpr bool same_features(std::span<const hb_feature_t> a,
+                                            std::span<const hb_feature_t> b) noexcept
+        {
+            return std::ranges::equal(a, b, [](const hb_feature_t &x,
+                                               const hb_feature_t &y) noexcept {
+                return x.tag == y.tag && x.value == y.value && x.start == y.start &&
+                       x.end == y.end;
+            });
+        }
+
+      public:
+        // NOTE: 超过上限直接清空，字体集合变化频繁时避免无限增长
+        static constexpr size_t MAX_ENTRIES = 256;
+
+        [[nodiscard]] hb_shape_plan_t *get(hb_font_t *font,
+                                           const hb_segment_properties_t &props,
+                                           std::span<const hb_feature_t> features = {})
+        {
+            if (const uint64_t now = generation().load(std::memory_order_acquire);
+                now != generation_)
+            {
+                entries_.clear();
+                generation_ = now;
+            }
+            unsigned int num_coords = 0;
+            const int *coords = hb_font_get_var_coords_normalized(font, &num_coords);
+            const std::span<const int> coord_span{coords, num_coords};
+            for (const auto &e : entries_)
+            {
+                if (*e.font == font && hb_segment_properties_equal(&e.props, &props) &&
+                    same_features(e.features, features) &&
+                    std::ranges::equal(e.coords, coord_span))
+                {
+                    ++hits_;
+                    return *e.plan;
+                }
+            }
+            ++misses_;
+            if (entries_.size() >= MAX_ENTRIES)
+                entries_.clear();
+
+            auto *plan = hb_shape_plan_create_cached2(
+                hb_font_get_face(font), &props, features.data(),
+                static_cast<unsigned int>(features.size()), coords, num_coords, nullptr);
+            entries_.emplace_back(entry{.font = hb_font_ref{hb_font_reference(font)},
+                                        .props = props,
+                                        .features = {features.begin(), features.end()},
+                                        .coords = {coord_span.begin(), coord_span.end()},
+                                        .plan = hb_plan_ref{plan}});
+            return plan;
+        }
+
+        /**
+         * @brief 以 buf 当前的 segment properties 取 plan 并执行，等价于 hb_shape_full
+         */
+        bool execute(hb_font_t *font, hb_buffer_t *buf,
+                     std::span<const hb_feature_t> features = {})
+        {
+            hb_segment_properties_t props;
+            hb_buffer_get_segment_properties(buf, &props);
+            return hb_shape_plan_execute(get(font, props, features), font, buf,
+                                         features.data(),
+                                         static_cast<unsigned int>(features.size())) != 0;
+        }
+
+        void clear() noexcept
+        {
+            entries_.clear();
+        }
+        // NOTE: 丢弃当前线程中 font 的所有 plan 并释放对它的引用
+        void erase(hb_font_t *font) noexcept
+        {
+            std::erase_if(entries_, [font](const entry &e) { return *e.font == font; });
+        }
+        // NOTE: 字体卸载时调用：各线程的缓存在下一次 get 时清空
+        static void invalidate_all() noexcept
+        {
+            generation().fetch_add(1, std::memory_order_release);
+        }
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return entries_.size();
+        }
+        [[nodiscard]] size_t hits() const noexcept
+        {
+            return hits_;
+        }
+        [[nodiscard]] size_t misses() const noexcept
+        {
+            return misses_;
+        }
+
+      private:
+        std::vector<entry> entries_;
+        uint64_t generation_{generation().load(std::memory_order_acquire)};
+        size_t hits_{0};
+        size_t misses_{0};
+    };
+}; // namespace mcs::vulkan::font::harfbuzz
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../__icu_import.hpp"
+#include "../__libunibreak.hpp"
+#include "../line_break_backend.hpp"
+#include "../../utils/make_vk_exception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::font::icu
+{
+    /**
+     * NOTE: ICU 后端，输出与 libunibreak::line_breaker 相同的 LINEBREAK_* 序列。
+     * - BreakIterator 按语言缓存，跨调用复用（创建一次要加载规则数据，代价远大于断行本身）
+     * - UTF-16 缓冲区复用容量，通过 UText 交给 ICU，不构造 UnicodeString
+     * - 强制换行取自规则状态 UBRK_LINE_HARD，而不是比较换行字符
+     * 不是线程安全的，每个线程一份（随 text_arena）。
+     */
+    class line_breaker
+    {
+      public:
+        using iterator_ptr = std::unique_ptr<::icu::BreakIterator>;
+
+        std::span<const char> operator()(std::span<const uint32_t> codepoints,
+                                         std::string_view langBcp47,
+                                         std::vector<char> &types)
+        {
+            types.assign(codepoints.size(), LINEBREAK_NOBREAK);
+            if (codepoints.empty())
+                return types;
+
+            utf16_.clear();
+            for (uint32_t cp : codepoints)
+            {
+                if (cp > 0xFFFF) // NOLINT
+                {
+                    utf16_.push_back(U16_LEAD(cp));
+                    utf16_.push_back(U16_TRAIL(cp));
+                }
+                else
+                    utf16_.push_back(static_cast<UChar>(cp));
+            }
+
+            UErrorCode status = U_ZERO_ERROR;
+            UText text = UTEXT_INITIALIZER;
+            utext_openUChars(&text, utf16_.data(), static_cast<int64_t>(utf16_.size()),
+                             &status);
+            ::icu::BreakIterator &iterator = get(langBcp47);
+            iterator.setText(&text, status);
+            utext_close(&text); // NOTE: iterator 持有浅拷贝，utf16_ 在下次调用前保持有效
+            if (U_FAILURE(status))
+                throw make_vk_exception("icu BreakIterator::setText failed");
+
+            // NOTE: 边界单调递增，顺序推进 UTF-16 偏移即可换算为码点下标
+            size_t index = 0;
+            int32_t offset = 0;
+            iterator.first();
+            for (int32_t pos = iterator.next(); pos != ::icu::BreakIterator::DONE;
+                 pos = iterator.next())
+            {
+                while (offset < pos)
+                    offset += codepoints[index++] > 0xFFFF ? 2 : 1; // NOLINT
+                const int32_t rule = iterator.getRuleStatus();
+                types[index - 1] = rule >= UBRK_LINE_HARD && rule < UBRK_LINE_HARD_LIMIT
+                                       ? LINEBREAK_MUSTBREAK
+                                       : LINEBREAK_ALLOWBREAK;
+            }
+            // NOTE: 与 libunibreak 一致，文本末尾总是强制换行(LB3)
+            types.back() = LINEBREAK_MUSTBREAK;
+            return types;
+        }
+
+        [[nodiscard]] size_t cached_iterators() const noexcept
+        {
+            return iterators_.size();
+        }
+
+      private:
+        std::vector<UChar> utf16_;
+        // NOTE: 一个应用通常只有几种语言，线性查找即可，先试上次命中的 last_
+        std::vector<std::pair<std::string, iterator_ptr>> iterators_;
+        size_t last_{0};
+
+        ::icu::BreakIterator &get(std::string_view langBcp47)
+        {
+            if (last_ < iterators_.size() && iterators_[last_].first == langBcp47)
+                return *iterators_[last_].second;
+            for (size_t i = 0; i < iterators_.size(); ++i)
+            {
+                if (iterators_[i].first == langBcp47)
+                {
+                    last_ = i;
+                    return *iterators_[i].second;
+                }
+            }
+
+            UErrorCode status = U_ZERO_ERROR;
+            ::icu::Locale locale =
+                langBcp47.empty()
+                    ? ::icu::Locale::getRoot()
+                    : ::icu::Locale::forLanguageTag(
+                          {langBcp47.data(), static_cast<int32_t>(langBcp47.size())},
+                          status);
+            if (U_FAILURE(status))
+            {
+                status = U_ZERO_ERROR;
+                locale = ::icu::Locale::getRoot();
+            }
+            iterator_ptr iterator{
+                ::icu::BreakIterator::createLineInstance(locale, status)};
+            if (U_FAILURE(status) || iterator == nullptr)
+                throw make_vk_exception("icu BreakIterator::createLineInstance failed");
+            last_ = iterators_.size();
+            iterators_.emplace_back(std::string{langBcp47}, std::move(iterator));
+            return *iterators_.back().second;
+        }
+    };
+
+    static_assert(line_break_backend<line_breaker>);
+}; // namespace mcs::vulkan::font::icu
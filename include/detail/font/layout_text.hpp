@@ -0,0 +1,34 @@
+#pragma once
+
+#include "text_arena.hpp"
+#include "assign_fonts.hpp"
+#include "utf8proc/normalize.hpp"
+#include "bidi/analyze.hpp"
+#include "harfbuzz/shape.hpp"
+
+#include <span>
+#include <string_view>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: normalize -> bidi -> assign_fonts -> line breaks -> shape，结果全部写入 arena。
+     * 各阶段之间只传 span，不产生中间 vector。
+     */
+    template <typename FontSelector, typename LineBreaker>
+    constexpr static void layout_text(
+        text_arena<typename FontSelector::font_context_type, LineBreaker> &arena,
+        std::string_view text, int base_level, FontSelector &selector)
+    {
+        using FontContext = FontSelector::font_context_type;
+        std::span<const uint32_t> codepoints =
+            utf8proc::normalize(text, arena.codepoints);
+        bidi::analyze(codepoints, base_level, arena.visual, arena.locator.get());
+        assign_fonts(codepoints, arena.visual, selector, arena.shape_infos,
+                     arena.shape_ranges);
+        arena.breaker(codepoints, selector.langBcp47(), arena.breaks);
+        harfbuzz::shape<FontContext>(codepoints, arena.shape_infos, arena.shape_ranges,
+                                     selector.notdefFont(), arena.buffer.get(),
+                                     arena.plans, arena.glyphs, arena.glyph_ranges);
+    }
+}; // namespace mcs::vulkan::font
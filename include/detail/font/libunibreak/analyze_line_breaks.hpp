@@ -3,6 +3,7 @@
 #include "break_result.hpp"
 #include <cstdint>
 #include <print>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -10,6 +11,19 @@
 
 namespace mcs::vulkan::font::libunibreak
 {
+    // NOTE: 写入调用方持有的 types（复用容量）
+    constexpr static std::span<const char> analyze_line_breaks(
+        std::span<const uint32_t> codepoints, std::string_view langBcp47,
+        std::vector<char> &types)
+    {
+        types.resize(codepoints.size());
+        if (codepoints.empty())
+            return types;
+        set_linebreaks_utf32(codepoints.data(), codepoints.size(),
+                             langBcp47.empty() ? "" : langBcp47.data(), types.data());
+        return types;
+    }
+
     constexpr static break_result analyze_line_breaks(
         const std::vector<uint32_t> &codepoints, std::string_view langBcp47)
     {
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "analyze_line_breaks.hpp"
+#include "../line_break_backend.hpp"
+
+namespace mcs::vulkan::font::libunibreak
+{
+    // NOTE: 默认后端，无状态
+    struct line_breaker
+    {
+        constexpr std::span<const char> operator()(std::span<const uint32_t> codepoints,
+                                                   std::string_view langBcp47,
+                                                   std::vector<char> &types) const
+        {
+            return analyze_line_breaks(codepoints, langBcp47, types);
+        }
+    };
+
+    static_assert(line_break_backend<line_breaker>);
+}; // namespace mcs::vulkan::font::libunibreak
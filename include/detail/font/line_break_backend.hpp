@@ -0,0 +1,25 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 断行后端。对每个 codepoint 写入其后的断行类型(LINEBREAK_*，与 libunibreak 一致)，
+     * 末尾字符固定为 LINEBREAK_MUSTBREAK。写入调用方持有的 types（复用容量）。
+     * 后端对象可以持有可复用的状态，随 text_arena 按线程保存，不要求线程安全。
+     */
+    template <typename T>
+    concept line_break_backend =
+        std::default_initializable<T> &&
+        requires(T &backend, std::span<const uint32_t> codepoints,
+                 std::string_view langBcp47, std::vector<char> &types) {
+            {
+                backend(codepoints, langBcp47, types)
+            } -> std::same_as<std::span<const char>>;
+        };
+}; // namespace mcs::vulkan::font
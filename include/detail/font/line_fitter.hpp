@@ -0,0 +1,322 @@
+#pragma once
+
+#include "text_layout.hpp"
+#include "__libunibreak.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace mcs::vulkan::font
+{
+    // NOTE: 一行 = 逻辑顺序的 codepoint 区间 [first, first + count)
+    struct line_box // NOLINTBEGIN
+    {
+        size_t first;
+        size_t count;
+        double width; // 不含行尾空白，单位与 shape_result::advance_x 相同(em)
+        bool hard;    // 以强制换行(LINEBREAK_MUSTBREAK)结束
+    }; // NOLINTEND
+
+    /**
+     * NOTE: 段落断行。build() 一次性把 libunibreak 断点与 shape 结果的 advance 前缀和
+     * 建立好，之后 wrap() 换任意行宽都不需要重新 shape。
+     * - greedy: O(n)，逐个断点向前推进
+     * - optimal: 最小化非末行的 (max_width - width)^2，按强制换行分块做 DP
+     * reorder() 对单行做 UAX #9 L2 重排，输出该行按视觉顺序排列的 glyph 区间。
+     * 断点只落在 cluster 边界上；行尾空白悬挂，不计入宽度。
+     * 不处理 unsafe_to_break：行首/行尾的字形沿用整段 shape 的结果。
+     */
+    class line_fitter
+    {
+      public:
+        enum class mode : uint8_t
+        {
+            greedy,
+            optimal
+        };
+
+        template <typename FontContext>
+        constexpr void build(const text_layout<FontContext> &layout)
+        {
+            const size_t n = layout.codepoints.size();
+            advance_.assign(n + 1, 0.0);
+            flags_.assign(n, 0);
+            for (const auto &glyph : layout.glyphs)
+            {
+                advance_[glyph.logical_idx + 1] += glyph.advance_x;
+                flags_[glyph.logical_idx] |= CLUSTER_START;
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                advance_[i + 1] += advance_[i];
+                if (isHanging(layout.codepoints[i]))
+                    flags_[i] |= HANG;
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                // NOTE: 断在 i 之后，要求 i + 1 是 cluster 起点
+                const bool boundary = i + 1 == n || (flags_[i + 1] & CLUSTER_START) != 0;
+                const char type = i < layout.breaks.size() ? layout.breaks[i]
+                                                           : LINEBREAK_NOBREAK;
+                if (type == LINEBREAK_MUSTBREAK || i + 1 == n)
+                    flags_[i] |= MUST_BREAK;
+                else if (type == LINEBREAK_ALLOWBREAK && boundary)
+                    flags_[i] |= ALLOW_BREAK;
+            }
+
+            // NOTE: 逻辑顺序的 run 下标，reorder 时二分查找
+            logicalRuns_.resize(layout.visual.runs.size());
+            for (size_t i = 0; i < logicalRuns_.size(); ++i)
+                logicalRuns_[i] = i;
+            std::ranges::sort(logicalRuns_, {}, [&](size_t index) {
+                return layout.visual.runs[index].offset;
+            });
+        }
+
+        constexpr std::span<const line_box> wrap(double max_width,
+                                                 mode fit = mode::greedy)
+        {
+            lines_.clear();
+            if (fit == mode::greedy)
+                wrapGreedy(max_width);
+            else
+                wrapOptimal(max_width);
+            return lines_;
+        }
+
+        [[nodiscard]] constexpr std::span<const line_box> lines() const noexcept
+        {
+            return lines_;
+        }
+
+        // NOTE: [first, last) 的宽度，不含行尾悬挂空白
+        [[nodiscard]] constexpr double width(size_t first, size_t last) const noexcept
+        {
+            while (last > first && (flags_[last - 1] & HANG) != 0)
+                --last;
+            return advance_[last] - advance_[first];
+        }
+
+        /**
+         * @brief 单行的视觉顺序：与该行相交的 bidi run 按 L2 规则重排，
+         * out 中每项是 layout.glyphs 的一段，direction 为该 run 的方向
+         */
+        template <typename FontContext>
+        constexpr void reorder(const text_layout<FontContext> &layout,
+                               const line_box &line, std::vector<run_range> &out)
+        {
+            out.clear();
+            lineRuns_.clear();
+            const size_t first = line.first;
+            const size_t last = line.first + line.count;
+            const auto &runs = layout.visual.runs;
+            auto it = std::ranges::partition_point(logicalRuns_, [&](size_t index) {
+                return runs[index].offset + runs[index].length <= first;
+            });
+            for (; it != logicalRuns_.end() && runs[*it].offset < last; ++it)
+            {
+                auto glyphs = clipGlyphs(layout, *it, first, last);
+                if (glyphs.count != 0)
+                    lineRuns_.emplace_back(line_run{.glyphs = glyphs,
+                                                    .level = runs[*it].level});
+            }
+
+            // UAX #9 L2: 从最高层级到最低奇数层级，逐层反转连续的 >= level 的序列
+            uint8_t highest = 0;
+            uint8_t lowest_odd = std::numeric_limits<uint8_t>::max();
+            for (const auto &run : lineRuns_)
+            {
+                highest = std::max(highest, run.level);
+                if ((run.level % 2) != 0)
+                    lowest_odd = std::min(lowest_odd, run.level);
+            }
+            for (uint8_t level = highest; level >= lowest_odd && level > 0; --level)
+            {
+                for (auto begin = lineRuns_.begin(); begin != lineRuns_.end();)
+                {
+                    if (begin->level < level)
+                    {
+                        ++begin;
+                        continue;
+                    }
+                    auto end = std::find_if(
+                        begin, lineRuns_.end(),
+                        [&](const line_run &r) { return r.level < level; });
+                    std::reverse(begin, end);
+                    begin = end;
+                }
+            }
+            for (const auto &run : lineRuns_)
+                out.emplace_back(run.glyphs);
+        }
+
+      private:
+        static constexpr uint8_t CLUSTER_START = 1U << 0U;
+        static constexpr uint8_t ALLOW_BREAK = 1U << 1U;
+        static constexpr uint8_t MUST_BREAK = 1U << 2U;
+        static constexpr uint8_t HANG = 1U << 3U;
+        static constexpr double OVERFLOW_PENALTY = 1e6;
+
+        struct line_run
+        {
+            run_range glyphs;
+            uint8_t level;
+        };
+
+        std::vector<double> advance_; // 前缀和，advance_[i] = [0, i) 的宽度
+        std::vector<uint8_t> flags_;
+        std::vector<size_t> logicalRuns_;
+        std::vector<line_box> lines_;
+        // optimal 与 reorder 的临时空间，复用容量
+        std::vector<size_t> candidates_;
+        std::vector<double> cost_;
+        std::vector<size_t> prev_;
+        std::vector<line_run> lineRuns_;
+
+        // NOTE: 行尾悬挂的空白与段落分隔符
+        [[nodiscard]] static constexpr bool isHanging(uint32_t cp) noexcept
+        {
+            switch (cp)
+            {
+            case 0x09: // NOLINTBEGIN
+            case 0x0A:
+            case 0x0B:
+            case 0x0C:
+            case 0x0D:
+            case 0x20:
+            case 0x85:
+            case 0x1680:
+            case 0x2028:
+            case 0x2029:
+            case 0x205F:
+            case 0x3000: // NOLINTEND
+                return true;
+            default:
+                return (cp >= 0x2000 && cp <= 0x200A && cp != 0x2007); // NOLINT
+            }
+        }
+
+        constexpr void push(size_t first, size_t last, bool hard)
+        {
+            lines_.emplace_back(line_box{.first = first,
+                                         .count = last - first,
+                                         .width = width(first, last),
+                                         .hard = hard});
+        }
+
+        constexpr void wrapGreedy(double max_width)
+        {
+            const size_t n = flags_.size();
+            size_t start = 0;
+            size_t last = 0; // 0 表示当前行还没有断点
+            for (size_t i = 0; i < n; ++i)
+            {
+                const uint8_t f = flags_[i];
+                if ((f & (ALLOW_BREAK | MUST_BREAK)) == 0)
+                    continue;
+                const size_t end = i + 1;
+                if (last != 0 && width(start, end) > max_width)
+                {
+                    push(start, last, false);
+                    start = last;
+                }
+                if ((f & MUST_BREAK) != 0)
+                {
+                    push(start, end, true);
+                    start = end;
+                    last = 0;
+                    continue;
+                }
+                last = end;
+            }
+            if (start < n)
+                push(start, n, false);
+        }
+
+        // NOTE: 强制换行之间 [first, last) 的最小不齐度断行
+        constexpr void wrapBlock(size_t first, size_t last, double max_width,
+                                 bool hard)
+        {
+            candidates_.clear();
+            candidates_.emplace_back(first);
+            for (size_t i = first; i + 1 < last; ++i)
+                if ((flags_[i] & ALLOW_BREAK) != 0)
+                    candidates_.emplace_back(i + 1);
+            candidates_.emplace_back(last);
+
+            const size_t m = candidates_.size();
+            cost_.assign(m, std::numeric_limits<double>::infinity());
+            prev_.assign(m, 0);
+            cost_[0] = 0.0;
+            for (size_t j = 1; j < m; ++j)
+            {
+                for (size_t i = j; i-- > 0;)
+                {
+                    const double w = width(candidates_[i], candidates_[j]);
+                    // NOTE: 超宽时仍允许单个不可断的片段独占一行，按超出量重罚
+                    if (w > max_width && i + 1 != j)
+                        break;
+                    const double slack = max_width - w;
+                    double badness = (j + 1 == m) ? 0.0 : slack * slack;
+                    if (w > max_width)
+                        badness = OVERFLOW_PENALTY * (w - max_width);
+                    const double total = cost_[i] + badness;
+                    if (total < cost_[j])
+                    {
+                        cost_[j] = total;
+                        prev_[j] = i;
+                    }
+                }
+            }
+
+            // 回溯，结果逆序写入后再翻转
+            const size_t begin = lines_.size();
+            for (size_t j = m - 1; j > 0; j = prev_[j])
+                push(candidates_[prev_[j]], candidates_[j], hard && j + 1 == m);
+            std::reverse(lines_.begin() + static_cast<std::ptrdiff_t>(begin),
+                         lines_.end());
+        }
+
+        constexpr void wrapOptimal(double max_width)
+        {
+            const size_t n = flags_.size();
+            size_t start = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                if ((flags_[i] & MUST_BREAK) == 0)
+                    continue;
+                wrapBlock(start, i + 1, max_width, true);
+                start = i + 1;
+            }
+            if (start < n)
+                wrapBlock(start, n, max_width, false);
+        }
+
+        // NOTE: run 内的 glyph 按 logical_idx 单调(LTR 递增，RTL 递减)，二分截取
+        template <typename FontContext>
+        [[nodiscard]] static constexpr run_range clipGlyphs(
+            const text_layout<FontContext> &layout, size_t run, size_t first,
+            size_t last) noexcept
+        {
+            const run_range &range = layout.glyph_ranges[run];
+            auto glyphs = layout.glyphs_of(range);
+            const bool rtl = range.direction == HB_DIRECTION_RTL;
+            auto before = [&](const auto &g) {
+                return rtl ? g.logical_idx >= last : g.logical_idx < first;
+            };
+            auto inside = [&](const auto &g) {
+                return rtl ? g.logical_idx >= first : g.logical_idx < last;
+            };
+            auto begin = std::partition_point(glyphs.begin(), glyphs.end(), before);
+            auto end = std::partition_point(begin, glyphs.end(), inside);
+            return run_range{
+                .direction = range.direction,
+                .first = range.first + static_cast<size_t>(begin - glyphs.begin()),
+                .count = static_cast<size_t>(end - begin)};
+        }
+    };
+}; // namespace mcs::vulkan::font
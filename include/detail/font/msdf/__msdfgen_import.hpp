@@ -0,0 +1,4 @@
+#pragma once
+
+#include <msdfgen.h>
+#include <msdfgen-ext.h>
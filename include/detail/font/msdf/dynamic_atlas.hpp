@@ -0,0 +1,331 @@
+#pragma once
+
+#include "generate_glyph.hpp"
+#include "shelf_packer.hpp"
+
+#include "../Font.hpp"
+#include "../../utils/thread_pool.hpp"
+#include "../../utils/mcs_assert.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::font::msdf
+{
+    struct dynamic_atlas_config // NOLINTBEGIN
+    {
+        int page_size = 1024;         // 页宽高(像素)
+        size_t max_pages = 4;         // 超出后按 LRU 淘汰
+        double glyph_size = 32.0;     // 每 em 的像素数
+        double px_range = 4.0;        // 距离场范围(像素)
+        double angle_threshold = 3.0; // edgeColoringSimple
+        int padding = 1;
+    }; // NOLINTEND
+
+    // NOTE: 与 GlyphInfo 相同的约定：uv 以左上角为原点，plane_bounds 单位为 em
+    struct dynamic_glyph // NOLINTBEGIN
+    {
+        uint32_t page;
+        Font::Bounds uv_bounds;
+        Font::Bounds plane_bounds;
+        double advance;
+    }; // NOLINTEND
+
+    /**
+     * NOTE: 运行时按需生成的 MSDF 图集(CPU 侧)。
+     * - find(): 已就绪返回字形，否则在调用线程取出轮廓(FT_Face 不是线程安全的)，
+     *   交给线程池 generateMSDF，返回 nullptr，调用方本帧跳过或用 notdef 代替
+     * - flush(): 每帧调用一次，收集已完成的结果，shelf 打包进 RGBA8 页并记录脏矩形
+     * - 页满时新建页(不超过 max_pages)，否则淘汰最久未用、且本帧未使用的字形
+     * GPU 上传见 dynamic_atlas_texture，只拷贝脏矩形。
+     */
+    class dynamic_atlas
+    {
+      public:
+        struct page // NOLINTBEGIN
+        {
+            shelf_packer packer;
+            std::vector<uint8_t> pixels; // RGBA8，行优先，左上角为原点
+            std::vector<atlas_rect> dirty;
+        }; // NOLINTEND
+
+        // NOTE: dirty 区域紧密排列在 staging 中的位置
+        struct dirty_region // NOLINTBEGIN
+        {
+            uint32_t page;
+            atlas_rect rect;
+            size_t offset;
+        }; // NOLINTEND
+
+        struct stats // NOLINTBEGIN
+        {
+            size_t requests; // 触发生成的 find
+            size_t hits;
+            size_t evictions;
+            double generate_ms; // 工作线程累计耗时
+        }; // NOLINTEND
+
+        dynamic_atlas(thread_pool &pool, dynamic_atlas_config config = {}) noexcept
+            : pool_{&pool}, config_{config}
+        {
+        }
+
+        // NOTE: 字体由调用方持有，生命周期需长于图集
+        uint32_t addFont(msdfgen::FontHandle *font)
+        {
+            fonts_.emplace_back(font);
+            return static_cast<uint32_t>(fonts_.size() - 1);
+        }
+
+        // NOTE: 开始新的一帧；本帧 find 到的字形不会在本帧被淘汰
+        void beginFrame() noexcept
+        {
+            ++frame_;
+        }
+
+        // NOTE: 返回的指针在下一次 flush 前有效
+        const dynamic_glyph *find(uint32_t font, uint32_t glyph_index)
+        {
+            const uint64_t key = (static_cast<uint64_t>(font) << 32U) | glyph_index;
+            if (auto it = entries_.find(key); it != entries_.end())
+            {
+                auto &e = it->second;
+                e.frame = frame_;
+                if (e.rect.w != 0)
+                    lru_.splice(lru_.begin(), lru_, e.lru);
+                ++stats_.hits;
+                return &e.glyph;
+            }
+            // NOTE: 已生成但页满未放入的(waiting_)也不再重复请求
+            if (!pending_.contains(key) && !waiting_.contains(key))
+            {
+                ++stats_.requests;
+                pending_.emplace(key, request(fonts_[font], glyph_index));
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief 收集已完成的字形并写入页，返回新加入的字形数
+         * @param wait 为 true 时阻塞直到全部请求完成(预热 / 测试)
+         */
+        size_t flush(bool wait = false)
+        {
+            size_t added = 0;
+            for (auto it = pending_.begin(); it != pending_.end();)
+            {
+                if (!wait && it->second.wait_for(std::chrono::seconds{0}) !=
+                                 std::future_status::ready)
+                {
+                    ++it;
+                    continue;
+                }
+                waiting_.emplace(it->first, it->second.get());
+                it = pending_.erase(it);
+            }
+            // NOTE: 放不下的(本帧字形占满所有页)留到下一次
+            std::erase_if(waiting_, [&](auto &item) {
+                if (!insert(item.first, item.second))
+                    return false;
+                ++added;
+                return true;
+            });
+            return added;
+        }
+
+        // NOTE: 所有页的脏矩形紧密写入 staging，返回每个矩形的位置并清空脏标记
+        void takeDirty(std::vector<uint8_t> &staging, std::vector<dirty_region> &regions)
+        {
+            staging.clear();
+            regions.clear();
+            for (uint32_t p = 0; p < pages_.size(); ++p)
+            {
+                auto &pg = pages_[p];
+                for (const auto &rect : pg.dirty)
+                {
+                    regions.emplace_back(
+                        dirty_region{.page = p, .rect = rect, .offset = staging.size()});
+                    for (int y = rect.y; y < rect.y + rect.h; ++y)
+                    {
+                        const auto *row = pg.pixels.data() + pixelOffset(rect.x, y);
+                        staging.insert(staging.end(), row,
+                                       row + (static_cast<size_t>(rect.w) * CHANNELS));
+                    }
+                }
+                pg.dirty.clear();
+            }
+        }
+
+        [[nodiscard]] std::span<const page> pages() const noexcept
+        {
+            return pages_;
+        }
+        [[nodiscard]] const dynamic_atlas_config &config() const noexcept
+        {
+            return config_;
+        }
+        [[nodiscard]] size_t glyphCount() const noexcept
+        {
+            return entries_.size();
+        }
+        [[nodiscard]] size_t pendingCount() const noexcept
+        {
+            return pending_.size() + waiting_.size();
+        }
+        [[nodiscard]] size_t textureBytes() const noexcept
+        {
+            return pages_.size() * pageBytes();
+        }
+        [[nodiscard]] const stats &statistics() const noexcept
+        {
+            return stats_;
+        }
+
+      private:
+        static constexpr size_t CHANNELS = GLYPH_CHANNELS;
+
+        struct bitmap
+        {
+            glyph_bitmap glyph;
+            double ms{0.0};
+        };
+        struct entry
+        {
+            dynamic_glyph glyph;
+            atlas_rect rect; // w == 0 表示空白字形，不占页面
+            uint64_t frame;
+            std::list<uint64_t>::iterator lru;
+        };
+
+        thread_pool *pool_;
+        dynamic_atlas_config config_;
+        std::vector<msdfgen::FontHandle *> fonts_;
+        std::vector<page> pages_;
+        std::unordered_map<uint64_t, entry> entries_;
+        std::unordered_map<uint64_t, std::future<bitmap>> pending_;
+        std::unordered_map<uint64_t, bitmap> waiting_;
+        std::list<uint64_t> lru_; // 头部最近使用
+        uint64_t frame_{0};
+        stats stats_{};
+
+        [[nodiscard]] size_t pageBytes() const noexcept
+        {
+            const auto size = static_cast<size_t>(config_.page_size);
+            return size * size * CHANNELS;
+        }
+        [[nodiscard]] size_t pixelOffset(int x, int y) const noexcept
+        {
+            return ((static_cast<size_t>(y) * static_cast<size_t>(config_.page_size)) +
+                    static_cast<size_t>(x)) *
+                   CHANNELS;
+        }
+
+        std::future<bitmap> request(msdfgen::FontHandle *font, uint32_t glyph_index)
+        {
+            double advance = 0.0;
+            auto shape = load_glyph_shape(font, glyph_index, advance);
+            const glyph_params params{.glyph_size = config_.glyph_size,
+                                      .px_range = config_.px_range,
+                                      .angle_threshold = config_.angle_threshold};
+            return pool_->submit([shape = std::move(shape), advance, params]() mutable {
+                const auto start = std::chrono::steady_clock::now();
+                bitmap out{.glyph = generate_glyph(shape, advance, params)};
+                out.ms = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+                return out;
+            });
+        }
+
+        bool insert(uint64_t key, const bitmap &result)
+        {
+            // NOTE: 每个键只有一个条目，重复的结果直接丢弃，不占页面也不进 LRU
+            if (entries_.contains(key))
+                return true;
+            stats_.generate_ms += result.ms;
+            const auto &bmp = result.glyph;
+            const auto &plane = bmp.plane_bounds;
+            entry e{.glyph = {.page = 0,
+                              .uv_bounds = {.left = 0, .bottom = 0, .right = 0, .top = 0},
+                              .plane_bounds = {.left = plane.left,
+                                               .bottom = plane.bottom,
+                                               .right = plane.right,
+                                               .top = plane.top},
+                              .advance = bmp.advance},
+                    .rect = {},
+                    .frame = frame_,
+                    .lru = lru_.end()};
+            if (bmp.width == 0)
+            {
+                entries_.emplace(key, e);
+                return true;
+            }
+            auto placed = allocate(bmp.width, bmp.height);
+            if (!placed)
+                return false;
+            const auto [index, rect] = *placed;
+            auto &pg = pages_[index];
+            for (int y = 0; y < rect.h; ++y)
+                std::ranges::copy_n(
+                    bmp.rgba.data() + (static_cast<size_t>(y) * rect.w * CHANNELS),
+                    static_cast<std::ptrdiff_t>(rect.w * CHANNELS),
+                    pg.pixels.data() + pixelOffset(rect.x, rect.y + y));
+            pg.dirty.emplace_back(rect);
+
+            const double size = config_.page_size;
+            e.glyph.page = index;
+            e.glyph.uv_bounds = {.left = (rect.x + 0.5) / size,
+                                 .bottom = (rect.y + rect.h - 0.5) / size,
+                                 .right = (rect.x + rect.w - 0.5) / size,
+                                 .top = (rect.y + 0.5) / size};
+            e.rect = rect;
+            lru_.push_front(key);
+            e.lru = lru_.begin();
+            entries_.emplace(key, e);
+            return true;
+        }
+
+        // NOTE: 现有页 -> 新页 -> 淘汰 LRU 后重试
+        std::optional<std::pair<uint32_t, atlas_rect>> allocate(int w, int h)
+        {
+            for (uint32_t p = 0; p < pages_.size(); ++p)
+                if (auto rect = pages_[p].packer.alloc(w, h))
+                    return std::pair{p, *rect};
+            if (pages_.size() < config_.max_pages)
+            {
+                auto &pg = pages_.emplace_back(
+                    page{.packer = {config_.page_size, config_.page_size,
+                                    config_.padding},
+                         .pixels = std::vector<uint8_t>(pageBytes(), 0),
+                         .dirty = {}});
+                if (auto rect = pg.packer.alloc(w, h))
+                    return std::pair{static_cast<uint32_t>(pages_.size() - 1), *rect};
+                return std::nullopt;
+            }
+            while (!lru_.empty())
+            {
+                auto it = entries_.find(lru_.back());
+                MCS_ASSERT(it != entries_.end());
+                if (it->second.frame == frame_)
+                    break; // 其余都是本帧使用的
+                const uint32_t p = it->second.glyph.page;
+                pages_[p].packer.free(it->second.rect);
+                lru_.pop_back();
+                entries_.erase(it);
+                ++stats_.evictions;
+                if (auto rect = pages_[p].packer.alloc(w, h))
+                    return std::pair{p, *rect};
+            }
+            return std::nullopt;
+        }
+    };
+}; // namespace mcs::vulkan::font::msdf
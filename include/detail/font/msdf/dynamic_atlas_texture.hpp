@@ -0,0 +1,163 @@
+#pragma once
+
+#include "dynamic_atlas.hpp"
+
+#include "../FontAllocationContext.hpp"
+#include "../../vma/create_texture_image.hpp"
+#include "../../vma/create_image.hpp"
+#include "../../vma/staging_buffer.hpp"
+#include "../../tool/sType.hpp"
+
+#include <vector>
+
+namespace mcs::vulkan::font::msdf
+{
+    /**
+     * NOTE: dynamic_atlas 的 GPU 侧，每页一张 RGBA8 纹理。
+     * 新页整页上传；已有页只拷贝脏矩形，所有区域合并到一个 staging buffer、一次提交。
+     */
+    class dynamic_atlas_texture
+    {
+        using resource = vma::resource;
+        using create_image = vma::create_image;
+        using create_texture_image = vma::create_texture_image;
+
+      public:
+        explicit dynamic_atlas_texture(FontAllocationContext allocation) noexcept
+            : allocation_{allocation}
+        {
+        }
+
+        // NOTE: 在 atlas.flush() 之后、录制绘制命令之前调用；返回本次上传的字节数
+        size_t upload(dynamic_atlas &atlas)
+        {
+            atlas.takeDirty(staging_, regions_);
+            const auto pages = atlas.pages();
+            const size_t uploaded = textures_.size();
+            size_t bytes = 0;
+            for (size_t p = uploaded; p < pages.size(); ++p)
+            {
+                textures_.emplace_back(makePage(atlas.config().page_size)
+                                           .build(std::span<const uint8_t>{
+                                               pages[p].pixels.data(),
+                                               pages[p].pixels.size()}));
+                bytes += pages[p].pixels.size();
+            }
+            // NOTE: 新页已经整页上传
+            std::erase_if(regions_, [&](const auto &r) { return r.page >= uploaded; });
+            if (regions_.empty())
+                return bytes;
+
+            const auto [allocator, device, pool, queue] = allocation_;
+            auto staging = vma::staging_buffer(allocator, staging_.size());
+            staging.copyDataToBuffer(staging_.data(), staging_.size());
+
+            auto command = create_texture_image::beginSingleTimeCommand(*pool);
+            for (uint32_t p = 0; p < textures_.size(); ++p)
+            {
+                copies_.clear();
+                for (const auto &r : regions_)
+                {
+                    if (r.page != p)
+                        continue;
+                    copies_.emplace_back(VkBufferImageCopy{
+                        .bufferOffset = r.offset,
+                        .bufferRowLength = 0, // 紧密排列
+                        .bufferImageHeight = 0,
+                        .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+                        .imageOffset = {r.rect.x, r.rect.y, 0},
+                        .imageExtent = {static_cast<uint32_t>(r.rect.w),
+                                        static_cast<uint32_t>(r.rect.h), 1}});
+                    bytes += static_cast<size_t>(r.rect.w) * r.rect.h * 4;
+                }
+                if (copies_.empty())
+                    continue;
+                const VkImage image = textures_[p].image();
+                barrier(command, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                command.copyBufferToImage(*staging, image,
+                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, copies_);
+                barrier(command, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            }
+            create_texture_image::endSingleTimeCommand(*pool, *queue, command);
+            return bytes;
+        }
+
+        [[nodiscard]] const resource &view(uint32_t page) const noexcept
+        {
+            return textures_[page];
+        }
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return textures_.size();
+        }
+
+      private:
+        FontAllocationContext allocation_;
+        std::vector<resource> textures_;
+        std::vector<uint8_t> staging_;
+        std::vector<dynamic_atlas::dirty_region> regions_;
+        std::vector<VkBufferImageCopy> copies_;
+
+        [[nodiscard]] create_texture_image makePage(int size) const
+        {
+            const auto [allocator, device, pool, queue] = allocation_;
+            return create_texture_image{
+                *pool, *queue,
+                create_image{*device, allocator}
+                    .setCreateInfo(
+                        {.imageType = VK_IMAGE_TYPE_2D,
+                         .format = VK_FORMAT_R8G8B8A8_UNORM,
+                         .extent = {static_cast<uint32_t>(size),
+                                    static_cast<uint32_t>(size), 1},
+                         .mipLevels = 1,
+                         .arrayLayers = 1,
+                         .samples = VK_SAMPLE_COUNT_1_BIT,
+                         .tiling = VK_IMAGE_TILING_OPTIMAL,
+                         .usage =
+                             VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                         .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                         .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                         .allocationCreateInfo =
+                             {.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+                              .usage = VMA_MEMORY_USAGE_AUTO}})
+                    .setViewCreateInfo(
+                        {.viewType = VK_IMAGE_VIEW_TYPE_2D,
+                         .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                              .baseMipLevel = 0,
+                                              .levelCount = 1,
+                                              .baseArrayLayer = 0,
+                                              .layerCount = 1}})};
+        }
+
+        // NOTE: 采样 <-> 传输目的地，页面其余部分内容保留(oldLayout 不用 UNDEFINED)
+        static void barrier(const CommandBuffer &command, VkImage image,
+                            VkImageLayout old_layout, VkImageLayout new_layout)
+        {
+            using tool::sType;
+            const bool to_transfer = new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            const VkImageMemoryBarrier barrier{
+                .sType = sType<VkImageMemoryBarrier>(),
+                .srcAccessMask = to_transfer ? VK_ACCESS_SHADER_READ_BIT
+                                             : VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = to_transfer ? VK_ACCESS_TRANSFER_WRITE_BIT
+                                             : VK_ACCESS_SHADER_READ_BIT,
+                .oldLayout = old_layout,
+                .newLayout = new_layout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image,
+                .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                     .baseMipLevel = 0,
+                                     .levelCount = 1,
+                                     .baseArrayLayer = 0,
+                                     .layerCount = 1}};
+            const VkPipelineStageFlags shader = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            const VkPipelineStageFlags transfer = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            command.pipelineBarrier(to_transfer ? shader : transfer,
+                                    to_transfer ? transfer : shader, 0, {}, {},
+                                    std::span{&barrier, 1});
+        }
+    };
+}; // namespace mcs::vulkan::font::msdf
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "__msdfgen_import.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mcs::vulkan::font::msdf
+{
+    constexpr size_t GLYPH_CHANNELS = 4; // RGBA8
+
+    struct glyph_params // NOLINTBEGIN
+    {
+        double glyph_size = 32.0;     // 每 em 的像素数
+        double px_range = 4.0;        // 距离场范围(像素)
+        double angle_threshold = 3.0; // edgeColoringSimple
+    }; // NOLINTEND
+
+    // NOTE: 与 Font::Bounds 字段一致，单位为 em，y 向上
+    struct glyph_bounds // NOLINTBEGIN
+    {
+        double left;
+        double bottom;
+        double right;
+        double top;
+    }; // NOLINTEND
+
+    struct glyph_bitmap // NOLINTBEGIN
+    {
+        int width{0}; // 0 表示空白字形
+        int height{0};
+        glyph_bounds plane_bounds{};
+        double advance{0.0};
+        std::vector<uint8_t> rgba; // 行优先，左上角为原点
+    }; // NOLINTEND
+
+    // NOTE: FT_Face 不是线程安全的，必须在持有字体的线程调用
+    inline msdfgen::Shape load_glyph_shape(msdfgen::FontHandle *font,
+                                           uint32_t glyph_index, double &advance)
+    {
+        msdfgen::Shape shape;
+        advance = 0.0;
+        if (!msdfgen::loadGlyph(shape, font, msdfgen::GlyphIndex(glyph_index),
+                                msdfgen::FONT_SCALING_EM_NORMALIZED, &advance))
+            return {};
+        return shape;
+    }
+
+    /**
+     * NOTE: 生成单个字形的 MSDF，可在任意线程调用(只接触 shape)。
+     * 包围盒四边各扩 range/2，居中到整像素盒子内；
+     * plane_bounds 四边各收进半个像素，与 msdf-atlas-gen 的 planeBounds/atlasBounds 一致。
+     */
+    inline glyph_bitmap generate_glyph(msdfgen::Shape &shape, double advance,
+                                       const glyph_params &params)
+    {
+        glyph_bitmap out{.advance = advance};
+        shape.normalize();
+        if (shape.contours.empty() || !shape.validate())
+            return out;
+        msdfgen::edgeColoringSimple(shape, params.angle_threshold);
+
+        const double scale = params.glyph_size;
+        const double range = params.px_range / scale; // em
+        auto bounds = shape.getBounds();
+        const double l = bounds.l - (range / 2);
+        const double b = bounds.b - (range / 2);
+        const double r = bounds.r + (range / 2);
+        const double t = bounds.t + (range / 2);
+        out.width = static_cast<int>(std::ceil((r - l) * scale));
+        out.height = static_cast<int>(std::ceil((t - b) * scale));
+        const double tx = (((out.width / scale) - (r - l)) / 2) - l;
+        const double ty = (((out.height / scale) - (t - b)) / 2) - b;
+
+        msdfgen::Bitmap<float, 3> msdf(out.width, out.height);
+        msdfgen::generateMSDF(
+            msdf, shape,
+            msdfgen::SDFTransformation(
+                msdfgen::Projection(scale, msdfgen::Vector2(tx, ty)),
+                msdfgen::Range(range)));
+
+        // NOTE: msdfgen 的 y 向上，翻转为左上角原点
+        out.rgba.resize(static_cast<size_t>(out.width) * static_cast<size_t>(out.height) *
+                        GLYPH_CHANNELS);
+        auto *dst = out.rgba.data();
+        for (int y = out.height - 1; y >= 0; --y)
+        {
+            for (int x = 0; x < out.width; ++x)
+            {
+                const float *px = msdf(x, y);
+                for (int c = 0; c < 3; ++c)
+                    *dst++ = static_cast<uint8_t>(
+                        std::clamp((px[c] * 255.0F) + 0.5F, 0.0F, 255.0F));
+                *dst++ = 255; // NOLINT
+            }
+        }
+        const double half = 0.5 / scale;
+        out.plane_bounds = {.left = half - tx,
+                            .bottom = half - ty,
+                            .right = (out.width / scale) - half - tx,
+                            .top = (out.height / scale) - half - ty};
+        return out;
+    }
+}; // namespace mcs::vulkan::font::msdf
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::font::msdf
+{
+    // NOTE: 页内像素矩形，原点在左上角
+    struct atlas_rect // NOLINTBEGIN
+    {
+        int x;
+        int y;
+        int w;
+        int h;
+    }; // NOLINTEND
+
+    /**
+     * NOTE: 可释放的 shelf(货架)分配器。高度按 BUCKET 向上取整，同高的字形共用一层，
+     * 层内从左向右分配；free 的空位记在层内，同层后续分配优先复用。
+     * 最上面的层清空后归还高度，可以被其它高度的层使用。
+     * 每个矩形右/下各留 padding 像素，避免线性采样串色。
+     */
+    class shelf_packer
+    {
+      public:
+        static constexpr int BUCKET = 4;
+
+        constexpr shelf_packer(int width, int height, int padding = 1) noexcept
+            : width_{width}, height_{height}, padding_{padding}
+        {
+        }
+
+        constexpr std::optional<atlas_rect> alloc(int w, int h)
+        {
+            const int pw = w + padding_;
+            const int ph = bucket(h + padding_);
+            if (pw > width_ || ph > height_)
+                return std::nullopt;
+            for (auto &s : shelves_)
+            {
+                if (s.height != ph)
+                    continue;
+                if (auto x = s.take(pw, width_))
+                    return place(*x, s.y, w, h);
+            }
+            if (top_ + ph > height_)
+                return std::nullopt;
+            auto &s = shelves_.emplace_back(shelf{.y = top_, .height = ph});
+            top_ += ph;
+            return place(*s.take(pw, width_), s.y, w, h);
+        }
+
+        constexpr void free(const atlas_rect &rect)
+        {
+            auto it = std::ranges::find(shelves_, rect.y, &shelf::y);
+            if (it == shelves_.end())
+                return;
+            it->release(rect.x, rect.w + padding_);
+            used_ -= static_cast<int64_t>(rect.w) * rect.h;
+            // NOTE: 顶层清空后归还高度
+            while (!shelves_.empty() && shelves_.back().cursor == 0)
+            {
+                top_ -= shelves_.back().height;
+                shelves_.pop_back();
+            }
+        }
+
+        constexpr void clear() noexcept
+        {
+            shelves_.clear();
+            top_ = 0;
+            used_ = 0;
+        }
+
+        // NOTE: 已分配的像素面积(不含 padding)
+        [[nodiscard]] constexpr int64_t used() const noexcept
+        {
+            return used_;
+        }
+        [[nodiscard]] constexpr int width() const noexcept
+        {
+            return width_;
+        }
+        [[nodiscard]] constexpr int height() const noexcept
+        {
+            return height_;
+        }
+
+      private:
+        struct slot
+        {
+            int x;
+            int w;
+        };
+        struct shelf
+        {
+            int y;
+            int height;
+            int cursor{0};
+            std::vector<slot> free{};
+
+            // NOTE: 先复用空位(first fit)，再从 cursor 向右
+            constexpr std::optional<int> take(int w, int width)
+            {
+                for (auto it = free.begin(); it != free.end(); ++it)
+                {
+                    if (it->w < w)
+                        continue;
+                    const int x = it->x;
+                    it->x += w;
+                    it->w -= w;
+                    if (it->w == 0)
+                        free.erase(it);
+                    return x;
+                }
+                if (cursor + w > width)
+                    return std::nullopt;
+                return std::exchange(cursor, cursor + w);
+            }
+
+            // NOTE: 与相邻空位合并；紧邻 cursor 时退回 cursor
+            constexpr void release(int x, int w)
+            {
+                auto it = std::ranges::lower_bound(free, x, {}, &slot::x);
+                if (it != free.end() && x + w == it->x)
+                {
+                    w += it->w;
+                    it = free.erase(it);
+                }
+                if (it != free.begin() && std::prev(it)->x + std::prev(it)->w == x)
+                {
+                    --it;
+                    it->w += w;
+                    x = it->x;
+                    w = it->w;
+                    it = free.erase(it);
+                }
+                if (x + w == cursor)
+                    cursor = x;
+                else
+                    free.insert(it, slot{.x = x, .w = w});
+            }
+        };
+
+        int width_;
+        int height_;
+        int padding_;
+        int top_{0};
+        int64_t used_{0};
+        std::vector<shelf> shelves_;
+
+        [[nodiscard]] static constexpr int bucket(int h) noexcept
+        {
+            return (h + BUCKET - 1) / BUCKET * BUCKET;
+        }
+        constexpr atlas_rect place(int x, int y, int w, int h) noexcept
+        {
+            used_ += static_cast<int64_t>(w) * h;
+            return {.x = x, .y = y, .w = w, .h = h};
+        }
+    };
+}; // namespace mcs::vulkan::font::msdf
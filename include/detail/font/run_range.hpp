@@ -0,0 +1,15 @@
+#pragma once
+
+#include "__harfbuzz_import.hpp"
+#include <cstddef>
+
+namespace mcs::vulkan::font
+{
+    // NOTE: 扁平存储中的一段 [first, first + count)，替代 vector<vector<T>>
+    struct run_range // NOLINTBEGIN
+    {
+        hb_direction_t direction;
+        size_t first;
+        size_t count;
+    }; // NOLINTEND
+}; // namespace mcs::vulkan::font
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "__harfbuzz_import.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: selectFont 结果缓存。
+     * key = (script, codepoint)，偏好语言是 selector 的状态，变化时整体 clear()。
+     * 不按 Unicode block 缓存: 同一 block 内的字体覆盖并不连续(子集化字体尤为明显)，
+     * 按码点缓存才能与未缓存时的结果严格一致。
+     * 失败的结果(font == nullptr)同样缓存，避免对缺字反复遍历 candidate。
+     */
+    template <typename SelectResult>
+    class select_cache
+    {
+        using key_type = uint64_t;
+        static constexpr key_type make_key(char32_t codepoint,
+                                           hb_script_t script) noexcept
+        {
+            return (static_cast<key_type>(script) << 32U) | // NOLINT
+                   static_cast<key_type>(codepoint);
+        }
+
+      public:
+        [[nodiscard]] constexpr const SelectResult *find(char32_t codepoint,
+                                                         hb_script_t script) noexcept
+        {
+            if (auto it = map_.find(make_key(codepoint, script)); it != map_.end())
+            {
+                ++hits_;
+                return &it->second;
+            }
+            ++misses_;
+            return nullptr;
+        }
+        constexpr void insert(char32_t codepoint, hb_script_t script,
+                              const SelectResult &result)
+        {
+            map_.insert_or_assign(make_key(codepoint, script), result);
+        }
+
+        // NOTE: 字体集合、candidate、偏好语言任一变化都必须调用
+        constexpr void clear() noexcept
+        {
+            map_.clear();
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept
+        {
+            return map_.size();
+        }
+        [[nodiscard]] constexpr size_t hits() const noexcept
+        {
+            return hits_;
+        }
+        [[nodiscard]] constexpr size_t misses() const noexcept
+        {
+            return misses_;
+        }
+
+      private:
+        std::unordered_map<key_type, SelectResult> map_;
+        size_t hits_{0};
+        size_t misses_{0};
+    };
+}; // namespace mcs::vulkan::font
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "layout_text.hpp"
+#include "shared_selector.hpp"
+
+#include "../utils/thread_pool.hpp"
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 批量排版互不相关的字符串，normalize -> bidi -> assign_fonts -> shape 分散到线程池。
+     * - out[i] 对应 texts[i]，与调度顺序无关；out 的旧容量会被复用
+     * - 每个工作线程使用自己的 text_arena（hb_buffer_t / SBScriptLocator 不共享）
+     * - hb_font_t 只读共享：hb-ft 在访问 FT_Face 时自带锁
+     * - 字体选择通过 shared_selector，懒加载 candidate 在锁内串行发生，但在工作线程上
+     *   执行 factory.make(FT_Face + 纹理上传)；调用线程阻塞期间不会与之争用队列。
+     *   加载哪个 candidate 取决于调度顺序，需要确定结果时先把 candidate 全部 load
+     * 调用线程阻塞到全部完成，期间不要修改 selector。
+     */
+    template <typename FontSelector,
+              typename FontContext = FontSelector::font_context_type,
+              line_break_backend LineBreaker = libunibreak::line_breaker>
+    void shape_batch(thread_pool &pool, std::span<const std::string_view> texts,
+                     int base_level, FontSelector &selector,
+                     std::vector<text_layout<FontContext>> &out)
+    {
+        using view_type = shared_selector<FontSelector>::view;
+
+        out.resize(texts.size());
+        shared_selector<FontSelector> shared{selector};
+        // NOTE: 每个工作线程一个 view，线程私有的 select_cache 在整个批次内复用
+        std::vector<view_type> views;
+        views.reserve(pool.size());
+        for (size_t i = 0; i < pool.size(); ++i)
+            views.emplace_back(shared);
+
+        pool.for_each_index(texts.size(), [&](size_t index) {
+            auto &view = views[thread_pool::current_worker()];
+            auto &arena = text_arena<FontContext, LineBreaker>::local();
+            layout_text(arena, texts[index], base_level, view);
+            // NOTE: 拷贝而不是 swap，arena 保留容量
+            out[index] = static_cast<const text_layout<FontContext> &>(arena);
+        });
+    }
+}; // namespace mcs::vulkan::font
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "select_cache.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 多线程共享一个 FontSelector。
+     * FontSelector 内部有缓存且会懒加载 candidate（会创建纹理），本身不是线程安全的：
+     * 每个线程持有一个 view，先查线程私有的 select_cache，未命中才加锁访问共享 selector。
+     * - 懒加载 candidate(factory.make：FT_Face + 纹理上传)在 mutex_ 内、由调用 selectFont
+     *   的线程执行；调用方要保证 factory 用到的队列/命令池此时没有被其他线程使用
+     * - 每次加载都递增 generation_，各 view 发现变化后清空自己的缓存，
+     *   与 FontSelector::loadFromCandidate 中的 cache_.clear() 一致
+     * view 只应在一次批处理内使用，期间不要在其他线程修改 selector。
+     */
+    template <typename FontSelector>
+    class shared_selector
+    {
+      public:
+        using font_context_type = FontSelector::font_context_type;
+        using select_result_type = FontSelector::select_result_type;
+
+        class view
+        {
+          public:
+            using font_context_type = shared_selector::font_context_type;
+            using select_result_type = shared_selector::select_result_type;
+
+            explicit view(shared_selector &shared) noexcept : shared_{&shared} {}
+
+            [[nodiscard]] select_result_type selectFont(char32_t codepoint,
+                                                        hb_script_t script)
+            {
+                // NOTE: 其他线程加载了新字体，旧的结果可能不再成立
+                if (const uint64_t now =
+                        shared_->generation_.load(std::memory_order_acquire);
+                    now != generation_)
+                {
+                    cache_.clear();
+                    generation_ = now;
+                }
+                if (const auto *hit = cache_.find(codepoint, script))
+                    return *hit;
+                select_result_type ret;
+                {
+                    std::scoped_lock lock{shared_->mutex_};
+                    auto &selector = *shared_->selector_;
+                    const size_t candidates = selector.candidate().size();
+                    ret = selector.selectFont(codepoint, script);
+                    if (selector.candidate().size() != candidates)
+                    {
+                        // NOTE: 本线程刚加载了字体，自己的缓存同样作废
+                        cache_.clear();
+                        generation_ = shared_->generation_.fetch_add(
+                                          1, std::memory_order_acq_rel) +
+                                      1;
+                    }
+                }
+                cache_.insert(codepoint, script, ret);
+                return ret;
+            }
+            [[nodiscard]] static hb_language_t getFallbackLanguage(
+                hb_script_t script, const font_context_type *select_font) noexcept
+            {
+                return FontSelector::getFallbackLanguage(script, select_font);
+            }
+            [[nodiscard]] std::string_view langBcp47() const noexcept
+            {
+                return shared_->langBcp47_;
+            }
+            [[nodiscard]] const font_context_type *notdefFont() const noexcept
+            {
+                return shared_->notdefFont_;
+            }
+
+          private:
+            shared_selector *shared_;
+            select_cache<select_result_type> cache_;
+            uint64_t generation_{0};
+        };
+
+        explicit shared_selector(FontSelector &selector) noexcept
+            : selector_{&selector}, langBcp47_{selector.langBcp47()},
+              notdefFont_{selector.notdefFont()}
+        {
+        }
+
+      private:
+        FontSelector *selector_;
+        std::string_view langBcp47_;
+        const font_context_type *notdefFont_;
+        std::mutex mutex_;
+        std::atomic<uint64_t> generation_{0}; // 每次懒加载 candidate 递增
+    };
+}; // namespace mcs::vulkan::font
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "text_layout.hpp"
+#include "harfbuzz/shape_plan_cache.hpp"
+#include "libunibreak/line_breaker.hpp"
+#include "../utils/unique_handle.hpp"
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 文本管线的中间结果 + 可复用的临时资源，按线程复用。
+     * reset() 只 clear 不释放：容量单调增长，达到最大文本规模后重排不再分配堆内存。
+     * 结果可以通过 text_layout::swap 转移给调用方，换回的旧容量继续复用。
+     * SheenBidi / HarfBuzz 内部的 malloc 不在此范围内。
+     * LineBreaker 为断行后端(line_break_backend)，其内部状态同样按线程复用。
+     */
+    template <typename FontContext,
+              line_break_backend LineBreaker = libunibreak::line_breaker>
+    class text_arena : public text_layout<FontContext>
+    {
+      public:
+        using SBScriptLocatorPtr =
+            unique_handle<SBScriptLocatorRef,
+                          [](SBScriptLocatorRef value) constexpr noexcept {
+                              SBScriptLocatorRelease(value);
+                          }>;
+        using HBBufferPtr = unique_handle<hb_buffer_t *, [](hb_buffer_t *value) noexcept {
+            hb_buffer_destroy(value);
+        }>;
+
+        // NOLINTBEGIN
+        SBScriptLocatorPtr locator{SBScriptLocatorCreate()};
+        HBBufferPtr buffer{hb_buffer_create()};
+        // NOTE: 跨帧保留，同一 (font, script, language, direction) 只编译一次 plan
+        harfbuzz::shape_plan_cache plans;
+        LineBreaker breaker;
+        // NOLINTEND
+
+        constexpr void reset() noexcept
+        {
+            this->clear();
+        }
+
+        // NOTE: 每个线程一份，hb_buffer_t 不能跨线程共享
+        static text_arena &local() noexcept
+        {
+            thread_local text_arena arena;
+            return arena;
+        }
+    };
+}; // namespace mcs::vulkan::font
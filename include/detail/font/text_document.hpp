@@ -0,0 +1,213 @@
+#pragma once
+
+#include "layout_text.hpp"
+#include "bidi/split_paragraphs.hpp"
+
+#include "../utils/mcs_assert.hpp"
+#include "../utils/weighted_sequence.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 可编辑文本模型。按 UAX #9 段落缓存整条管线的结果，
+     * 编辑只重排受影响的段落(通常是 1 个)，再把结果拼回段落表。
+     * 段落之间互不影响: bidi / 断行 / shape 都不跨段落，NFC 不会合成分隔符。
+     * 段落表是按字节数加权的 treap，定位偏移、拆分/合并段落都是 O(log 段落数)。
+     */
+    template <typename FontSelector,
+              line_break_backend LineBreaker = libunibreak::line_breaker>
+    class text_document
+    {
+        using FontContext = FontSelector::font_context_type;
+
+      public:
+        using layout_type = text_layout<FontContext>;
+        struct paragraph // NOLINTBEGIN
+        {
+            std::string text; // 源 UTF-8，含结尾分隔符
+            layout_type layout;
+        }; // NOLINTEND
+        struct paragraph_span // NOLINTBEGIN
+        {
+            size_t first;
+            size_t count;
+        }; // NOLINTEND
+
+        constexpr text_document(FontSelector *selector, int base_level) noexcept
+            : selector_{selector}, baseLevel_{base_level}
+        {
+            paragraphs_.push_back(std::make_unique<paragraph>());
+        }
+
+        constexpr void assign(std::string_view text)
+        {
+            paragraphs_.clear();
+            insertParagraphs(0, text);
+            if (paragraphs_.empty())
+                paragraphs_.push_back(std::make_unique<paragraph>());
+        }
+
+        /**
+         * @brief 用 text 替换文档中 [offset, offset + count) 的 UTF-8 字节
+         * @return 重排后的段落区间
+         */
+        constexpr paragraph_span replace(size_t offset, size_t count,
+                                         std::string_view text)
+        {
+            MCS_ASSERT(offset + count <= size(), "text_document::replace out of range");
+            auto [first, begin] = locate(offset);
+            auto [last, end] = locate(offset + count);
+            if (last < paragraphs_.size() && end == 0 && last > first)
+            {
+                // NOTE: 终点恰好在段首，等价于上一段的末尾
+                --last;
+                end = paragraphs_[last]->text.size();
+            }
+
+            std::string merged;
+            merged.reserve(begin + text.size() + (bytesOf(last) - end));
+            merged.append(paragraphs_[first]->text, 0, begin);
+            merged.append(text);
+            if (last < paragraphs_.size())
+                merged.append(paragraphs_[last]->text, end);
+
+            // NOTE: 上一段结尾的 CR 与 merged 开头的 LF 组成 CRLF
+            if (first > 0 && merged.starts_with('\n') &&
+                paragraphs_[first - 1]->text.ends_with('\r'))
+                merged.insert(0, paragraphs_[--first]->text);
+
+            // NOTE: 删除了分隔符，或 CR 与下一段的 LF 组成 CRLF，都要与下一段合并
+            size_t erase_end = std::min(last + 1, paragraphs_.size());
+            while (erase_end < paragraphs_.size() &&
+                   needMerge(merged, paragraphs_[erase_end]->text))
+                merged.append(paragraphs_[erase_end++]->text);
+
+            paragraphs_.erase(first, erase_end);
+            const size_t inserted = insertParagraphs(first, merged);
+            if (paragraphs_.empty())
+                paragraphs_.push_back(std::make_unique<paragraph>());
+            return {.first = first, .count = inserted};
+        }
+        constexpr paragraph_span insert(size_t offset, std::string_view text)
+        {
+            return replace(offset, 0, text);
+        }
+        constexpr paragraph_span erase(size_t offset, size_t count)
+        {
+            return replace(offset, count, {});
+        }
+
+        // NOTE: 字体/偏好语言变化后需要全部重排
+        constexpr void relayout()
+        {
+            paragraphs_.for_each([this](auto &p) { layoutParagraph(*p); });
+        }
+
+        /**
+         * @brief 文档字节偏移 -> (段落下标, 段内字节偏移)
+         * 恰好位于段落边界时返回后一段的段首；offset == size() 时返回最后一段的末尾
+         */
+        [[nodiscard]] constexpr std::pair<size_t, size_t> locate(
+            size_t offset) const noexcept
+        {
+            if (const auto found = paragraphs_.locate(offset);
+                found.first < paragraphs_.size())
+                return found;
+            const size_t back = paragraphs_.size() - 1;
+            return {back, paragraphs_[back]->text.size()};
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept
+        {
+            return paragraphs_.total();
+        }
+        [[nodiscard]] constexpr size_t paragraphCount() const noexcept
+        {
+            return paragraphs_.size();
+        }
+        // NOTE: 段落表的树高，locate/拆分/合并的代价与它成正比；只用于测试/诊断
+        [[nodiscard]] constexpr size_t paragraphTreeDepth() const noexcept
+        {
+            return paragraphs_.depth();
+        }
+        [[nodiscard]] constexpr const paragraph &operator[](size_t index) const noexcept
+        {
+            return *paragraphs_[index];
+        }
+        [[nodiscard]] constexpr std::string text() const
+        {
+            std::string ret;
+            ret.reserve(size());
+            paragraphs_.for_each([&](const auto &p) { ret.append(p->text); });
+            return ret;
+        }
+
+      private:
+        FontSelector *selector_;
+        int baseLevel_;
+        struct paragraph_bytes
+        {
+            [[nodiscard]] size_t operator()(
+                const std::unique_ptr<paragraph> &p) const noexcept
+            {
+                return p->text.size();
+            }
+        };
+
+        weighted_sequence<std::unique_ptr<paragraph>, paragraph_bytes> paragraphs_;
+        std::vector<bidi::paragraph_boundary> boundaries_;
+
+        [[nodiscard]] constexpr size_t bytesOf(size_t index) const noexcept
+        {
+            return index < paragraphs_.size() ? paragraphs_[index]->text.size() : 0;
+        }
+
+        // NOTE: merged 结尾的分隔符被删掉了，或结尾的 CR 与下一段开头的 LF 组成 CRLF
+        [[nodiscard]] constexpr bool needMerge(std::string_view merged,
+                                               std::string_view next)
+        {
+            if (merged.empty())
+                return true;
+            if (merged.back() == '\r')
+                return next.starts_with('\n');
+            // 分隔符最长 3 字节(U+2029)，只检查结尾即可
+            constexpr size_t TAIL = 4;
+            bidi::split_paragraphs(
+                merged.substr(merged.size() - std::min(merged.size(), TAIL)),
+                boundaries_);
+            return boundaries_.empty() || boundaries_.back().separator_length == 0;
+        }
+
+        constexpr void layoutParagraph(paragraph &p)
+        {
+            auto &arena = text_arena<FontContext, LineBreaker>::local();
+            layout_text(arena, p.text, baseLevel_, *selector_);
+            // NOTE: 结果换给段落，旧容量留在 arena 中复用
+            p.layout.swap(arena);
+        }
+
+        constexpr size_t insertParagraphs(size_t index, std::string_view text)
+        {
+            bidi::split_paragraphs(text, boundaries_);
+            std::vector<std::unique_ptr<paragraph>> fresh;
+            fresh.reserve(boundaries_.size());
+            for (const auto &b : boundaries_)
+            {
+                auto p = std::make_unique<paragraph>();
+                p->text.assign(text.substr(b.offset, b.length));
+                layoutParagraph(*p);
+                fresh.emplace_back(std::move(p));
+            }
+            paragraphs_.insert(index, fresh);
+            return fresh.size();
+        }
+    };
+}; // namespace mcs::vulkan::font
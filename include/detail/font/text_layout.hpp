@@ -0,0 +1,63 @@
+#pragma once
+
+#include "bidi/visual_buffer.hpp"
+#include "harfbuzz/shape_result.hpp"
+#include "run_range.hpp"
+#include "shape_info.hpp"
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 一段文本经过整条管线后的结果，全部扁平存储，子序列用 run_range 表示。
+     * 索引均相对于本段文本的 codepoints。
+     */
+    template <typename FontContext>
+    struct text_layout // NOLINTBEGIN
+    {
+        using font_context_type = FontContext;
+        using shape_info_type = shape_info<FontContext>;
+        using shape_result_type = harfbuzz::shape_result<FontContext>;
+
+        std::vector<uint32_t> codepoints; // NFC，逻辑顺序
+        bidi::visual_buffer visual;
+        std::vector<shape_info_type> shape_infos;
+        std::vector<run_range> shape_ranges; // 每个 bidi run 对应一段 shape_infos
+        std::vector<char> breaks;            // LINEBREAK_*，见 line_break_backend
+        std::vector<shape_result_type> glyphs;
+        std::vector<run_range> glyph_ranges; // 每个 bidi run 对应一段 glyphs
+
+        [[nodiscard]] constexpr std::span<const shape_result_type> glyphs_of(
+            const run_range &range) const noexcept
+        {
+            return std::span{glyphs}.subspan(range.first, range.count);
+        }
+
+        // NOTE: 只 clear 不释放容量
+        constexpr void clear() noexcept
+        {
+            codepoints.clear();
+            visual.clear();
+            shape_infos.clear();
+            shape_ranges.clear();
+            breaks.clear();
+            glyphs.clear();
+            glyph_ranges.clear();
+        }
+
+        constexpr void swap(text_layout &other) noexcept
+        {
+            std::swap(codepoints, other.codepoints);
+            std::swap(visual, other.visual);
+            std::swap(shape_infos, other.shape_infos);
+            std::swap(shape_ranges, other.shape_ranges);
+            std::swap(breaks, other.breaks);
+            std::swap(glyphs, other.glyphs);
+            std::swap(glyph_ranges, other.glyph_ranges);
+        }
+    }; // NOLINTEND
+}; // namespace mcs::vulkan::font
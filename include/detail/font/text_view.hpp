@@ -0,0 +1,292 @@
+#pragma once
+
+#include "layout_text.hpp"
+#include "line_fitter.hpp"
+
+#include "../utils/fenwick_tree.hpp"
+#include "../utils/mcs_assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::font
+{
+    /**
+     * NOTE: 虚拟化的多行文本视图(日志、聊天记录)。每个源行是一个段落，
+     * 只有视口附近的行会经过 layout_text + line_fitter，超出 overscan 的结果被回收复用。
+     * 已测量的行高记在树状数组中，未测量的行按已测量行的平均高度估计，
+     * 供滚动条使用；滚动位置锚定在某一源行上，测量结果变化不会让可见内容跳动。
+     * 每帧的开销与可见行数成正比；与文档规模相关的只有源文本和每行一个 float。
+     * 宽度与高度的单位与 shape_result::advance_x 相同(em)。
+     */
+    template <typename FontSelector,
+              line_break_backend LineBreaker = libunibreak::line_breaker>
+    class text_view
+    {
+        using FontContext = FontSelector::font_context_type;
+
+      public:
+        using layout_type = text_layout<FontContext>;
+        struct visible_line // NOLINTBEGIN
+        {
+            size_t source;             // 源行下标
+            const layout_type *layout; // 源行的排版结果，下一次 update 前有效
+            line_box line;             // 源行内的一个视觉行
+            double y;                  // 视觉行顶部相对视口顶部的偏移
+        }; // NOLINTEND
+
+        constexpr text_view(FontSelector *selector, int base_level, double width,
+                            double line_height, size_t overscan = 8) noexcept
+            : selector_{selector}, baseLevel_{base_level}, width_{width},
+              lineHeight_{line_height}, overscan_{overscan}
+        {
+        }
+
+        constexpr void append(std::string_view line)
+        {
+            lines_.emplace_back(line);
+            heights_.emplace_back(0.0F);
+            measured_.push_back(height_sum{});
+        }
+
+        constexpr void set(size_t index, std::string_view line)
+        {
+            MCS_ASSERT(index < lines_.size(), "text_view::set out of range");
+            lines_[index].assign(line);
+            forget(index);
+            if (auto it = cache_.find(index); it != cache_.end())
+                recycle(it);
+        }
+
+        // NOTE: 宽度变化后所有行都要重新测量，O(n) 清零
+        constexpr void resize(double width)
+        {
+            if (width == width_)
+                return;
+            width_ = width;
+            std::ranges::fill(heights_, 0.0F);
+            measured_.assign(lines_.size());
+            for (auto it = cache_.begin(); it != cache_.end();)
+                it = recycle(it);
+        }
+
+        constexpr void scrollTo(double offset)
+        {
+            offset = std::clamp(offset, 0.0, std::max(0.0, contentHeight() - viewport_));
+            anchor_ = lineAt(offset);
+            anchorDelta_ = offset - offsetOf(anchor_);
+        }
+        constexpr void scrollBy(double delta)
+        {
+            scrollTo(offset() + delta);
+        }
+        constexpr void scrollToLine(size_t index)
+        {
+            scrollTo(offsetOf(std::min(index, lines_.size())));
+        }
+
+        /**
+         * @brief 排版视口内的行，返回按 y 递增的视觉行
+         * 只测量/缓存 [首个可见源行 - overscan, 最后可见源行 + overscan]
+         */
+        constexpr std::span<const visible_line> update(double viewport_height)
+        {
+            viewport_ = viewport_height;
+            visible_.clear();
+            if (lines_.empty())
+                return visible_;
+
+            anchor_ = std::min(anchor_, lines_.size() - 1);
+            const size_t first = anchor_ > overscan_ ? anchor_ - overscan_ : 0;
+            for (size_t i = first; i < anchor_; ++i)
+                (void)ensure(i);
+
+            double y = -anchorDelta_;
+            size_t last = anchor_;
+            for (; last < lines_.size() && y < viewport_height; ++last)
+            {
+                const auto &e = ensure(last);
+                // NOTE: 空行也占一行高度
+                std::span<const line_box> rows = e.fitter.lines();
+                if (rows.empty())
+                    rows = {&EMPTY_LINE, 1};
+                for (const auto &line : rows)
+                {
+                    if (y + lineHeight_ > 0.0 && y < viewport_height)
+                        visible_.emplace_back(visible_line{
+                            .source = last, .layout = &e.layout, .line = line, .y = y});
+                    y += lineHeight_;
+                }
+            }
+            const size_t end = std::min(lines_.size(), last + overscan_);
+            for (size_t i = last; i < end; ++i)
+                (void)ensure(i);
+
+            // NOTE: 回收窗口外的结果，缓存规模只与可见行数有关
+            for (auto it = cache_.begin(); it != cache_.end();)
+            {
+                if (it->first < first || it->first >= end)
+                    it = recycle(it);
+                else
+                    ++it;
+            }
+            return visible_;
+        }
+
+        // NOTE: 单个视觉行按视觉顺序排列的 glyph 区间，见 line_fitter::reorder
+        constexpr void reorder(const visible_line &line, std::vector<run_range> &out)
+        {
+            auto it = cache_.find(line.source);
+            MCS_ASSERT(it != cache_.end(), "text_view::reorder line not laid out");
+            it->second->fitter.reorder(it->second->layout, line.line, out);
+        }
+
+        // NOTE: 源行 index 顶部的位置，未测量的行按估计高度计算
+        [[nodiscard]] constexpr double offsetOf(size_t index) const
+        {
+            return value(measured_.prefix(index), index);
+        }
+        [[nodiscard]] constexpr double contentHeight() const
+        {
+            return offsetOf(lines_.size());
+        }
+        [[nodiscard]] constexpr double offset() const
+        {
+            return offsetOf(anchor_) + anchorDelta_;
+        }
+        [[nodiscard]] constexpr size_t lineCount() const noexcept
+        {
+            return lines_.size();
+        }
+        [[nodiscard]] constexpr size_t cachedCount() const noexcept
+        {
+            return cache_.size();
+        }
+        [[nodiscard]] constexpr size_t measuredCount() const
+        {
+            return measured_.prefix(lines_.size()).count;
+        }
+        [[nodiscard]] constexpr const std::string &operator[](size_t index) const noexcept
+        {
+            return lines_[index];
+        }
+
+      private:
+        struct entry
+        {
+            layout_type layout;
+            line_fitter fitter;
+        };
+        struct height_sum
+        {
+            double height{0.0};
+            size_t count{0};
+
+            constexpr height_sum operator+(const height_sum &o) const noexcept
+            {
+                return {.height = height + o.height, .count = count + o.count};
+            }
+            constexpr height_sum operator-(const height_sum &o) const noexcept
+            {
+                return {.height = height - o.height, .count = count - o.count};
+            }
+        };
+        using cache_type = std::unordered_map<size_t, std::unique_ptr<entry>>;
+        static constexpr line_box EMPTY_LINE{
+            .first = 0, .count = 0, .width = 0.0, .hard = true};
+
+        FontSelector *selector_;
+        int baseLevel_;
+        double width_;
+        double lineHeight_;
+        size_t overscan_;
+        std::vector<std::string> lines_;
+        std::vector<float> heights_; // 0 表示未测量
+        fenwick_tree<height_sum> measured_;
+        cache_type cache_;
+        std::vector<std::unique_ptr<entry>> spare_; // 回收的 entry，复用容量
+        std::vector<visible_line> visible_;
+        size_t anchor_{0};
+        double anchorDelta_{0.0};
+        double viewport_{0.0};
+
+        [[nodiscard]] constexpr double estimate(const height_sum &sum) const noexcept
+        {
+            return sum.count == 0 ? lineHeight_
+                                  : sum.height / static_cast<double>(sum.count);
+        }
+        // NOTE: 前 index 行的总高度 = 已测量之和 + 未测量行数 * 平均高度
+        [[nodiscard]] constexpr double value(const height_sum &sum, size_t index) const
+        {
+            const double avg = estimate(measured_.prefix(lines_.size()));
+            return sum.height + (static_cast<double>(index - sum.count) * avg);
+        }
+
+        // NOTE: offset 所在的源行
+        [[nodiscard]] constexpr size_t lineAt(double offset) const
+        {
+            if (lines_.empty())
+                return 0;
+            const double avg = estimate(measured_.prefix(lines_.size()));
+            const size_t index =
+                measured_.partition_point([&](const height_sum &sum, size_t count) {
+                    return sum.height + (static_cast<double>(count - sum.count) * avg) <=
+                           offset;
+                });
+            return std::min(index, lines_.size() - 1);
+        }
+
+        constexpr void forget(size_t index)
+        {
+            if (heights_[index] == 0.0F)
+                return;
+            // NOTE: count 为 size_t，减法按模运算，累加后仍然正确
+            const height_sum old{.height = heights_[index], .count = 1};
+            measured_.add(index, height_sum{} - old);
+            heights_[index] = 0.0F;
+        }
+
+        constexpr cache_type::iterator recycle(cache_type::iterator it)
+        {
+            spare_.emplace_back(std::move(it->second));
+            return cache_.erase(it);
+        }
+
+        constexpr const entry &ensure(size_t index)
+        {
+            if (auto it = cache_.find(index); it != cache_.end())
+                return *it->second;
+
+            std::unique_ptr<entry> e;
+            if (spare_.empty())
+                e = std::make_unique<entry>();
+            else
+            {
+                e = std::move(spare_.back());
+                spare_.pop_back();
+            }
+            auto &arena = text_arena<FontContext, LineBreaker>::local();
+            layout_text(arena, lines_[index], baseLevel_, *selector_);
+            e->layout.swap(arena);
+            e->fitter.build(e->layout);
+            const size_t rows = std::max<size_t>(1, e->fitter.wrap(width_).size());
+
+            const auto height =
+                static_cast<float>(static_cast<double>(rows) * lineHeight_);
+            if (heights_[index] != height)
+            {
+                forget(index);
+                measured_.add(index, height_sum{.height = height, .count = 1});
+                heights_[index] = height;
+            }
+            return *cache_.emplace(index, std::move(e)).first->second;
+        }
+    };
+}; // namespace mcs::vulkan::font
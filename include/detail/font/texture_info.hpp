@@ -5,6 +5,7 @@
 #include <string>
 #include <variant>
 #include "../load/raw_stbi_image.hpp"
+#include "../load/ktx2_image.hpp"
 
 namespace mcs::vulkan::font
 {
@@ -17,9 +18,16 @@ namespace mcs::vulkan::font
             std::string image_path;            // NOLINT
             constexpr auto operator<=>(const stbi_image_type &) const noexcept = default;
         };
+        // NOTE: gen_emoji_atlas -format ktx2 的输出，免去 PNG 解码
+        struct ktx2_image_type
+        {
+            using type = load::ktx2_image;
+            std::string image_path; // NOLINT
+            constexpr auto operator<=>(const ktx2_image_type &) const noexcept = default;
+        };
         // NOLINTBEGIN
         texture_bind_sampler bind;
-        std::variant<struct stbi_image_type> image_variant;
+        std::variant<struct stbi_image_type, struct ktx2_image_type> image_variant;
         // NOLINTEND
 
         constexpr auto operator<=>(const texture_info &) const noexcept = default;
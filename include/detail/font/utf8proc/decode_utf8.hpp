@@ -0,0 +1,183 @@
+#pragma once
+
+#include "../__utf8proc_import.hpp"
+#include "../../utils/safe_reinterpret_cast.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MCS_UTF8_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MCS_UTF8_NEON
+#endif
+
+namespace mcs::vulkan::font::utf8proc
+{
+    namespace detail
+    {
+        constexpr size_t UTF8_BLOCK = 16;
+
+        // NOTE: 16 字节全是 ASCII 时零扩展写出 16 个码点
+        inline bool ascii_block(const unsigned char *src, uint32_t *dst) noexcept
+        {
+#if defined(MCS_UTF8_SSE2)
+            const __m128i bytes = _mm_loadu_si128(
+                safe_reinterpret_cast<const __m128i *>(src));
+            if (_mm_movemask_epi8(bytes) != 0)
+                return false;
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+            auto *out = safe_reinterpret_cast<__m128i *>(dst);
+            _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+            return true;
+#elif defined(MCS_UTF8_NEON)
+            const uint8x16_t bytes = vld1q_u8(src);
+            if (vmaxvq_u8(bytes) >= 0x80)
+                return false;
+            const uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+            const uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+            vst1q_u32(dst + 0, vmovl_u16(vget_low_u16(lo)));
+            vst1q_u32(dst + 4, vmovl_u16(vget_high_u16(lo)));
+            vst1q_u32(dst + 8, vmovl_u16(vget_low_u16(hi)));
+            vst1q_u32(dst + 12, vmovl_u16(vget_high_u16(hi)));
+            return true;
+#else
+            // SWAR: 两个 64 位字的最高位
+            uint64_t a;
+            uint64_t b;
+            std::memcpy(&a, src, sizeof(a));
+            std::memcpy(&b, src + sizeof(a), sizeof(b));
+            if (((a | b) & 0x8080808080808080ULL) != 0)
+                return false;
+            for (size_t i = 0; i < UTF8_BLOCK; ++i)
+                dst[i] = src[i];
+            return true;
+#endif
+        }
+
+        constexpr bool is_continuation(unsigned char c) noexcept
+        {
+            return (c & 0xC0U) == 0x80U;
+        }
+
+        /**
+         * @brief 校验并解码一个多字节序列，返回字节数，非法时返回 0
+         * 拒绝过长编码、代理项与 > U+10FFFF(RFC 3629)
+         */
+        constexpr size_t decode_one(const unsigned char *p, const unsigned char *end,
+                                    uint32_t &cp) noexcept
+        {
+            const unsigned char c = *p;
+            const auto left = static_cast<size_t>(end - p);
+            if (c >= 0xC2 && c <= 0xDF) // NOLINTBEGIN
+            {
+                if (left < 2 || !is_continuation(p[1]))
+                    return 0;
+                cp = ((c & 0x1FU) << 6U) | (p[1] & 0x3FU);
+                return 2;
+            }
+            if (c >= 0xE0 && c <= 0xEF)
+            {
+                if (left < 3 || !is_continuation(p[1]) || !is_continuation(p[2]))
+                    return 0;
+                if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] > 0x9F))
+                    return 0;
+                cp = ((c & 0x0FU) << 12U) | ((p[1] & 0x3FU) << 6U) | (p[2] & 0x3FU);
+                return 3;
+            }
+            if (c >= 0xF0 && c <= 0xF4)
+            {
+                if (left < 4 || !is_continuation(p[1]) || !is_continuation(p[2]) ||
+                    !is_continuation(p[3]))
+                    return 0;
+                if ((c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] > 0x8F))
+                    return 0;
+                cp = ((c & 0x07U) << 18U) | ((p[1] & 0x3FU) << 12U) |
+                     ((p[2] & 0x3FU) << 6U) | (p[3] & 0x3FU);
+                return 4;
+            } // NOLINTEND
+            return 0;
+        }
+    }; // namespace detail
+
+    /**
+     * NOTE: 校验 UTF-8 并解码为 UTF-32，写入调用方的 codepoints(复用容量)。
+     * ASCII 以 16 字节为一块走 SIMD(SSE2/NEON，否则 SWAR)，其余逐字符校验。
+     * 非法输入返回 false，codepoints 内容未定义。
+     */
+    inline bool decode_utf8(std::string_view text, std::vector<uint32_t> &codepoints)
+    {
+        // 码点数不超过字节数
+        if (codepoints.size() < text.size())
+            codepoints.resize(text.size());
+        const auto *p = safe_reinterpret_cast<const unsigned char *>(text.data());
+        const auto *end = p + text.size();
+        uint32_t *out = codepoints.data();
+        while (p < end)
+        {
+            if (static_cast<size_t>(end - p) >= detail::UTF8_BLOCK &&
+                detail::ascii_block(p, out))
+            {
+                p += detail::UTF8_BLOCK;
+                out += detail::UTF8_BLOCK;
+                continue;
+            }
+            // NOTE: 混合块：逐字符，直到下一个可能的 ASCII 块
+            const auto *stop = std::min(end, p + detail::UTF8_BLOCK);
+            while (p < stop)
+            {
+                if (*p < 0x80)
+                {
+                    *out++ = *p++;
+                    continue;
+                }
+                uint32_t cp = 0;
+                const size_t n = detail::decode_one(p, end, cp);
+                if (n == 0)
+                    return false;
+                *out++ = cp;
+                p += n;
+            }
+        }
+        codepoints.resize(static_cast<size_t>(out - codepoints.data()));
+        return true;
+    }
+
+    /**
+     * NOTE: NFC 快速检查(保守)：返回 true 时文本一定已经是 NFC，可以跳过规范化；
+     * false 表示"可能不是"，需要完整规范化。
+     * 以下码点视为安全：< U+0300(ASCII/Latin-1/拉丁扩展，无组合符)、谚文音节、
+     * 以及 combining_class 为 0、没有规范分解、不会作为组合第二个字符、不在组合排除表中的码点。
+     */
+    inline bool is_nfc_quick(std::span<const uint32_t> codepoints) noexcept
+    {
+        for (const uint32_t cp : codepoints)
+        {
+            if (cp < 0x300) // NOLINTBEGIN
+                continue;
+            if ((cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0xAC00 && cp <= 0xD7A3))
+                continue; // CJK 统一表意文字 / 谚文音节
+            if (cp >= 0x1100 && cp <= 0x11FF)
+                return false; // 谚文字母，算法组合 // NOLINTEND
+            const auto *prop = utf8proc_get_property(static_cast<utf8proc_int32_t>(cp));
+            if (prop->combining_class != 0 || prop->comb_issecond != 0 ||
+                prop->comp_exclusion != 0)
+                return false;
+            if (prop->decomp_seqindex != UINT16_MAX && prop->decomp_type == 0)
+                return false; // 有规范分解(包括单字符分解)
+        }
+        return true;
+    }
+}; // namespace mcs::vulkan::font::utf8proc
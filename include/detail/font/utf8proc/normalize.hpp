@@ -2,11 +2,15 @@
 
 #include "../__utf8proc_import.hpp"
 #include "normalize_result.hpp"
+#include "decode_utf8.hpp"
 #include "../../utils/make_vk_exception.hpp"
 #include "../../utils/safe_reinterpret_cast.hpp"
+#include <cstdint>
 #include <print>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace mcs::vulkan::font::utf8proc
 {
@@ -53,6 +57,54 @@ namespace mcs::vulkan::font::utf8proc
         return normalize(safe_reinterpret_cast<const utf8proc_uint8_t *>(text.data()));
     }
 
+
+    /**
+     * NOTE: 写入调用方持有的 codepoints（复用容量），不经过 UTF-8 中间结果。
+     * utf8proc_decompose 分解 + utf8proc_normalize_utf32 原地组合 == NFC。
+     * 容量足够时不分配内存。
+     */
+    static constexpr std::span<const uint32_t> normalize_full(
+        std::string_view text, std::vector<uint32_t> &codepoints)
+    {
+        static_assert(sizeof(utf8proc_int32_t) == sizeof(uint32_t));
+        constexpr auto options =
+            static_cast<utf8proc_option_t>(UTF8PROC_STABLE | UTF8PROC_COMPOSE);
+        const auto *str = safe_reinterpret_cast<const utf8proc_uint8_t *>(text.data());
+        const auto len = static_cast<utf8proc_ssize_t>(text.size());
+
+        codepoints.resize(codepoints.capacity());
+        utf8proc_ssize_t count = 0;
+        while (true)
+        {
+            count = utf8proc_decompose(
+                str, len, safe_reinterpret_cast<utf8proc_int32_t *>(codepoints.data()),
+                static_cast<utf8proc_ssize_t>(codepoints.size()), options);
+            if (count < 0)
+                throw make_vk_exception("Normalization failed");
+            if (static_cast<size_t>(count) <= codepoints.size())
+                break;
+            codepoints.resize(static_cast<size_t>(count));
+        }
+        count = utf8proc_normalize_utf32(
+            safe_reinterpret_cast<utf8proc_int32_t *>(codepoints.data()), count, options);
+        if (count < 0)
+            throw make_vk_exception("Normalization failed");
+        codepoints.resize(static_cast<size_t>(count));
+        return codepoints;
+    }
+
+    /**
+     * NOTE: 快速路径：SIMD 解码后做 NFC quick check，已经是 NFC(绝大多数 ASCII/CJK 文本)
+     * 时直接返回解码结果，不调用 utf8proc；否则(或非法 UTF-8)走 normalize_full。
+     */
+    static constexpr std::span<const uint32_t> normalize(
+        std::string_view text, std::vector<uint32_t> &codepoints)
+    {
+        if (decode_utf8(text, codepoints) && is_nfc_quick(codepoints))
+            return codepoints;
+        return normalize_full(text, codepoints);
+    }
+
     static constexpr void print_normalized(const normalize_result &norm,
                                            const char8_t *raw_text)
     {
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::load
+{
+    /**
+     * NOTE: 在 thread_pool 上并行解码资源(图像、字体图集、字体文件)，按完成顺序分批取回:
+     * - submit(fn) 立即返回句柄(提交序号)，fn 在工作线程中执行并返回 T
+     * - take() 阻塞到至少一个结果就绪，然后取走所有已就绪的结果(最多 max 个)，
+     *   调用方可以一边等待剩余的解码，一边把这一批交给 GPU 上传(vma::upload_queue)
+     * - fn 抛出的异常在 take()/poll() 取到该结果时重新抛出
+     * submit/take/poll 只能由同一个池外线程调用；析构时等待已提交的任务结束。
+     */
+    template <typename T>
+    class decode_queue
+    {
+      public:
+        struct decoded // NOLINTBEGIN
+        {
+            size_t index; // submit() 返回的句柄
+            T value;
+        }; // NOLINTEND
+        static constexpr size_t ALL = std::numeric_limits<size_t>::max();
+
+        explicit decode_queue(thread_pool &pool) noexcept : pool_{&pool} {}
+        decode_queue(const decode_queue &) = delete;
+        decode_queue(decode_queue &&) = delete;
+        decode_queue &operator=(const decode_queue &) = delete;
+        decode_queue &operator=(decode_queue &&) = delete;
+        ~decode_queue() noexcept
+        {
+            std::unique_lock lock{mutex_};
+            cv_.wait(lock, [this] { return running_ == 0; });
+        }
+
+        template <typename F>
+            requires std::is_convertible_v<std::invoke_result_t<std::decay_t<F>>, T>
+        size_t submit(F &&decode)
+        {
+            const size_t index = submitted_++;
+            {
+                std::scoped_lock lock{mutex_};
+                ++running_;
+            }
+            auto task = [this, index, decode = std::forward<F>(decode)]() mutable {
+                slot done{.index = index, .value = std::nullopt, .error = nullptr};
+                try
+                {
+                    done.value.emplace(decode());
+                }
+                catch (...)
+                {
+                    done.error = std::current_exception();
+                }
+                // NOTE: 持锁通知，析构函数看到 running_ == 0 后 cv_ 才会被销毁
+                std::scoped_lock lock{mutex_};
+                ready_.emplace_back(std::move(done));
+                --running_;
+                cv_.notify_all();
+            };
+            (void)pool_->submit(std::move(task));
+            return index;
+        }
+
+        // NOTE: 没有未取走的任务时立即返回空
+        std::vector<decoded> take(size_t max = ALL)
+        {
+            std::unique_lock lock{mutex_};
+            cv_.wait(lock, [this] { return !ready_.empty() || running_ == 0; });
+            return drain(max);
+        }
+
+        // NOTE: 不阻塞，只取已就绪的结果
+        std::vector<decoded> poll(size_t max = ALL)
+        {
+            std::scoped_lock lock{mutex_};
+            return drain(max);
+        }
+
+        // NOTE: 已提交但尚未取走的数量
+        [[nodiscard]] size_t pending() const noexcept
+        {
+            return submitted_ - taken_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return pending() == 0;
+        }
+
+      private:
+        struct slot // NOLINTBEGIN
+        {
+            size_t index;
+            std::optional<T> value;
+            std::exception_ptr error;
+        }; // NOLINTEND
+
+        thread_pool *pool_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<slot> ready_;
+        size_t running_{0};
+        size_t submitted_{0};
+        size_t taken_{0};
+
+        // NOTE: 调用方持有 mutex_。失败的结果单独成批：排在最前时抛出，否则留到下一次
+        std::vector<decoded> drain(size_t max)
+        {
+            std::vector<decoded> batch;
+            if (!ready_.empty() && ready_.front().error)
+            {
+                auto error = std::move(ready_.front().error);
+                ready_.pop_front();
+                ++taken_;
+                std::rethrow_exception(error);
+            }
+            batch.reserve(std::min(max, ready_.size()));
+            while (!ready_.empty() && batch.size() < max && !ready_.front().error)
+            {
+                auto &front = ready_.front();
+                batch.emplace_back(decoded{.index = front.index,
+                                           .value = std::move(*front.value)});
+                ready_.pop_front();
+            }
+            taken_ += batch.size();
+            return batch;
+        }
+    };
+}; // namespace mcs::vulkan::load
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 
 namespace mcs::vulkan::load
 {
@@ -13,4 +15,13 @@ namespace mcs::vulkan::load
         { t.size() } noexcept -> std::convertible_to<std::size_t>;
     };
 
+    // NOTE: 预生成的一级 mip，offset 相对于所有级连续存放的数据块
+    struct image_level // NOLINTBEGIN
+    {
+        std::size_t offset;
+        std::size_t size;
+        uint32_t width;
+        uint32_t height;
+    }; // NOLINTEND
+
 }; // namespace mcs::vulkan::load
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../__ktx_import.hpp"
+#include "../__vulkan.hpp"
+#include "../utils/make_vk_exception.hpp"
+#include "../utils/mcs_assert.hpp"
+#include "../utils/unique_handle.hpp"
+
+#include "image_source.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mcs::vulkan::load
+{
+    /**
+     * NOTE: KTX2 纹理(libktx 读取)，数据已经是 GPU 格式，不需要解码。
+     * zstd/zlib 超压缩在加载时由 libktx 解压；Basis Universal 需要转码，不支持。
+     * data()/size() 为第 0 级、第 0 层的像素；all_data()/levels() 为整个 mip 链，
+     * create_texture_image::templateForKtx2 一次拷贝、每级一个区域上传，不解码也不 blit。
+     * 块压缩格式(BC/ETC2/ASTC)同样原样上传，是否可采样由设备决定。
+     */
+    struct ktx2_image
+    {
+        using texture_ptr = unique_handle<ktxTexture2 *, [](ktxTexture2 *value) noexcept {
+            ktxTexture2_Destroy(value);
+        }>;
+
+        ktx2_image() = default;
+        explicit ktx2_image(const char *filename)
+        {
+            ktxTexture2 *texture = nullptr;
+            if (ktxTexture2_CreateFromNamedFile(filename,
+                                                KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT,
+                                                &texture) != KTX_SUCCESS)
+                throw make_vk_exception("failed to load ktx2 texture!");
+            texture_ = texture_ptr{texture};
+            if (ktxTexture2_NeedsTranscoding(texture))
+                throw make_vk_exception("ktx2 texture needs basis transcoding!");
+
+            ktx_size_t offset = 0;
+            if (ktxTexture_GetImageOffset(ktxTexture(texture), 0, 0, 0, &offset) !=
+                KTX_SUCCESS)
+                throw make_vk_exception("failed to query ktx2 image offset!");
+            data_ = ktxTexture_GetData(ktxTexture(texture)) + offset;
+            size_ = ktxTexture_GetImageSize(ktxTexture(texture), 0);
+
+            // NOTE: 只取第 0 层、第 0 面；各级在 libktx 的数据块中已按块大小对齐
+            levels_.reserve(texture->numLevels);
+            for (uint32_t level = 0; level < texture->numLevels; ++level)
+            {
+                if (ktxTexture_GetImageOffset(ktxTexture(texture), level, 0, 0,
+                                              &offset) != KTX_SUCCESS)
+                    throw make_vk_exception("failed to query ktx2 level offset!");
+                levels_.emplace_back(image_level{
+                    .offset = offset,
+                    .size = ktxTexture_GetImageSize(ktxTexture(texture), level),
+                    .width = std::max(texture->baseWidth >> level, 1U),
+                    .height = std::max(texture->baseHeight >> level, 1U)});
+            }
+
+            MCS_ASSERT(texture->baseWidth != 0);
+            MCS_ASSERT(texture->baseHeight != 0);
+        }
+
+        [[nodiscard]] bool valid() const noexcept
+        {
+            return data_ != nullptr;
+        }
+        [[nodiscard]] int width() const noexcept
+        {
+            return static_cast<int>(texture_.get()->baseWidth);
+        }
+        [[nodiscard]] int height() const noexcept
+        {
+            return static_cast<int>(texture_.get()->baseHeight);
+        }
+        [[nodiscard]] int channels() const noexcept
+        {
+            return static_cast<int>(ktxTexture2_GetNumComponents(texture_.get()));
+        }
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return size_;
+        }
+        [[nodiscard]] const uint8_t *data() const noexcept
+        {
+            return data_;
+        }
+        // NOTE: 文件里记录的 VkFormat，建图时应使用它而不是固定的 R8G8B8A8
+        [[nodiscard]] VkFormat format() const noexcept
+        {
+            return static_cast<VkFormat>(texture_.get()->vkFormat);
+        }
+        [[nodiscard]] bool block_compressed() const noexcept
+        {
+            return texture_.get()->isCompressed;
+        }
+
+        [[nodiscard]] uint32_t level_count() const noexcept
+        {
+            return static_cast<uint32_t>(levels_.size());
+        }
+        [[nodiscard]] std::span<const image_level> levels() const noexcept
+        {
+            return levels_;
+        }
+        // NOTE: 所有级的数据，levels() 的 offset 相对于它
+        [[nodiscard]] std::span<const uint8_t> all_data() const noexcept
+        {
+            auto *texture = ktxTexture(texture_.get());
+            return {ktxTexture_GetData(texture), ktxTexture_GetDataSize(texture)};
+        }
+
+      private:
+        texture_ptr texture_;
+        const uint8_t *data_{nullptr};
+        std::size_t size_{0};
+        std::vector<image_level> levels_;
+    };
+
+    static_assert(image_source<ktx2_image>);
+
+}; // namespace mcs::vulkan::load
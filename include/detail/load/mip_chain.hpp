@@ -0,0 +1,522 @@
+#pragma once
+
+#include "image_source.hpp"
+#include "../utils/get_mip_levels.hpp"
+#include "../utils/mcs_assert.hpp"
+#include "../utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MCS_MIP_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MCS_MIP_NEON
+#endif
+
+namespace mcs::vulkan::load
+{
+    enum class mip_filter : uint8_t
+    {
+        eBox,   // 2x2 平均，最快
+        eKaiser // 8 tap Kaiser 窗 sinc，可分离，更锐利、摩尔纹更少
+    };
+
+    struct mip_options // NOLINTBEGIN
+    {
+        mip_filter filter = mip_filter::eBox;
+        // RGB 为 sRGB 编码(VK_FORMAT_*_SRGB 或按 sRGB 显示的 UNORM)：解码到线性空间再滤波
+        bool srgb = false;
+        // 数据已预乘 alpha；否则滤波时按 alpha 加权，透明像素的颜色不会渗到边缘
+        bool premultiplied = false;
+        // (0, 1) 时逐级缩放 alpha，保持 alpha > cutoff 的覆盖率(alpha test 的植被、文字)
+        float alpha_cutoff = 0.0F;
+        uint32_t max_levels = 0; // 0 为完整 mip 链
+    }; // NOLINTEND
+
+    namespace detail::mip
+    {
+        // NOTE: 一个像素(RGBA)一个 128 位寄存器
+#if defined(MCS_MIP_SSE2)
+        using vec4 = __m128;
+        inline vec4 load(const float *p) noexcept
+        {
+            return _mm_loadu_ps(p);
+        }
+        inline void store(float *p, vec4 v) noexcept
+        {
+            _mm_storeu_ps(p, v);
+        }
+        inline vec4 splat(float w) noexcept
+        {
+            return _mm_set1_ps(w);
+        }
+        inline vec4 add(vec4 a, vec4 b) noexcept
+        {
+            return _mm_add_ps(a, b);
+        }
+        inline vec4 mul(vec4 a, vec4 b) noexcept
+        {
+            return _mm_mul_ps(a, b);
+        }
+#elif defined(MCS_MIP_NEON)
+        using vec4 = float32x4_t;
+        inline vec4 load(const float *p) noexcept
+        {
+            return vld1q_f32(p);
+        }
+        inline void store(float *p, vec4 v) noexcept
+        {
+            vst1q_f32(p, v);
+        }
+        inline vec4 splat(float w) noexcept
+        {
+            return vdupq_n_f32(w);
+        }
+        inline vec4 add(vec4 a, vec4 b) noexcept
+        {
+            return vaddq_f32(a, b);
+        }
+        inline vec4 mul(vec4 a, vec4 b) noexcept
+        {
+            return vmulq_f32(a, b);
+        }
+#else
+        struct vec4 // NOLINTBEGIN
+        {
+            std::array<float, 4> v;
+        }; // NOLINTEND
+        inline vec4 load(const float *p) noexcept
+        {
+            return {{p[0], p[1], p[2], p[3]}};
+        }
+        inline void store(float *p, vec4 v) noexcept
+        {
+            std::copy(v.v.begin(), v.v.end(), p);
+        }
+        inline vec4 splat(float w) noexcept
+        {
+            return {{w, w, w, w}};
+        }
+        inline vec4 add(vec4 a, vec4 b) noexcept
+        {
+            for (size_t i = 0; i < 4; ++i)
+                a.v[i] += b.v[i];
+            return a;
+        }
+        inline vec4 mul(vec4 a, vec4 b) noexcept
+        {
+            for (size_t i = 0; i < 4; ++i)
+                a.v[i] *= b.v[i];
+            return a;
+        }
+#endif
+
+        constexpr size_t ROWS_PER_TASK = 32;
+        constexpr size_t KAISER_TAPS = 8;
+        constexpr size_t ENCODE_STEPS = 4096; // 线性 -> sRGB 查表精度
+
+        inline float srgb_to_linear(float c) noexcept
+        {
+            return c <= 0.04045F ? c / 12.92F : std::pow((c + 0.055F) / 1.055F, 2.4F);
+        }
+        inline float linear_to_srgb(float c) noexcept
+        {
+            return c <= 0.0031308F ? c * 12.92F
+                                   : (1.055F * std::pow(c, 1.0F / 2.4F)) - 0.055F;
+        }
+        inline const std::array<float, 256> &decode_table() noexcept
+        {
+            static const auto table = [] {
+                std::array<float, 256> t{};
+                for (size_t i = 0; i < t.size(); ++i)
+                    t[i] = srgb_to_linear(static_cast<float>(i) / 255.0F);
+                return t;
+            }();
+            return table;
+        }
+        inline const std::array<uint8_t, ENCODE_STEPS + 1> &encode_table() noexcept
+        {
+            static const auto table = [] {
+                std::array<uint8_t, ENCODE_STEPS + 1> t{};
+                for (size_t i = 0; i < t.size(); ++i)
+                    t[i] = static_cast<uint8_t>(std::lround(
+                        linear_to_srgb(static_cast<float>(i) / ENCODE_STEPS) * 255.0F));
+                return t;
+            }();
+            return table;
+        }
+
+        // NOTE: 中心在 2x + 0.5 的 8 个源像素，tap k 对应 2x + k - 3
+        inline const std::array<float, KAISER_TAPS> &kaiser_weights() noexcept
+        {
+            static const auto weights = [] {
+                constexpr double BETA = 4.0;
+                constexpr double RADIUS = KAISER_TAPS / 2.0;
+                const auto bessel_i0 = [](double x) {
+                    double sum = 1.0;
+                    double term = 1.0;
+                    for (int k = 1; k < 32; ++k)
+                    {
+                        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                        sum += term;
+                    }
+                    return sum;
+                };
+                std::array<float, KAISER_TAPS> w{};
+                double total = 0.0;
+                std::array<double, KAISER_TAPS> raw{};
+                for (size_t k = 0; k < KAISER_TAPS; ++k)
+                {
+                    const double d = static_cast<double>(k) - 3.5;
+                    const double t = d / 2.0 * std::numbers::pi;
+                    const double sinc = std::sin(t) / t;
+                    const double r = d / RADIUS;
+                    const double window =
+                        bessel_i0(BETA * std::sqrt(std::max(0.0, 1.0 - (r * r)))) /
+                        bessel_i0(BETA);
+                    raw[k] = sinc * window;
+                    total += raw[k];
+                }
+                for (size_t k = 0; k < KAISER_TAPS; ++k)
+                    w[k] = static_cast<float>(raw[k] / total);
+                return w;
+            }();
+            return weights;
+        }
+
+        // NOTE: fn(first, last) 处理 [first, last) 行，有线程池时按行分块并行
+        inline void for_rows(thread_pool *pool, size_t rows, auto &&fn)
+        {
+            if (pool == nullptr || rows <= ROWS_PER_TASK)
+            {
+                fn(size_t{0}, rows);
+                return;
+            }
+            const size_t tasks = (rows + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+            pool->for_each_index(tasks, [&](size_t task) {
+                const size_t first = task * ROWS_PER_TASK;
+                fn(first, std::min(rows, first + ROWS_PER_TASK));
+            });
+        }
+
+        struct level_image // NOLINTBEGIN
+        {
+            std::vector<float> texels; // 线性、预乘 alpha 的 RGBA
+            uint32_t width{0};
+            uint32_t height{0};
+
+            [[nodiscard]] const float *at(uint32_t x, uint32_t y) const noexcept
+            {
+                return &texels[((size_t{y} * width) + x) * 4];
+            }
+        }; // NOLINTEND
+    }; // namespace detail::mip
+
+    /**
+     * NOTE: CPU 生成 RGBA8 的 mip 链，替代 vkCmdBlitImage:
+     * - 不要求格式支持 SAMPLED_IMAGE_FILTER_LINEAR
+     * - 在线性、预乘 alpha 的浮点空间中滤波，sRGB 与非预乘数据也不会变暗、出黑边
+     * - 每一级都从上一级的浮点结果生成，只在输出时量化一次
+     * data()/levels() 与 ktx2_image::all_data()/levels() 相同，可直接交给
+     * create_texture_image::build(data, levels) 或 upload_queue::texture。
+     */
+    class mip_chain
+    {
+      public:
+        mip_chain() = default;
+        // NOTE: rgba8 为第 0 级，紧密排列；pool 非空时每一级按行分块并行
+        mip_chain(std::span<const uint8_t> rgba8, uint32_t width, uint32_t height,
+                  const mip_options &options = {}, thread_pool *pool = nullptr)
+        {
+            MCS_ASSERT(width > 0 && height > 0);
+            MCS_ASSERT(rgba8.size() == size_t{width} * height * 4);
+            const uint32_t full = get_mip_levels(width, height);
+            const uint32_t count =
+                options.max_levels == 0 ? full : std::min(options.max_levels, full);
+
+            size_t total = 0;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const uint32_t w = std::max(width >> i, 1U);
+                const uint32_t h = std::max(height >> i, 1U);
+                levels_.emplace_back(image_level{
+                    .offset = total, .size = size_t{w} * h * 4, .width = w, .height = h});
+                total += levels_.back().size;
+            }
+            data_.resize(total);
+            // 第 0 级原样保留
+            std::ranges::copy(rgba8, data_.begin());
+            if (count == 1)
+                return;
+
+            // NOTE: 第 0 级逐行解码，不展开成整张浮点图
+            const byte_rows base{.data = rgba8, .width = width, .options = &options};
+            const float coverage = cutoffEnabled(options)
+                                       ? this->coverage(0, options.alpha_cutoff)
+                                       : 0.0F;
+            level_image current;
+            for (uint32_t i = 1; i < count; ++i)
+            {
+                const uint32_t w = levels_[i - 1].width;
+                const uint32_t h = levels_[i - 1].height;
+                current = i == 1 ? downsample(base, w, h, options.filter, pool)
+                                 : downsample(float_rows{.image = &current}, w, h,
+                                              options.filter, pool);
+                const float scale = cutoffEnabled(options)
+                                        ? coverageScale(current, options.alpha_cutoff,
+                                                        coverage)
+                                        : 1.0F;
+                encode(current, options, scale,
+                       std::span{data_}.subspan(levels_[i].offset, levels_[i].size),
+                       pool);
+            }
+        }
+
+        [[nodiscard]] std::span<const uint8_t> data() const noexcept
+        {
+            return data_;
+        }
+        [[nodiscard]] std::span<const image_level> levels() const noexcept
+        {
+            return levels_;
+        }
+        [[nodiscard]] uint32_t level_count() const noexcept
+        {
+            return static_cast<uint32_t>(levels_.size());
+        }
+        [[nodiscard]] std::span<const uint8_t> level(uint32_t index) const noexcept
+        {
+            return std::span{data_}.subspan(levels_[index].offset, levels_[index].size);
+        }
+
+        // NOTE: 第 index 级中 alpha > cutoff 的比例，测试与调参用
+        [[nodiscard]] float coverage(uint32_t index, float cutoff) const noexcept
+        {
+            const auto texels = level(index);
+            const float threshold = cutoff * 255.0F;
+            size_t covered = 0;
+            for (size_t i = 3; i < texels.size(); i += 4)
+                covered += static_cast<float>(texels[i]) > threshold ? 1 : 0;
+            return static_cast<float>(covered) / static_cast<float>(texels.size() / 4);
+        }
+
+      private:
+        using level_image = detail::mip::level_image;
+        std::vector<uint8_t> data_;
+        std::vector<image_level> levels_;
+
+        static bool cutoffEnabled(const mip_options &options) noexcept
+        {
+            return options.alpha_cutoff > 0.0F && options.alpha_cutoff < 1.0F;
+        }
+
+        // NOTE: 行来源：row(y) 返回线性、预乘 alpha 的一行 RGBA 浮点
+        struct byte_rows // NOLINTBEGIN
+        {
+            std::span<const uint8_t> data;
+            uint32_t width;
+            const mip_options *options;
+
+            const float *row(uint32_t y, std::vector<float> &scratch) const
+            {
+                scratch.resize(size_t{width} * 4);
+                const auto &table = detail::mip::decode_table();
+                const uint8_t *src = &data[size_t{y} * width * 4];
+                for (size_t i = 0; i < scratch.size(); i += 4)
+                {
+                    const float a = static_cast<float>(src[i + 3]) / 255.0F;
+                    const float premul = options->premultiplied ? 1.0F : a;
+                    for (size_t c = 0; c < 3; ++c)
+                        scratch[i + c] =
+                            premul * (options->srgb ? table[src[i + c]]
+                                                    : static_cast<float>(src[i + c]) /
+                                                          255.0F);
+                    scratch[i + 3] = a;
+                }
+                return scratch.data();
+            }
+        }; // NOLINTEND
+        struct float_rows // NOLINTBEGIN
+        {
+            const level_image *image;
+
+            const float *row(uint32_t y, std::vector<float> & /*scratch*/) const noexcept
+            {
+                return image->at(0, y);
+            }
+        }; // NOLINTEND
+
+        template <typename Rows>
+        static level_image downsample(const Rows &src, uint32_t width, uint32_t height,
+                                      mip_filter filter, thread_pool *pool)
+        {
+            return filter == mip_filter::eKaiser
+                       ? downsampleKaiser(src, width, height, pool)
+                       : downsampleBox(src, width, height, pool);
+        }
+
+        template <typename Rows>
+        static level_image downsampleBox(const Rows &src, uint32_t width,
+                                         uint32_t height, thread_pool *pool)
+        {
+            namespace m = detail::mip;
+            const uint32_t w = std::max(width / 2, 1U);
+            const uint32_t h = std::max(height / 2, 1U);
+            level_image dst{
+                .texels = std::vector<float>(size_t{w} * h * 4), .width = w, .height = h};
+            const m::vec4 quarter = m::splat(0.25F);
+            m::for_rows(pool, h, [&](size_t first, size_t last) {
+                std::vector<float> scratch0;
+                std::vector<float> scratch1;
+                for (auto y = static_cast<uint32_t>(first); y < last; ++y)
+                {
+                    const uint32_t y0 = std::min(2 * y, height - 1);
+                    const uint32_t y1 = std::min((2 * y) + 1, height - 1);
+                    const float *r0 = src.row(y0, scratch0);
+                    const float *r1 = src.row(y1, scratch1);
+                    float *out = &dst.texels[size_t{y} * w * 4];
+                    for (uint32_t x = 0; x < w; ++x, out += 4)
+                    {
+                        const size_t x0 = size_t{std::min(2 * x, width - 1)} * 4;
+                        const size_t x1 = size_t{std::min((2 * x) + 1, width - 1)} * 4;
+                        const m::vec4 top = m::add(m::load(r0 + x0), m::load(r0 + x1));
+                        const m::vec4 bottom = m::add(m::load(r1 + x0), m::load(r1 + x1));
+                        m::store(out, m::mul(m::add(top, bottom), quarter));
+                    }
+                }
+            });
+            return dst;
+        }
+
+        // NOTE: 先水平再垂直，边界按钳位处理
+        template <typename Rows>
+        static level_image downsampleKaiser(const Rows &src, uint32_t width,
+                                            uint32_t height, thread_pool *pool)
+        {
+            namespace m = detail::mip;
+            const auto &weights = m::kaiser_weights();
+            std::array<float, m::KAISER_TAPS> w{};
+            std::ranges::copy(weights, w.begin());
+            const auto clamp_tap = [](uint32_t i, size_t k, uint32_t size) {
+                const auto s = static_cast<int64_t>(2 * i) + static_cast<int64_t>(k) - 3;
+                return static_cast<uint32_t>(std::clamp<int64_t>(s, 0, size - 1));
+            };
+
+            const uint32_t dw = std::max(width / 2, 1U);
+            const uint32_t dh = std::max(height / 2, 1U);
+            level_image tmp{.texels = std::vector<float>(size_t{dw} * height * 4),
+                            .width = dw,
+                            .height = height};
+            m::for_rows(pool, height, [&](size_t first, size_t last) {
+                std::vector<float> scratch;
+                for (auto y = static_cast<uint32_t>(first); y < last; ++y)
+                {
+                    const float *row = src.row(y, scratch);
+                    float *out = &tmp.texels[size_t{y} * dw * 4];
+                    for (uint32_t x = 0; x < dw; ++x, out += 4)
+                    {
+                        m::vec4 acc = m::splat(0.0F);
+                        for (size_t k = 0; k < m::KAISER_TAPS; ++k)
+                        {
+                            const size_t tap = size_t{clamp_tap(x, k, width)} * 4;
+                            acc = m::add(acc, m::mul(m::load(row + tap), m::splat(w[k])));
+                        }
+                        m::store(out, acc);
+                    }
+                }
+            });
+
+            level_image dst{.texels = std::vector<float>(size_t{dw} * dh * 4),
+                            .width = dw,
+                            .height = dh};
+            m::for_rows(pool, dh, [&](size_t first, size_t last) {
+                std::array<const float *, m::KAISER_TAPS> rows{};
+                for (auto y = static_cast<uint32_t>(first); y < last; ++y)
+                {
+                    for (size_t k = 0; k < m::KAISER_TAPS; ++k)
+                        rows[k] = tmp.at(0, clamp_tap(y, k, height));
+                    float *out = &dst.texels[size_t{y} * dw * 4];
+                    for (size_t x = 0; x < size_t{dw} * 4; x += 4)
+                    {
+                        m::vec4 acc = m::splat(0.0F);
+                        for (size_t k = 0; k < m::KAISER_TAPS; ++k)
+                        {
+                            const m::vec4 tap = m::load(rows[k] + x);
+                            acc = m::add(acc, m::mul(tap, m::splat(w[k])));
+                        }
+                        m::store(out + x, acc);
+                    }
+                }
+            });
+            return dst;
+        }
+
+        static float coverageOf(const level_image &img, float cutoff,
+                                float scale) noexcept
+        {
+            size_t covered = 0;
+            for (size_t i = 3; i < img.texels.size(); i += 4)
+                covered += img.texels[i] * scale > cutoff ? 1 : 0;
+            const size_t pixels = img.texels.size() / 4;
+            return static_cast<float>(covered) / static_cast<float>(pixels);
+        }
+
+        // NOTE: 二分查找 alpha 的缩放，使本级覆盖率接近第 0 级(Castaño 的做法)
+        static float coverageScale(const level_image &img, float cutoff,
+                                   float target) noexcept
+        {
+            float lo = 0.0F;
+            float hi = 4.0F;
+            for (int i = 0; i < 16; ++i)
+            {
+                const float mid = (lo + hi) / 2;
+                (coverageOf(img, cutoff, mid) < target ? lo : hi) = mid;
+            }
+            return (lo + hi) / 2;
+        }
+
+        static void encode(const level_image &img, const mip_options &options,
+                           float alpha_scale, std::span<uint8_t> out, thread_pool *pool)
+        {
+            namespace m = detail::mip;
+            const auto &table = m::encode_table();
+            const auto to_unorm = [](float v) {
+                return static_cast<uint8_t>((std::clamp(v, 0.0F, 1.0F) * 255.0F) + 0.5F);
+            };
+            const auto to_srgb = [&](float v) {
+                const float steps = std::clamp(v, 0.0F, 1.0F) * m::ENCODE_STEPS;
+                return table[static_cast<size_t>(steps + 0.5F)];
+            };
+            m::for_rows(pool, img.height, [&](size_t first, size_t last) {
+                const size_t begin = first * img.width * 4;
+                const size_t end = last * img.width * 4;
+                for (size_t i = begin; i < end; i += 4)
+                {
+                    const float a = std::max(img.texels[i + 3], 0.0F);
+                    const float scaled = std::min(a * alpha_scale, 1.0F);
+                    // 预乘数据随 alpha 一起缩放；非预乘数据还原颜色
+                    float color_scale = options.premultiplied ? 1.0F : 0.0F;
+                    if (a > 0.0F)
+                        color_scale = options.premultiplied ? scaled / a : 1.0F / a;
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        float v = img.texels[i + c] * color_scale;
+                        if (options.premultiplied)
+                            v = std::min(v, scaled);
+                        out[i + c] = options.srgb ? to_srgb(v) : to_unorm(v);
+                    }
+                    out[i + 3] = to_unorm(scaled);
+                }
+            });
+        }
+    };
+}; // namespace mcs::vulkan::load
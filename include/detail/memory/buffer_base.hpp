@@ -1,7 +1,9 @@
 #pragma once
 
 #include "../LogicalDevice.hpp"
+#include "device_memory_arena.hpp"
 #include <cassert>
+#include <utility>
 
 namespace mcs::vulkan::memory
 {
@@ -14,6 +16,15 @@ namespace mcs::vulkan::memory
         {
             assert(device_ != nullptr && buffer_ != nullptr && bufferMemory_ != nullptr);
         }
+        // NOTE: 内存来自 arena 的子分配，销毁时归还给 arena
+        constexpr buffer_base(const LogicalDevice &device, VkBuffer buffer,
+                              device_memory_arena &arena,
+                              const arena_allocation &allocation) noexcept
+            : device_{&device}, buffer_{buffer}, bufferMemory_{allocation.memory},
+              arena_{&arena}, allocation_{allocation}
+        {
+            assert(device_ != nullptr && buffer_ != nullptr && bufferMemory_ != nullptr);
+        }
         constexpr ~buffer_base() noexcept
         {
             destroy();
@@ -24,7 +35,9 @@ namespace mcs::vulkan::memory
         constexpr buffer_base(buffer_base &&other) noexcept
             : device_{std::exchange(other.device_, nullptr)},
               buffer_{std::exchange(other.buffer_, nullptr)},
-              bufferMemory_{std::exchange(other.bufferMemory_, nullptr)}
+              bufferMemory_{std::exchange(other.bufferMemory_, nullptr)},
+              arena_{std::exchange(other.arena_, nullptr)},
+              allocation_{other.allocation_}
         {
         }
 
@@ -32,14 +45,12 @@ namespace mcs::vulkan::memory
         {
             if (&other != this)
             {
-                if (device_ != nullptr)
-                {
-                    device_->freeMemory(bufferMemory_, device_->allocator());
-                    device_->destroyBuffer(buffer_, device_->allocator());
-                }
+                destroy();
                 device_ = std::exchange(other.device_, nullptr);
                 buffer_ = std::exchange(other.buffer_, nullptr);
                 bufferMemory_ = std::exchange(other.bufferMemory_, nullptr);
+                arena_ = std::exchange(other.arena_, nullptr);
+                allocation_ = other.allocation_;
             }
             return *this;
         }
@@ -52,6 +63,11 @@ namespace mcs::vulkan::memory
         {
             return bufferMemory_;
         }
+        // NOTE: 子分配时为 bufferMemory() 内的偏移，独立分配时为 0
+        [[nodiscard]] constexpr VkDeviceSize memoryOffset() const noexcept
+        {
+            return arena_ != nullptr ? allocation_.offset : 0;
+        }
 
         [[nodiscard]] constexpr auto *device() const noexcept
         {
@@ -65,22 +81,38 @@ namespace mcs::vulkan::memory
         {
             if (device_ != nullptr)
             {
-                device_->freeMemory(bufferMemory_, device_->allocator());
-                device_->destroyBuffer(buffer_, device_->allocator());
+                if (arena_ != nullptr)
+                {
+                    device_->destroyBuffer(buffer_, device_->allocator());
+                    std::exchange(arena_, nullptr)->free(allocation_);
+                }
+                else
+                {
+                    device_->freeMemory(bufferMemory_, device_->allocator());
+                    device_->destroyBuffer(buffer_, device_->allocator());
+                }
                 device_ = nullptr;
                 buffer_ = nullptr;
                 bufferMemory_ = nullptr;
             }
         }
+        // NOTE: 子分配的内存由 arena 持久映射，map/unmap 不再调用 vkMapMemory
         // NOLINTNEXTLINE
         [[nodiscard]] constexpr void *map(size_t size, VkMemoryMapFlags flags) const
         {
+            if (arena_ != nullptr)
+            {
+                assert(allocation_.mapped != nullptr && size <= allocation_.size);
+                return allocation_.mapped;
+            }
             void *data; // NOLINT
             device_->mapMemory(bufferMemory_, 0, size, flags, &data);
             return data;
         }
         constexpr void unmap() const noexcept
         {
+            if (arena_ != nullptr)
+                return;
             device_->unmapMemory(bufferMemory_);
         }
 
@@ -88,5 +120,7 @@ namespace mcs::vulkan::memory
         const LogicalDevice *device_{};
         VkBuffer buffer_{};
         VkDeviceMemory bufferMemory_{};
+        device_memory_arena *arena_{};
+        arena_allocation allocation_{};
     };
 }; // namespace mcs::vulkan::memory
\ No newline at end of file
@@ -5,7 +5,10 @@
 #include "../tool/pNext.hpp"
 #include "../tool/Flags.hpp"
 #include "memory_allocate_info.hpp"
+#include "device_memory_arena.hpp"
+#include "../utils/make_vk_exception.hpp"
 #include <functional>
+#include <optional>
 #include <vector>
 
 namespace mcs::vulkan::memory
@@ -91,6 +94,38 @@ namespace mcs::vulkan::memory
                 throw;
             }
         }
+        // NOTE: 从 arena 子分配。genMemoryAllocateInfo 只用于选择内存类型
+        [[nodiscard]] buffer_base build(device_memory_arena &arena) const
+        {
+            const LogicalDevice &device = arena.device();
+            const VkBufferCreateInfo createInfo = createInfo_();
+            if ((createInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) != 0 &&
+                !arena.deviceAddress())
+                throw make_vk_exception(
+                    "device address buffer needs an arena with DEVICE_ADDRESS_BIT");
+            VkBuffer buffer = nullptr;
+            std::optional<arena_allocation> allocation;
+            try
+            {
+                buffer = device.createBuffer(createInfo, device.allocator());
+                const VkMemoryRequirements requirements =
+                    device.getBufferMemoryRequirements(buffer);
+                const memory_allocate_info genAllocateInfo =
+                    genMemoryAllocateInfo_(requirements, arena.memoryProperties());
+                allocation = arena.allocate(requirements, genAllocateInfo.memoryTypeIndex,
+                                            resource_kind::eLinear);
+                device.bindBufferMemory(buffer, allocation->memory, allocation->offset);
+                return buffer_base{device, buffer, arena, *allocation};
+            }
+            catch (...)
+            {
+                if (allocation.has_value())
+                    arena.free(*allocation);
+                if (buffer != nullptr)
+                    device.destroyBuffer(buffer, device.allocator());
+                throw;
+            }
+        }
         constexpr create_buffer() noexcept : createInfo_{} {}
         constexpr create_buffer(create_info createInfo,
                                 GenMemoryAllocateInfo genMemoryAllocateInfo) noexcept
@@ -4,7 +4,9 @@
 #include "../tool/flags.hpp"
 #include "../ImageView.hpp"
 #include "memory_allocate_info.hpp"
+#include "device_memory_arena.hpp"
 #include <functional>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -155,6 +157,36 @@ namespace mcs::vulkan::memory
                 throw;
             }
         }
+        // NOTE: 从 arena 子分配。genMemoryAllocateInfo 只用于选择内存类型
+        [[nodiscard]] image_base build(device_memory_arena &arena) const
+        {
+            const LogicalDevice &device = arena.device();
+            const VkImageCreateInfo createInfo = createInfo_();
+            VkImage image = nullptr;
+            std::optional<arena_allocation> allocation;
+            try
+            {
+                image = device.createImage(createInfo, device.allocator());
+                const VkMemoryRequirements requirements =
+                    device.getImageMemoryRequirements(image);
+                const memory_allocate_info genAllocateInfo =
+                    genMemoryAllocateInfo_(requirements, arena.memoryProperties());
+                allocation = arena.allocate(requirements, genAllocateInfo.memoryTypeIndex,
+                                            createInfo.tiling == VK_IMAGE_TILING_OPTIMAL
+                                                ? resource_kind::eOptimal
+                                                : resource_kind::eLinear);
+                device.bindImageMemory(image, allocation->memory, allocation->offset);
+                return {device, image, arena, *allocation};
+            }
+            catch (...)
+            {
+                if (allocation.has_value())
+                    arena.free(*allocation);
+                if (image != nullptr)
+                    device.destroyImage(image, device.allocator());
+                throw;
+            }
+        }
         constexpr VkImageView buildRawView(const LogicalDevice &device,
                                            VkImage image) const
         {
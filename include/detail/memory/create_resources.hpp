@@ -16,5 +16,12 @@ namespace mcs::vulkan::memory
             VkImageView imageView = create_image::buildRawView(device, base.image());
             return {std::move(base), imageView};
         }
+        [[nodiscard]] resource build(device_memory_arena &arena) const
+        {
+            image_base base = create_image::build(arena);
+            VkImageView imageView =
+                create_image::buildRawView(arena.device(), base.image());
+            return {std::move(base), imageView};
+        }
     };
 }; // namespace mcs::vulkan::memory
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "create_buffer.hpp"
 #include "../tool/pNext.hpp"
 #include "find_memory_type_index.hpp"
+#include "gen_memory_allocate_info.hpp"
 
 namespace mcs::vulkan::memory
 {
@@ -31,4 +32,12 @@ namespace mcs::vulkan::memory
             }}
             .build(device);
     };
+    // NOTE: 从 arena 子分配，SHADER_DEVICE_ADDRESS 由 arena 的 allocateFlags 负责
+    static constexpr auto create_simple_buffer(device_memory_arena &arena,
+                                               create_buffer::create_info info,
+                                               VkMemoryPropertyFlags properties) // NOLINT
+    {
+        return create_buffer{std::move(info), gen_memory_allocate_info(properties)}
+            .build(arena);
+    }
 }; // namespace mcs::vulkan::memory
\ No newline at end of file
@@ -0,0 +1,281 @@
+#pragma once
+
+#include "tlsf_allocator.hpp"
+#include "../LogicalDevice.hpp"
+#include "../tool/sType.hpp"
+#include "../tool/Flags.hpp"
+#include "../utils/mcs_assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mcs::vulkan::memory
+{
+    // NOTE: bufferImageGranularity > 1 时线性资源与最优排布的图像放在不同的块里，
+    //  同一块内不会出现两类资源相邻在同一页上
+    enum class resource_kind : uint8_t
+    {
+        eLinear,  // 缓冲区、VK_IMAGE_TILING_LINEAR 的图像
+        eOptimal, // VK_IMAGE_TILING_OPTIMAL 的图像
+    };
+
+    struct arena_allocation // NOLINTBEGIN
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        void *mapped; // 块是 HOST_VISIBLE 时持久映射，指向 offset 处；否则为空
+        uint32_t pool;
+        uint32_t block;
+        tlsf_allocator::node_type node;
+    }; // NOLINTEND
+
+    /**
+     * NOTE: 非 VMA 路径的设备内存子分配器。按 (内存类型, resource_kind) 分池，
+     * 每个池持有若干大块 VkDeviceMemory，块内用 tlsf_allocator 管理偏移:
+     * - 大多数资源不再调用 vkAllocateMemory，只在块耗尽时新建块
+     * - 超过常规块大小(blockSize，小堆上为堆的 1/8)的请求独占一个块，释放后立即归还
+     * - HOST_VISIBLE 的块创建时整体映射，map() 直接返回块内地址
+     * - 每个池最多保留一个空块，其余空块立即归还驱动
+     * 资源持有指向 arena 的指针，arena 必须比从它分配的资源活得久。不是线程安全的。
+     */
+    class device_memory_arena
+    {
+      public:
+        static constexpr auto DEFAULT_BLOCK_SIZE = VkDeviceSize{64} << 20U; // 64 MiB
+
+        struct create_info // NOLINTBEGIN
+        {
+            VkDeviceSize blockSize{DEFAULT_BLOCK_SIZE};
+            // 所有块共用。缓冲区带 SHADER_DEVICE_ADDRESS 时需要 DEVICE_ADDRESS_BIT
+            tool::Flags<VkMemoryAllocateFlagBits> allocateFlags;
+        }; // NOLINTEND
+        struct statistics // NOLINTBEGIN
+        {
+            uint32_t blockCount;
+            uint32_t allocationCount;
+            uint32_t freeRegionCount;
+            VkDeviceSize blockBytes;
+            VkDeviceSize usedBytes;
+            VkDeviceSize largestFreeRegion;
+            uint64_t deviceAllocations; // 累计 vkAllocateMemory 次数
+
+            // 0 表示空闲空间连成一片；越接近 1，空闲空间越碎
+            [[nodiscard]] double fragmentation() const noexcept
+            {
+                const VkDeviceSize freeBytes = blockBytes - usedBytes;
+                if (freeBytes == 0)
+                    return 0.0;
+                return 1.0 - (static_cast<double>(largestFreeRegion) /
+                              static_cast<double>(freeBytes));
+            }
+        }; // NOLINTEND
+
+        device_memory_arena(const LogicalDevice &device, create_info createInfo)
+            : device_{&device}, createInfo_{createInfo},
+              memoryProperties_{device.physicalDevice()->getMemoryProperties()}
+        {
+            MCS_ASSERT(createInfo_.blockSize > 0);
+            const VkPhysicalDeviceLimits limits =
+                device.physicalDevice()->getProperties().limits;
+            bufferImageGranularity_ = limits.bufferImageGranularity;
+            nonCoherentAtomSize_ = limits.nonCoherentAtomSize;
+        }
+        device_memory_arena(const device_memory_arena &) = delete;
+        device_memory_arena(device_memory_arena &&) = delete;
+        device_memory_arena &operator=(const device_memory_arena &) = delete;
+        device_memory_arena &operator=(device_memory_arena &&) = delete;
+        ~device_memory_arena() noexcept
+        {
+            for (auto &pool : pools_)
+                for (auto &block : pool)
+                    releaseBlock(block);
+        }
+
+        [[nodiscard]] arena_allocation allocate(const VkMemoryRequirements &requirements,
+                                                uint32_t memoryTypeIndex,
+                                                resource_kind kind)
+        {
+            MCS_ASSERT(memoryTypeIndex < memoryProperties_.memoryTypeCount);
+            const auto poolIndex = static_cast<uint32_t>(
+                (memoryTypeIndex * 2) +
+                (bufferImageGranularity_ > 1 && kind == resource_kind::eOptimal ? 1 : 0));
+            const VkMemoryPropertyFlags flags =
+                memoryProperties_.memoryTypes[memoryTypeIndex].propertyFlags;
+            VkDeviceSize alignment = requirements.alignment;
+            // NOTE: 非 coherent 的映射内存按 nonCoherentAtomSize 对齐，flush 时不会越界
+            if ((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0 &&
+                (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
+                alignment = std::max(alignment, nonCoherentAtomSize_);
+
+            auto &pool = pools_[poolIndex];
+            for (uint32_t i = 0; i < static_cast<uint32_t>(pool.size()); ++i)
+            {
+                if (pool[i].memory == nullptr)
+                    continue;
+                if (auto range = pool[i].allocator.allocate(requirements.size, alignment))
+                    return makeAllocation(poolIndex, i, *range);
+            }
+
+            const uint32_t blockIndex =
+                createBlock(poolIndex, memoryTypeIndex, requirements.size + alignment);
+            const auto range =
+                pool[blockIndex].allocator.allocate(requirements.size, alignment);
+            MCS_ASSERT(range.has_value());
+            return makeAllocation(poolIndex, blockIndex, *range);
+        }
+
+        void free(const arena_allocation &allocation) noexcept
+        {
+            auto &pool = pools_[allocation.pool];
+            auto &block = pool[allocation.block];
+            MCS_ASSERT(block.memory == allocation.memory);
+            block.allocator.free(allocation.node);
+            if (!block.allocator.empty())
+                return;
+            // NOTE: 独占块或池里还有别的空块时归还，否则留作下次分配
+            const bool otherEmpty = std::ranges::any_of(pool, [&](const auto &other) {
+                return &other != &block && other.memory != nullptr &&
+                       other.allocator.empty();
+            });
+            if (otherEmpty || block.dedicated)
+                releaseBlock(block);
+        }
+
+        [[nodiscard]] statistics stats() const noexcept
+        {
+            statistics result{.deviceAllocations = deviceAllocations_};
+            for (const auto &pool : pools_)
+                for (const auto &block : pool)
+                {
+                    if (block.memory == nullptr)
+                        continue;
+                    const auto blockStats = block.allocator.stats();
+                    ++result.blockCount;
+                    result.allocationCount += blockStats.allocationCount;
+                    result.freeRegionCount += blockStats.freeRegionCount;
+                    result.blockBytes += blockStats.capacity;
+                    result.usedBytes += blockStats.usedBytes;
+                    result.largestFreeRegion =
+                        std::max(result.largestFreeRegion, blockStats.largestFreeRegion);
+                }
+            return result;
+        }
+
+        [[nodiscard]] const LogicalDevice &device() const noexcept
+        {
+            return *device_;
+        }
+        [[nodiscard]] const VkPhysicalDeviceMemoryProperties &memoryProperties()
+            const noexcept
+        {
+            return memoryProperties_;
+        }
+        [[nodiscard]] bool deviceAddress() const noexcept
+        {
+            return (createInfo_.allocateFlags & VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT) !=
+                   0;
+        }
+
+      private:
+        struct block_type // NOLINTBEGIN
+        {
+            VkDeviceMemory memory{};
+            tlsf_allocator allocator;
+            void *mapped{};
+            bool dedicated{false}; // 为超出常规块大小的单个请求创建
+        }; // NOLINTEND
+
+        const LogicalDevice *device_;
+        create_info createInfo_;
+        VkPhysicalDeviceMemoryProperties memoryProperties_;
+        VkDeviceSize bufferImageGranularity_{1};
+        VkDeviceSize nonCoherentAtomSize_{1};
+        uint64_t deviceAllocations_{0};
+        std::array<std::vector<block_type>, size_t{VK_MAX_MEMORY_TYPES} * 2> pools_{};
+
+        [[nodiscard]] arena_allocation makeAllocation(
+            uint32_t pool, uint32_t block,
+            const tlsf_allocator::allocation &range) const noexcept
+        {
+            const auto &owner = pools_[pool][block];
+            return {.memory = owner.memory,
+                    .offset = range.offset,
+                    .size = range.size,
+                    .mapped = owner.mapped != nullptr
+                                  ? static_cast<std::byte *>(owner.mapped) + range.offset
+                                  : nullptr,
+                    .pool = pool,
+                    .block = block,
+                    .node = range.node};
+        }
+
+        // NOTE: 小堆上按堆大小的 1/8 建块，避免一个块占满整个堆
+        [[nodiscard]] uint32_t createBlock(uint32_t poolIndex, uint32_t memoryTypeIndex,
+                                           VkDeviceSize minSize)
+        {
+            const auto &type = memoryProperties_.memoryTypes[memoryTypeIndex];
+            const VkDeviceSize heapSize =
+                memoryProperties_.memoryHeaps[type.heapIndex].size;
+            const VkDeviceSize regularSize =
+                std::min(createInfo_.blockSize, heapSize / 8);
+            const VkDeviceSize blockSize = std::max(regularSize, minSize);
+
+            // NOTE: 先准备好位置和元数据，vkAllocateMemory 之后不再有会抛出的操作
+            auto &pool = pools_[poolIndex];
+            auto slot =
+                std::ranges::find(pool, VkDeviceMemory{nullptr}, &block_type::memory);
+            if (slot == pool.end())
+            {
+                pool.reserve(pool.size() + 1);
+                slot = pool.end();
+            }
+
+            const VkMemoryAllocateFlagsInfo flagsInfo{
+                .sType = tool::sType<VkMemoryAllocateFlagsInfo>(),
+                .flags = createInfo_.allocateFlags};
+            const VkMemoryAllocateInfo allocateInfo{
+                .sType = tool::sType<VkMemoryAllocateInfo>(),
+                .pNext = createInfo_.allocateFlags != 0 ? &flagsInfo : nullptr,
+                .allocationSize = blockSize,
+                .memoryTypeIndex = memoryTypeIndex};
+            block_type block{.allocator = tlsf_allocator{blockSize},
+                             .dedicated = minSize > regularSize};
+            block.memory = device_->allocateMemory(allocateInfo, device_->allocator());
+            ++deviceAllocations_;
+            if ((type.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0)
+            {
+                try
+                {
+                    device_->mapMemory(block.memory, 0, VK_WHOLE_SIZE, 0, &block.mapped);
+                }
+                catch (...)
+                {
+                    device_->freeMemory(block.memory, device_->allocator());
+                    throw;
+                }
+            }
+
+            if (slot != pool.end())
+            {
+                *slot = std::move(block);
+                return static_cast<uint32_t>(slot - pool.begin());
+            }
+            pool.emplace_back(std::move(block));
+            return static_cast<uint32_t>(pool.size() - 1);
+        }
+
+        void releaseBlock(block_type &block) noexcept
+        {
+            if (block.memory == nullptr)
+                return;
+            if (block.mapped != nullptr)
+                device_->unmapMemory(block.memory);
+            device_->freeMemory(block.memory, device_->allocator());
+            block = {};
+        }
+    };
+}; // namespace mcs::vulkan::memory
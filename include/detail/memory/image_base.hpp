@@ -1,7 +1,9 @@
 #pragma once
 
 #include "../LogicalDevice.hpp"
+#include "device_memory_arena.hpp"
 #include <cassert>
+#include <utility>
 
 namespace mcs::vulkan::memory
 {
@@ -14,6 +16,15 @@ namespace mcs::vulkan::memory
         {
             assert(device_ != nullptr && image_ != nullptr && imageMemory_ != nullptr);
         }
+        // NOTE: 内存来自 arena 的子分配，销毁时归还给 arena
+        constexpr image_base(const LogicalDevice &device, VkImage image,
+                             device_memory_arena &arena,
+                             const arena_allocation &allocation) noexcept
+            : device_{&device}, image_{image}, imageMemory_{allocation.memory},
+              arena_{&arena}, allocation_{allocation}
+        {
+            assert(device_ != nullptr && image_ != nullptr && imageMemory_ != nullptr);
+        }
         constexpr ~image_base() noexcept
         {
             destroy();
@@ -24,7 +35,9 @@ namespace mcs::vulkan::memory
         constexpr image_base(image_base &&other) noexcept
             : device_{std::exchange(other.device_, nullptr)},
               image_{std::exchange(other.image_, nullptr)},
-              imageMemory_{std::exchange(other.imageMemory_, nullptr)}
+              imageMemory_{std::exchange(other.imageMemory_, nullptr)},
+              arena_{std::exchange(other.arena_, nullptr)},
+              allocation_{other.allocation_}
         {
         }
 
@@ -32,14 +45,12 @@ namespace mcs::vulkan::memory
         {
             if (&other != this)
             {
-                if (device_ != nullptr)
-                {
-                    device_->freeMemory(imageMemory_, device_->allocator());
-                    device_->destroyImage(image_, device_->allocator());
-                }
+                destroy();
                 device_ = std::exchange(other.device_, nullptr);
                 image_ = std::exchange(other.image_, nullptr);
                 imageMemory_ = std::exchange(other.imageMemory_, nullptr);
+                arena_ = std::exchange(other.arena_, nullptr);
+                allocation_ = other.allocation_;
             }
             return *this;
         }
@@ -52,6 +63,11 @@ namespace mcs::vulkan::memory
         {
             return imageMemory_;
         }
+        // NOTE: 子分配时为 imageMemory() 内的偏移，独立分配时为 0
+        [[nodiscard]] constexpr VkDeviceSize memoryOffset() const noexcept
+        {
+            return arena_ != nullptr ? allocation_.offset : 0;
+        }
 
         [[nodiscard]] constexpr auto *device() const noexcept
         {
@@ -65,8 +81,16 @@ namespace mcs::vulkan::memory
         {
             if (device_ != nullptr)
             {
-                device_->freeMemory(imageMemory_, device_->allocator());
-                device_->destroyImage(image_, device_->allocator());
+                if (arena_ != nullptr)
+                {
+                    device_->destroyImage(image_, device_->allocator());
+                    std::exchange(arena_, nullptr)->free(allocation_);
+                }
+                else
+                {
+                    device_->freeMemory(imageMemory_, device_->allocator());
+                    device_->destroyImage(image_, device_->allocator());
+                }
                 device_ = nullptr;
                 image_ = nullptr;
                 imageMemory_ = nullptr;
@@ -77,5 +101,7 @@ namespace mcs::vulkan::memory
         const LogicalDevice *device_{};
         VkImage image_{};
         VkDeviceMemory imageMemory_{};
+        device_memory_arena *arena_{};
+        arena_allocation allocation_{};
     };
 }; // namespace mcs::vulkan::memory
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "../utils/mcs_assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace mcs::vulkan::memory
+{
+    /**
+     * NOTE: TLSF(Two-Level Segregated Fit)：只管理 [0, capacity) 的偏移，不接触真实内存。
+     * - 一级按 2 的幂分档，二级每档再分 16 份；两级位图定位非空空闲链表，分配/释放 O(1)
+     * - 释放时与物理相邻的空闲块立即合并，不存在相邻的两个空闲块
+     * - 对齐：按 size + alignment - 1 查找，前部的填充拆成独立的空闲块
+     */
+    class tlsf_allocator
+    {
+      public:
+        using size_type = uint64_t;
+        using node_type = uint32_t;
+        static constexpr node_type INVALID_NODE = (std::numeric_limits<node_type>::max)();
+
+        struct allocation // NOLINTBEGIN
+        {
+            size_type offset;
+            size_type size;
+            node_type node; // 释放时使用
+        }; // NOLINTEND
+        struct statistics // NOLINTBEGIN
+        {
+            size_type capacity;
+            size_type usedBytes;
+            size_type freeBytes;
+            size_type largestFreeRegion;
+            uint32_t allocationCount;
+            uint32_t freeRegionCount;
+        }; // NOLINTEND
+
+        tlsf_allocator() = default;
+        explicit tlsf_allocator(size_type capacity) : capacity_{capacity}
+        {
+            MCS_ASSERT(capacity > 0);
+            insertFree(newNode(0, capacity));
+        }
+
+        [[nodiscard]] std::optional<allocation> allocate(size_type size,
+                                                         size_type alignment = 1)
+        {
+            MCS_ASSERT(std::has_single_bit(alignment));
+            size = size == 0 ? 1 : size;
+            const size_type search = size + alignment - 1;
+            if (search < size || search > capacity_)
+                return std::nullopt;
+            node_type found = findFree(search);
+            if (found == INVALID_NODE)
+                found = findInBin(search);
+            if (found == INVALID_NODE)
+                return std::nullopt;
+            removeFree(found);
+
+            // NOTE: 被找到的块前后一定都是已用块，拆出的空闲块无需再合并
+            const size_type aligned = alignUp(nodes_[found].offset, alignment);
+            if (const size_type padding = aligned - nodes_[found].offset; padding > 0)
+            {
+                const node_type front = newNode(nodes_[found].offset, padding);
+                linkBefore(front, found);
+                nodes_[found].offset = aligned;
+                nodes_[found].size -= padding;
+                insertFree(front);
+            }
+            if (nodes_[found].size > size)
+            {
+                const node_type back =
+                    newNode(nodes_[found].offset + size, nodes_[found].size - size);
+                linkAfter(found, back);
+                nodes_[found].size = size;
+                insertFree(back);
+            }
+            nodes_[found].used = true;
+            usedBytes_ += size;
+            ++allocationCount_;
+            return allocation{
+                .offset = nodes_[found].offset, .size = size, .node = found};
+        }
+
+        void free(node_type node) noexcept
+        {
+            MCS_ASSERT(node < nodes_.size() && nodes_[node].used);
+            nodes_[node].used = false;
+            usedBytes_ -= nodes_[node].size;
+            --allocationCount_;
+            if (const node_type prev = nodes_[node].prevPhys;
+                prev != INVALID_NODE && !nodes_[prev].used)
+            {
+                removeFree(prev);
+                nodes_[node].offset = nodes_[prev].offset;
+                nodes_[node].size += nodes_[prev].size;
+                unlinkPhys(prev);
+                releaseNode(prev);
+            }
+            if (const node_type next = nodes_[node].nextPhys;
+                next != INVALID_NODE && !nodes_[next].used)
+            {
+                removeFree(next);
+                nodes_[node].size += nodes_[next].size;
+                unlinkPhys(next);
+                releaseNode(next);
+            }
+            insertFree(node);
+        }
+
+        [[nodiscard]] size_type capacity() const noexcept
+        {
+            return capacity_;
+        }
+        [[nodiscard]] size_type usedBytes() const noexcept
+        {
+            return usedBytes_;
+        }
+        [[nodiscard]] uint32_t allocationCount() const noexcept
+        {
+            return allocationCount_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return allocationCount_ == 0;
+        }
+
+        // NOTE: 遍历所有块，O(块数)，不要在热路径上调用
+        [[nodiscard]] statistics stats() const noexcept
+        {
+            statistics result{.capacity = capacity_,
+                              .usedBytes = usedBytes_,
+                              .freeBytes = capacity_ - usedBytes_,
+                              .largestFreeRegion = 0,
+                              .allocationCount = allocationCount_,
+                              .freeRegionCount = 0};
+            for (const auto &node : nodes_)
+            {
+                if (node.used || !node.live)
+                    continue;
+                ++result.freeRegionCount;
+                result.largestFreeRegion = std::max(result.largestFreeRegion, node.size);
+            }
+            return result;
+        }
+
+      private:
+        static constexpr uint32_t SL_BITS = 4;
+        static constexpr uint32_t SL_COUNT = 1U << SL_BITS;
+        static constexpr uint32_t FL_COUNT = 64 - SL_BITS + 1;
+
+        struct node // NOLINTBEGIN
+        {
+            size_type offset;
+            size_type size;
+            node_type prevPhys{INVALID_NODE};
+            node_type nextPhys{INVALID_NODE};
+            node_type prevFree{INVALID_NODE};
+            node_type nextFree{INVALID_NODE};
+            bool used{false};
+            bool live{true}; // false: 在 recycled_ 中等待复用
+        }; // NOLINTEND
+        struct bin_index // NOLINTBEGIN
+        {
+            uint32_t fl;
+            uint32_t sl;
+        }; // NOLINTEND
+
+        size_type capacity_{};
+        size_type usedBytes_{};
+        uint32_t allocationCount_{};
+        std::vector<node> nodes_;
+        std::vector<node_type> recycled_;
+        uint64_t flBitmap_{};
+        std::array<uint32_t, FL_COUNT> slBitmap_{};
+        std::array<std::array<node_type, SL_COUNT>, FL_COUNT> heads_ = [] {
+            std::array<std::array<node_type, SL_COUNT>, FL_COUNT> heads{};
+            for (auto &row : heads)
+                row.fill(INVALID_NODE);
+            return heads;
+        }();
+
+        static constexpr size_type alignUp(size_type value, size_type alignment) noexcept
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+        // NOTE: 小于 16 的尺寸都落在第 0 档，按字节细分
+        static constexpr bin_index mapping(size_type size) noexcept
+        {
+            const auto msb = static_cast<uint32_t>(std::bit_width(size) - 1);
+            if (msb < SL_BITS)
+                return {.fl = 0, .sl = static_cast<uint32_t>(size)};
+            return {.fl = msb - SL_BITS + 1,
+                    .sl = static_cast<uint32_t>(size >> (msb - SL_BITS)) - SL_COUNT};
+        }
+        // NOTE: 向上取整到档位上界，找到的档中任何块都不小于 size
+        static constexpr bin_index mappingSearch(size_type size) noexcept
+        {
+            const auto msb = static_cast<uint32_t>(std::bit_width(size) - 1);
+            if (msb >= SL_BITS)
+            {
+                const size_type round = (size_type{1} << (msb - SL_BITS)) - 1;
+                if (size + round > size)
+                    size += round;
+            }
+            return mapping(size);
+        }
+
+        [[nodiscard]] node_type findFree(size_type size) const noexcept
+        {
+            auto [fl, sl] = mappingSearch(size);
+            if (fl >= FL_COUNT)
+                return INVALID_NODE;
+            uint32_t slMap = sl < SL_COUNT ? slBitmap_[fl] & (~0U << sl) : 0;
+            if (slMap == 0)
+            {
+                const uint64_t flMap =
+                    fl + 1 < FL_COUNT ? flBitmap_ & (~uint64_t{0} << (fl + 1)) : 0;
+                if (flMap == 0)
+                    return INVALID_NODE;
+                fl = static_cast<uint32_t>(std::countr_zero(flMap));
+                slMap = slBitmap_[fl];
+            }
+            sl = static_cast<uint32_t>(std::countr_zero(slMap));
+            return heads_[fl][sl];
+        }
+
+        // NOTE: 向上取整会跳过 size 所在的档，该档里仍可能有够大的块(如恰好等大的独占块)
+        [[nodiscard]] node_type findInBin(size_type size) const noexcept
+        {
+            const auto [fl, sl] = mapping(size);
+            node_type index = heads_[fl][sl];
+            while (index != INVALID_NODE && nodes_[index].size < size)
+                index = nodes_[index].nextFree;
+            return index;
+        }
+
+        void insertFree(node_type index) noexcept
+        {
+            const auto [fl, sl] = mapping(nodes_[index].size);
+            auto &head = heads_[fl][sl];
+            nodes_[index].prevFree = INVALID_NODE;
+            nodes_[index].nextFree = head;
+            if (head != INVALID_NODE)
+                nodes_[head].prevFree = index;
+            head = index;
+            slBitmap_[fl] |= 1U << sl;
+            flBitmap_ |= uint64_t{1} << fl;
+        }
+        void removeFree(node_type index) noexcept
+        {
+            const auto [fl, sl] = mapping(nodes_[index].size);
+            const node_type prev = nodes_[index].prevFree;
+            const node_type next = nodes_[index].nextFree;
+            if (prev != INVALID_NODE)
+                nodes_[prev].nextFree = next;
+            else
+                heads_[fl][sl] = next;
+            if (next != INVALID_NODE)
+                nodes_[next].prevFree = prev;
+            if (heads_[fl][sl] == INVALID_NODE)
+            {
+                slBitmap_[fl] &= ~(1U << sl);
+                if (slBitmap_[fl] == 0)
+                    flBitmap_ &= ~(uint64_t{1} << fl);
+            }
+        }
+
+        node_type newNode(size_type offset, size_type size)
+        {
+            if (!recycled_.empty())
+            {
+                const node_type index = recycled_.back();
+                recycled_.pop_back();
+                nodes_[index] = node{.offset = offset, .size = size};
+                return index;
+            }
+            nodes_.emplace_back(node{.offset = offset, .size = size});
+            recycled_.reserve(nodes_.size());
+            return static_cast<node_type>(nodes_.size() - 1);
+        }
+        void releaseNode(node_type index) noexcept
+        {
+            nodes_[index].live = false;
+            // NOTE: 不会分配：newNode 保证 recycled_ 的容量不小于节点数
+            recycled_.push_back(index);
+        }
+        void linkBefore(node_type index, node_type next) noexcept
+        {
+            const node_type prev = nodes_[next].prevPhys;
+            nodes_[index].prevPhys = prev;
+            nodes_[index].nextPhys = next;
+            nodes_[next].prevPhys = index;
+            if (prev != INVALID_NODE)
+                nodes_[prev].nextPhys = index;
+        }
+        void linkAfter(node_type prev, node_type index) noexcept
+        {
+            const node_type next = nodes_[prev].nextPhys;
+            nodes_[index].prevPhys = prev;
+            nodes_[index].nextPhys = next;
+            nodes_[prev].nextPhys = index;
+            if (next != INVALID_NODE)
+                nodes_[next].prevPhys = index;
+        }
+        void unlinkPhys(node_type index) noexcept
+        {
+            const node_type prev = nodes_[index].prevPhys;
+            const node_type next = nodes_[index].nextPhys;
+            if (prev != INVALID_NODE)
+                nodes_[prev].nextPhys = next;
+            if (next != INVALID_NODE)
+                nodes_[next].prevPhys = prev;
+        }
+    };
+}; // namespace mcs::vulkan::memory
@@ -3,7 +3,7 @@
 #include "sType.hpp"
 #include "pNext.hpp"
 #include "Flags.hpp"
-#include "../utils/read_file.hpp"
+#include "../utils/mapped_file.hpp"
 #include "../ShaderModule.hpp"
 #include "../Pipeline.hpp"
 #include <concepts>
@@ -47,14 +47,14 @@ namespace mcs::vulkan::tool
             };
             constexpr auto operator()(const LogicalDevice &device) const
             {
-                auto data = read_file(filePath);
+                // NOTE: 直接从映射的页面创建，不复制 SPIR-V
+                const mapped_file data{filePath};
                 MCS_ASSERT(not data.empty());
                 return result_type{
                     ShaderModule(device, device.createShaderModule(
                                              {.sType = sType<VkShaderModuleCreateInfo>(),
                                               .codeSize = data.size(),
-                                              .pCode = std::bit_cast<const uint32_t *>(
-                                                  data.data())},
+                                              .pCode = data.as<uint32_t>().data()},
                                              device.allocator())),
                     {.sType = sType<VkPipelineShaderStageCreateInfo>(),
                      .pNext = pNext.value(),
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "create_graphics_pipeline.hpp"
+#include "sType.hpp"
+#include "../PipelineCache.hpp"
+#include "../utils/thread_pool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::tool
+{
+    /**
+     * NOTE: 批量编译图形管线。每个描述一次 create_graphics_pipeline::build，
+     * 在 thread_pool 上并发执行，结果与 add() 的顺序一致。
+     * - 共享缓存：VkPipelineCache 默认由驱动内部同步，可被多个线程同时使用
+     * - perWorkerCaches：每个工作线程一个临时缓存，结束后合并进 cache，
+     *   避免驱动在共享缓存上的锁竞争；cache 以 EXTERNALLY_SYNCHRONIZED 创建时必须使用
+     * 任一管线失败时，等待其余任务结束后抛出第一个异常，已创建的管线随之销毁。
+     */
+    struct create_graphics_pipelines
+    {
+        using clock = std::chrono::steady_clock;
+
+        struct build_options // NOLINTBEGIN
+        {
+            VkPipelineCache cache{};
+            bool perWorkerCaches{false};
+        }; // NOLINTEND
+        struct result_type // NOLINTBEGIN
+        {
+            std::vector<Pipeline> pipelines;
+            // 各管线从读入 SPIR-V 到 vkCreateGraphicsPipelines 返回的耗时
+            std::vector<clock::duration> compileTimes;
+        }; // NOLINTEND
+
+        // NOTE: 返回该管线在结果中的下标
+        size_t add(create_graphics_pipeline &&create)
+        {
+            pipelines_.emplace_back(std::move(create));
+            return pipelines_.size() - 1;
+        }
+        auto &setPipelines(std::vector<create_graphics_pipeline> &&pipelines) noexcept
+        {
+            pipelines_ = std::move(pipelines);
+            return *this;
+        }
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return pipelines_.size();
+        }
+
+        // NOTE: pool 为空时在调用线程中依次编译
+        [[nodiscard]] result_type build(const LogicalDevice &device,
+                                        thread_pool *pool = nullptr,
+                                        build_options options = {}) const
+        {
+            result_type result{.pipelines = std::vector<Pipeline>(pipelines_.size()),
+                               .compileTimes =
+                                   std::vector<clock::duration>(pipelines_.size())};
+            const auto compile = [&](size_t index, VkPipelineCache cache) {
+                const auto start = clock::now();
+                result.pipelines[index] = pipelines_[index].build(device, cache);
+                result.compileTimes[index] = clock::now() - start;
+            };
+            if (pool == nullptr)
+            {
+                for (size_t i = 0; i < pipelines_.size(); ++i)
+                    compile(i, options.cache);
+                return result;
+            }
+            if (!options.perWorkerCaches)
+            {
+                pool->for_each_index(pipelines_.size(), [&](size_t index) {
+                    compile(index, options.cache);
+                });
+                return result;
+            }
+
+            // NOTE: 每个缓存只被一个线程使用，但不设 EXTERNALLY_SYNCHRONIZED，
+            //  该标志需要启用 pipelineCreationCacheControl。以 cache 的数据为初值
+            const std::vector<uint8_t> seed =
+                options.cache != nullptr ? device.getPipelineCacheData(options.cache)
+                                         : std::vector<uint8_t>{};
+            const VkPipelineCacheCreateInfo createInfo{
+                .sType = sType<VkPipelineCacheCreateInfo>(),
+                .initialDataSize = seed.size(),
+                .pInitialData = seed.empty() ? nullptr : seed.data()};
+            std::vector<PipelineCache> workerCaches;
+            workerCaches.reserve(pool->size());
+            for (size_t i = 0; i < pool->size(); ++i)
+                workerCaches.emplace_back(
+                    device, device.createPipelineCache(createInfo, device.allocator()));
+            pool->for_each_index(pipelines_.size(), [&](size_t index) {
+                compile(index, *workerCaches[thread_pool::current_worker()]);
+            });
+            if (options.cache != nullptr)
+            {
+                std::vector<VkPipelineCache> sources;
+                sources.reserve(workerCaches.size());
+                for (const auto &cache : workerCaches)
+                    sources.emplace_back(*cache);
+                device.mergePipelineCaches(options.cache,
+                                           static_cast<uint32_t>(sources.size()),
+                                           sources.data());
+            }
+            return result;
+        }
+
+      private:
+        std::vector<create_graphics_pipeline> pipelines_;
+    };
+}; // namespace mcs::vulkan::tool
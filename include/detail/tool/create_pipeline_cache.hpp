@@ -0,0 +1,63 @@
+#pragma once
+
+#include "sType.hpp"
+#include "Flags.hpp"
+#include "../PipelineCache.hpp"
+#include "../utils/mapped_file.hpp"
+
+#include <filesystem>
+#include <string>
+#include <utility>
+
+namespace mcs::vulkan::tool
+{
+    struct create_pipeline_cache
+    {
+        /*
+        typedef struct VkPipelineCacheCreateInfo {
+            VkStructureType               sType;
+            const void*                   pNext;
+            VkPipelineCacheCreateFlags    flags;
+            size_t                        initialDataSize;
+            const void*                   pInitialData;
+        } VkPipelineCacheCreateInfo;
+        */
+        struct create_info // NOLINTBEGIN
+        {
+            Flags<VkPipelineCacheCreateFlagBits> flags;
+            // 缓存文件：存在且与设备匹配时作为初始数据，析构时写回。空则只在内存中
+            std::string filePath;
+        }; // NOLINTEND
+
+        // NOTE: 文件缺失、损坏或属于其他设备/驱动时从空缓存开始，不报错
+        [[nodiscard]] PipelineCache build(const LogicalDevice &device) const
+        {
+            mapped_file file;
+            std::error_code ec;
+            if (!createInfo_.filePath.empty() &&
+                std::filesystem::is_regular_file(createInfo_.filePath, ec))
+                file = mapped_file{createInfo_.filePath};
+            const auto bytes = file.as<uint8_t>();
+            const bool loaded =
+                PipelineCache::compatible(*device.physicalDevice(), bytes);
+
+            const VkPipelineCacheCreateInfo createInfo{
+                .sType = sType<VkPipelineCacheCreateInfo>(),
+                .flags = createInfo_.flags,
+                .initialDataSize = loaded ? bytes.size() : 0,
+                .pInitialData = loaded ? bytes.data() : nullptr};
+            VkPipelineCache cache =
+                device.createPipelineCache(createInfo, device.allocator());
+            return PipelineCache{device, cache, createInfo_.filePath, loaded};
+        }
+
+        auto &setCreateInfo(create_info &&createInfo) noexcept
+        {
+            createInfo_ = std::move(createInfo);
+            return *this;
+        }
+
+      private:
+        create_info createInfo_;
+    };
+}; // namespace mcs::vulkan::tool
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "sType.hpp"
+#include "Flags.hpp"
+#include "../DescriptorPool.hpp"
+#include "../utils/check_vkresult.hpp"
+#include "../utils/mcs_assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::tool
+{
+    /**
+     * NOTE: 按帧(frame_context::currentFrame)分配临时描述符集，替代固定大小的单个 DescriptorPool:
+     * - 当前池耗尽时换下一个池，池的容量按 growth 倍增到 maxSetsPerPool
+     * - reset(frame) 在该帧的 fence 之后调用，一次重置该帧用过的所有池
+     * - 重置后的池进入空闲列表，所有池的描述符配比相同，任何一帧都可以复用
+     * 热路径 allocate() 只有一次 vkAllocateDescriptorSets；稳定后不再创建池。
+     * 不是线程安全的：每个录制线程使用自己的分配器。
+     */
+    template <size_t MAX_FRAMES_IN_FLIGHT>
+    class descriptor_allocator
+    {
+      public:
+        struct pool_ratio // NOLINTBEGIN
+        {
+            VkDescriptorType type;
+            float ratio; // 每个描述符集平均需要的该类型描述符数
+        }; // NOLINTEND
+        struct create_info // NOLINTBEGIN
+        {
+            std::vector<pool_ratio> ratios;
+            uint32_t initialSets{64};
+            uint32_t maxSetsPerPool{4096};
+            float growth{2.0F};
+            Flags<VkDescriptorPoolCreateFlagBits> flags;
+        }; // NOLINTEND
+
+        descriptor_allocator(const LogicalDevice &device, create_info createInfo)
+            : device_{&device}, createInfo_{std::move(createInfo)},
+              nextSets_{createInfo_.initialSets}
+        {
+            MCS_ASSERT(!createInfo_.ratios.empty() && createInfo_.initialSets > 0);
+        }
+        descriptor_allocator(const descriptor_allocator &) = delete;
+        descriptor_allocator(descriptor_allocator &&) noexcept = default;
+        descriptor_allocator &operator=(const descriptor_allocator &) = delete;
+        descriptor_allocator &operator=(descriptor_allocator &&) noexcept = default;
+        ~descriptor_allocator() noexcept = default;
+
+        [[nodiscard]] VkDescriptorSet allocate(uint32_t frame,
+                                               VkDescriptorSetLayout layout,
+                                               const void *pNext = nullptr)
+        {
+            MCS_ASSERT(frame < MAX_FRAMES_IN_FLIGHT);
+            auto &current = frames_[frame];
+            VkDescriptorSetAllocateInfo allocateInfo{
+                .sType = sType<VkDescriptorSetAllocateInfo>(),
+                .pNext = pNext,
+                .descriptorPool = current.active,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &layout};
+            VkDescriptorSet set{};
+            if (allocateInfo.descriptorPool != nullptr)
+            {
+                const VkResult result =
+                    device_->allocateDescriptorSets(allocateInfo, &set);
+                if (result == VK_SUCCESS)
+                    return set;
+                if (result != VK_ERROR_OUT_OF_POOL_MEMORY &&
+                    result != VK_ERROR_FRAGMENTED_POOL)
+                    check_vkresult(result);
+            }
+            // NOTE: 冷路径：换池后重试一次，新池仍失败说明布局超出了单池容量
+            allocateInfo.descriptorPool = current.active = takePool(current);
+            check_vkresult(device_->allocateDescriptorSets(allocateInfo, &set));
+            return set;
+        }
+
+        // NOTE: 调用方保证该帧的命令已执行完(等待过 inFlightFences[frame])
+        void reset(uint32_t frame)
+        {
+            MCS_ASSERT(frame < MAX_FRAMES_IN_FLIGHT);
+            auto &current = frames_[frame];
+            for (auto &entry : current.used)
+            {
+                entry.pool.reset();
+                ready_.emplace_back(std::move(entry));
+            }
+            current.used.clear();
+            current.active = nullptr;
+            // NOTE: 大池排在末尾，优先复用
+            std::ranges::sort(ready_, {}, &pool_entry::maxSets);
+        }
+
+        // NOTE: 已创建的池总数，稳定运行后不应再增长
+        [[nodiscard]] size_t pool_count() const noexcept
+        {
+            size_t count = ready_.size();
+            for (const auto &frame : frames_)
+                count += frame.used.size();
+            return count;
+        }
+        [[nodiscard]] size_t frame_pool_count(uint32_t frame) const noexcept
+        {
+            return frames_[frame].used.size();
+        }
+
+      private:
+        struct pool_entry // NOLINTBEGIN
+        {
+            DescriptorPool pool;
+            uint32_t maxSets;
+        }; // NOLINTEND
+        struct frame_pools // NOLINTBEGIN
+        {
+            std::vector<pool_entry> used; // 末尾为 active
+            VkDescriptorPool active{};
+        }; // NOLINTEND
+
+        const LogicalDevice *device_;
+        create_info createInfo_;
+        uint32_t nextSets_;
+        std::array<frame_pools, MAX_FRAMES_IN_FLIGHT> frames_{};
+        std::vector<pool_entry> ready_;
+
+        VkDescriptorPool takePool(frame_pools &frame)
+        {
+            if (!ready_.empty())
+            {
+                frame.used.emplace_back(std::move(ready_.back()));
+                ready_.pop_back();
+            }
+            else
+            {
+                frame.used.emplace_back(createPool(nextSets_));
+                const float grown = static_cast<float>(nextSets_) * createInfo_.growth;
+                nextSets_ = std::min(static_cast<uint32_t>(grown),
+                                     createInfo_.maxSetsPerPool);
+            }
+            return *frame.used.back().pool;
+        }
+
+        [[nodiscard]] pool_entry createPool(uint32_t maxSets) const
+        {
+            std::vector<VkDescriptorPoolSize> sizes;
+            sizes.reserve(createInfo_.ratios.size());
+            for (const auto &[type, ratio] : createInfo_.ratios)
+                sizes.emplace_back(VkDescriptorPoolSize{
+                    .type = type,
+                    .descriptorCount = std::max(
+                        1U, static_cast<uint32_t>(
+                                std::ceil(ratio * static_cast<float>(maxSets))))});
+            const VkDescriptorPoolCreateInfo createInfo{
+                .sType = sType<VkDescriptorPoolCreateInfo>(),
+                .flags = createInfo_.flags,
+                .maxSets = maxSets,
+                .poolSizeCount = static_cast<uint32_t>(sizes.size()),
+                .pPoolSizes = sizes.data()};
+            VkDescriptorPool pool =
+                device_->createDescriptorPool(createInfo, device_->allocator());
+            return {.pool = DescriptorPool{*device_, pool}, .maxSets = maxSets};
+        }
+    };
+}; // namespace mcs::vulkan::tool
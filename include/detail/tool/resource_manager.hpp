@@ -1,11 +1,34 @@
 #pragma once
 
+#include "sType.hpp"
+#include "../LogicalDevice.hpp"
+
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace mcs::vulkan::tool
 {
+    /**
+     * NOTE: 固定容量的资源槽(bindless 纹理/采样器数组的下标):
+     * - 空闲槽用侵入式双向链表串起来，取/还/占用任意空闲槽都是 O(1)
+     * - key -> slot 的哈希索引，find_slot_by_name 可直接用 string_view 查找；
+     *   允许重名，返回下标最小的槽，与按下标顺序查找的结果一致
+     * - 计数缓存，free_count/used_count 不再遍历整个数组
+     * - use_slot 记下新占用的槽，write_descriptors 把它们合并成连续区间批量写入描述符
+     */
     template <class resource_type, uint32_t MAX_TEXTURES>
     struct resource_manager
     {
@@ -20,37 +43,72 @@ namespace mcs::vulkan::tool
         std::array<resource_type, MAX_TEXTURES> resources;
         std::array<std::string, MAX_TEXTURES> resources_key;
 
-        constexpr void use_slot(slot_type index, resource_type resource,
-                                std::string key) noexcept
+        // NOTE: 不是 noexcept：unordered_map 的默认构造在部分实现上会分配
+        constexpr resource_manager()
+        {
+            for (slot_type i = 0; i < MAX_TEXTURES; ++i)
+            {
+                free_prev_[i] = i == 0 ? invalid_index : i - 1;
+                free_next_[i] = i + 1 == MAX_TEXTURES ? invalid_index : i + 1;
+            }
+            free_head_ = MAX_TEXTURES == 0 ? invalid_index : 0;
+        }
+
+        constexpr void use_slot(slot_type index, resource_type resource, std::string key)
         {
             mark_used(index);
             resources[index] = std::move(resource);
+            if (!key.empty())
+            {
+                // NOTE: 同名的槽按下标升序保存，front() 即下标最小的槽
+                auto &slots = key_index_[key];
+                slots.insert(std::ranges::lower_bound(slots, index), index);
+            }
             resources_key[index] = std::move(key);
+            if (!std::exchange(dirty_mark_[index], true))
+                dirty_.emplace_back(index);
+        }
+        // NOTE: 占用第一个空闲槽，没有空闲槽时返回 nullopt
+        [[nodiscard]] constexpr std::optional<slot_type> use_slot(resource_type resource,
+                                                                  std::string key)
+        {
+            if (free_head_ == invalid_index)
+                return std::nullopt;
+            const slot_type index = free_head_;
+            use_slot(index, std::move(resource), std::move(key));
+            return index;
         }
         constexpr void free_slot(slot_type index) noexcept
         {
             mark_free(index);
             resources[index] = {};
+            if (auto it = key_index_.find(resources_key[index]); it != key_index_.end())
+            {
+                // NOTE: 绕过 use_slot 直接改 resources_key / mark_used 时索引里可能没有该槽
+                auto &slots = it->second;
+                const auto pos = std::ranges::lower_bound(slots, index);
+                if (pos != slots.end() && *pos == index)
+                    slots.erase(pos);
+                if (slots.empty())
+                    key_index_.erase(it);
+            }
             resources_key[index] = {};
         }
         [[nodiscard]] constexpr std::optional<slot_type> find_slot_by_name(
-            std::string key) const noexcept
+            std::string_view key) const noexcept
         {
-            for (slot_type i = 0; i < resources_key.size(); ++i)
-            {
-                if (resources_key[i] == key)
-                    return i;
-            }
+            if (auto it = key_index_.find(key); it != key_index_.end())
+                return it->second.front();
             return std::nullopt;
         }
 
-        constexpr auto free_count() const noexcept
+        [[nodiscard]] constexpr size_t free_count() const noexcept
         {
-            return std::ranges::count(slot_status, MARK_FREE);
+            return MAX_TEXTURES - used_count_;
         }
-        constexpr auto used_count() const noexcept
+        [[nodiscard]] constexpr size_t used_count() const noexcept
         {
-            return std::ranges::count(slot_status, MARK_USED);
+            return used_count_;
         }
         [[nodiscard]] constexpr bool is_free(slot_type index) const noexcept
         {
@@ -60,27 +118,39 @@ namespace mcs::vulkan::tool
         {
             return slot_status[index] == MARK_USED;
         }
+        // NOTE: 释放的槽放在链表头，下次最先被复用
         constexpr void mark_free(slot_type index) noexcept
         {
             assert(is_used(index) && "该槽已经是空闲的(Double free)");
             slot_status[index] = MARK_FREE;
+            free_prev_[index] = invalid_index;
+            free_next_[index] = free_head_;
+            if (free_head_ != invalid_index)
+                free_prev_[free_head_] = index;
+            free_head_ = index;
+            --used_count_;
         }
+        // NOTE: 从空闲链表中摘下，保留 free_next_[index]，
+        //  遍历 view_free_indexes() 时占用当前槽不会打断遍历
         constexpr void mark_used(slot_type index) noexcept
         {
             assert(is_free(index) && "该槽已经是空闲的(Double used)");
             slot_status[index] = MARK_USED;
+            const slot_type prev = free_prev_[index];
+            const slot_type next = free_next_[index];
+            if (prev != invalid_index)
+                free_next_[prev] = next;
+            else
+                free_head_ = next;
+            if (next != invalid_index)
+                free_prev_[next] = prev;
+            ++used_count_;
         }
+        // NOTE: 沿空闲链表遍历，只访问空闲槽
         constexpr auto view_free_indexes() const noexcept
         {
-            return slot_status | std::views::enumerate |
-                   std::views::filter([](auto tup) noexcept {
-                       auto [index, status] = tup;
-                       return status == MARK_FREE;
-                   }) |
-                   std::views::transform([](auto tup) noexcept -> slot_type {
-                       auto [index, status] = tup;
-                       return index;
-                   });
+            return std::ranges::subrange{free_iterator{this, free_head_},
+                                         std::default_sentinel};
         }
         constexpr auto view_used_indexes() const noexcept
         {
@@ -101,6 +171,71 @@ namespace mcs::vulkan::tool
                        return std::make_pair(i, &resources[i]);
                    });
         }
+        // NOTE: 自上次 write_descriptors/clear_dirty 以来新占用的槽
+        [[nodiscard]] constexpr std::span<const slot_type> dirty_indexes() const noexcept
+        {
+            return dirty_;
+        }
+        constexpr void clear_dirty() noexcept
+        {
+            for (const slot_type index : dirty_)
+                dirty_mark_[index] = false;
+            dirty_.clear();
+        }
+
+        /**
+         * NOTE: 把新占用的槽写入 bindless 数组(dstBinding 的 dstArrayElement = 槽号)。
+         * 连续的槽合并成一个 VkWriteDescriptorSet，所有 dstSets 一次 vkUpdateDescriptorSets。
+         * make_info(const resource_type &) 返回该槽的 VkDescriptorImageInfo。
+         * 数组绑定需要 UPDATE_AFTER_BIND / PARTIALLY_BOUND，否则调用方要保证 dstSets 不在使用中。
+         */
+        template <typename F>
+        void write_descriptors(const LogicalDevice &device,
+                               std::span<const VkDescriptorSet> dstSets,
+                               uint32_t dstBinding, VkDescriptorType descriptorType,
+                               F &&make_info)
+        {
+            // NOTE: 占用后又释放的槽不再写入
+            std::erase_if(dirty_, [this](slot_type index) {
+                if (is_used(index))
+                    return false;
+                dirty_mark_[index] = false;
+                return true;
+            });
+            if (dirty_.empty() || dstSets.empty())
+            {
+                clear_dirty();
+                return;
+            }
+            std::ranges::sort(dirty_);
+
+            std::vector<VkDescriptorImageInfo> infos;
+            infos.reserve(dirty_.size());
+            for (const slot_type index : dirty_)
+                infos.emplace_back(std::invoke(make_info, resources[index]));
+
+            std::vector<VkWriteDescriptorSet> writes;
+            for (size_t begin = 0; begin < dirty_.size();)
+            {
+                size_t end = begin + 1;
+                while (end < dirty_.size() && dirty_[end] == dirty_[end - 1] + 1)
+                    ++end;
+                for (const VkDescriptorSet set : dstSets)
+                    writes.emplace_back(VkWriteDescriptorSet{
+                        .sType = sType<VkWriteDescriptorSet>(),
+                        .dstSet = set,
+                        .dstBinding = dstBinding,
+                        .dstArrayElement = dirty_[begin],
+                        .descriptorCount = static_cast<uint32_t>(end - begin),
+                        .descriptorType = descriptorType,
+                        .pImageInfo = &infos[begin]});
+                begin = end;
+            }
+            device.updateDescriptorSets(static_cast<uint32_t>(writes.size()),
+                                        writes.data(), 0, nullptr);
+            clear_dirty();
+        }
+
         struct auto_free_slot_type
         {
           private:
@@ -150,5 +285,56 @@ namespace mcs::vulkan::tool
                 return *this;
             }
         };
+
+      private:
+        struct string_hash
+        {
+            using is_transparent = void;
+            [[nodiscard]] size_t operator()(std::string_view key) const noexcept
+            {
+                return std::hash<std::string_view>{}(key);
+            }
+        };
+        struct free_iterator
+        {
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = slot_type;
+            using difference_type = std::ptrdiff_t;
+
+            const resource_manager *manager{};
+            slot_type index{invalid_index};
+
+            constexpr slot_type operator*() const noexcept
+            {
+                return index;
+            }
+            constexpr free_iterator &operator++() noexcept
+            {
+                index = manager->free_next_[index];
+                return *this;
+            }
+            constexpr free_iterator operator++(int) noexcept
+            {
+                auto old = *this;
+                ++*this;
+                return old;
+            }
+            constexpr bool operator==(const free_iterator &) const noexcept = default;
+            constexpr bool operator==(std::default_sentinel_t) const noexcept
+            {
+                return index == invalid_index;
+            }
+        };
+
+        std::array<slot_type, MAX_TEXTURES> free_prev_{};
+        std::array<slot_type, MAX_TEXTURES> free_next_{};
+        slot_type free_head_{invalid_index};
+        size_t used_count_{0};
+        // NOTE: 每个 key 对应按下标升序排列的槽，绝大多数只有一个
+        std::unordered_map<std::string, std::vector<slot_type>, string_hash,
+                           std::equal_to<>>
+            key_index_;
+        std::array<bool, MAX_TEXTURES> dirty_mark_{};
+        std::vector<slot_type> dirty_;
     };
 }; // namespace mcs::vulkan::tool
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace mcs::vulkan
+{
+    /**
+     * NOTE: 树状数组(Fenwick)，单点增量 / 前缀和 / 按前缀和二分都是 O(log n)。
+     * T 需要默认构造为零元，并支持 operator+ / operator-。
+     */
+    template <typename T>
+    class fenwick_tree
+    {
+      public:
+        constexpr fenwick_tree() = default;
+        constexpr explicit fenwick_tree(size_t count) : tree_(count) {}
+
+        // NOTE: 所有元素置零，保留容量
+        constexpr void assign(size_t count)
+        {
+            tree_.assign(count, T{});
+        }
+
+        // NOTE: 末尾追加一个元素，O(log n)
+        constexpr void push_back(const T &value)
+        {
+            const size_t i = tree_.size() + 1; // 1-based
+            const size_t low = i - (i & (~i + 1));
+            tree_.emplace_back(value + (prefix(i - 1) - prefix(low)));
+        }
+
+        // NOTE: 第 index 个元素加上 delta
+        constexpr void add(size_t index, const T &delta)
+        {
+            for (size_t i = index + 1; i <= tree_.size(); i += i & (~i + 1))
+                tree_[i - 1] = tree_[i - 1] + delta;
+        }
+
+        // NOTE: [0, count) 的和
+        [[nodiscard]] constexpr T prefix(size_t count) const
+        {
+            T sum{};
+            for (size_t i = count; i > 0; i -= i & (~i + 1))
+                sum = sum + tree_[i - 1];
+            return sum;
+        }
+
+        /**
+         * @brief 返回最大的 count 使 pred(prefix(count), count) 为真
+         * pred 必须对 count 单调(先真后假)，pred(T{}, 0) 视为真
+         */
+        template <typename Pred>
+        [[nodiscard]] constexpr size_t partition_point(Pred &&pred) const
+        {
+            size_t pos = 0;
+            T sum{};
+            for (size_t step = std::bit_floor(tree_.size()); step > 0; step >>= 1U)
+            {
+                if (pos + step > tree_.size())
+                    continue;
+                T next = sum + tree_[pos + step - 1];
+                if (pred(next, pos + step))
+                {
+                    pos += step;
+                    sum = next;
+                }
+            }
+            return pos;
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept
+        {
+            return tree_.size();
+        }
+
+      private:
+        std::vector<T> tree_;
+    };
+}; // namespace mcs::vulkan
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "make_vk_exception.hpp"
+#include "mcs_assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MCS_MAPPED_FILE_MMAP
+#endif
+
+namespace mcs::vulkan
+{
+    /**
+     * NOTE: 只读的整文件视图。POSIX 上 mmap(MAP_PRIVATE)，页面按需从页缓存读入，
+     * 多个进程/对象映射同一文件时共享物理内存；其他平台或 mmap 失败时退回一次性读入。
+     * 视图在对象析构前有效：FT_New_Memory_Face 等不复制数据的使用者必须比它活得短。
+     */
+    class mapped_file
+    {
+      public:
+        mapped_file() = default;
+        explicit mapped_file(const std::string &path)
+        {
+#if defined(MCS_MAPPED_FILE_MMAP)
+            if (map(path))
+                return;
+#endif
+            readAll(path);
+        }
+
+        // NOTE: 不映射，直接读入(对照测试、不支持 mmap 的文件系统)
+        [[nodiscard]] static mapped_file read(const std::string &path)
+        {
+            mapped_file file;
+            file.readAll(path);
+            return file;
+        }
+
+        mapped_file(const mapped_file &) = delete;
+        mapped_file &operator=(const mapped_file &) = delete;
+        mapped_file(mapped_file &&o) noexcept
+            : data_{std::exchange(o.data_, nullptr)}, size_{std::exchange(o.size_, 0)},
+              mapped_{std::exchange(o.mapped_, false)}, buffer_{std::move(o.buffer_)}
+        {
+        }
+        mapped_file &operator=(mapped_file &&o) noexcept
+        {
+            if (&o != this)
+            {
+                destroy();
+                data_ = std::exchange(o.data_, nullptr);
+                size_ = std::exchange(o.size_, 0);
+                mapped_ = std::exchange(o.mapped_, false);
+                buffer_ = std::move(o.buffer_);
+            }
+            return *this;
+        }
+        ~mapped_file() noexcept
+        {
+            destroy();
+        }
+
+        void destroy() noexcept
+        {
+#if defined(MCS_MAPPED_FILE_MMAP)
+            if (mapped_)
+                ::munmap(const_cast<std::byte *>(data_), size_); // NOLINT
+#endif
+            data_ = nullptr;
+            size_ = 0;
+            mapped_ = false;
+            buffer_ = {};
+        }
+
+        [[nodiscard]] std::span<const std::byte> bytes() const noexcept
+        {
+            return {data_, size_};
+        }
+        // NOTE: 按 T 解释，例如 as<uint32_t>() 给 SPIR-V、as<FT_Byte>() 给 FreeType
+        template <typename T>
+        [[nodiscard]] std::span<const T> as() const noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto *ptr = reinterpret_cast<const T *>(data_); // NOLINT
+            MCS_ASSERT(reinterpret_cast<std::uintptr_t>(ptr) % alignof(T) == 0); // NOLINT
+            return {ptr, size_ / sizeof(T)};
+        }
+        [[nodiscard]] const std::byte *data() const noexcept
+        {
+            return data_;
+        }
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return size_;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+        // NOTE: 逐页读一个字节，让缺页(磁盘 I/O)发生在当前线程，例如解码线程池中
+        void prefault() const noexcept
+        {
+#if defined(MCS_MAPPED_FILE_MMAP)
+            if (!mapped_)
+                return;
+            ::madvise(const_cast<std::byte *>(data_), size_, MADV_WILLNEED); // NOLINT
+            const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            volatile std::byte sink{};
+            for (std::size_t i = 0; i < size_; i += page)
+                sink = data_[i]; // NOLINT
+            (void)sink;
+#endif
+        }
+        // NOTE: true 为 mmap，false 为读入的缓冲
+        [[nodiscard]] bool mapped() const noexcept
+        {
+            return mapped_;
+        }
+
+      private:
+        const std::byte *data_{nullptr};
+        std::size_t size_{0};
+        bool mapped_{false};
+        std::vector<std::byte> buffer_;
+
+#if defined(MCS_MAPPED_FILE_MMAP)
+        bool map(const std::string &path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT
+            if (fd < 0)
+                throw make_vk_exception("failed to open file!");
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+            {
+                ::close(fd);
+                return false;
+            }
+            if (st.st_size == 0)
+            {
+                ::close(fd);
+                return false; // mmap 不接受长度 0；/proc 等报告 0 的文件交给 readAll
+            }
+            const auto size = static_cast<std::size_t>(st.st_size);
+            void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd); // 映射持有文件的引用
+            if (addr == MAP_FAILED) // NOLINT
+                return false;
+            data_ = static_cast<const std::byte *>(addr);
+            size_ = size;
+            mapped_ = true;
+            return true;
+        }
+#endif
+
+        // NOTE: 分块读到 EOF，不依赖 tellg：管道、/proc 等报告的大小不可信
+        void readAll(const std::string &path)
+        {
+            constexpr std::size_t CHUNK = std::size_t{64} << 10U;
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open())
+                throw make_vk_exception("failed to open file!");
+            std::size_t size = 0;
+            while (file)
+            {
+                buffer_.resize(size + CHUNK);
+                file.read(reinterpret_cast<char *>(buffer_.data() + size), // NOLINT
+                          static_cast<std::streamsize>(CHUNK));
+                size += static_cast<std::size_t>(file.gcount());
+            }
+            if (file.bad())
+                throw make_vk_exception("failed to read file!");
+            buffer_.resize(size);
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+    };
+}; // namespace mcs::vulkan
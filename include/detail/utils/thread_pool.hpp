@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan
+{
+    /**
+     * NOTE: 固定线程数的工作线程池。submit 返回 std::future，异常经 future 传回。
+     * for_each_index 阻塞直到全部完成，下标通过原子计数动态分配，结果顺序由调用方按下标写入。
+     * 不要在池内线程中调用 for_each_index / 等待 submit 的 future，否则可能死锁。
+     */
+    class thread_pool
+    {
+      public:
+        explicit thread_pool(
+            size_t count = std::max<size_t>(1, std::thread::hardware_concurrency()))
+        {
+            workers_.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                workers_.emplace_back([this, i](const std::stop_token &token) {
+                    worker_index() = i;
+                    run(token);
+                });
+        }
+        thread_pool(const thread_pool &) = delete;
+        thread_pool(thread_pool &&) = delete;
+        thread_pool &operator=(const thread_pool &) = delete;
+        thread_pool &operator=(thread_pool &&) = delete;
+        ~thread_pool() noexcept
+        {
+            for (auto &worker : workers_)
+                worker.request_stop();
+            cv_.notify_all();
+        }
+
+        template <typename F>
+        auto submit(F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            using result_type = std::invoke_result_t<std::decay_t<F>>;
+            std::packaged_task<result_type()> task{std::forward<F>(f)};
+            auto future = task.get_future();
+            {
+                std::scoped_lock lock{mutex_};
+                tasks_.emplace_back(std::move(task));
+            }
+            cv_.notify_one();
+            return future;
+        }
+
+        // NOTE: fn(index) 并行执行 [0, count)，第一个异常会在全部结束后重新抛出
+        void for_each_index(size_t count, auto &&fn)
+        {
+            if (count == 0)
+                return;
+            std::atomic<size_t> next{0};
+            const size_t jobs = std::min(count, workers_.size());
+            std::vector<std::future<void>> futures;
+            futures.reserve(jobs);
+            for (size_t j = 0; j < jobs; ++j)
+                futures.emplace_back(submit([&] {
+                    constexpr auto order = std::memory_order_relaxed;
+                    for (size_t i = next.fetch_add(1, order); i < count;
+                         i = next.fetch_add(1, order))
+                        fn(i);
+                }));
+            std::exception_ptr error;
+            for (auto &f : futures)
+            {
+                try
+                {
+                    f.get();
+                }
+                catch (...)
+                {
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return workers_.size();
+        }
+
+        // NOTE: 当前工作线程在池中的下标 [0, size())，非池内线程返回 npos
+        [[nodiscard]] static size_t current_worker() noexcept
+        {
+            return worker_index();
+        }
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+      private:
+        std::mutex mutex_;
+        std::condition_variable_any cv_;
+        std::deque<std::move_only_function<void()>> tasks_;
+        std::vector<std::jthread> workers_; // NOTE: 最后声明，最先析构(join)
+
+        static size_t &worker_index() noexcept
+        {
+            thread_local size_t index = npos;
+            return index;
+        }
+
+        void run(const std::stop_token &token)
+        {
+            while (true)
+            {
+                std::move_only_function<void()> task;
+                {
+                    std::unique_lock lock{mutex_};
+                    if (!cv_.wait(lock, token, [this] { return !tasks_.empty(); }))
+                        return;
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+                task();
+            }
+        }
+    };
+}; // namespace mcs::vulkan
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "mcs_assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan
+{
+    /**
+     * NOTE: 带权序列(隐式 treap)。元素按下标排列，每个元素有一个权值(如字节数):
+     * - 按下标访问、按累计权值定位、在任意位置插入/删除区间都是期望 O(log n)
+     * - 节点放在数组里用下标互相引用，删除的节点留待复用
+     * Weight(const T &) 返回元素的权值，元素插入后权值不能再变。
+     */
+    template <typename T, typename Weight>
+    class weighted_sequence
+    {
+      public:
+        using node_type = uint32_t;
+        static constexpr node_type INVALID_NODE = (std::numeric_limits<node_type>::max)();
+
+        constexpr weighted_sequence() = default;
+        constexpr explicit weighted_sequence(Weight weight) : weight_{std::move(weight)}
+        {
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept
+        {
+            return countOf(root_);
+        }
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return root_ == INVALID_NODE;
+        }
+        // NOTE: 所有元素的权值之和
+        [[nodiscard]] constexpr size_t total() const noexcept
+        {
+            return weightOf(root_);
+        }
+
+        constexpr void clear() noexcept
+        {
+            nodes_.clear();
+            recycled_.clear();
+            root_ = INVALID_NODE;
+        }
+
+        [[nodiscard]] constexpr T &operator[](size_t index) noexcept
+        {
+            return nodes_[find(index)].value;
+        }
+        [[nodiscard]] constexpr const T &operator[](size_t index) const noexcept
+        {
+            return nodes_[find(index)].value;
+        }
+
+        constexpr void push_back(T value)
+        {
+            root_ = merge(root_, newNode(std::move(value)));
+        }
+        // NOTE: 把 values 中的元素依次移入，第一个元素的下标为 index
+        template <std::ranges::input_range R>
+        constexpr void insert(size_t index, R &&values)
+        {
+            MCS_ASSERT(index <= size(), "weighted_sequence::insert out of range");
+            node_type fresh = INVALID_NODE;
+            for (auto &&value : values)
+                fresh = merge(fresh, newNode(std::move(value)));
+            auto [front, back] = split(root_, index);
+            root_ = merge(merge(front, fresh), back);
+        }
+        // NOTE: 删除 [first, last)，O(log n + 删除的元素数)
+        constexpr void erase(size_t first, size_t last) noexcept
+        {
+            MCS_ASSERT(first <= last && last <= size(),
+                       "weighted_sequence::erase out of range");
+            auto [front, rest] = split(root_, first);
+            auto [middle, back] = split(rest, last - first);
+            release(middle);
+            root_ = merge(front, back);
+        }
+
+        /**
+         * @brief 累计权值 -> (元素下标, 元素内偏移)
+         * 权值为 0 的元素不会被选中；offset >= total() 时返回 (size(), offset - total())
+         */
+        [[nodiscard]] constexpr std::pair<size_t, size_t> locate(
+            size_t offset) const noexcept
+        {
+            if (offset >= total())
+                return {size(), offset - total()};
+            size_t index = 0;
+            node_type n = root_;
+            while (n != INVALID_NODE)
+            {
+                const auto &cur = nodes_[n];
+                const size_t left = weightOf(cur.left);
+                if (offset < left)
+                {
+                    n = cur.left;
+                    continue;
+                }
+                offset -= left;
+                index += countOf(cur.left);
+                if (offset < cur.weight)
+                    return {index, offset};
+                offset -= cur.weight;
+                ++index;
+                n = cur.right;
+            }
+            return {size(), offset};
+        }
+
+        // NOTE: 树高(空序列为 0)，遍历所有节点，只用于测试/诊断
+        [[nodiscard]] constexpr size_t depth() const noexcept
+        {
+            return depthOf(root_);
+        }
+
+        // NOTE: 按下标顺序访问每个元素
+        template <typename F>
+        constexpr void for_each(F &&fn)
+        {
+            visit(*this, root_, fn);
+        }
+        template <typename F>
+        constexpr void for_each(F &&fn) const
+        {
+            visit(*this, root_, fn);
+        }
+
+      private:
+        struct node // NOLINTBEGIN
+        {
+            T value;
+            size_t weight;  // 本元素
+            size_t summary; // 子树权值和
+            node_type count{1};
+            node_type left{INVALID_NODE};
+            node_type right{INVALID_NODE};
+            uint32_t priority;
+        }; // NOLINTEND
+
+        [[no_unique_address]] Weight weight_{};
+        std::vector<node> nodes_;
+        std::vector<node_type> recycled_;
+        node_type root_{INVALID_NODE};
+        uint32_t seed_{0x9E3779B9U};
+
+        [[nodiscard]] constexpr size_t countOf(node_type n) const noexcept
+        {
+            return n == INVALID_NODE ? 0 : nodes_[n].count;
+        }
+        [[nodiscard]] constexpr size_t weightOf(node_type n) const noexcept
+        {
+            return n == INVALID_NODE ? 0 : nodes_[n].summary;
+        }
+        [[nodiscard]] constexpr size_t depthOf(node_type n) const noexcept
+        {
+            if (n == INVALID_NODE)
+                return 0;
+            return 1 + std::max(depthOf(nodes_[n].left), depthOf(nodes_[n].right));
+        }
+        constexpr void update(node_type n) noexcept
+        {
+            auto &cur = nodes_[n];
+            cur.count =
+                static_cast<node_type>(1 + countOf(cur.left) + countOf(cur.right));
+            cur.summary = cur.weight + weightOf(cur.left) + weightOf(cur.right);
+        }
+
+        // NOTE: xorshift32，只用来打乱优先级
+        constexpr uint32_t nextPriority() noexcept
+        {
+            seed_ ^= seed_ << 13U;
+            seed_ ^= seed_ >> 17U;
+            seed_ ^= seed_ << 5U;
+            return seed_;
+        }
+        constexpr node_type newNode(T value)
+        {
+            const size_t weight = weight_(value);
+            node item{.value = std::move(value),
+                      .weight = weight,
+                      .summary = weight,
+                      .priority = nextPriority()};
+            if (!recycled_.empty())
+            {
+                const node_type index = recycled_.back();
+                recycled_.pop_back();
+                nodes_[index] = std::move(item);
+                return index;
+            }
+            nodes_.emplace_back(std::move(item));
+            recycled_.reserve(nodes_.size());
+            return static_cast<node_type>(nodes_.size() - 1);
+        }
+        constexpr void release(node_type n) noexcept
+        {
+            if (n == INVALID_NODE)
+                return;
+            release(nodes_[n].left);
+            release(nodes_[n].right);
+            nodes_[n].value = T{};
+            // NOTE: 不会分配：newNode 保证 recycled_ 的容量不小于节点数
+            recycled_.push_back(n);
+        }
+
+        [[nodiscard]] constexpr node_type find(size_t index) const noexcept
+        {
+            MCS_ASSERT(index < size(), "weighted_sequence index out of range");
+            node_type n = root_;
+            while (true)
+            {
+                const size_t left = countOf(nodes_[n].left);
+                if (index == left)
+                    return n;
+                if (index < left)
+                    n = nodes_[n].left;
+                else
+                {
+                    index -= left + 1;
+                    n = nodes_[n].right;
+                }
+            }
+        }
+
+        // NOTE: 前 count 个元素与其余元素
+        constexpr std::pair<node_type, node_type> split(node_type n,
+                                                        size_t count) noexcept
+        {
+            if (n == INVALID_NODE)
+                return {INVALID_NODE, INVALID_NODE};
+            if (countOf(nodes_[n].left) >= count)
+            {
+                auto [front, back] = split(nodes_[n].left, count);
+                nodes_[n].left = back;
+                update(n);
+                return {front, n};
+            }
+            const size_t skip = countOf(nodes_[n].left) + 1;
+            auto [front, back] = split(nodes_[n].right, count - skip);
+            nodes_[n].right = front;
+            update(n);
+            return {n, back};
+        }
+        constexpr node_type merge(node_type front, node_type back) noexcept
+        {
+            if (front == INVALID_NODE)
+                return back;
+            if (back == INVALID_NODE)
+                return front;
+            if (nodes_[front].priority > nodes_[back].priority)
+            {
+                nodes_[front].right = merge(nodes_[front].right, back);
+                update(front);
+                return front;
+            }
+            nodes_[back].left = merge(front, nodes_[back].left);
+            update(back);
+            return back;
+        }
+
+        template <typename Self, typename F>
+        static constexpr void visit(Self &self, node_type n, F &fn)
+        {
+            if (n == INVALID_NODE)
+                return;
+            visit(self, self.nodes_[n].left, fn);
+            fn(self.nodes_[n].value);
+            visit(self, self.nodes_[n].right, fn);
+        }
+    };
+}; // namespace mcs::vulkan
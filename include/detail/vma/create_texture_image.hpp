@@ -8,7 +8,9 @@
 #include "../CommandPool.hpp"
 
 #include "../utils/get_mip_levels.hpp"
+#include "../utils/mcs_assert.hpp"
 
+#include <array>
 #include <span>
 #include <utility>
 
@@ -17,8 +19,12 @@
 #include "create_image.hpp"
 
 #include "../load/raw_stbi_image.hpp"
+#include "../load/ktx2_image.hpp"
+#include "../load/mip_chain.hpp"
 #include "../tool/sType.hpp"
 
+#include <vector>
+
 namespace mcs::vulkan::vma
 {
     struct create_texture_image
@@ -57,12 +63,20 @@ namespace mcs::vulkan::vma
                                           const VkImage &image, VkImageLayout oldLayout,
                                           VkImageLayout newLayout, uint32_t mipLevels)
         {
-            using tool::sType;
             // 我们需要执行几个转换：
             // 1.从初始未定义的布局到针对接收数据优化的布局（传输目的地）
             // 2.从传输目的地到针对着色器读取优化的布局，因此我们的片段着色器可以从中采样
             auto commandBuffer = beginSingleTimeCommand(pool);
+            recordTransition(commandBuffer, image, oldLayout, newLayout, mipLevels);
+            endSingleTimeCommand(pool, queue, commandBuffer);
+        }
 
+        // NOTE: 只录制屏障，不提交。upload_queue 把多个纹理录进同一个命令缓冲
+        static void recordTransition(const CommandBufferView &commandBuffer,
+                                     const VkImage &image, VkImageLayout oldLayout,
+                                     VkImageLayout newLayout, uint32_t mipLevels)
+        {
+            using tool::sType;
             VkImageMemoryBarrier barrier{
                 .sType = sType<VkImageMemoryBarrier>(),
                 .oldLayout = oldLayout,
@@ -108,7 +122,6 @@ namespace mcs::vulkan::vma
             // NOTE: 4. 执行布局转换的最常见方法之一是使用映像内存屏障。设置不同掩码来优化速度
             commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, {}, {},
                                           std::array<VkImageMemoryBarrier, 1>{barrier});
-            endSingleTimeCommand(pool, queue, commandBuffer);
         }
 
         static void copyBufferToImage(const CommandPool &commandpool, const Queue &queue,
@@ -147,28 +160,126 @@ namespace mcs::vulkan::vma
                                     VkImage &image, VkFormat imageFormat,
                                     mipmap_param param)
         {
-            using tool::sType;
-            auto [texWidth, texHeight, mipLevels] = param;
+            checkLinearBlit(*commandpool.device(), imageFormat);
+            auto commandBuffer = beginSingleTimeCommand(commandpool);
+            recordMipmaps(commandBuffer, image, param);
+            endSingleTimeCommand(commandpool, queue, commandBuffer);
+            // NOTE: 应该注意的是，在运行时生成mipmap级别在实践中并不常见。
+            //  通常它们是预先生成的，并与基本级别一起存储在纹理文件中，以提高加载速度
 
-            const auto *logicalDevice = commandpool.device();
+            // NOTE:总之，每个mip级别都要像加载原始图像一样加载到图像中。
+        }
 
+        static void checkLinearBlit(const LogicalDevice &logicalDevice,
+                                    VkFormat imageFormat)
+        {
             /*
         这样的内置函数生成所有mip级别非常方便，
         但遗憾的是不能保证所有平台都支持，它需要我们使用的纹理图像格式来支持线性过滤
         */
             // NOTE: 4. 要求线性滤波
             //  Check if image format supports linear blit-ing
-            if (VkFormatProperties formatProperties =
-                    logicalDevice->physicalDevice()->getFormatProperties(imageFormat);
-                (formatProperties.optimalTilingFeatures &
-                 VkFormatFeatureFlagBits::
-                     VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) == 0)
+            if (!supportsLinearBlit(logicalDevice, imageFormat))
             {
                 throw std::runtime_error(
                     "texture image format does not support linear blitting!");
             }
+        }
+        [[nodiscard]] static bool supportsLinearBlit(const LogicalDevice &logicalDevice,
+                                                     VkFormat imageFormat)
+        {
+            const VkFormatProperties formatProperties =
+                logicalDevice.physicalDevice()->getFormatProperties(imageFormat);
+            return (formatProperties.optimalTilingFeatures &
+                    VkFormatFeatureFlagBits::
+                        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+        }
 
-            auto commandBuffer = beginSingleTimeCommand(commandpool);
+        // NOTE: load::mip_chain 能处理的格式(每像素 4 个 8 位通道)
+        [[nodiscard]] static constexpr bool isRgba8(VkFormat format) noexcept
+        {
+            switch (format)
+            {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                return true;
+            default:
+                return false;
+            }
+        }
+        [[nodiscard]] static constexpr bool isSrgb(VkFormat format) noexcept
+        {
+            return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+        }
+        /**
+         * NOTE: 核心格式的 texel(压缩格式为块)字节数，未知格式返回 0。
+         * 依赖 VkFormat 中同类格式连续编号；深度/模板格式按单个 aspect 拷贝，这里不区分
+         */
+        [[nodiscard]] static constexpr uint32_t texelBlockSize(VkFormat format) noexcept
+        {
+            struct format_range // NOLINTBEGIN
+            {
+                VkFormat first;
+                VkFormat last;
+                uint32_t size;
+            }; // NOLINTEND
+            constexpr std::array RANGES{
+                format_range{VK_FORMAT_R4G4_UNORM_PACK8, VK_FORMAT_R4G4_UNORM_PACK8, 1},
+                format_range{VK_FORMAT_R4G4B4A4_UNORM_PACK16,
+                             VK_FORMAT_A1R5G5B5_UNORM_PACK16, 2},
+                format_range{VK_FORMAT_R8_UNORM, VK_FORMAT_R8_SRGB, 1},
+                format_range{VK_FORMAT_R8G8_UNORM, VK_FORMAT_R8G8_SRGB, 2},
+                format_range{VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_B8G8R8_SRGB, 3},
+                format_range{VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_A2B10G10R10_SINT_PACK32,
+                             4},
+                format_range{VK_FORMAT_R16_UNORM, VK_FORMAT_R16_SFLOAT, 2},
+                format_range{VK_FORMAT_R16G16_UNORM, VK_FORMAT_R16G16_SFLOAT, 4},
+                format_range{VK_FORMAT_R16G16B16_UNORM, VK_FORMAT_R16G16B16_SFLOAT, 6},
+                format_range{VK_FORMAT_R16G16B16A16_UNORM, VK_FORMAT_R16G16B16A16_SFLOAT,
+                             8},
+                format_range{VK_FORMAT_R32_UINT, VK_FORMAT_R32_SFLOAT, 4},
+                format_range{VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32_SFLOAT, 8},
+                format_range{VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32_SFLOAT, 12},
+                format_range{VK_FORMAT_R32G32B32A32_UINT, VK_FORMAT_R32G32B32A32_SFLOAT,
+                             16},
+                format_range{VK_FORMAT_R64_UINT, VK_FORMAT_R64_SFLOAT, 8},
+                format_range{VK_FORMAT_R64G64_UINT, VK_FORMAT_R64G64_SFLOAT, 16},
+                format_range{VK_FORMAT_R64G64B64_UINT, VK_FORMAT_R64G64B64_SFLOAT, 24},
+                format_range{VK_FORMAT_R64G64B64A64_UINT, VK_FORMAT_R64G64B64A64_SFLOAT,
+                             32},
+                format_range{VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+                             VK_FORMAT_E5B9G9R9_UFLOAT_PACK32, 4},
+                format_range{VK_FORMAT_D16_UNORM, VK_FORMAT_D16_UNORM, 2},
+                format_range{VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D32_SFLOAT, 4},
+                format_range{VK_FORMAT_S8_UINT, VK_FORMAT_S8_UINT, 1},
+                format_range{VK_FORMAT_BC1_RGB_UNORM_BLOCK, VK_FORMAT_BC1_RGBA_SRGB_BLOCK,
+                             8},
+                format_range{VK_FORMAT_BC2_UNORM_BLOCK, VK_FORMAT_BC3_SRGB_BLOCK, 16},
+                format_range{VK_FORMAT_BC4_UNORM_BLOCK, VK_FORMAT_BC4_SNORM_BLOCK, 8},
+                format_range{VK_FORMAT_BC5_UNORM_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK, 16},
+                format_range{VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+                             VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK, 8},
+                format_range{VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+                             VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK, 16},
+                format_range{VK_FORMAT_EAC_R11_UNORM_BLOCK, VK_FORMAT_EAC_R11_SNORM_BLOCK,
+                             8},
+                format_range{VK_FORMAT_EAC_R11G11_UNORM_BLOCK,
+                             VK_FORMAT_ASTC_12x12_SRGB_BLOCK, 16},
+            };
+            for (const auto &range : RANGES)
+                if (format >= range.first && format <= range.last)
+                    return range.size;
+            return 0;
+        }
+
+        // NOTE: 录制 mip 链的 blit，调用前第 0 级为 TRANSFER_DST，结束时全部为 SHADER_READ
+        static void recordMipmaps(const CommandBufferView &commandBuffer,
+                                  const VkImage &image, mipmap_param param)
+        {
+            using tool::sType;
+            auto [texWidth, texHeight, mipLevels] = param;
 
             VkImageMemoryBarrier barrier = {
                 .sType = sType<VkImageMemoryBarrier>(),
@@ -257,12 +368,85 @@ namespace mcs::vulkan::vma
                 VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TRANSFER_BIT,
                 VkPipelineStageFlagBits::VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, {}, {},
                 std::span{&barrier, 1});
+        }
 
-            endSingleTimeCommand(commandpool, queue, commandBuffer);
-            // NOTE: 应该注意的是，在运行时生成mipmap级别在实践中并不常见。
-            //  通常它们是预先生成的，并与基本级别一起存储在纹理文件中，以提高加载速度
+        // NOTE: UNDEFINED -> 拷贝第 0 级 -> mip 链或直接 SHADER_READ
+        static void recordUpload(const CommandBufferView &commandBuffer,
+                                 VkBuffer buffer, VkDeviceSize offset,
+                                 const VkImage &image, VkExtent2D extent,
+                                 uint32_t mipLevels)
+        {
+            recordTransition(commandBuffer, image,
+                             VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                             VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             mipLevels);
+            VkBufferImageCopy region{
+                .bufferOffset = offset,
+                .bufferRowLength = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource = {VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, 0,
+                                     0, 1},
+                .imageOffset = {0, 0, 0},
+                .imageExtent = {extent.width, extent.height, 1}};
+            commandBuffer.copyBufferToImage(
+                buffer, image, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                std::array<VkBufferImageCopy, 1>{region});
+            if (mipLevels == 1)
+                recordTransition(commandBuffer, image,
+                                 VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                 VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                 mipLevels);
+            else
+                recordMipmaps(commandBuffer, image,
+                              mipmap_param{.width = static_cast<int32_t>(extent.width),
+                                           .height = static_cast<int32_t>(extent.height),
+                                           .mip_levels = mipLevels});
+        }
 
-            // NOTE:总之，每个mip级别都要像加载原始图像一样加载到图像中。
+        static void checkSampled(const LogicalDevice &logicalDevice, VkFormat imageFormat)
+        {
+            if (VkFormatProperties formatProperties =
+                    logicalDevice.physicalDevice()->getFormatProperties(imageFormat);
+                (formatProperties.optimalTilingFeatures &
+                 VkFormatFeatureFlagBits::VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0)
+            {
+                throw std::runtime_error(
+                    "texture image format does not support sampling!");
+            }
+        }
+
+        // NOTE: 预生成的 mip 链：整体进入 TRANSFER_DST，每级一个拷贝区域，不 blit
+        static void recordLevelsUpload(const CommandBufferView &commandBuffer,
+                                       VkBuffer buffer, VkDeviceSize offset,
+                                       const VkImage &image,
+                                       std::span<const load::image_level> levels)
+        {
+            const auto levelCount = static_cast<uint32_t>(levels.size());
+            recordTransition(commandBuffer, image,
+                             VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                             VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             levelCount);
+            std::vector<VkBufferImageCopy> regions;
+            regions.reserve(levels.size());
+            for (uint32_t i = 0; i < levelCount; ++i)
+            {
+                const auto &level = levels[i];
+                regions.emplace_back(VkBufferImageCopy{
+                    .bufferOffset = offset + level.offset,
+                    .bufferRowLength = 0,
+                    .bufferImageHeight = 0,
+                    .imageSubresource = {VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
+                                         i, 0, 1},
+                    .imageOffset = {0, 0, 0},
+                    .imageExtent = {level.width, level.height, 1}});
+            }
+            commandBuffer.copyBufferToImage(
+                buffer, image, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                regions);
+            recordTransition(commandBuffer, image,
+                             VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             levelCount);
         }
 
         constexpr create_texture_image(const CommandPool &pool, const Queue &queue,
@@ -277,32 +461,60 @@ namespace mcs::vulkan::vma
             uint32_t mipLevels = creator_.createInfo().mipLevels;
             VmaAllocator allocator = creator_.allocator();
 
+            // NOTE: 格式不支持线性 blit 时改用 CPU 生成 mip 链
+            const VkFormat format = creator_.refImageFormat();
+            if (mipLevels > 1 && isRgba8(format) &&
+                !supportsLinearBlit(*pool_->device(), format))
+                return build(pixels, load::mip_options{.srgb = isSrgb(format)});
+
             // 创建暂存缓冲区
             auto stagingBuffer = staging_buffer(allocator, pixels.size());
             stagingBuffer.copyDataToBuffer(pixels.data(), pixels.size());
 
             auto textureImage_ = creator_.makeImage();
-            transitionImageLayout(
-                *pool_, *queue_, *textureImage_, VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
-                VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
-            copyBufferToImage(*pool_, *queue_, *stagingBuffer, *textureImage_,
-                              VkExtent2D{.width = width, .height = height});
+            if (mipLevels > 1)
+                checkLinearBlit(*pool_->device(), format);
+
+            // NOTE: 转换、拷贝、mip 生成录进同一个命令缓冲，只提交、等待一次
+            auto commandBuffer = beginSingleTimeCommand(*pool_);
+            recordUpload(commandBuffer, *stagingBuffer, 0, *textureImage_,
+                         VkExtent2D{.width = width, .height = height}, mipLevels);
+            endSingleTimeCommand(*pool_, *queue_, commandBuffer);
+            auto imageView_ = creator_.makeImageView(*textureImage_);
+            return {std::move(textureImage_), std::move(imageView_)};
+        }
 
-            if (mipLevels == 1)
-                transitionImageLayout(
-                    *pool_, *queue_, *textureImage_,
-                    VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
-            else
-                generateMipmaps(*pool_, *queue_, *textureImage_,
-                                creator_.refImageFormat(),
-                                mipmap_param{.width = static_cast<int32_t>(width),
-                                             .height = static_cast<int32_t>(height),
-                                             .mip_levels = mipLevels});
+        // NOTE: data 为所有级连续存放的数据，levels.size() 必须等于 mipLevels
+        resource build(std::span<const uint8_t> data,
+                       std::span<const load::image_level> levels)
+        {
+            MCS_ASSERT(levels.size() == creator_.createInfo().mipLevels);
+            VmaAllocator allocator = creator_.allocator();
+            checkSampled(*pool_->device(), creator_.createInfo().format);
+
+            auto stagingBuffer = staging_buffer(allocator, data.size());
+            stagingBuffer.copyDataToBuffer(data.data(), data.size());
+
+            auto textureImage_ = creator_.makeImage();
+            auto commandBuffer = beginSingleTimeCommand(*pool_);
+            recordLevelsUpload(commandBuffer, *stagingBuffer, 0, *textureImage_, levels);
+            endSingleTimeCommand(*pool_, *queue_, commandBuffer);
             auto imageView_ = creator_.makeImageView(*textureImage_);
             return {std::move(textureImage_), std::move(imageView_)};
         }
 
+        // NOTE: pixels 为紧密排列的 RGBA8 第 0 级，其余 mipLevels - 1 级在 CPU 上生成
+        resource build(std::span<const uint8_t> pixels, load::mip_options options,
+                       thread_pool *threads = nullptr)
+        {
+            const auto &info = creator_.createInfo();
+            MCS_ASSERT(isRgba8(info.format));
+            options.max_levels = info.mipLevels;
+            const load::mip_chain chain{pixels, info.extent.width, info.extent.height,
+                                        options, threads};
+            return build(chain.data(), chain.levels());
+        }
+
         constexpr auto &updateImageExtent(const VkExtent3D &extent) noexcept
         {
             creator_.createInfo().extent = extent;
@@ -388,6 +600,44 @@ namespace mcs::vulkan::vma
                 .build({img.data(), img.size()});
         }
 
+        // NOTE: 格式与 mip 级数取自文件
+        [[nodiscard]] create_image ktx2Creator(const load::ktx2_image &img) const
+        {
+            const uint32_t mipLevels = img.level_count();
+            return create_image{*queue_->device(), creator_.allocator()}
+                .setCreateInfo(
+                    {.imageType = VK_IMAGE_TYPE_2D,
+                     .format = img.format(),
+                     .extent = {.width = static_cast<uint32_t>(img.width()),
+                                .height = static_cast<uint32_t>(img.height()),
+                                .depth = 1},
+                     .mipLevels = mipLevels,
+                     .arrayLayers = 1,
+                     .samples = VK_SAMPLE_COUNT_1_BIT,
+                     .tiling = VK_IMAGE_TILING_OPTIMAL,
+                     .usage =
+                         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                     .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                     .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                     .allocationCreateInfo = {.usage = VMA_MEMORY_USAGE_AUTO}})
+                .setViewCreateInfo(
+                    {.viewType = VK_IMAGE_VIEW_TYPE_2D,
+                     .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                          .baseMipLevel = 0,
+                                          .levelCount = mipLevels,
+                                          .baseArrayLayer = 0,
+                                          .layerCount = 1}});
+        }
+        [[nodiscard]] auto templateForKtx2(const load::ktx2_image &img) const
+        {
+            return create_texture_image{*this->pool_, *this->queue_, ktx2Creator(img)}
+                .build(img.all_data(), img.levels());
+        }
+        [[nodiscard]] auto templateForKtx2(const std::string &path) const
+        {
+            return templateForKtx2(load::ktx2_image{path.c_str()});
+        }
+
       private:
         const CommandPool *pool_;
         const Queue *queue_;
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "../tool/sType.hpp"
+#include "../Queue.hpp"
+#include "../Fence.hpp"
+#include "../CommandBuffer.hpp"
+#include "../CommandPool.hpp"
+#include "../utils/make_vk_exception.hpp"
+#include "../utils/mcs_assert.hpp"
+#include "../load/image_source.hpp"
+
+#include "auto_map_buffer.hpp"
+#include "staging_buffer.hpp"
+#include "create_image.hpp"
+#include "create_texture_image.hpp"
+#include "resource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace mcs::vulkan::vma
+{
+    /**
+     * NOTE: 批量异步上传。create_texture_image::build 每个纹理都要提交并等待一次，
+     * 这里把任意多个纹理/缓冲的上传录进同一个命令缓冲，submit() 时才提交一次:
+     * - 暂存数据写入持久映射的环形缓冲区，超过一半容量的数据单独分配暂存缓冲
+     * - 每次提交得到一个单调递增的 ticket，由 fence 标记完成；completed() 不阻塞
+     * - 环形缓冲区写满时自动提交当前批次，并等待最早的批次退役以回收空间
+     * 纹理在对应 ticket 完成之前不能被采样、销毁。不是线程安全的。
+     */
+    class upload_queue
+    {
+      public:
+        static constexpr size_t DEFAULT_RING_SIZE = size_t{64} << 20U; // 64 MiB
+        // NOTE: 缓冲上传与未知格式的暂存偏移对齐；图像按 lcm(texel 块大小, 4)
+        static constexpr VkDeviceSize ALIGNMENT = 16;
+
+        upload_queue(const CommandPool &pool, const Queue &queue, VmaAllocator allocator,
+                     size_t ring_size = DEFAULT_RING_SIZE)
+            : pool_{&pool}, queue_{&queue}, allocator_{allocator},
+              ring_{staging_buffer(allocator, ring_size)}, ringSize_{ring_size}
+        {
+        }
+        upload_queue(const upload_queue &) = delete;
+        upload_queue(upload_queue &&) = delete;
+        upload_queue &operator=(const upload_queue &) = delete;
+        upload_queue &operator=(upload_queue &&) = delete;
+        ~upload_queue() noexcept
+        {
+            // NOTE: 未提交的录制直接丢弃；已提交的必须等 GPU 用完暂存内存
+            for (const auto &batch : inFlight_)
+                (void)pool_->device()->waitForFences(1, *batch.fence, VK_TRUE,
+                                                     UINT64_MAX);
+        }
+
+        /**
+         * NOTE: 创建 creator 描述的图像并录制上传: UNDEFINED -> 拷贝第 0 级 ->
+         * mip 链(mipLevels > 1，需要线性 blit)或直接 SHADER_READ_ONLY。
+         * pixels 为第 0 级的紧密排列数据，调用返回后即可释放。
+         */
+        resource texture(create_image &creator, std::span<const uint8_t> pixels)
+        {
+            const auto &info = creator.createInfo();
+            checkSampled(info.format);
+            if (info.mipLevels > 1 && info.format != lastBlitFormat_)
+            {
+                create_texture_image::checkLinearBlit(*pool_->device(), info.format);
+                lastBlitFormat_ = info.format;
+            }
+            auto image = creator.makeImage();
+            auto view = creator.makeImageView(*image);
+            const auto [src, offset] = stage(pixels, imageAlignment(info.format));
+            create_texture_image::recordUpload(
+                recording(), src, offset, *image,
+                VkExtent2D{.width = info.extent.width, .height = info.extent.height},
+                info.mipLevels);
+            return {std::move(image), std::move(view)};
+        }
+
+        // NOTE: 预生成的 mip 链(例如 load::ktx2_image::all_data()/levels())，不 blit
+        resource texture(create_image &creator, std::span<const uint8_t> data,
+                         std::span<const load::image_level> levels)
+        {
+            const auto &info = creator.createInfo();
+            MCS_ASSERT(levels.size() == info.mipLevels);
+            checkSampled(info.format);
+            auto image = creator.makeImage();
+            auto view = creator.makeImageView(*image);
+            const auto [src, offset] = stage(data, imageAlignment(info.format));
+            create_texture_image::recordLevelsUpload(recording(), src, offset, *image,
+                                                     levels);
+            return {std::move(image), std::move(view)};
+        }
+
+        // NOTE: 拷贝到 dst[offset, offset + data.size())，dst 需带 TRANSFER_DST 用途
+        void buffer(VkBuffer dst, VkDeviceSize offset, std::span<const uint8_t> data)
+        {
+            if (data.empty())
+                return;
+            const auto [src, src_offset] = stage(data, ALIGNMENT);
+            const VkBufferCopy region{
+                .srcOffset = src_offset, .dstOffset = offset, .size = data.size()};
+            recording().copyBuffer(src, dst, std::span{&region, 1});
+            bufferWritten_ = true;
+        }
+
+        // NOTE: 提交当前批次，返回其 ticket；没有待提交的内容时返回最近一次提交的 ticket
+        uint64_t submit()
+        {
+            using tool::sType;
+            if (!recording_)
+                return submitted_;
+            if (bufferWritten_)
+            {
+                // 后续提交中任何阶段读取这些缓冲都能看到传输写入
+                const VkMemoryBarrier barrier{
+                    .sType = sType<VkMemoryBarrier>(),
+                    .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                    .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT};
+                recording_.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                           VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, {},
+                                           std::span{&barrier, 1}, {}, {});
+                bufferWritten_ = false;
+            }
+            recording_.end();
+
+            batch next{.commandBuffer = std::move(recording_),
+                       .fence = takeFence(),
+                       .ticket = ++submitted_,
+                       .ringEnd = head_,
+                       .dedicated = std::move(dedicated_)};
+            dedicated_.clear();
+            queue_->submit(1,
+                           {.sType = sType<VkSubmitInfo>(),
+                            .commandBufferCount = 1,
+                            .pCommandBuffers = &*next.commandBuffer},
+                           *next.fence);
+            inFlight_.emplace_back(std::move(next));
+            ++submitCount_;
+            return submitted_;
+        }
+
+        // NOTE: 非阻塞，顺带回收所有已完成的批次
+        [[nodiscard]] bool completed(uint64_t ticket)
+        {
+            while (!inFlight_.empty() && signaled(inFlight_.front()))
+                retireFront();
+            return ticket <= completed_;
+        }
+
+        // NOTE: 等待 ticket 完成；ticket 属于尚未提交的批次时先提交
+        void wait(uint64_t ticket)
+        {
+            if (ticket > submitted_)
+                submit();
+            while (completed_ < ticket && !inFlight_.empty())
+            {
+                check_vkresult(pool_->device()->waitForFences(
+                    1, *inFlight_.front().fence, VK_TRUE, UINT64_MAX));
+                retireFront();
+            }
+        }
+
+        // NOTE: 提交并等待全部完成
+        void flush()
+        {
+            wait(submit());
+        }
+
+        // NOTE: 当前录制中的上传完成时的 ticket
+        [[nodiscard]] uint64_t pending_ticket() const noexcept
+        {
+            return submitted_ + 1;
+        }
+        [[nodiscard]] uint64_t completed_ticket() const noexcept
+        {
+            return completed_;
+        }
+        [[nodiscard]] size_t submit_count() const noexcept
+        {
+            return submitCount_;
+        }
+        [[nodiscard]] size_t in_flight() const noexcept
+        {
+            return inFlight_.size();
+        }
+        [[nodiscard]] size_t ring_size() const noexcept
+        {
+            return ringSize_;
+        }
+
+      private:
+        struct batch // NOLINTBEGIN
+        {
+            CommandBuffer commandBuffer;
+            Fence fence;
+            uint64_t ticket;
+            uint64_t ringEnd; // 退役后环形缓冲区的 tail
+            std::vector<buffer_base> dedicated;
+        }; // NOLINTEND
+
+        const CommandPool *pool_;
+        const Queue *queue_;
+        VmaAllocator allocator_;
+        auto_map_buffer ring_;
+        size_t ringSize_;
+        // NOTE: head_/tail_ 是单调递增的虚拟偏移，物理偏移为 % ringSize_
+        uint64_t head_{0};
+        uint64_t tail_{0};
+
+        CommandBuffer recording_;
+        std::vector<buffer_base> dedicated_;
+        bool bufferWritten_{false};
+        std::deque<batch> inFlight_;
+        std::vector<Fence> freeFences_;
+        uint64_t submitted_{0};
+        uint64_t completed_{0};
+        size_t submitCount_{0};
+        VkFormat lastBlitFormat_{VK_FORMAT_UNDEFINED};
+        VkFormat lastSampledFormat_{VK_FORMAT_UNDEFINED};
+
+        const CommandBufferView &recording()
+        {
+            if (!recording_)
+                recording_ = create_texture_image::beginSingleTimeCommand(*pool_);
+            return recording_;
+        }
+
+        Fence takeFence()
+        {
+            using tool::sType;
+            if (freeFences_.empty())
+                return Fence{*pool_->device(),
+                             {.sType = sType<VkFenceCreateInfo>(), .flags = 0}};
+            Fence fence = std::move(freeFences_.back());
+            freeFences_.pop_back();
+            return fence;
+        }
+
+        [[nodiscard]] bool signaled(const batch &inFlight) const
+        {
+            const VkResult result =
+                pool_->device()->waitForFences(1, *inFlight.fence, VK_TRUE, 0);
+            if (result == VK_TIMEOUT)
+                return false;
+            check_vkresult(result);
+            return true;
+        }
+
+        void retireFront()
+        {
+            auto &front = inFlight_.front();
+            pool_->device()->resetFences(1, *front.fence);
+            freeFences_.emplace_back(std::move(front.fence));
+            tail_ = front.ringEnd;
+            completed_ = front.ticket;
+            inFlight_.pop_front();
+        }
+
+        // NOTE: bufferOffset 必须是 texel 块大小的整数倍，且是 4 的倍数；
+        //  3/6/12 字节的格式不是 2 的幂，16 字节对齐满足不了
+        [[nodiscard]] static constexpr VkDeviceSize imageAlignment(
+            VkFormat format) noexcept
+        {
+            const VkDeviceSize block = create_texture_image::texelBlockSize(format);
+            return block == 0 ? ALIGNMENT : std::lcm(block, VkDeviceSize{4});
+        }
+        // NOTE: 同一格式只查询一次
+        void checkSampled(VkFormat format)
+        {
+            if (format == lastSampledFormat_)
+                return;
+            create_texture_image::checkSampled(*pool_->device(), format);
+            lastSampledFormat_ = format;
+        }
+
+        // NOTE: 把 data 写入暂存内存，返回 {buffer, offset}，offset 是 alignment 的倍数
+        std::pair<VkBuffer, VkDeviceSize> stage(std::span<const uint8_t> data,
+                                                VkDeviceSize alignment)
+        {
+            const uint64_t size = data.size();
+            if (size > ringSize_ / 2)
+            {
+                // 大块数据不占环形缓冲区，随批次退役释放
+                auto &dedicated =
+                    dedicated_.emplace_back(staging_buffer(allocator_, size));
+                dedicated.copyDataToBuffer(data.data(), size);
+                check_vkresult(
+                    ::vmaFlushAllocation(allocator_, dedicated.allocation(), 0, size));
+                return {dedicated.buffer(), 0};
+            }
+
+            const uint64_t offset = reserve(size, alignment) % ringSize_;
+            std::memcpy(static_cast<uint8_t *>(ring_.mapPtr()) + offset, data.data(),
+                        size);
+            // NOTE: 内存类型不是 HOST_COHERENT 时需要 flush，否则为空操作
+            check_vkresult(
+                ::vmaFlushAllocation(allocator_, ring_.allocation(), offset, size));
+            return {ring_.buffer(), offset};
+        }
+
+        uint64_t reserve(uint64_t size, uint64_t alignment)
+        {
+            for (;;)
+            {
+                // 全部空闲时从一圈的起点开始，避免零散的尾部
+                if (head_ == tail_ && inFlight_.empty() && !recording_)
+                    head_ = tail_ = (head_ + ringSize_ - 1) / ringSize_ * ringSize_;
+
+                // NOTE: 对齐的是物理偏移：alignment 不一定整除 ringSize_
+                const uint64_t lap = head_ / ringSize_ * ringSize_;
+                uint64_t offset =
+                    lap + ((head_ - lap + alignment - 1) / alignment * alignment);
+                if (offset - lap + size > ringSize_) // 不跨越末尾，跳到下一圈
+                    offset = lap + ringSize_;
+                if (offset + size - tail_ <= ringSize_)
+                {
+                    head_ = offset + size;
+                    return offset;
+                }
+                // 空间被占用：先退役最早的批次，没有在途批次时提交当前批次
+                if (inFlight_.empty())
+                    submit();
+                wait(inFlight_.front().ticket);
+            }
+        }
+    };
+}; // namespace mcs::vulkan::vma
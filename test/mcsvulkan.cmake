@@ -9,4 +9,5 @@ include(${CMAKE_SOURCE_DIR}/test/mcsvulkan/conn.cmake)
 include(${CMAKE_SOURCE_DIR}/test/mcsvulkan/yoga.cmake)
 include(${CMAKE_SOURCE_DIR}/test/mcsvulkan/meta.cmake)
 include(${CMAKE_SOURCE_DIR}/test/mcsvulkan/ecs.cmake)
-include(${CMAKE_SOURCE_DIR}/test/mcsvulkan/task.cmake)
\ No newline at end of file
+include(${CMAKE_SOURCE_DIR}/test/mcsvulkan/task.cmake)
+include(${CMAKE_SOURCE_DIR}/test/mcsvulkan/font.cmake)
\ No newline at end of file
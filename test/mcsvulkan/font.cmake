@@ -0,0 +1,38 @@
+set(DIR_NAME "mcsvulkan/font")
+set(EXE_DIR "${CMAKE_SOURCE_DIR}/test/${DIR_NAME}")
+
+set(BASE_LIBS ${MCSVULKAN_LIBS})
+
+macro(add_vulkan_font_test fileName)
+    string(REPLACE "/" "-" PREFIX_NAME ${DIR_NAME})
+    set(TAGET_NAME "${PREFIX_NAME}-${fileName}")
+    add_executable(${TAGET_NAME} "${EXE_DIR}/${fileName}.cpp")
+    target_link_libraries(${TAGET_NAME} PRIVATE ${BASE_LIBS})
+
+    # 添加测试
+    add_test(NAME "${TAGET_NAME}" COMMAND $<TARGET_FILE:${TAGET_NAME}>)
+endmacro()
+
+add_vulkan_font_test(test_select_cache)
+add_vulkan_font_test(test_text_arena)
+add_vulkan_font_test(test_text_document)
+add_vulkan_font_test(test_shape_batch)
+add_vulkan_font_test(test_shape_plan_cache)
+ADD_MSDF_DEF(${TAGET_NAME})
+add_vulkan_font_test(test_line_fitter)
+add_vulkan_font_test(test_text_view)
+add_vulkan_font_test(test_dynamic_atlas)
+target_link_libraries(${TAGET_NAME} PRIVATE msdfgen::msdfgen)
+ADD_MSDF_DEF(${TAGET_NAME})
+add_vulkan_font_test(test_utf8_decode)
+add_vulkan_font_test(test_line_breakers)
+target_link_libraries(${TAGET_NAME} PRIVATE ICU::uc ICU::i18n ICU::dt)
+add_vulkan_font_test(test_glyph_instance)
+add_vulkan_font_test(test_cluster_index)
+add_vulkan_font_test(test_mapped_file)
+ADD_MSDF_DEF(${TAGET_NAME})
+
+# end
+unset(BASE_LIBS)
+unset(EXE_DIR)
+unset(DIR_NAME)
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../../../include/detail/__font.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <initializer_list>
+#include <print>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define TEST(name) std::cout << "[TEST] " << name << " ... "
+#define PASS() std::cout << "PASSED\n"
+#define CHECK(cond)                                                              \
+    do                                                                           \
+    {                                                                            \
+        if (!(cond))                                                             \
+        {                                                                        \
+            std::cerr << "FAILED at line " << __LINE__ << ": " << #cond << "\n"; \
+            std::abort();                                                        \
+        }                                                                        \
+    } while (false)
+#define REQUIRE(cond) CHECK(cond)
+
+namespace fake
+{
+    using mcs::vulkan::font::FontInfo;
+    using mcs::vulkan::font::FontMetadata;
+
+    using mcs::vulkan::font::Font;
+
+    // NOTE: 每个字形固定 advance 16px(atlas.size = 32，即 0.5em)，断行/测量才有意义
+    inline hb_font_t *make_hb_font()
+    {
+        static hb_font_funcs_t *funcs = [] {
+            hb_font_funcs_t *f = hb_font_funcs_create();
+            hb_font_funcs_set_glyph_h_advance_func(
+                f,
+                [](hb_font_t *, void *, hb_codepoint_t, void *) -> hb_position_t {
+                    return 16 * 64; // NOLINT
+                },
+                nullptr, nullptr);
+            hb_font_funcs_make_immutable(f);
+            return f;
+        }();
+        hb_font_t *font = hb_font_create(hb_face_get_empty());
+        hb_font_set_funcs(font, funcs, nullptr, nullptr);
+        return font;
+    }
+
+    // NOTE: 无需 GPU 的 FontContext，字形覆盖直接使用 meta_data.unicode_set
+    // hb_font 基于空 face：任何码点都 shape 成 glyph 0，足够驱动整条管线
+    struct font_context // NOLINTBEGIN
+    {
+        using glyph_info_type = mcs::vulkan::font::GlyphInfo<font_context>;
+        using hb_font_type =
+            mcs::vulkan::unique_handle<hb_font_t *, [](hb_font_t *value) noexcept {
+                hb_font_destroy(value);
+            }>;
+
+        std::string name;
+        FontMetadata meta_data;
+        Font font;
+        Font::glyphs_type notdef{};
+        std::unordered_map<FT_UInt, const Font::glyphs_type *> glyph_index_to_glyphs;
+        std::unordered_map<uint32_t, const Font::glyphs_type *> unicode_default_glyphs;
+        hb_font_type hb_font{make_hb_font()};
+
+        [[nodiscard]] bool has_glyph(uint32_t codepoint) const noexcept
+        {
+            return contain_codepoint(meta_data, codepoint);
+        }
+        static bool contain_codepoint(const FontMetadata &meta_data,
+                                      char32_t codepoint) noexcept
+        {
+            return hb_set_has(meta_data.unicode_set.get(), codepoint) != 0;
+        }
+        static bool contain_lang(const FontMetadata &meta_data, hb_tag_t tag) noexcept
+        {
+            return meta_data.lang_tags.contains(tag);
+        }
+        static bool contain_script(const FontMetadata &meta_data,
+                                   hb_script_t script) noexcept
+        {
+            return meta_data.scripts.contains(script);
+        }
+        [[nodiscard]] bool contain_lang(hb_tag_t tag) const noexcept
+        {
+            return contain_lang(meta_data, tag);
+        }
+        [[nodiscard]] bool contain_script(hb_script_t script) const noexcept
+        {
+            return contain_script(meta_data, script);
+        }
+    }; // NOLINTEND
+
+    struct font_factory
+    {
+        using font_context_type = font_context;
+
+        const font_context *make(FontInfo info)
+        {
+            auto ctx = std::make_unique<font_context>();
+            ctx->name = info.meta_data.family_name;
+            ctx->meta_data = std::move(info.meta_data);
+            ctx->font.atlas.size = 32; // NOLINT
+            ctx->glyph_index_to_glyphs[0] = &ctx->notdef;
+            return fonts.emplace_back(std::move(ctx)).get();
+        }
+        void removeFont(const font_context *font)
+        {
+            std::erase_if(fonts, [font](const auto &ptr) { return ptr.get() == font; });
+        }
+        std::vector<std::unique_ptr<font_context>> fonts; // NOLINT
+    };
+
+    struct range
+    {
+        char32_t first;
+        char32_t last;
+    };
+    inline FontInfo make_info(std::string name, std::initializer_list<range> ranges,
+                              std::set<hb_script_t> scripts, std::set<hb_tag_t> langs)
+    {
+        FontInfo info{};
+        info.meta_data.family_name = std::move(name);
+        for (auto [first, last] : ranges)
+            hb_set_add_range(info.meta_data.unicode_set.get(), first, last);
+        info.meta_data.scripts = std::move(scripts);
+        info.meta_data.lang_tags = std::move(langs);
+        return info;
+    }
+}; // namespace fake
@@ -0,0 +1,189 @@
+#include "head.hpp"
+#include "../../../include/detail/font/cluster_index.hpp"
+#include <algorithm>
+#include <format>
+
+namespace font_ns = mcs::vulkan::font;
+using font_ns::cluster_index;
+using font_ns::line_fitter;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+using layout_type = font_ns::text_layout<fake::font_context>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+constexpr double CHAR_ADVANCE = 0.5;
+
+static void load_fonts(selector_type &selector)
+{
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}, {0x300, 0x36F}, {0x1F300, 0x1FAFF}},
+                            {HB_SCRIPT_LATIN}, {ENG}));
+    selector.load(make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.initNotdefFont();
+}
+
+// NOTE: 每个 cluster 的第一个 glyph 占固定宽度，其余(组合附加符、肤色修饰符)为 0
+static layout_type make_layout(selector_type &selector, std::string_view text,
+                               int base_level = 0)
+{
+    auto &arena = font_ns::text_arena<fake::font_context>::local();
+    font_ns::layout_text(arena, text, base_level, selector);
+    layout_type layout = arena;
+    for (size_t i = 0; i < layout.glyphs.size(); ++i)
+    {
+        const bool follower =
+            i > 0 && layout.glyphs[i - 1].logical_idx == layout.glyphs[i].logical_idx;
+        layout.glyphs[i].advance_x = follower ? 0.0 : CHAR_ADVANCE;
+    }
+    return layout;
+}
+
+// NOTE: 每个 glyph 都落在其 cluster 所在字素簇的 glyph 区间内
+static void check_glyph_ranges(const cluster_index &index, const layout_type &layout)
+{
+    for (size_t gi = 0; gi < layout.glyphs.size(); ++gi)
+    {
+        const size_t logical = layout.glyphs[gi].logical_idx;
+        const auto &g = index.graphemes()[index.grapheme_at(logical)];
+        CHECK(gi >= g.glyph_first && gi < g.glyph_first + g.glyph_count);
+    }
+}
+
+static void test_ltr()
+{
+    TEST("LTR carets, hit testing and grapheme-aware movement");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    auto layout = make_layout(selector, "Hello");
+    cluster_index index;
+    index.build(layout);
+    CHECK(index.graphemes().size() == 5);
+    CHECK(index.width() == 2.5);
+    for (size_t i = 0; i <= 5; ++i)
+        CHECK(index.caret_x(i) == CHAR_ADVANCE * static_cast<double>(i));
+    CHECK(index.hit_test(-1.0) == 0);
+    CHECK(index.hit_test(0.74) == 1);
+    CHECK(index.hit_test(0.76) == 2);
+    CHECK(index.hit_test(100.0) == 5);
+    check_glyph_ranges(index, layout);
+
+    // NOTE: "q" + U+0307 U+0323(NFC 只重排、不合成) 与 👍🏽 各是一个字素簇
+    layout = make_layout(selector, "aq\xCC\x87\xCC\xA3\xF0\x9F\x91\x8D\xF0\x9F\x8F\xBDz");
+    index.build(layout);
+    CHECK(layout.codepoints.size() == 7);
+    CHECK(index.graphemes().size() == 4);
+    CHECK(index.next_caret(0) == 1);
+    CHECK(index.next_caret(1) == 4);
+    CHECK(index.next_caret(4) == 6);
+    CHECK(index.next_caret(6) == 7);
+    CHECK(index.next_caret(7) == 7);
+    CHECK(index.prev_caret(7) == 6);
+    CHECK(index.prev_caret(6) == 4);
+    CHECK(index.prev_caret(4) == 1);
+    CHECK(index.prev_caret(0) == 0);
+    CHECK(index.grapheme_at(3) == 1);
+    CHECK(index.caret_x(4) == 2 * CHAR_ADVANCE);
+    check_glyph_ranges(index, layout);
+    PASS();
+}
+
+static void test_rtl_and_mixed()
+{
+    TEST("RTL and mixed-direction carets round-trip through hit testing");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    // 纯 RTL：逻辑起点在最右
+    auto layout = make_layout(selector, "مرحبا", 1);
+    cluster_index index;
+    index.build(layout);
+    const size_t n = layout.codepoints.size();
+    CHECK(index.graphemes().size() == n);
+    CHECK(index.caret_x(0) == index.width());
+    CHECK(index.caret_x(n) == 0.0);
+    for (size_t i = 0; i <= n; ++i)
+        CHECK(index.hit_test(index.caret_x(i)) == i);
+    CHECK(index.hit_test(index.width() + 1.0) == 0);
+    check_glyph_ranges(index, layout);
+
+    // 混排：每个字素簇的两侧光标都能命中回来
+    layout = make_layout(selector, "abc مرحبا def");
+    index.build(layout);
+    check_glyph_ranges(index, layout);
+    for (const auto &g : index.graphemes())
+    {
+        CHECK(g.width == CHAR_ADVANCE);
+        const double quarter = g.width / 4;
+        CHECK(index.hit_test(g.leading() + (g.rtl ? -quarter : quarter)) == g.first);
+        CHECK(index.hit_test(g.trailing() + (g.rtl ? quarter : -quarter)) ==
+              g.first + g.count);
+    }
+    PASS();
+}
+
+static void test_wrapped_line()
+{
+    TEST("cluster_index over one wrapped line uses line-relative x");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    auto layout = make_layout(selector, "aaa bbb ccc");
+    line_fitter fitter;
+    fitter.build(layout);
+    auto lines = fitter.wrap(2.0);
+    CHECK(lines.size() == 3);
+    std::vector<font_ns::run_range> runs;
+    fitter.reorder(layout, lines[1], runs);
+    cluster_index index;
+    index.build(layout, runs, lines[1].first, lines[1].first + lines[1].count);
+    CHECK(index.graphemes().size() == lines[1].count);
+    CHECK(index.caret_x(lines[1].first) == 0.0);
+    CHECK(index.hit_test(0.0) == lines[1].first);
+    CHECK(index.hit_test(0.3) == lines[1].first + 1);
+    PASS();
+}
+
+static void bench_hit_test()
+{
+    using clock = std::chrono::steady_clock;
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    std::string text;
+    for (size_t i = 0; text.size() < 100'000; ++i)
+        text += std::format("{} ", (i % 3) == 0 ? "مرحبا" : "lorem");
+    auto layout = make_layout(selector, text);
+
+    auto start = clock::now();
+    cluster_index index;
+    index.build(layout);
+    const double build_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    constexpr size_t QUERIES = 1'000'000;
+    size_t checksum = 0;
+    start = clock::now();
+    for (size_t i = 0; i < QUERIES; ++i)
+        checksum += index.hit_test(index.width() * static_cast<double>(i % 997) / 997.0);
+    const double query_ns =
+        std::chrono::duration<double, std::nano>(clock::now() - start).count() /
+        static_cast<double>(QUERIES);
+    std::println("[BENCH] {} codepoints, {} graphemes: build {:.2f} ms, "
+                 "hit_test {:.1f} ns/query (checksum {})",
+                 layout.codepoints.size(), index.graphemes().size(), build_ms, query_ns,
+                 checksum);
+}
+
+int main()
+{
+    test_ltr();
+    test_rtl_and_mixed();
+    test_wrapped_line();
+    bench_hit_test();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
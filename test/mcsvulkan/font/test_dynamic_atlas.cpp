@@ -0,0 +1,223 @@
+#include "head.hpp"
+#include "../../../include/detail/font/msdf/dynamic_atlas.hpp"
+#include <filesystem>
+
+namespace font_ns = mcs::vulkan::font;
+using font_ns::msdf::dynamic_atlas;
+using font_ns::msdf::shelf_packer;
+
+using FontHandlePtr = mcs::vulkan::unique_handle<
+    msdfgen::FontHandle *,
+    [](msdfgen::FontHandle *value) noexcept { msdfgen::destroyFont(value); }>;
+
+static void test_shelf_packer()
+{
+    TEST("shelf packer: buckets, reuse, top shelf release");
+    shelf_packer packer{64, 32, 1};
+    auto a = packer.alloc(10, 10); // 层高 12
+    auto b = packer.alloc(20, 9);
+    auto c = packer.alloc(10, 15); // 层高 16
+    CHECK(a && b && c);
+    CHECK(a->y == 0 && b->y == 0 && b->x == 11);
+    CHECK(c->y == 12);
+
+    // 同层复用空位
+    packer.free(*a);
+    auto d = packer.alloc(8, 11);
+    CHECK(d && d->x == 0 && d->y == 0);
+    CHECK(packer.used() == (20 * 9) + (10 * 15) + (8 * 11));
+
+    // 顶层清空后高度可以给别的层用
+    packer.free(*c);
+    auto e = packer.alloc(60, 19);
+    CHECK(e && e->y == 12);
+    CHECK(!packer.alloc(64, 1).has_value()); // 超宽(含 padding)
+    PASS();
+}
+
+struct font_file
+{
+    font_ns::freetype::face face;
+    FontHandlePtr handle;
+};
+
+static std::optional<font_file> open_font(const font_ns::freetype::loader &library)
+{
+    const std::string path = FONT_INPUT_DIR "/TiroBangla-Regular.ttf";
+    if (!std::filesystem::exists(path))
+    {
+        std::println("[SKIP] {} not found", path);
+        return std::nullopt;
+    }
+    font_ns::freetype::face face{*library, path};
+    FontHandlePtr handle{msdfgen::adoptFreetypeFont(*face)};
+    return font_file{.face = std::move(face), .handle = std::move(handle)};
+}
+
+static size_t total_dirty(dynamic_atlas &atlas)
+{
+    std::vector<uint8_t> staging;
+    std::vector<dynamic_atlas::dirty_region> regions;
+    atlas.takeDirty(staging, regions);
+    size_t expected = 0;
+    for (const auto &r : regions)
+    {
+        CHECK(r.offset == expected);
+        expected += static_cast<size_t>(r.rect.w) * r.rect.h * 4;
+    }
+    CHECK(staging.size() == expected);
+    return regions.size();
+}
+
+static void test_generate(font_file &font)
+{
+    TEST("on-demand generation, uv/plane bounds, dirty regions");
+    mcs::vulkan::thread_pool pool{4};
+    dynamic_atlas atlas{pool, {.page_size = 512, .max_pages = 2}};
+    const auto id = atlas.addFont(*font.handle);
+
+    constexpr uint32_t GLYPHS = 64;
+    for (uint32_t g = 0; g < GLYPHS; ++g)
+        CHECK(atlas.find(id, g) == nullptr);
+    CHECK(atlas.pendingCount() == GLYPHS);
+    CHECK(atlas.find(id, 0) == nullptr); // 不重复请求
+    CHECK(atlas.statistics().requests == GLYPHS);
+
+    atlas.flush(true);
+    CHECK(atlas.glyphCount() == GLYPHS && atlas.pendingCount() == 0);
+    size_t inked = 0;
+    for (uint32_t g = 0; g < GLYPHS; ++g)
+    {
+        const auto *glyph = atlas.find(id, g);
+        CHECK(glyph != nullptr);
+        const auto &uv = glyph->uv_bounds;
+        if (uv.right == 0.0)
+            continue; // 空白字形
+        ++inked;
+        CHECK(0.0 <= uv.left && uv.left < uv.right && uv.right <= 1.0);
+        CHECK(0.0 <= uv.top && uv.top < uv.bottom && uv.bottom <= 1.0);
+        const auto &plane = glyph->plane_bounds;
+        CHECK(plane.left < plane.right && plane.bottom < plane.top);
+    }
+    CHECK(inked > 0);
+    CHECK(total_dirty(atlas) == inked);
+    CHECK(total_dirty(atlas) == 0); // 已上传过的不再是脏区
+    PASS();
+}
+
+static void test_eviction(font_file &font)
+{
+    TEST("LRU eviction keeps glyphs used in the current frame");
+    mcs::vulkan::thread_pool pool{4};
+    dynamic_atlas atlas{pool,
+                        {.page_size = 128, .max_pages = 1, .glyph_size = 16.0}};
+    const auto id = atlas.addFont(*font.handle);
+    const auto glyphs = static_cast<uint32_t>((*font.face)->num_glyphs);
+
+    // NOTE: 每帧使用一个滑动窗口的字形，总量远超一页
+    constexpr uint32_t WINDOW = 12;
+    for (uint32_t frame = 0; frame + WINDOW < std::min(glyphs, 200U); frame += 4)
+    {
+        atlas.beginFrame();
+        for (uint32_t g = frame; g < frame + WINDOW; ++g)
+            (void)atlas.find(id, g);
+        atlas.flush(true);
+        for (uint32_t g = frame; g < frame + WINDOW; ++g)
+            CHECK(atlas.find(id, g) != nullptr);
+    }
+    CHECK(atlas.pages().size() == 1);
+    CHECK(atlas.statistics().evictions > 0);
+    PASS();
+}
+
+static void test_waiting_not_requested_twice(font_file &font)
+{
+    TEST("glyphs waiting for space are not requested again");
+    mcs::vulkan::thread_pool pool{4};
+    dynamic_atlas atlas{pool, {.page_size = 64, .max_pages = 1, .glyph_size = 16.0}};
+    const auto id = atlas.addFont(*font.handle);
+    const auto glyphs = static_cast<uint32_t>((*font.face)->num_glyphs);
+    const uint32_t count = std::min(glyphs, 48U);
+
+    // NOTE: 一帧请求远超一页的字形，放不下的留在等待队列里
+    atlas.beginFrame();
+    for (uint32_t g = 0; g < count; ++g)
+        (void)atlas.find(id, g);
+    atlas.flush(true);
+    const size_t waiting = atlas.pendingCount();
+    CHECK(waiting > 0);
+    const size_t requests = atlas.statistics().requests;
+
+    // NOTE: flush 前再次请求同样的未缓存字形
+    for (uint32_t g = 0; g < count; ++g)
+        (void)atlas.find(id, g);
+    CHECK(atlas.statistics().requests == requests);
+    CHECK(atlas.pendingCount() == waiting);
+
+    // NOTE: 之后的帧只用别的字形，迫使等待中的字形进入后再被淘汰
+    for (uint32_t frame = 0; frame < 8; ++frame)
+    {
+        atlas.beginFrame();
+        for (uint32_t g = count; g < std::min(glyphs, count + 16); ++g)
+            (void)atlas.find(id, g);
+        atlas.flush(true);
+    }
+    CHECK(atlas.statistics().evictions > 0);
+    CHECK(atlas.glyphCount() + atlas.pendingCount() <= atlas.statistics().requests);
+    PASS();
+}
+
+// NOTE: 一屏常用字形 vs 整个字体的图集
+static void bench_memory_latency(font_file &font)
+{
+    using clock = std::chrono::steady_clock;
+    const auto glyphs = static_cast<uint32_t>((*font.face)->num_glyphs);
+    const uint32_t screen = std::min(glyphs, 300U);
+    mcs::vulkan::thread_pool pool;
+
+    dynamic_atlas dynamic{pool, {.page_size = 512, .max_pages = 4}};
+    auto id = dynamic.addFont(*font.handle);
+    auto start = clock::now();
+    for (uint32_t g = 0; g < screen; ++g)
+        (void)dynamic.find(id, g);
+    const auto request_us =
+        std::chrono::duration<double, std::micro>(clock::now() - start).count();
+    dynamic.flush(true);
+    const auto first_use_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    dynamic_atlas full{pool, {.page_size = 2048, .max_pages = 64}};
+    id = full.addFont(*font.handle);
+    start = clock::now();
+    for (uint32_t g = 0; g < glyphs; ++g)
+        (void)full.find(id, g);
+    full.flush(true);
+    const auto full_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    std::println("[BENCH] dynamic: {} glyphs, {} pages, {:.1f} KiB texture, "
+                 "request {:.1f} us, first use {:.2f} ms",
+                 dynamic.glyphCount(), dynamic.pages().size(),
+                 static_cast<double>(dynamic.textureBytes()) / 1024.0, request_us,
+                 first_use_ms);
+    std::println("[BENCH] full:    {} glyphs, {} pages, {:.1f} KiB texture, "
+                 "generate {:.2f} ms ({:.2f} ms cpu on {} threads)",
+                 full.glyphCount(), full.pages().size(),
+                 static_cast<double>(full.textureBytes()) / 1024.0, full_ms,
+                 full.statistics().generate_ms, pool.size());
+}
+
+int main()
+{
+    test_shelf_packer();
+    font_ns::freetype::loader library;
+    if (auto font = open_font(library))
+    {
+        test_generate(*font);
+        test_eviction(*font);
+        test_waiting_not_requested_twice(*font);
+        bench_memory_latency(*font);
+    }
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include "head.hpp"
+#include "../../../include/detail/font/glyph_instance.hpp"
+#include "../../../include/detail/__glm_import.hpp"
+#include <cmath>
+#include <random>
+
+namespace font_ns = mcs::vulkan::font;
+using font_ns::glyph_instance;
+using font_ns::glyph_pen;
+
+// NOTE: pack_glyph_instances 只需要 bind 与 type
+struct bind_context // NOLINTBEGIN
+{
+    font_ns::texture_bind_sampler bind;
+    font_ns::FontType type;
+}; // NOLINTEND
+using shape_result = font_ns::harfbuzz::shape_result<bind_context>;
+
+// NOTE: 与 test_dod21 的 shader_data::Glyph 布局相同，作为对照
+struct legacy_glyph // NOLINTBEGIN
+{
+    uint32_t entity_index;
+    uint32_t textureIndex;
+    uint32_t samplerIndex;
+    uint32_t fontType;
+    float pxRange;
+    uint32_t modulateFlag;
+    glm::vec4 color;
+    glm::mat4 model;
+    glm::vec2 uv_scale;
+    glm::vec2 uv_offset;
+    uint32_t hover_fn;
+}; // NOLINTEND
+static_assert(sizeof(legacy_glyph) == 124);
+
+static std::vector<shape_result> make_line(size_t count, const bind_context *fonts,
+                                           size_t font_count, uint32_t seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+    std::vector<shape_result> line;
+    line.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        shape_result g{};
+        g.font_ctx = &fonts[(i / 7) % font_count]; // 每 7 个字形换一次字体
+        g.advance_x = 0.4 + (0.3 * unit(rng));
+        if (i % 6 == 5) // NOLINT 空格
+        {
+            line.push_back(g);
+            continue;
+        }
+        const double left = 0.05 * unit(rng);
+        const double top = -0.75 - (0.2 * unit(rng)); // yOrigin = top: 基线以上为负
+        g.plane_bounds = {.left = left,
+                          .bottom = 0.1 + (0.2 * unit(rng)),
+                          .right = left + 0.3 + (0.4 * unit(rng)),
+                          .top = top};
+        const double u = 0.9 * unit(rng);
+        const double v = 0.9 * unit(rng);
+        g.uv_bounds = {.left = u,
+                       .bottom = v + (0.05 * unit(rng)),
+                       .right = u + (0.05 * unit(rng)),
+                       .top = v};
+        line.push_back(g);
+    }
+    return line;
+}
+
+static void test_layout_and_pack()
+{
+    TEST("glyph_instance is 32 bytes and packs indices losslessly");
+    static_assert(sizeof(glyph_instance) == 32);
+    static_assert(alignof(glyph_instance) == 4);
+    constexpr uint32_t PACKED =
+        glyph_instance::pack(4095, 17, font_ns::FontType::eMTSDF, 1); // NOLINT
+    glyph_instance g{.packed = PACKED};
+    CHECK(g.texture_index() == 4095);
+    CHECK(g.sampler_index() == 17);
+    CHECK(g.font_type() == font_ns::FontType::eMTSDF);
+    CHECK(g.flags() == glyph_instance::FLAG_MODULATE);
+    PASS();
+}
+
+static void test_quantize_matches_scalar()
+{
+    TEST("SIMD unorm16 quantizer matches scalar reference");
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<float> dist{-0.25F, 1.25F};
+    for (int i = 0; i < 100000; ++i) // NOLINT
+    {
+        std::array<float, 6> in; // NOLINT
+        for (auto &v : in)
+            v = dist(rng);
+        const auto fast = font_ns::detail::quantize_unorm16(in);
+        const auto ref = font_ns::detail::quantize_unorm16_scalar(in);
+        for (size_t k = 0; k < in.size(); ++k)
+            CHECK(std::abs(int{fast[k]} - int{ref[k]}) <= 1); // 舍入到偶数 vs 远离零
+    }
+    CHECK(font_ns::detail::quantize_unorm16({0, 1, 0, 1, 2, -1}) ==
+          (font_ns::detail::quantized{0, 65535, 0, 65535, 65535, 0}));
+    PASS();
+}
+
+static void test_convert()
+{
+    TEST("pack_glyph_instances reproduces the test_dod21 glyph rectangles");
+    const std::array<bind_context, 3> fonts{
+        bind_context{.bind = {.texture_index = 3, .sampler_index = 1},
+                     .type = font_ns::FontType::eMSDF},
+        bind_context{.bind = {.texture_index = 9, .sampler_index = 0},
+                     .type = font_ns::FontType::eBITMAP},
+        bind_context{.bind = {.texture_index = 12, .sampler_index = 2},
+                     .type = font_ns::FontType::eSDF}};
+    const auto line = make_line(257, fonts.data(), fonts.size(), 1); // NOLINT
+
+    constexpr float EM = 48.0F;
+    constexpr float BASELINE = 120.0F;
+    std::vector<glyph_instance> out(line.size());
+    glyph_pen pen{.x = 10.0F, .baseline = BASELINE, .em_size = EM, .color = 0xFF00FF80U};
+    const size_t count = font_ns::pack_glyph_instances<bind_context>(line, pen, out);
+
+    // NOTE: 参照 test_dod21：top = baseline + plane.top * em
+    float cursor = 10.0F;
+    size_t j = 0;
+    constexpr float UNORM = 1.0F / 65535.0F;
+    for (const auto &g : line)
+    {
+        if (g.plane_bounds != font_ns::Font::Bounds{})
+        {
+            const auto &inst = out[j++];
+            const float left = cursor + (static_cast<float>(g.plane_bounds.left) * EM);
+            const float top = BASELINE + (static_cast<float>(g.plane_bounds.top) * EM);
+            const float w =
+                static_cast<float>(g.plane_bounds.right - g.plane_bounds.left) * EM;
+            const float h =
+                static_cast<float>(g.plane_bounds.bottom - g.plane_bounds.top) * EM;
+            CHECK(std::abs(inst.x - left) < 1e-3F);
+            CHECK(std::abs(inst.y - top) < 1e-3F);
+            const float scale = font_ns::GLYPH_EM_RANGE * inst.em_size * UNORM;
+            CHECK(std::abs((inst.size[0] * scale) - w) < 0.01F);
+            CHECK(std::abs((inst.size[1] * scale) - h) < 0.01F);
+            CHECK(std::abs((inst.uv[0] * UNORM) - g.uv_bounds.left) < 1e-4);
+            CHECK(std::abs((inst.uv[1] * UNORM) - g.uv_bounds.top) < 1e-4);
+            CHECK(std::abs((inst.uv[2] * UNORM) - g.uv_bounds.right) < 1e-4);
+            CHECK(std::abs((inst.uv[3] * UNORM) - g.uv_bounds.bottom) < 1e-4);
+            CHECK(inst.texture_index() == g.font_ctx->bind.texture_index);
+            CHECK(inst.sampler_index() == g.font_ctx->bind.sampler_index);
+            CHECK(inst.font_type() == g.font_ctx->type);
+            CHECK(inst.color == 0xFF00FF80U);
+        }
+        cursor += static_cast<float>(g.advance_x) * EM;
+    }
+    CHECK(count == j);
+    CHECK(count < line.size()); // 空格不产生实例
+    CHECK(std::abs(pen.x - cursor) < 1e-3F);
+    PASS();
+}
+
+// NOTE: test_dod21 的逐字形构造方式
+static size_t build_legacy(std::span<const shape_result> line, float em, float baseline,
+                           float cursor, std::span<legacy_glyph> out)
+{
+    size_t count = 0;
+    for (const auto &g : line)
+    {
+        if (g.plane_bounds != font_ns::Font::Bounds{})
+        {
+            const float left = cursor + (static_cast<float>(g.plane_bounds.left) * em);
+            const float right = cursor + (static_cast<float>(g.plane_bounds.right) * em);
+            const float top = baseline + (static_cast<float>(g.plane_bounds.top) * em);
+            const float bottom =
+                baseline + (static_cast<float>(g.plane_bounds.bottom) * em);
+            const glm::vec2 p0{left, top};
+            const glm::vec2 p2{right, bottom};
+            legacy_glyph lg{};
+            lg.textureIndex = g.font_ctx->bind.texture_index;
+            lg.samplerIndex = g.font_ctx->bind.sampler_index;
+            lg.fontType = static_cast<uint32_t>(g.font_ctx->type);
+            lg.modulateFlag = 1;
+            lg.color = glm::vec4(1.0F);
+            const glm::vec2 center = (p0 + p2) * 0.5F;
+            lg.model = glm::translate(glm::mat4(1.0F), glm::vec3(center, 0.0F)) *
+                       glm::scale(glm::mat4(1.0F), glm::vec3(p2 - p0, 1.0F));
+            lg.uv_scale = {static_cast<float>(g.uv_bounds.right - g.uv_bounds.left),
+                           static_cast<float>(g.uv_bounds.bottom - g.uv_bounds.top)};
+            lg.uv_offset = {static_cast<float>(g.uv_bounds.left),
+                            static_cast<float>(g.uv_bounds.top)};
+            lg.hover_fn = ~0U;
+            out[count++] = lg;
+        }
+        cursor += static_cast<float>(g.advance_x) * em;
+    }
+    return count;
+}
+
+static void bench_convert()
+{
+    using clock = std::chrono::steady_clock;
+    constexpr size_t GLYPHS = size_t{1} << 16U;
+    constexpr int ROUNDS = 50;
+    const std::array<bind_context, 2> fonts{
+        bind_context{.bind = {.texture_index = 1, .sampler_index = 0},
+                     .type = font_ns::FontType::eMSDF},
+        bind_context{.bind = {.texture_index = 2, .sampler_index = 0},
+                     .type = font_ns::FontType::eBITMAP}};
+    const auto line = make_line(GLYPHS, fonts.data(), fonts.size(), 2);
+    std::vector<glyph_instance> compact(line.size());
+    std::vector<legacy_glyph> legacy(line.size());
+
+    size_t compact_count = 0;
+    size_t legacy_count = 0;
+    auto run = [&](auto &&fn) {
+        fn(); // 预热
+        const auto start = clock::now();
+        for (int i = 0; i < ROUNDS; ++i)
+            fn();
+        return std::chrono::duration<double>(clock::now() - start).count() / ROUNDS;
+    };
+    const double t_compact = run([&] {
+        glyph_pen pen{.x = 0.0F, .baseline = 100.0F, .em_size = 32.0F};
+        compact_count = font_ns::pack_glyph_instances<bind_context>(line, pen, compact);
+    });
+    const double t_legacy = run(
+        [&] { legacy_count = build_legacy(line, 32.0F, 100.0F, 0.0F, legacy); });
+    CHECK(compact_count == legacy_count);
+
+    const auto report = [&](const char *name, size_t bytes, double seconds) {
+        std::println("[BENCH] {:>7}: {:>3} B/glyph, {:.1f} Mglyph/s, "
+                     "{:.2f} GB/s written, {:.2f} MB per {} glyphs",
+                     name, bytes, static_cast<double>(compact_count) / seconds / 1e6,
+                     static_cast<double>(compact_count * bytes) / seconds / 1e9,
+                     static_cast<double>(compact_count * bytes) / 1e6, compact_count);
+    };
+    report("compact", sizeof(glyph_instance), t_compact);
+    report("legacy", sizeof(legacy_glyph), t_legacy);
+}
+
+int main()
+{
+    test_layout_and_pack();
+    test_quantize_matches_scalar();
+    test_convert();
+    bench_convert();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "head.hpp"
+#include "../../../include/detail/font/icu/line_breaker.hpp"
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace font_ns = mcs::vulkan::font;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+
+struct corpus // NOLINTBEGIN
+{
+    const char *name;
+    const char *lang;
+    std::string_view text;
+}; // NOLINTEND
+
+// NOTE: thai 没有空格分词，ICU 用词典断行，libunibreak 只能整段不断，预期差异最大
+constexpr std::array CORPORA{
+    corpus{.name = "latin",
+           .lang = "en",
+           .text = "The quick brown fox jumps over the lazy dog. It's 10:30, "
+                   "e-mail me at foo@example.com (or not)!\nSecond line."},
+    corpus{.name = "cjk",
+           .lang = "zh-Hans",
+           .text = "中文排版需要处理标点挤压与避头尾规则，例如「引号」和（括号）。\n"
+                   "日本語の文章も含みます。ひらがなとカタカナ、漢字。"},
+    corpus{.name = "korean", .lang = "ko", .text = "한국어 문장은 공백으로 단어를 나눕니다."},
+    corpus{.name = "arabic",
+           .lang = "ar",
+           .text = "مرحبا بالعالم، هذا نص عربي مع أرقام 123 و English."},
+    corpus{.name = "thai", .lang = "th", .text = "ภาษาไทยไม่มีการเว้นวรรคระหว่างคำ"},
+    corpus{.name = "mixed",
+           .lang = "",
+           .text = "log: 用户 alice 登录成功 (مرحبا) status=200 ok 😀👍🏽 done\r\nnext"},
+};
+
+static std::vector<uint32_t> decode(std::string_view text)
+{
+    std::vector<uint32_t> out;
+    CHECK(font_ns::utf8proc::decode_utf8(text, out));
+    return out;
+}
+
+static size_t count_hard(std::span<const char> types)
+{
+    return static_cast<size_t>(std::ranges::count(types, LINEBREAK_MUSTBREAK));
+}
+
+static void test_conformance()
+{
+    TEST("libunibreak and ICU backends agree on hard breaks, report soft agreement");
+    font_ns::libunibreak::line_breaker unibreak;
+    font_ns::icu::line_breaker icu;
+    std::vector<char> a;
+    std::vector<char> b;
+    std::cout << '\n';
+    for (const auto &[name, lang, text] : CORPORA)
+    {
+        const auto codepoints = decode(text);
+        (void)unibreak(codepoints, lang, a);
+        (void)icu(codepoints, lang, b);
+        CHECK(a.size() == codepoints.size());
+        CHECK(b.size() == codepoints.size());
+        CHECK(a.back() == LINEBREAK_MUSTBREAK);
+        CHECK(b.back() == LINEBREAK_MUSTBREAK);
+        // NOTE: 强制换行只由 BK/CR/LF/NL 决定，两个实现必须一致
+        for (size_t i = 0; i < codepoints.size(); ++i)
+            CHECK((a[i] == LINEBREAK_MUSTBREAK) == (b[i] == LINEBREAK_MUSTBREAK));
+
+        size_t same = 0;
+        for (size_t i = 0; i < codepoints.size(); ++i)
+            same += static_cast<size_t>(a[i] == b[i]);
+        std::println("  {:>6}: {} codepoints, {} hard, agreement {:.1f}%", name,
+                     codepoints.size(), count_hard(a),
+                     100.0 * static_cast<double>(same) /
+                         static_cast<double>(codepoints.size()));
+    }
+
+    // NOTE: 没有争议的情形：空格之后可断、表意文字之间可断、CR LF 不拆开
+    const auto latin = decode("hello world");
+    CHECK(icu(latin, "en", b)[5] == LINEBREAK_ALLOWBREAK);
+    CHECK(std::ranges::equal(b, unibreak(latin, "en", a)));
+    const auto han = decode("天地玄黄");
+    CHECK(std::ranges::equal(icu(han, "zh", b), unibreak(han, "zh", a)));
+    const auto crlf = decode("a\r\nb");
+    CHECK(icu(crlf, "", b)[1] == LINEBREAK_NOBREAK);
+    CHECK(b[2] == LINEBREAK_MUSTBREAK);
+    CHECK(icu({}, "", b).empty());
+    PASS();
+}
+
+static void test_iterator_reuse()
+{
+    TEST("ICU backend reuses one BreakIterator per language");
+    font_ns::icu::line_breaker icu;
+    std::vector<char> out;
+    std::vector<char> first;
+    const auto codepoints = decode(CORPORA[0].text);
+    (void)icu(codepoints, "en", first);
+    for (int i = 0; i < 100; ++i) // NOLINT
+    {
+        CHECK(std::ranges::equal(icu(codepoints, "en", out), first));
+        (void)icu(decode(CORPORA[1].text), "zh-Hans", out);
+    }
+    CHECK(icu.cached_iterators() == 2);
+    // NOTE: 非法语言标签回退到 root，不抛异常
+    (void)icu(codepoints, "not a tag!", out);
+    CHECK(icu.cached_iterators() == 3);
+    PASS();
+}
+
+static void test_pipeline_backend()
+{
+    TEST("text_arena with ICU backend drives layout_text");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    selector.load(fake::make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.load(fake::make_info("cjk", {{0x3000, 0x303F}, {0x4E00, 0x9FFF}},
+                                  {HB_SCRIPT_HAN}, {}));
+    selector.initNotdefFont();
+
+    font_ns::text_arena<fake::font_context, font_ns::icu::line_breaker> arena;
+    font_ns::text_arena<fake::font_context> reference;
+    for (int i = 0; i < 3; ++i)
+    {
+        arena.reset();
+        reference.reset();
+        font_ns::layout_text(arena, CORPORA[0].text, 0, selector);
+        font_ns::layout_text(reference, CORPORA[0].text, 0, selector);
+        CHECK(std::ranges::equal(arena.codepoints, reference.codepoints));
+        CHECK(arena.breaks.size() == arena.codepoints.size());
+        std::vector<char> expected;
+        font_ns::icu::line_breaker icu;
+        CHECK(std::ranges::equal(
+            arena.breaks, icu(arena.codepoints, selector.langBcp47(), expected)));
+    }
+    CHECK(arena.breaker.cached_iterators() == 1);
+    PASS();
+}
+
+static void bench_backends()
+{
+    using clock = std::chrono::steady_clock;
+    constexpr size_t CODEPOINTS = size_t{1} << 18U;
+    constexpr int ROUNDS = 10;
+    font_ns::libunibreak::line_breaker unibreak;
+    font_ns::icu::line_breaker icu;
+    std::vector<char> out;
+    for (const auto &[name, lang, text] : CORPORA)
+    {
+        const auto unit = decode(text);
+        std::vector<uint32_t> codepoints;
+        while (codepoints.size() < CODEPOINTS)
+            codepoints.insert(codepoints.end(), unit.begin(), unit.end());
+
+        auto mcps = [&](auto &backend) {
+            (void)backend(codepoints, lang, out); // 预热：创建 iterator，分配容量
+            const auto start = clock::now();
+            for (int i = 0; i < ROUNDS; ++i)
+                (void)backend(codepoints, lang, out);
+            const double s =
+                std::chrono::duration<double>(clock::now() - start).count();
+            return static_cast<double>(codepoints.size()) * ROUNDS / s / 1e6;
+        };
+        const double a = mcps(unibreak);
+        const double b = mcps(icu);
+        std::println("[BENCH] {:>6}: libunibreak {:.1f} Mcp/s, ICU {:.1f} Mcp/s", name, a,
+                     b);
+    }
+}
+
+int main()
+{
+    test_conformance();
+    test_iterator_reuse();
+    test_pipeline_backend();
+    bench_backends();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
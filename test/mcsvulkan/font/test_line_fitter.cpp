@@ -0,0 +1,232 @@
+#include "head.hpp"
+#include <algorithm>
+#include <format>
+#include <iterator>
+
+namespace font_ns = mcs::vulkan::font;
+using font_ns::line_box;
+using font_ns::line_fitter;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+using layout_type = font_ns::text_layout<fake::font_context>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+constexpr double CHAR_ADVANCE = 0.5;
+constexpr double SPACE_ADVANCE = 0.25;
+
+static void load_fonts(selector_type &selector)
+{
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.load(make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.initNotdefFont();
+}
+
+// NOTE: fake 字体的 advance 全为 0，这里按字符写入固定宽度
+static layout_type make_layout(selector_type &selector, std::string_view text,
+                               int base_level = 0)
+{
+    auto &arena = font_ns::text_arena<fake::font_context>::local();
+    font_ns::layout_text(arena, text, base_level, selector);
+    layout_type layout = arena;
+    for (auto &g : layout.glyphs)
+        g.advance_x =
+            layout.codepoints[g.logical_idx] == ' ' ? SPACE_ADVANCE : CHAR_ADVANCE;
+    return layout;
+}
+
+static std::u32string line_text(const layout_type &layout, const line_box &line)
+{
+    std::u32string ret;
+    for (size_t i = line.first; i < line.first + line.count; ++i)
+        ret.push_back(static_cast<char32_t>(layout.codepoints[i]));
+    return ret;
+}
+
+static void check_cover(std::span<const line_box> lines, size_t size)
+{
+    size_t next = 0;
+    for (const auto &line : lines)
+    {
+        CHECK(line.first == next);
+        CHECK(line.count > 0);
+        next += line.count;
+    }
+    CHECK(next == size);
+}
+
+static void test_greedy()
+{
+    TEST("greedy wrap, hanging spaces, mandatory breaks");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    auto layout = make_layout(selector, "aaa bbb ccc\ndd");
+    line_fitter fitter;
+    fitter.build(layout);
+
+    // "aaa bbb" = 3 * 0.5 + 0.25 + 3 * 0.5
+    auto lines = fitter.wrap(3.3);
+    CHECK(lines.size() == 3);
+    CHECK(line_text(layout, lines[0]) == U"aaa bbb ");
+    CHECK(lines[0].width == 3.25 && !lines[0].hard);
+    CHECK(line_text(layout, lines[1]) == U"ccc\n");
+    CHECK(lines[1].width == 1.5 && lines[1].hard);
+    CHECK(line_text(layout, lines[2]) == U"dd");
+    check_cover(lines, layout.codepoints.size());
+
+    // 不重新 shape，直接换行宽
+    lines = fitter.wrap(1.6);
+    CHECK(lines.size() == 4);
+    CHECK(line_text(layout, lines[0]) == U"aaa ");
+    check_cover(lines, layout.codepoints.size());
+
+    // 不可断的单词超宽时独占一行
+    lines = fitter.wrap(0.1);
+    CHECK(lines.size() == 4);
+    CHECK(lines[0].width == 1.5);
+    PASS();
+}
+
+static double raggedness(std::span<const line_box> lines, double max_width)
+{
+    double total = 0;
+    for (const auto &line : lines)
+        if (!line.hard)
+            total += (max_width - line.width) * (max_width - line.width);
+    return total;
+}
+
+static void test_optimal()
+{
+    TEST("optimal wrap fits and is no more ragged than greedy");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    auto layout = make_layout(
+        selector, "aaa bb cc ddddd e ffff gg hhhhhh ii j kkk llll m nnnnn oo p qqq");
+    line_fitter fitter;
+    fitter.build(layout);
+    for (double max_width : {3.0, 4.5, 6.0, 9.0})
+    {
+        std::vector<line_box> greedy;
+        std::ranges::copy(fitter.wrap(max_width), std::back_inserter(greedy));
+        auto optimal = fitter.wrap(max_width, line_fitter::mode::optimal);
+        check_cover(optimal, layout.codepoints.size());
+        for (const auto &line : optimal)
+            CHECK(line.width <= max_width);
+        CHECK(raggedness(optimal, max_width) <= raggedness(greedy, max_width));
+    }
+    PASS();
+}
+
+static std::vector<size_t> visual_glyphs(line_fitter &fitter, const layout_type &layout,
+                                         const line_box &line)
+{
+    std::vector<font_ns::run_range> runs;
+    fitter.reorder(layout, line, runs);
+    std::vector<size_t> ret;
+    for (const auto &run : runs)
+        for (size_t i = run.first; i < run.first + run.count; ++i)
+            ret.push_back(i);
+    return ret;
+}
+
+static void test_reorder()
+{
+    TEST("per-line bidi reorder");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    for (auto [text, level] : {std::pair{"abc مرحبا بكم def", 0},
+                               std::pair{"مرحبا abc def بكم", 1}})
+    {
+        auto layout = make_layout(selector, text, level);
+        line_fitter fitter;
+        fitter.build(layout);
+
+        // 单行：与整段的视觉顺序一致
+        auto lines = fitter.wrap(1000.0);
+        CHECK(lines.size() == 1);
+        auto order = visual_glyphs(fitter, layout, lines[0]);
+        CHECK(order.size() == layout.glyphs.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            CHECK(order[i] == i);
+
+        // 多行：每行只含本行的字形，且全部字形恰好出现一次
+        lines = fitter.wrap(2.0);
+        CHECK(lines.size() > 1);
+        std::vector<size_t> seen;
+        for (const auto &line : lines)
+        {
+            for (size_t g : visual_glyphs(fitter, layout, line))
+            {
+                const size_t logical = layout.glyphs[g].logical_idx;
+                CHECK(logical >= line.first && logical < line.first + line.count);
+                seen.push_back(g);
+            }
+        }
+        std::ranges::sort(seen);
+        CHECK(seen.size() == layout.glyphs.size());
+        CHECK(std::ranges::adjacent_find(seen) == seen.end());
+    }
+    PASS();
+}
+
+static void bench_rewrap()
+{
+    using clock = std::chrono::steady_clock;
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    constexpr std::string_view words[] = {"lorem", "ipsum", "dolor", "sit", "amet",
+                                          "consectetur", "adipiscing", "elit", "sed",
+                                          "مرحبا", "العربية"};
+    // NOTE: 至少 100k 个字符(非 UTF-8 续字节)
+    std::string text;
+    for (size_t i = 0, chars = 0; chars < 100'000; ++i)
+    {
+        const auto word = words[(i * 7) % std::size(words)];
+        text += std::format("{} ", word);
+        chars += 1 + static_cast<size_t>(std::ranges::count_if(
+                         word, [](char c) { return (c & 0xC0) != 0x80; })); // NOLINT
+    }
+    auto start = clock::now();
+    auto layout = make_layout(selector, text);
+    const auto shape_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    line_fitter fitter;
+    start = clock::now();
+    fitter.build(layout);
+    const auto build_us =
+        std::chrono::duration<double, std::micro>(clock::now() - start).count();
+
+    constexpr int ROUNDS = 50;
+    for (auto fit : {line_fitter::mode::greedy, line_fitter::mode::optimal})
+    {
+        size_t lines = 0;
+        start = clock::now();
+        for (int i = 0; i < ROUNDS; ++i)
+            lines += fitter.wrap(20.0 + i, fit).size(); // NOLINT
+        const auto us =
+            std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        std::println("[BENCH] {} codepoints: shape {:.2f} ms, build {:.2f} us, "
+                     "{} re-wrap {:.2f} us ({} lines avg)",
+                     layout.codepoints.size(), shape_ms, build_us,
+                     fit == line_fitter::mode::greedy ? "greedy" : "optimal",
+                     us / ROUNDS, lines / ROUNDS);
+    }
+}
+
+int main()
+{
+    test_greedy();
+    test_optimal();
+    test_reorder();
+    bench_rewrap();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
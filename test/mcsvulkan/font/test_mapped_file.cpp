@@ -0,0 +1,177 @@
+#include "head.hpp"
+#include "../../../include/detail/utils/mapped_file.hpp"
+#include "../../../include/detail/utils/read_file.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define MCS_TEST_PEAK_RSS
+#endif
+
+using mcs::vulkan::mapped_file;
+using mcs::vulkan::read_file;
+namespace freetype = mcs::vulkan::font::freetype;
+
+static const std::string FONT_PATH = FONT_INPUT_DIR "/TiroBangla-Regular.ttf";
+
+static std::string temp_path(const char *name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static void write_file(const std::string &path, size_t size)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::vector<char> chunk(size_t{1} << 20U);
+    for (size_t i = 0; i < chunk.size(); ++i)
+        chunk[i] = static_cast<char>(i * 131);
+    for (size_t written = 0; written < size; written += chunk.size())
+        out.write(chunk.data(),
+                  static_cast<std::streamsize>(std::min(chunk.size(), size - written)));
+}
+
+// NOTE: ru_maxrss 在 Linux 上单位为 KiB；没有 getrusage 的平台不统计，返回 0
+static long peak_rss_kib()
+{
+#if defined(MCS_TEST_PEAK_RSS)
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+static void test_bytes()
+{
+    TEST("mapped_file matches buffered read");
+    const mapped_file file{FONT_PATH};
+    const auto copy = mapped_file::read(FONT_PATH);
+    CHECK(!copy.mapped());
+    CHECK(!file.empty());
+    CHECK(file.size() == copy.size());
+    CHECK(std::memcmp(file.data(), copy.data(), file.size()) == 0);
+    CHECK(file.as<uint32_t>().size() == file.size() / 4);
+
+    const auto legacy = read_file(FONT_PATH);
+    CHECK(legacy.size() == file.size());
+    CHECK(std::memcmp(legacy.data(), file.data(), file.size()) == 0);
+    PASS();
+}
+
+static void test_edge_cases()
+{
+    TEST("mapped_file empty file, missing file and moves");
+    const auto empty_path = temp_path("mcs_mapped_file_empty.bin");
+    write_file(empty_path, 0);
+    {
+        const mapped_file empty{empty_path};
+        CHECK(empty.empty());
+        CHECK(empty.bytes().empty());
+    }
+    std::filesystem::remove(empty_path);
+
+    bool thrown = false;
+    try
+    {
+        const mapped_file missing{temp_path("mcs_mapped_file_missing.bin")};
+    }
+    catch (const std::exception &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+#if defined(__linux__)
+    // NOTE: /proc 的文件 st_size 为 0，必须读到 EOF
+    const mapped_file status{"/proc/self/status"};
+    CHECK(!status.mapped() && !status.empty());
+    CHECK(mapped_file::read("/proc/self/status").size() > 0);
+#endif
+
+    mapped_file a{FONT_PATH};
+    const auto *data = a.data();
+    const size_t size = a.size();
+    mapped_file b{std::move(a)};
+    CHECK(b.data() == data && b.size() == size);
+    CHECK(a.empty() && a.data() == nullptr); // NOLINT
+    a = std::move(b);
+    CHECK(a.data() == data && b.empty()); // NOLINT
+    a.destroy();
+    CHECK(a.empty() && !a.mapped());
+    PASS();
+}
+
+static void test_face()
+{
+    TEST("freetype::face from a mapped font matches FT_New_Face");
+    freetype::loader library;
+    freetype::face mapped{*library, FONT_PATH};
+    FT_Face reference = nullptr;
+    CHECK(FT_New_Face(*library, FONT_PATH.c_str(), 0, &reference) == FT_Err_Ok);
+    CHECK((*mapped)->num_glyphs == reference->num_glyphs);
+    CHECK((*mapped)->units_per_EM == reference->units_per_EM);
+
+    // face 被移动后映射仍然有效
+    freetype::face moved{std::move(mapped)};
+    CHECK(FT_Load_Glyph(*moved, 1, FT_LOAD_NO_SCALE) == FT_Err_Ok);
+    CHECK(FT_Load_Glyph(reference, 1, FT_LOAD_NO_SCALE) == FT_Err_Ok);
+    CHECK((*moved)->glyph->metrics.horiAdvance == reference->glyph->metrics.horiAdvance);
+    FT_Done_Face(reference);
+
+    // NOTE: 读入的缓冲同样交给 FT_New_Memory_Face，不再让 FreeType 重读文件
+    freetype::face buffered{*library, mapped_file::read(FONT_PATH)};
+    CHECK((*buffered)->num_glyphs == (*moved)->num_glyphs);
+    PASS();
+}
+
+// NOTE: 大文件只访问少量页面(如字体表目录、SPIR-V 头)时的 I/O 时间与峰值 RSS。
+// 先测映射：ru_maxrss 只增不减，读入的整份拷贝会掩盖之后的结果
+static void bench_startup()
+{
+    using clock = std::chrono::steady_clock;
+    constexpr size_t SIZE = size_t{256} << 20U;
+    constexpr size_t STRIDE = size_t{1} << 20U;
+    const auto path = temp_path("mcs_mapped_file_bench.bin");
+    write_file(path, SIZE);
+
+    const long base_kib = peak_rss_kib();
+    auto start = clock::now();
+    size_t checksum = 0;
+    {
+        const mapped_file file{path};
+        const auto bytes = file.as<uint8_t>();
+        for (size_t i = 0; i < bytes.size(); i += STRIDE)
+            checksum += bytes[i];
+    }
+    const double mapped_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    const long mapped_kib = peak_rss_kib() - base_kib;
+
+    start = clock::now();
+    {
+        const auto data = read_file(path);
+        for (size_t i = 0; i < data.size(); i += STRIDE)
+            checksum -= static_cast<uint8_t>(data[i]);
+    }
+    const double read_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    const long read_kib = peak_rss_kib() - base_kib;
+    std::filesystem::remove(path);
+
+    CHECK(checksum == 0);
+    std::println("[BENCH] {} MiB, sparse access: mapped_file {:.2f} ms "
+                 "(+{} KiB peak RSS), read_file {:.2f} ms (+{} KiB peak RSS)",
+                 SIZE >> 20U, mapped_ms, mapped_kib, read_ms, read_kib);
+}
+
+int main()
+{
+    test_bytes();
+    test_edge_cases();
+    test_face();
+    bench_startup();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
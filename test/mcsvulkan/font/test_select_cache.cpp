@@ -0,0 +1,151 @@
+#include "head.hpp"
+
+using selector_type = mcs::vulkan::font::GenFontSelector<fake::font_factory>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ZHS = HB_TAG('Z', 'H', 'S', ' ');
+constexpr hb_tag_t JAN = HB_TAG('J', 'A', 'N', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+struct sample
+{
+    char32_t codepoint;
+    hb_script_t script;
+};
+
+// NOTE: 拉丁 / CJK / 阿拉伯 混排，模拟一段真实文本的码点分布
+static std::vector<sample> make_mixed_text(size_t count)
+{
+    std::vector<sample> text;
+    text.reserve(count);
+    constexpr std::u32string_view latin = U"The quick brown fox jumps over the lazy dog ";
+    constexpr std::u32string_view cjk = U"我能吞下玻璃而不伤身体。天地玄黄宇宙洪荒";
+    constexpr std::u32string_view arabic = U"أنا قادر على أكل الزجاج و هذا لا يؤلمني ";
+    while (text.size() < count)
+    {
+        for (auto cp : latin)
+            text.push_back({cp, HB_SCRIPT_LATIN});
+        for (auto cp : cjk)
+            text.push_back({cp, HB_SCRIPT_HAN});
+        for (auto cp : arabic)
+            text.push_back({cp, cp == U' ' ? HB_SCRIPT_COMMON : HB_SCRIPT_ARABIC});
+    }
+    text.resize(count);
+    return text;
+}
+
+static void load_fonts(selector_type &selector)
+{
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.setCandidate([] {
+        std::vector<mcs::vulkan::font::FontInfo> candidate;
+        candidate.emplace_back(make_info("cjk-sc", {{0x3000, 0x303F}, {0x4E00, 0x9FFF}},
+                                         {HB_SCRIPT_HAN}, {ZHS}));
+        candidate.emplace_back(make_info("arabic", {{0x20, 0x20}, {0x600, 0x6FF}},
+                                         {HB_SCRIPT_ARABIC}, {ARA}));
+        return candidate;
+    }());
+}
+
+static void test_cached_equals_uncached()
+{
+    TEST("cached selectFont == resolveFont");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    const auto text = make_mixed_text(4096);
+    // NOTE: 先跑一遍，让 candidate 全部加载完，之后字体集合不再变化
+    for (auto [cp, script] : text)
+        (void)selector.selectFont(cp, script);
+    CHECK(selector.candidate().empty());
+    for (auto [cp, script] : text)
+    {
+        auto cached = selector.selectFont(cp, script);
+        auto fresh = selector.resolveFont(cp, script);
+        CHECK(cached.font == fresh.font);
+        CHECK(cached.language == fresh.language);
+    }
+    CHECK(selector.selectCache().hits() > 0);
+    PASS();
+}
+
+static void test_invalidation()
+{
+    TEST("invalidate on load / setCandidate / preference / unload");
+    using fake::make_info;
+    fake::font_factory factory;
+    selector_type selector{&factory, ZHS};
+    selector.load(make_info("cjk-sc", {{0x4E00, 0x9FFF}}, {HB_SCRIPT_HAN}, {ZHS}));
+    selector.load(make_info("cjk-jp", {{0x4E00, 0x9FFF}}, {HB_SCRIPT_HAN}, {JAN}));
+
+    CHECK(selector.selectFont(U'天', HB_SCRIPT_HAN).font->name == "cjk-sc");
+    CHECK(selector.selectCache().size() == 1);
+
+    // 偏好语言变化
+    selector.setPreferenceTag(JAN);
+    CHECK(selector.selectCache().size() == 0);
+    CHECK(selector.selectFont(U'天', HB_SCRIPT_HAN).font->name == "cjk-jp");
+
+    // 缺字也会被缓存，setCandidate 之后必须重新解析
+    CHECK(!selector.selectFont(U'ا', HB_SCRIPT_ARABIC));
+    std::vector<mcs::vulkan::font::FontInfo> candidate;
+    candidate.emplace_back(
+        make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.setCandidate(std::move(candidate));
+    CHECK(selector.selectFont(U'ا', HB_SCRIPT_ARABIC).font->name == "arabic");
+
+    // load 追加的字体排在后面，但不限定语言时仍可能被选中
+    CHECK(!selector.selectFont(U'α', HB_SCRIPT_GREEK));
+    selector.load(make_info("greek", {{0x370, 0x3FF}}, {HB_SCRIPT_GREEK}, {}));
+    CHECK(selector.selectFont(U'α', HB_SCRIPT_GREEK).font->name == "greek");
+
+    // 卸载
+    const auto *jp = selector.selectFont(U'天', HB_SCRIPT_HAN).font;
+    CHECK(selector.unloadFont(jp));
+    CHECK(selector.selectFont(U'天', HB_SCRIPT_HAN).font->name == "cjk-sc");
+    PASS();
+}
+
+static void bench_mixed_text()
+{
+    using clock = std::chrono::steady_clock;
+    constexpr size_t COUNT = 200'000;
+    constexpr int ROUNDS = 10;
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    const auto text = make_mixed_text(COUNT);
+    for (auto [cp, script] : text)
+        (void)selector.selectFont(cp, script);
+
+    auto run = [&](auto &&select) {
+        size_t found = 0;
+        auto start = clock::now();
+        for (int r = 0; r < ROUNDS; ++r)
+            for (auto [cp, script] : text)
+                found += select(cp, script) ? 1 : 0;
+        auto ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        return std::pair{ns / (COUNT * ROUNDS), found};
+    };
+    auto [uncached, found0] = run([&](char32_t cp, hb_script_t script) {
+        return selector.resolveFont(cp, script);
+    });
+    auto [cached, found1] = run([&](char32_t cp, hb_script_t script) {
+        return selector.selectFont(cp, script);
+    });
+    CHECK(found0 == found1);
+    std::println("[BENCH] mixed Latin/CJK/Arabic {} codepoints: uncached {:.1f} ns/cp, "
+                 "cached {:.1f} ns/cp, speedup {:.2f}x, entries {}",
+                 COUNT, uncached, cached, uncached / cached,
+                 selector.selectCache().size());
+}
+
+int main()
+{
+    test_cached_equals_uncached();
+    test_invalidation();
+    bench_mixed_text();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "head.hpp"
+#include <algorithm>
+#include <format>
+
+namespace font_ns = mcs::vulkan::font;
+using mcs::vulkan::thread_pool;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+using layout_type = font_ns::text_layout<fake::font_context>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ZHS = HB_TAG('Z', 'H', 'S', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+static void load_fonts(selector_type &selector)
+{
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.initNotdefFont();
+    // NOTE: 留一部分在 candidate 中，验证懒加载在锁内串行发生
+    std::vector<font_ns::FontInfo> candidate;
+    candidate.emplace_back(make_info("cjk", {{0x3000, 0x303F}, {0x4E00, 0x9FFF}},
+                                     {HB_SCRIPT_HAN}, {ZHS}));
+    candidate.emplace_back(
+        make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.setCandidate(std::move(candidate));
+}
+
+static std::vector<std::string> make_labels(size_t count)
+{
+    constexpr std::string_view parts[] = {"OK", "Cancel", "设置", "إلغاء", "Volume 音量",
+                                          "مرحبا world", "文件 File"};
+    std::vector<std::string> labels;
+    labels.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        labels.emplace_back(std::format("{} #{}", parts[i % std::size(parts)], i));
+    return labels;
+}
+
+static bool same_layout(const layout_type &a, const layout_type &b)
+{
+    if (!std::ranges::equal(a.codepoints, b.codepoints) ||
+        !std::ranges::equal(a.breaks, b.breaks) || a.glyphs.size() != b.glyphs.size())
+        return false;
+    for (size_t i = 0; i < a.glyphs.size(); ++i)
+    {
+        if (a.glyphs[i].logical_idx != b.glyphs[i].logical_idx ||
+            a.glyphs[i].font_ctx->name != b.glyphs[i].font_ctx->name)
+            return false;
+    }
+    return true;
+}
+
+static void test_batch_matches_serial()
+{
+    TEST("shape_batch == serial layout_text, in input order");
+    const auto labels = make_labels(2000);
+    const std::vector<std::string_view> texts{labels.begin(), labels.end()};
+
+    fake::font_factory serial_factory;
+    selector_type serial_selector{&serial_factory, ENG};
+    load_fonts(serial_selector);
+    // NOTE: 先让 candidate 全部加载，保证两边字体顺序一致
+    for (auto text : texts)
+        font_ns::layout_text(font_ns::text_arena<fake::font_context>::local(), text, 0,
+                             serial_selector);
+
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    thread_pool pool{4};
+    std::vector<layout_type> out;
+    font_ns::shape_batch(pool, std::span{texts}, 0, selector, out);
+    CHECK(out.size() == texts.size());
+    CHECK(selector.candidate().empty());
+
+    auto &arena = font_ns::text_arena<fake::font_context>::local();
+    for (size_t i = 0; i < texts.size(); ++i)
+    {
+        font_ns::layout_text(arena, texts[i], 0, serial_selector);
+        CHECK(same_layout(out[i], arena));
+    }
+    PASS();
+}
+
+static void bench_batch()
+{
+    using clock = std::chrono::steady_clock;
+    const auto labels = make_labels(20000);
+    const std::vector<std::string_view> texts{labels.begin(), labels.end()};
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    std::vector<layout_type> out(texts.size());
+    auto &arena = font_ns::text_arena<fake::font_context>::local();
+    auto start = clock::now();
+    for (size_t i = 0; i < texts.size(); ++i)
+    {
+        font_ns::layout_text(arena, texts[i], 0, selector);
+        out[i] = static_cast<const layout_type &>(arena);
+    }
+    const auto serial =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    thread_pool pool;
+    font_ns::shape_batch(pool, std::span{texts}, 0, selector, out); // 预热
+    start = clock::now();
+    font_ns::shape_batch(pool, std::span{texts}, 0, selector, out);
+    const auto batch =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    std::println("[BENCH] {} labels: serial {:.2f} ms, batch({} threads) {:.2f} ms, "
+                 "speedup {:.2f}x",
+                 texts.size(), serial, pool.size(), batch, serial / batch);
+}
+
+int main()
+{
+    test_batch_matches_serial();
+    bench_batch();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
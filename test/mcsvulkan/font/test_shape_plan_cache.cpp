@@ -0,0 +1,262 @@
+#include "head.hpp"
+#include <algorithm>
+#include <filesystem>
+
+namespace font_ns = mcs::vulkan::font;
+using font_ns::harfbuzz::shape_plan_cache;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+using HBFontPtr = mcs::vulkan::unique_handle<hb_font_t *, [](hb_font_t *value) noexcept {
+    hb_font_destroy(value);
+}>;
+using HBBufferPtr =
+    mcs::vulkan::unique_handle<hb_buffer_t *, [](hb_buffer_t *value) noexcept {
+        hb_buffer_destroy(value);
+    }>;
+
+struct sample // NOLINTBEGIN
+{
+    const char *file;
+    hb_script_t script;
+    const char *language;
+    hb_direction_t direction;
+    std::vector<std::string_view> words;
+}; // NOLINTEND
+
+// NOTE: 仓库只带了 TiroBangla(孟加拉文，与天城文同属 Indic shaper)。
+// 阿拉伯文/天城文字体放进 FONT_INPUT_DIR 即可参与基准，缺失时跳过
+static const std::vector<sample> &samples()
+{
+    static const std::vector<sample> value{
+        {.file = "TiroBangla-Regular.ttf",
+         .script = HB_SCRIPT_BENGALI,
+         .language = "bn",
+         .direction = HB_DIRECTION_LTR,
+         .words = {"বাংলা", "ক্ষমা", "স্বাধীনতা", "রবীন্দ্রনাথ", "শ্রী"}},
+        {.file = "NotoSansArabic-Regular.ttf",
+         .script = HB_SCRIPT_ARABIC,
+         .language = "ar",
+         .direction = HB_DIRECTION_RTL,
+         .words = {"مرحبا", "العربية", "بسم الله", "إلغاء", "السلام عليكم"}},
+        {.file = "NotoSansDevanagari-Regular.ttf",
+         .script = HB_SCRIPT_DEVANAGARI,
+         .language = "hi",
+         .direction = HB_DIRECTION_LTR,
+         .words = {"हिन्दी", "क्षत्रिय", "स्वतंत्रता", "श्री", "द्वार"}}};
+    return value;
+}
+
+static HBFontPtr open_font(const char *file)
+{
+    const auto path = std::filesystem::path{FONT_INPUT_DIR} / file;
+    if (!std::filesystem::exists(path))
+        return HBFontPtr{};
+    hb_blob_t *blob = hb_blob_create_from_file_or_fail(path.string().c_str());
+    if (blob == nullptr)
+        return HBFontPtr{};
+    hb_face_t *face = hb_face_create(blob, 0);
+    hb_blob_destroy(blob);
+    HBFontPtr font{hb_font_create(face)};
+    hb_face_destroy(face);
+    return font;
+}
+
+static void fill(hb_buffer_t *buf, const sample &s, std::string_view word)
+{
+    hb_buffer_reset(buf);
+    hb_buffer_add_utf8(buf, word.data(), static_cast<int>(word.size()), 0,
+                       static_cast<int>(word.size()));
+    hb_buffer_set_direction(buf, s.direction);
+    hb_buffer_set_script(buf, s.script);
+    hb_buffer_set_language(buf, hb_language_from_string(s.language, -1));
+}
+
+static bool same_output(hb_buffer_t *a, hb_buffer_t *b)
+{
+    unsigned int na = 0;
+    unsigned int nb = 0;
+    const auto *ia = hb_buffer_get_glyph_infos(a, &na);
+    const auto *ib = hb_buffer_get_glyph_infos(b, &nb);
+    const auto *pa = hb_buffer_get_glyph_positions(a, &na);
+    const auto *pb = hb_buffer_get_glyph_positions(b, &nb);
+    if (na != nb)
+        return false;
+    for (unsigned int i = 0; i < na; ++i)
+    {
+        if (ia[i].codepoint != ib[i].codepoint || ia[i].cluster != ib[i].cluster ||
+            pa[i].x_advance != pb[i].x_advance || pa[i].x_offset != pb[i].x_offset ||
+            pa[i].y_offset != pb[i].y_offset)
+            return false;
+    }
+    return true;
+}
+
+static void test_cache_key()
+{
+    TEST("plan cache key = (font, script, language, direction, features)");
+    HBFontPtr font{hb_font_create(hb_face_get_empty())};
+    HBFontPtr other{hb_font_create(hb_face_get_empty())};
+    shape_plan_cache plans;
+
+    hb_segment_properties_t props = HB_SEGMENT_PROPERTIES_DEFAULT;
+    props.direction = HB_DIRECTION_LTR;
+    props.script = HB_SCRIPT_LATIN;
+    props.language = hb_language_from_string("en", -1);
+
+    auto *plan = plans.get(font.get(), props);
+    CHECK(plan != nullptr);
+    CHECK(plans.get(font.get(), props) == plan);
+    CHECK(plans.hits() == 1 && plans.misses() == 1);
+
+    auto rtl = props;
+    rtl.direction = HB_DIRECTION_RTL;
+    (void)plans.get(font.get(), rtl);
+    auto arabic = props;
+    arabic.script = HB_SCRIPT_ARABIC;
+    (void)plans.get(font.get(), arabic);
+    (void)plans.get(other.get(), props);
+    const hb_feature_t liga_off[] = {
+        {.tag = HB_TAG('l', 'i', 'g', 'a'), .value = 0, .start = 0, .end = ~0U}};
+    (void)plans.get(font.get(), props, liga_off);
+    (void)plans.get(font.get(), props, liga_off);
+    CHECK(plans.size() == 5);
+    CHECK(plans.misses() == 5 && plans.hits() == 2);
+
+    // NOTE: 同一 hb_font 改变变体坐标后不能复用旧 plan
+    const int coords[] = {8192};
+    hb_font_set_var_coords_normalized(font.get(), coords, 1);
+    unsigned int num_coords = 0;
+    (void)hb_font_get_var_coords_normalized(font.get(), &num_coords);
+    if (num_coords == 1)
+    {
+        (void)plans.get(font.get(), props);
+        CHECK(plans.size() == 6 && plans.misses() == 6);
+        (void)plans.get(font.get(), props);
+        CHECK(plans.hits() == 3);
+    }
+
+    // NOTE: erase 只丢弃该字体的 plan；invalidate_all 在下一次 get 时清空整个缓存
+    const size_t before = plans.size();
+    plans.erase(other.get());
+    CHECK(plans.size() == before - 1);
+    shape_plan_cache::invalidate_all();
+    (void)plans.get(other.get(), props);
+    CHECK(plans.size() == 1);
+
+    plans.clear();
+    CHECK(plans.size() == 0);
+    PASS();
+}
+
+static void test_execute_matches_hb_shape()
+{
+    TEST("shape_plan_cache::execute == hb_shape");
+    HBBufferPtr a{hb_buffer_create()};
+    HBBufferPtr b{hb_buffer_create()};
+    shape_plan_cache plans;
+    size_t fonts = 0;
+    for (const auto &s : samples())
+    {
+        auto font = open_font(s.file);
+        if (!font)
+            continue;
+        ++fonts;
+        for (int round = 0; round < 2; ++round)
+        {
+            for (auto word : s.words)
+            {
+                fill(a.get(), s, word);
+                fill(b.get(), s, word);
+                hb_shape(font.get(), a.get(), nullptr, 0);
+                CHECK(plans.execute(font.get(), b.get()));
+                CHECK(same_output(a.get(), b.get()));
+            }
+        }
+    }
+    CHECK(fonts > 0);
+    // 每个字体只有一组 (script, language, direction)
+    CHECK(plans.misses() == fonts);
+    PASS();
+}
+
+static void test_arena_reuses_plans()
+{
+    TEST("layout_text reuses text_arena::plans across calls");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.load(make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.initNotdefFont();
+
+    font_ns::text_arena<fake::font_context> arena;
+    constexpr std::string_view text = "hello مرحبا world";
+    font_ns::layout_text(arena, text, 0, selector);
+    const size_t plans = arena.plans.size();
+    const size_t misses = arena.plans.misses();
+    CHECK(plans > 0);
+    for (int i = 0; i < 10; ++i)
+        font_ns::layout_text(arena, text, 0, selector);
+    CHECK(arena.plans.size() == plans);
+    CHECK(arena.plans.misses() == misses);
+    CHECK(arena.plans.hits() > 0);
+    PASS();
+}
+
+static void bench_plans()
+{
+    using clock = std::chrono::steady_clock;
+    constexpr int ROUNDS = 2000;
+    HBBufferPtr buf{hb_buffer_create()};
+    for (const auto &s : samples())
+    {
+        auto font = open_font(s.file);
+        if (!font)
+        {
+            std::println("[BENCH] {}: not found, skipped", s.file);
+            continue;
+        }
+        auto run = [&](auto &&shape_one) {
+            const auto start = clock::now();
+            for (int i = 0; i < ROUNDS; ++i)
+                for (auto word : s.words)
+                {
+                    fill(buf.get(), s, word);
+                    shape_one();
+                }
+            const auto us =
+                std::chrono::duration<double, std::micro>(clock::now() - start).count();
+            return us / (ROUNDS * static_cast<double>(s.words.size()));
+        };
+
+        // NOTE: 每次新建 plan，即没有任何缓存时的 GSUB/GPOS 编译代价
+        const auto uncached = run([&] {
+            hb_segment_properties_t props;
+            hb_buffer_get_segment_properties(buf.get(), &props);
+            hb_shape_plan_t *plan =
+                hb_shape_plan_create(hb_font_get_face(font.get()), &props, nullptr, 0,
+                                     nullptr);
+            hb_shape_plan_execute(plan, font.get(), buf.get(), nullptr, 0);
+            hb_shape_plan_destroy(plan);
+        });
+        const auto shape = run([&] { hb_shape(font.get(), buf.get(), nullptr, 0); });
+        shape_plan_cache plans;
+        const auto cached = run([&] { (void)plans.execute(font.get(), buf.get()); });
+        std::println("[BENCH] {}: per word uncached plan {:.2f} us, hb_shape {:.2f} us, "
+                     "shape_plan_cache {:.2f} us",
+                     s.file, uncached, shape, cached);
+    }
+}
+
+int main()
+{
+    test_cache_key();
+    test_execute_matches_hb_shape();
+    test_arena_reuses_plans();
+    bench_plans();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
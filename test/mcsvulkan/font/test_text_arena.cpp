@@ -0,0 +1,116 @@
+#include "head.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// NOTE: 统计 C++ 堆分配次数（C 库内部的 malloc 不计入）
+static std::atomic<size_t> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) // NOLINT
+        return p;
+    throw std::bad_alloc{};
+}
+void operator delete(void *p) noexcept
+{
+    std::free(p); // NOLINT
+}
+void operator delete(void *p, std::size_t /*size*/) noexcept
+{
+    std::free(p); // NOLINT
+}
+
+namespace font_ns = mcs::vulkan::font;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+using arena_type = font_ns::text_arena<fake::font_context>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ZHS = HB_TAG('Z', 'H', 'S', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+constexpr std::string_view TEXT_A =
+    "Hello, world! 你好，世界。مرحبا بالعالم\n"
+    "The quick brown fox (123) jumps: ثعلب بني سريع.\n"
+    "é Ångström 天地玄黄";
+constexpr std::string_view TEXT_B = "short مرحبا 中文";
+
+static void load_fonts(selector_type &selector)
+{
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.load(make_info("cjk", {{0x3000, 0x303F}, {0x4E00, 0x9FFF}, {0xFF00, 0xFFEF}},
+                            {HB_SCRIPT_HAN}, {ZHS}));
+    selector.load(
+        make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.initNotdefFont();
+}
+
+static void test_same_as_vector_pipeline()
+{
+    TEST("arena pipeline == vector pipeline");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    auto norm = font_ns::utf8proc::normalize(std::string{TEXT_A});
+    auto visual = font_ns::bidi::analyze(norm.codepoints, 0);
+    auto runs = font_ns::assign_fonts(visual, selector);
+    auto shaped = font_ns::harfbuzz::shape(visual.mirrored_codepoints, runs,
+                                           selector.notdefFont());
+    auto breaks = font_ns::libunibreak::analyze_line_breaks(visual.mirrored_codepoints,
+                                                            selector.langBcp47());
+
+    arena_type arena;
+    font_ns::layout_text(arena, TEXT_A, 0, selector);
+
+    CHECK(std::ranges::equal(arena.codepoints, norm.codepoints));
+    CHECK(std::ranges::equal(arena.breaks, breaks.types));
+    CHECK(arena.visual.runs.size() == visual.visual_bidi_runs.size());
+    CHECK(arena.glyph_ranges.size() == shaped.size());
+    for (size_t i = 0; i < shaped.size(); ++i)
+    {
+        auto flat = arena.glyphs_of(arena.glyph_ranges[i]);
+        CHECK(flat.size() == shaped[i].size());
+        for (size_t j = 0; j < flat.size(); ++j)
+        {
+            CHECK(flat[j].logical_idx == shaped[i][j].logical_idx);
+            CHECK(flat[j].font_ctx == shaped[i][j].font_ctx);
+            CHECK(flat[j].direction == shaped[i][j].direction);
+        }
+    }
+    PASS();
+}
+
+static void test_steady_state_zero_allocation()
+{
+    TEST("steady-state relayout does zero heap allocations");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+    auto &arena = arena_type::local();
+
+    // 预热：容量增长到最大文本规模，select_cache 填满
+    font_ns::layout_text(arena, TEXT_A, 0, selector);
+    font_ns::layout_text(arena, TEXT_B, 1, selector);
+
+    const size_t before = g_allocations.load();
+    for (int i = 0; i < 100; ++i) // NOLINT
+    {
+        font_ns::layout_text(arena, (i % 2) == 0 ? TEXT_A : TEXT_B, i % 2, selector);
+        CHECK(!arena.glyphs.empty());
+    }
+    const size_t allocations = g_allocations.load() - before;
+    std::print("({} allocations) ", allocations);
+    CHECK(allocations == 0);
+    PASS();
+}
+
+int main()
+{
+    test_same_as_vector_pipeline();
+    test_steady_state_zero_allocation();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "head.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace font_ns = mcs::vulkan::font;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+using document_type = font_ns::text_document<selector_type>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+static void load_fonts(selector_type &selector)
+{
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.load(make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.initNotdefFont();
+}
+
+// NOTE: 增量结果必须与整篇重新排版完全一致
+static void check_same_as_fresh(const document_type &doc, selector_type &selector)
+{
+    document_type fresh{&selector, 0};
+    fresh.assign(doc.text());
+    CHECK(fresh.size() == doc.size());
+    CHECK(fresh.paragraphCount() == doc.paragraphCount());
+    for (size_t i = 0; i < doc.paragraphCount(); ++i)
+    {
+        const auto &a = doc[i];
+        const auto &b = fresh[i];
+        CHECK(a.text == b.text);
+        CHECK(std::ranges::equal(a.layout.codepoints, b.layout.codepoints));
+        CHECK(std::ranges::equal(a.layout.breaks, b.layout.breaks));
+        CHECK(a.layout.visual.runs.size() == b.layout.visual.runs.size());
+        CHECK(a.layout.glyphs.size() == b.layout.glyphs.size());
+    }
+}
+
+static void test_edits()
+{
+    TEST("incremental edits == full relayout");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    document_type doc{&selector, 0};
+    doc.assign("first line\nسطر ثان\r\nthird\n");
+    CHECK(doc.paragraphCount() == 3);
+    check_same_as_fresh(doc, selector);
+
+    // 段内插入：只重排 1 段
+    auto span = doc.insert(3, "XYZ");
+    CHECK(span.first == 0 && span.count == 1);
+    CHECK(doc[0].text == "firXYZst line\n");
+    check_same_as_fresh(doc, selector);
+
+    // 插入换行：拆分
+    span = doc.insert(5, "\n");
+    CHECK(span.first == 0 && span.count == 2);
+    CHECK(doc.paragraphCount() == 4);
+    check_same_as_fresh(doc, selector);
+
+    // 删除换行：合并
+    span = doc.erase(5, 1);
+    CHECK(span.first == 0 && span.count == 1);
+    CHECK(doc.paragraphCount() == 3);
+    check_same_as_fresh(doc, selector);
+
+    // 跨段替换
+    CHECK(doc.locate(doc.text().find("ثان")).first == 1);
+    doc.replace(doc.text().find("line"), doc.text().find("ثان") - doc.text().find("line"),
+                "L ");
+    check_same_as_fresh(doc, selector);
+
+    // CR 与下一段的 LF 组成 CRLF
+    doc.assign("a\rb\nc");
+    CHECK(doc.paragraphCount() == 3);
+    doc.erase(2, 1); // "a\r\nc"
+    CHECK(doc.text() == "a\r\nc");
+    CHECK(doc.paragraphCount() == 2);
+    check_same_as_fresh(doc, selector);
+
+    // 末尾追加 / 全部删除
+    doc.insert(doc.size(), "\ntail");
+    check_same_as_fresh(doc, selector);
+    doc.erase(0, doc.size());
+    CHECK(doc.size() == 0 && doc.paragraphCount() == 1);
+    PASS();
+}
+
+static void bench_keystroke()
+{
+    using clock = std::chrono::steady_clock;
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    const std::string line = "The quick brown fox jumps over the lazy dog. "
+                             "الثعلب البني السريع يقفز فوق الكلب الكسول.\n";
+    for (size_t bytes : {size_t{10} << 10U, size_t{1} << 20U})
+    {
+        std::string text;
+        while (text.size() < bytes)
+            text += line;
+        document_type doc{&selector, 0};
+        auto start = clock::now();
+        doc.assign(text);
+        auto full_ms =
+            std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+        constexpr int KEYSTROKES = 200;
+        // NOTE: 从段首开始插入，保证落在 UTF-8 字符边界上
+        const auto [paragraph, in_paragraph] = doc.locate(doc.size() / 2);
+        const size_t offset = (doc.size() / 2) - in_paragraph;
+        std::vector<double> us(KEYSTROKES);
+        for (int i = 0; i < KEYSTROKES; ++i)
+        {
+            start = clock::now();
+            doc.insert(offset + static_cast<size_t>(i), "a");
+            us[static_cast<size_t>(i)] =
+                std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        }
+        CHECK(doc[paragraph].text.starts_with(std::string(KEYSTROKES, 'a')));
+        // NOTE: 按键代价与段落表树高成正比；treap 期望高度约 2 ln P，这里留足余量
+        const size_t depth = doc.paragraphTreeDepth();
+        CHECK(depth <= 4 * std::bit_width(doc.paragraphCount()));
+        std::ranges::nth_element(us, us.begin() + (KEYSTROKES / 2));
+        std::println("[BENCH] {:>8} bytes, {:>6} paragraphs (tree depth {}): "
+                     "full layout {:.2f} ms, keystroke {:.2f} us (median)",
+                     doc.size(), doc.paragraphCount(), depth, full_ms,
+                     us[KEYSTROKES / 2]);
+    }
+}
+
+int main()
+{
+    test_edits();
+    bench_keystroke();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "head.hpp"
+#include <cmath>
+#include <format>
+
+namespace font_ns = mcs::vulkan::font;
+using selector_type = font_ns::GenFontSelector<fake::font_factory>;
+using view_type = font_ns::text_view<selector_type>;
+
+constexpr hb_tag_t ENG = HB_TAG('E', 'N', 'G', ' ');
+constexpr hb_tag_t ARA = HB_TAG('A', 'R', 'A', ' ');
+
+constexpr double WIDTH = 20.0; // fake 字体每个字形 0.5em，约 40 个字符一行
+constexpr double LINE_HEIGHT = 1.25;
+constexpr double VIEWPORT = 60 * LINE_HEIGHT;
+constexpr size_t OVERSCAN = 8;
+
+static void load_fonts(selector_type &selector)
+{
+    using fake::make_info;
+    selector.load(make_info("latin", {{0x20, 0x24F}}, {HB_SCRIPT_LATIN}, {ENG}));
+    selector.load(make_info("arabic", {{0x600, 0x6FF}}, {HB_SCRIPT_ARABIC}, {ARA}));
+    selector.initNotdefFont();
+}
+
+// NOTE: 长短不一的日志行，部分需要折行
+static std::string make_line(size_t i)
+{
+    constexpr std::string_view tails[] = {"", " connected", " مرحبا بكم",
+                                          " request finished in 12 ms with status 200",
+                                          " retrying the upload of chunk 17 of 64 after "
+                                          "a timeout on the secondary endpoint"};
+    return std::format("[{:06}] event{}", i, tails[(i * 7) % std::size(tails)]);
+}
+
+static double exact_height(selector_type &selector, std::string_view text)
+{
+    auto &arena = font_ns::text_arena<fake::font_context>::local();
+    font_ns::layout_text(arena, text, 0, selector);
+    font_ns::line_fitter fitter;
+    fitter.build(arena);
+    return static_cast<double>(std::max<size_t>(1, fitter.wrap(WIDTH).size())) *
+           LINE_HEIGHT;
+}
+
+static void check_frame(std::span<const view_type::visible_line> visible,
+                        const view_type &view)
+{
+    CHECK(!visible.empty());
+    CHECK(visible.front().y <= 0.0 && visible.front().y > -LINE_HEIGHT);
+    for (size_t i = 1; i < visible.size(); ++i)
+    {
+        CHECK(visible[i].y == visible[i - 1].y + LINE_HEIGHT);
+        CHECK(visible[i].source >= visible[i - 1].source);
+    }
+    CHECK(visible.back().y < VIEWPORT);
+    // NOTE: 缓存只覆盖可见源行 ± overscan
+    const size_t sources = visible.back().source - visible.front().source + 1;
+    CHECK(view.cachedCount() <= sources + (2 * OVERSCAN));
+}
+
+static void test_scroll_through()
+{
+    TEST("scroll through: bounded cache, exact heights once measured");
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    constexpr size_t LINES = 3000;
+    view_type view{&selector, 0, WIDTH, LINE_HEIGHT, OVERSCAN};
+    double exact = 0.0;
+    for (size_t i = 0; i < LINES; ++i)
+    {
+        view.append(make_line(i));
+        exact += exact_height(selector, make_line(i));
+    }
+    CHECK(view.contentHeight() == LINES * LINE_HEIGHT); // 全部未测量，按单行估计
+
+    auto visible = view.update(VIEWPORT);
+    CHECK(visible.front().source == 0 && visible.front().y == 0.0);
+    check_frame(visible, view);
+    while (view.offset() + VIEWPORT < view.contentHeight() - 1e-6)
+    {
+        view.scrollBy(VIEWPORT / 2);
+        check_frame(view.update(VIEWPORT), view);
+    }
+    CHECK(view.measuredCount() == LINES);
+    CHECK(std::abs(view.contentHeight() - exact) < 1e-6);
+    CHECK(view.update(VIEWPORT).back().source == LINES - 1);
+
+    // 锚定到某一源行
+    view.scrollToLine(1234);
+    visible = view.update(VIEWPORT);
+    CHECK(visible.front().source == 1234 && visible.front().y == 0.0);
+
+    // 修改可见行：下一帧重新排版并更新行高
+    const double before = view.contentHeight();
+    view.set(1234, make_line(4) + make_line(4));
+    visible = view.update(VIEWPORT);
+    CHECK(visible.front().source == 1234);
+    CHECK(view.contentHeight() != before);
+    CHECK(view.measuredCount() == LINES);
+
+    // 宽度变化：全部重新估计
+    view.resize(WIDTH * 2);
+    CHECK(view.measuredCount() == 0 && view.cachedCount() == 0);
+    check_frame(view.update(VIEWPORT), view);
+
+    // 视觉顺序
+    std::vector<font_ns::run_range> runs;
+    for (const auto &line : view.update(VIEWPORT))
+    {
+        view.reorder(line, runs);
+        size_t glyphs = 0;
+        for (const auto &run : runs)
+            glyphs += run.count;
+        CHECK(glyphs <= line.layout->glyphs.size());
+    }
+    PASS();
+}
+
+static void bench_frames()
+{
+    using clock = std::chrono::steady_clock;
+    fake::font_factory factory;
+    selector_type selector{&factory, ENG};
+    load_fonts(selector);
+
+    for (size_t lines : {size_t{10'000}, size_t{100'000}, size_t{500'000}})
+    {
+        view_type view{&selector, 0, WIDTH, LINE_HEIGHT, OVERSCAN};
+        for (size_t i = 0; i < lines; ++i)
+            view.append(make_line(i));
+        (void)view.update(VIEWPORT);
+
+        // 每帧滚动 3 行，以及随机跳转
+        constexpr int FRAMES = 300;
+        auto start = clock::now();
+        for (int i = 0; i < FRAMES; ++i)
+        {
+            view.scrollBy(3 * LINE_HEIGHT);
+            (void)view.update(VIEWPORT);
+        }
+        const auto scroll_us =
+            std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        start = clock::now();
+        for (int i = 0; i < FRAMES; ++i)
+        {
+            view.scrollTo(view.contentHeight() * ((i * 37) % 100) / 100.0); // NOLINT
+            (void)view.update(VIEWPORT);
+        }
+        const auto jump_us =
+            std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        std::println("[BENCH] {:>7} lines: scroll frame {:.2f} us, jump frame {:.2f} us, "
+                     "cached {} entries",
+                     lines, scroll_us / FRAMES, jump_us / FRAMES, view.cachedCount());
+    }
+}
+
+int main()
+{
+    test_scroll_through();
+    bench_frames();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "head.hpp"
+#include <algorithm>
+#include <string_view>
+
+namespace utf8 = mcs::vulkan::font::utf8proc;
+
+// NOTE: 以 utf8proc_iterate 为参照
+static std::vector<uint32_t> reference_decode(std::string_view text)
+{
+    std::vector<uint32_t> ret;
+    const auto *p = reinterpret_cast<const utf8proc_uint8_t *>(text.data()); // NOLINT
+    const auto *end = p + text.size();
+    while (p < end)
+    {
+        utf8proc_int32_t cp; // NOLINT
+        const auto bytes = utf8proc_iterate(p, end - p, &cp);
+        if (bytes < 0)
+            return {};
+        ret.push_back(static_cast<uint32_t>(cp));
+        p += bytes;
+    }
+    return ret;
+}
+
+struct corpus // NOLINTBEGIN
+{
+    const char *name;
+    std::string text;
+}; // NOLINTEND
+
+static std::string repeat(std::string_view unit, size_t bytes)
+{
+    std::string ret;
+    ret.reserve(bytes + unit.size());
+    while (ret.size() < bytes)
+        ret += unit;
+    return ret;
+}
+
+static std::vector<corpus> make_corpora(size_t bytes)
+{
+    return {
+        {.name = "ascii",
+         .text = repeat("The quick brown fox jumps over the lazy dog 0123456789. ",
+                        bytes)},
+        {.name = "latin1",
+         .text = repeat("Ça été très agréable, naïve façon de señor Müller. ", bytes)},
+        {.name = "cjk",
+         .text = repeat("中文排版需要处理标点挤压与避头尾规则，한국어 문장도 포함。", bytes)},
+        {.name = "mixed",
+         .text = repeat("log: 用户 alice 登录成功 (مرحبا) status=200 ok 😀 ", bytes)},
+    };
+}
+
+static void test_decode()
+{
+    TEST("SIMD decode matches utf8proc_iterate, rejects invalid UTF-8");
+    std::vector<uint32_t> out;
+    for (const auto &[name, text] : make_corpora(4096))
+    {
+        // 各种长度，覆盖 16 字节块边界
+        for (size_t len : {size_t{0}, size_t{1}, size_t{15}, size_t{16}, size_t{17},
+                           size_t{33}, text.size()})
+        {
+            std::string_view view{text.data(), std::min(len, text.size())};
+            const auto expected = reference_decode(view);
+            if (expected.empty() && !view.empty())
+                continue; // 截断在多字节序列中间
+            CHECK(utf8::decode_utf8(view, out));
+            CHECK(out == expected);
+        }
+    }
+    for (std::string_view bad :
+         {"\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80",
+          "\xF5\x80\x80\x80", "abc\xE4\xB8", "\x80", "0123456789abcdef\xFF"})
+    {
+        CHECK(!utf8::decode_utf8(bad, out));
+        bool thrown = false;
+        try
+        {
+            (void)utf8::normalize(bad, out);
+        }
+        catch (const std::exception &)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+    PASS();
+}
+
+static void test_quick_check()
+{
+    TEST("NFC quick check agrees with full normalization");
+    std::vector<uint32_t> fast;
+    std::vector<uint32_t> full;
+    std::vector<uint32_t> decoded;
+    for (const auto &[name, text] : make_corpora(1024))
+    {
+        CHECK(utf8::decode_utf8(text, decoded));
+        CHECK(utf8::is_nfc_quick(decoded));
+        CHECK(std::ranges::equal(utf8::normalize(text, fast),
+                                 utf8::normalize_full(text, full)));
+    }
+    // NFD、单字符分解、谚文字母、组合排除：必须走完整规范化
+    for (std::string_view text :
+         {"e\xCC\x81", "\xE2\x84\xAB", "\xE1\x84\x80\xE1\x85\xA1",
+          "\xE0\xA5\x98", "a\xCC\xA3\xCC\x87"})
+    {
+        CHECK(utf8::decode_utf8(text, decoded));
+        CHECK(!utf8::is_nfc_quick(decoded));
+        CHECK(std::ranges::equal(utf8::normalize(text, fast),
+                                 utf8::normalize_full(text, full)));
+        CHECK(fast != decoded);
+    }
+    PASS();
+}
+
+static void bench_throughput()
+{
+    using clock = std::chrono::steady_clock;
+    constexpr size_t BYTES = size_t{1} << 20U;
+    constexpr int ROUNDS = 20;
+    std::vector<uint32_t> out;
+    for (const auto &[name, text] : make_corpora(BYTES))
+    {
+        auto gbps = [&](auto &&fn) {
+            fn(); // 预热，分配容量
+            const auto start = clock::now();
+            for (int i = 0; i < ROUNDS; ++i)
+                fn();
+            const double s =
+                std::chrono::duration<double>(clock::now() - start).count();
+            return static_cast<double>(text.size()) * ROUNDS / s / 1e9;
+        };
+        const double decode = gbps([&] { (void)utf8::decode_utf8(text, out); });
+        const double fast = gbps([&] { (void)utf8::normalize(text, out); });
+        const double full = gbps([&] { (void)utf8::normalize_full(text, out); });
+        const double legacy = gbps([&] { (void)utf8::normalize(text.c_str()); });
+        std::println("[BENCH] {:>6}: decode {:.2f} GB/s, normalize {:.2f} GB/s, "
+                     "decompose+compose {:.3f} GB/s, utf8proc_NFC {:.3f} GB/s",
+                     name, decode, fast, full, legacy);
+    }
+}
+
+int main()
+{
+    test_decode();
+    test_quick_check();
+    bench_throughput();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -28,9 +28,13 @@ add_vulkan_tool_test(test_create_swap_chain)
 add_vulkan_tool_test(test_create_command_pool)
 add_vulkan_tool_test(test_frame_context)
 add_vulkan_tool_test(test_format)
+add_vulkan_tool_test(test_descriptor_allocator)
+add_vulkan_tool_test(test_resource_manager)
 
 add_std_glsl_target(test_create_pipeline_layout test_triangle.vert test_triangle.frag)
 add_std_glsl_target(test_create_graphics_pipeline test_triangle.vert test_triangle.frag)
+add_std_glsl_target(test_pipeline_cache test_triangle.vert test_triangle.frag)
+add_std_glsl_target(test_create_graphics_pipelines test_triangle.vert test_triangle.frag)
 
 # end
 std_glsl_env_destroy()
\ No newline at end of file
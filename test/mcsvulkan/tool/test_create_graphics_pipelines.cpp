@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "../head.hpp"
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::structure_chain;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_pipeline_layout;
+using mcs::vulkan::tool::create_graphics_pipeline;
+using mcs::vulkan::tool::create_pipeline_cache;
+using mcs::vulkan::tool::create_graphics_pipelines;
+using mcs::vulkan::tool::make_pNext;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::thread_pool;
+using mcs::vulkan::MCS_ASSERT;
+
+// NOTE: 不需要窗口。动态渲染，管线只需要颜色附件格式
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+struct variant_state // NOLINTBEGIN
+{
+    VkPrimitiveTopology topology;
+    VkCullModeFlags cullMode;
+    VkFrontFace frontFace;
+    VkBool32 blend;
+    VkSampleCountFlagBits samples;
+}; // NOLINTEND
+
+static create_graphics_pipeline make_variant(VkPipelineLayout layout,
+                                             const variant_state &state)
+{
+    using stage_info = create_graphics_pipeline::stage_info;
+    create_graphics_pipeline create;
+    create.setCreateInfo(
+        {.pNext = make_pNext(structure_chain<VkPipelineRenderingCreateInfo>{
+             {.colorAttachmentCount = 1, .pColorAttachmentFormats = &COLOR_FORMAT}}),
+         .stages = create_graphics_pipeline::makeStages(
+             stage_info{.stage = VK_SHADER_STAGE_VERTEX_BIT,
+                        .filePath = VERT_SHADER_PATH,
+                        .pName = "main"},
+             stage_info{.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+                        .filePath = FRAG_SHADER_PATH,
+                        .pName = "main"}),
+         .vertexInputState = {},
+         .inputAssemblyState = {.topology = state.topology,
+                                .primitiveRestartEnable = VK_FALSE},
+         .tessellationState = {},
+         .viewportState = {.viewports = {VkViewport{}}, .scissors = {VkRect2D{}}},
+         .rasterizationState = {.depthClampEnable = VK_FALSE,
+                                .rasterizerDiscardEnable = VK_FALSE,
+                                .polygonMode = VK_POLYGON_MODE_FILL,
+                                .cullMode = state.cullMode,
+                                .frontFace = state.frontFace,
+                                .depthBiasEnable = VK_FALSE,
+                                .lineWidth = 1.0F},
+         .multisampleState = {.rasterizationSamples = state.samples,
+                              .sampleShadingEnable = VK_FALSE},
+         .depthStencilState = {},
+         .colorBlendState = {.logicOpEnable = VK_FALSE,
+                             .logicOp = VkLogicOp::VK_LOGIC_OP_COPY,
+                             .attachments = {{.blendEnable = state.blend,
+                                              .srcColorBlendFactor =
+                                                  VK_BLEND_FACTOR_SRC_ALPHA,
+                                              .dstColorBlendFactor =
+                                                  VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                                              .colorBlendOp = VK_BLEND_OP_ADD,
+                                              .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+                                              .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+                                              .alphaBlendOp = VK_BLEND_OP_ADD,
+                                              .colorWriteMask =
+                                                  VK_COLOR_COMPONENT_R_BIT |
+                                                  VK_COLOR_COMPONENT_G_BIT |
+                                                  VK_COLOR_COMPONENT_B_BIT |
+                                                  VK_COLOR_COMPONENT_A_BIT}}},
+         .dynamicState = {.dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT,
+                                            VK_DYNAMIC_STATE_SCISSOR}},
+         .layout = layout});
+    return create;
+}
+
+// NOTE: MSAA、图元拓扑、剔除、混合的 48 个组合
+static create_graphics_pipelines make_variants(VkPipelineLayout layout)
+{
+    constexpr std::array TOPOLOGIES{VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+                                    VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP};
+    constexpr std::array CULL_MODES{VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT,
+                                    VK_CULL_MODE_FRONT_BIT};
+    constexpr std::array FRONT_FACES{VK_FRONT_FACE_CLOCKWISE,
+                                     VK_FRONT_FACE_COUNTER_CLOCKWISE};
+    constexpr std::array SAMPLES{VK_SAMPLE_COUNT_1_BIT, VK_SAMPLE_COUNT_4_BIT};
+    create_graphics_pipelines variants;
+    for (size_t i = 0; i < 48; ++i)
+        (void)variants.add(make_variant(
+            layout,
+            {.topology = TOPOLOGIES[i % 2],
+             .cullMode = static_cast<VkCullModeFlags>(CULL_MODES[(i / 2) % 3]),
+             .frontFace = FRONT_FACES[(i / 6) % 2],
+             .blend = static_cast<VkBool32>((i / 12) % 2),
+             .samples = SAMPLES[i / 24]}));
+    return variants;
+}
+
+int main()
+try
+{
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_create_graphics_pipelines",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    structure_chain<VkPhysicalDeviceFeatures2, VkPhysicalDeviceVulkan13Features>
+        enablefeatureChain = {{}, {.dynamicRendering = VK_TRUE}};
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    std::println("device: {}", physical_device.getProperties().deviceName);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.pNext = make_pNext(enablefeatureChain),
+                 .queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    auto pipelineLayout = create_pipeline_layout{}
+                              .setCreateInfo({.setLayouts = {}, .pushConstantRanges = {}})
+                              .build(device);
+    const auto variants = make_variants(*pipelineLayout);
+
+    using result_type = create_graphics_pipelines::result_type;
+    const auto total_ms = [](const result_type &result) {
+        double sum = 0;
+        for (const auto &time : result.compileTimes)
+            sum += std::chrono::duration<double, std::milli>(time).count();
+        return sum;
+    };
+    const auto check = [&](const result_type &result) {
+        MCS_ASSERT(result.pipelines.size() == variants.size());
+        MCS_ASSERT(result.compileTimes.size() == variants.size());
+        for (const auto &pipeline : result.pipelines)
+            MCS_ASSERT(pipeline);
+    };
+    const auto timed = [](auto &&fn) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = fn();
+        const double ms = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+        return std::pair{std::move(result), ms};
+    };
+
+    // 1. 基准：调用线程依次编译，不用缓存
+    const auto [serial, serial_ms] = timed([&] { return variants.build(device); });
+    check(serial);
+    std::println("[BENCH] {} pipelines serial: {:.2f} ms", variants.size(), serial_ms);
+    for (size_t i = 0; i < 4; ++i)
+        std::println("  pipeline {}: {:.3f} ms", i,
+                     std::chrono::duration<double, std::milli>(serial.compileTimes[i])
+                         .count());
+
+    // 2. 线程池，无缓存 / 共享缓存 / 每线程缓存
+    const size_t cores = std::max(1U, std::thread::hardware_concurrency());
+    for (size_t threads = 1;; threads = std::min(threads * 2, cores))
+    {
+        thread_pool pool{threads};
+        const auto [none, none_ms] = timed([&] { return variants.build(device, &pool); });
+        check(none);
+
+        auto shared = create_pipeline_cache{}.setCreateInfo({}).build(device);
+        const auto [cold, cold_ms] = timed(
+            [&] { return variants.build(device, &pool, {.cache = *shared}); });
+        check(cold);
+        const auto [warm, warm_ms] = timed(
+            [&] { return variants.build(device, &pool, {.cache = *shared}); });
+        check(warm);
+
+        auto merged = create_pipeline_cache{}.setCreateInfo({}).build(device);
+        const auto [worker, worker_ms] = timed([&] {
+            return variants.build(device, &pool,
+                                  {.cache = *merged, .perWorkerCaches = true});
+        });
+        check(worker);
+        // 合并后的缓存包含全部管线
+        MCS_ASSERT(merged.data().size() > 32);
+
+        std::println("[BENCH] {} threads: no cache {:.2f} ms ({:.2f}x, compile sum "
+                     "{:.2f} ms), shared cold {:.2f} ms, shared warm {:.2f} ms, "
+                     "per-worker {:.2f} ms",
+                     threads, none_ms, serial_ms / none_ms, total_ms(none), cold_ms,
+                     warm_ms, worker_ms);
+        if (threads == cores)
+            break;
+    }
+
+    // 3. 任一管线失败：等待其余任务后抛出
+    {
+        auto broken = make_variants(*pipelineLayout);
+        create_graphics_pipeline missing;
+        missing.setCreateInfo({.stages = create_graphics_pipeline::makeStages(
+                                   create_graphics_pipeline::stage_info{
+                                       .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                                       .filePath = "missing.spv",
+                                       .pName = "main"}),
+                               .layout = *pipelineLayout});
+        (void)broken.add(std::move(missing));
+        thread_pool pool{2};
+        bool thrown = false;
+        try
+        {
+            (void)broken.build(device, &pool);
+        }
+        catch (const std::exception &)
+        {
+            thrown = true;
+        }
+        MCS_ASSERT(thrown);
+    }
+
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
@@ -0,0 +1,199 @@
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <print>
+#include <vector>
+
+#include "../head.hpp"
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_descriptor_set_layout;
+using mcs::vulkan::tool::create_descriptor_pool;
+using mcs::vulkan::tool::descriptor_allocator;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::MCS_ASSERT;
+
+// NOTE: 不需要窗口，也不提交命令：没有 GPU 工作时帧可以立即 reset
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+constexpr uint32_t FRAMES = 64;
+constexpr uint32_t SETS_PER_FRAME = 1000;
+
+int main()
+try
+{
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_descriptor_allocator",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    std::println("device: {}", physical_device.getProperties().deviceName);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    // 每帧的物体：一个 uniform buffer + 一张纹理
+    auto setLayout =
+        create_descriptor_set_layout{}
+            .setCreateInfo(
+                {.bindings = {{.binding = 0,
+                               .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                               .descriptorCount = 1,
+                               .stageFlags = VK_SHADER_STAGE_VERTEX_BIT},
+                              {.binding = 1,
+                               .descriptorType =
+                                   VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                               .descriptorCount = 1,
+                               .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT}}})
+            .build(device);
+    const VkDescriptorSetLayout layout = *setLayout;
+    using clock = std::chrono::steady_clock;
+    const auto ns_per_set = [](clock::duration time, size_t sets) {
+        return std::chrono::duration<double, std::nano>(time).count() /
+               static_cast<double>(sets);
+    };
+
+    // 1. 固定大小的池：耗尽即失败
+    {
+        auto pool = create_descriptor_pool{}
+                        .setCreateInfo(
+                            {.maxSets = 16,
+                             .poolSizes = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 16},
+                                           {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                            16}}})
+                        .build(device);
+        const VkDescriptorSetAllocateInfo info{
+            .sType = mcs::vulkan::tool::sType<VkDescriptorSetAllocateInfo>(),
+            .descriptorPool = *pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &layout};
+        for (uint32_t i = 0; i < 16; ++i)
+            (void)device.allocateDescriptorSets(info);
+        bool thrown = false;
+        try
+        {
+            (void)device.allocateDescriptorSets(info);
+        }
+        catch (const std::exception &)
+        {
+            thrown = true;
+        }
+        MCS_ASSERT(thrown);
+    }
+
+    // 2. 分配器：按需串联新池，预热后只复用
+    descriptor_allocator<MAX_FRAMES_IN_FLIGHT> allocator{
+        device,
+        {.ratios = {{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .ratio = 1.0F},
+                    {.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .ratio = 1.0F}},
+         .initialSets = 16,
+         .maxSetsPerPool = 512}};
+    size_t warm_pools = 0;
+    clock::duration warm_time{};
+    for (uint32_t frame = 0; frame < FRAMES; ++frame)
+    {
+        const uint32_t currentFrame = frame % MAX_FRAMES_IN_FLIGHT;
+        allocator.reset(currentFrame);
+        const auto start = clock::now();
+        for (uint32_t i = 0; i < SETS_PER_FRAME; ++i)
+            MCS_ASSERT(allocator.allocate(currentFrame, layout) != VK_NULL_HANDLE);
+        const auto time = clock::now() - start;
+        if (frame == 2 * MAX_FRAMES_IN_FLIGHT)
+            warm_pools = allocator.pool_count();
+        if (frame >= 2 * MAX_FRAMES_IN_FLIGHT)
+        {
+            warm_time += time;
+            // NOTE: 稳定后不再创建池
+            MCS_ASSERT(allocator.pool_count() == warm_pools);
+        }
+    }
+    std::println("pools: {} total, {} in the last frame", allocator.pool_count(),
+                 allocator.frame_pool_count((FRAMES - 1) % MAX_FRAMES_IN_FLIGHT));
+
+    // 3. 对照：一个足够大的固定池，每帧 reset，经返回 vector 的分配接口
+    clock::duration fixed_time{};
+    {
+        auto pool = create_descriptor_pool{}
+                        .setCreateInfo(
+                            {.maxSets = SETS_PER_FRAME,
+                             .poolSizes = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                                            SETS_PER_FRAME},
+                                           {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                            SETS_PER_FRAME}}})
+                        .build(device);
+        const VkDescriptorSetAllocateInfo info{
+            .sType = mcs::vulkan::tool::sType<VkDescriptorSetAllocateInfo>(),
+            .descriptorPool = *pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &layout};
+        for (uint32_t frame = 2 * MAX_FRAMES_IN_FLIGHT; frame < FRAMES; ++frame)
+        {
+            pool.reset();
+            const auto start = clock::now();
+            for (uint32_t i = 0; i < SETS_PER_FRAME; ++i)
+                MCS_ASSERT(device.allocateDescriptorSets(info)[0] != VK_NULL_HANDLE);
+            fixed_time += clock::now() - start;
+        }
+    }
+    const size_t measured = size_t{FRAMES - (2 * MAX_FRAMES_IN_FLIGHT)} * SETS_PER_FRAME;
+    std::println("[BENCH] {} sets/frame: descriptor_allocator {:.1f} ns/set, "
+                 "fixed pool {:.1f} ns/set",
+                 SETS_PER_FRAME, ns_per_set(warm_time, measured),
+                 ns_per_set(fixed_time, measured));
+
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
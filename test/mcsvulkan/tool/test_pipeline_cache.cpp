@@ -0,0 +1,270 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <vector>
+
+#include "../head.hpp"
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::structure_chain;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_pipeline_layout;
+using mcs::vulkan::tool::create_graphics_pipeline;
+using mcs::vulkan::tool::create_pipeline_cache;
+using mcs::vulkan::tool::make_pNext;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::Pipeline;
+using mcs::vulkan::PipelineCache;
+using mcs::vulkan::MCS_ASSERT;
+
+// NOTE: 不需要窗口。动态渲染，管线只需要颜色附件格式
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+struct variant_state // NOLINTBEGIN
+{
+    VkPrimitiveTopology topology;
+    VkCullModeFlags cullMode;
+    VkFrontFace frontFace;
+    VkBool32 blend;
+}; // NOLINTEND
+
+static create_graphics_pipeline make_variant(VkPipelineLayout layout,
+                                             const variant_state &state)
+{
+    using stage_info = create_graphics_pipeline::stage_info;
+    create_graphics_pipeline create;
+    create.setCreateInfo(
+        {.pNext = make_pNext(structure_chain<VkPipelineRenderingCreateInfo>{
+             {.colorAttachmentCount = 1, .pColorAttachmentFormats = &COLOR_FORMAT}}),
+         .stages = create_graphics_pipeline::makeStages(
+             stage_info{.stage = VK_SHADER_STAGE_VERTEX_BIT,
+                        .filePath = VERT_SHADER_PATH,
+                        .pName = "main"},
+             stage_info{.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+                        .filePath = FRAG_SHADER_PATH,
+                        .pName = "main"}),
+         .vertexInputState = {},
+         .inputAssemblyState = {.topology = state.topology,
+                                .primitiveRestartEnable = VK_FALSE},
+         .tessellationState = {},
+         .viewportState = {.viewports = {VkViewport{}}, .scissors = {VkRect2D{}}},
+         .rasterizationState = {.depthClampEnable = VK_FALSE,
+                                .rasterizerDiscardEnable = VK_FALSE,
+                                .polygonMode = VK_POLYGON_MODE_FILL,
+                                .cullMode = state.cullMode,
+                                .frontFace = state.frontFace,
+                                .depthBiasEnable = VK_FALSE,
+                                .lineWidth = 1.0F},
+         .multisampleState = {.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+                              .sampleShadingEnable = VK_FALSE},
+         .depthStencilState = {},
+         .colorBlendState = {.logicOpEnable = VK_FALSE,
+                             .logicOp = VkLogicOp::VK_LOGIC_OP_COPY,
+                             .attachments = {{.blendEnable = state.blend,
+                                              .srcColorBlendFactor =
+                                                  VK_BLEND_FACTOR_SRC_ALPHA,
+                                              .dstColorBlendFactor =
+                                                  VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                                              .colorBlendOp = VK_BLEND_OP_ADD,
+                                              .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+                                              .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+                                              .alphaBlendOp = VK_BLEND_OP_ADD,
+                                              .colorWriteMask =
+                                                  VK_COLOR_COMPONENT_R_BIT |
+                                                  VK_COLOR_COMPONENT_G_BIT |
+                                                  VK_COLOR_COMPONENT_B_BIT |
+                                                  VK_COLOR_COMPONENT_A_BIT}}},
+         .dynamicState = {.dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT,
+                                            VK_DYNAMIC_STATE_SCISSOR}},
+         .layout = layout});
+    return create;
+}
+
+// NOTE: 24 个状态组合，驱动不能把它们当作同一条管线
+static std::vector<create_graphics_pipeline> make_variants(VkPipelineLayout layout)
+{
+    std::vector<create_graphics_pipeline> variants;
+    for (const auto topology :
+         {VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP})
+        for (const auto cullMode :
+             {VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_FRONT_BIT})
+            for (const auto frontFace :
+                 {VK_FRONT_FACE_CLOCKWISE, VK_FRONT_FACE_COUNTER_CLOCKWISE})
+                for (const VkBool32 blend : {VK_FALSE, VK_TRUE})
+                    variants.emplace_back(make_variant(
+                        layout, {.topology = topology,
+                                 .cullMode = static_cast<VkCullModeFlags>(cullMode),
+                                 .frontFace = frontFace,
+                                 .blend = blend}));
+    return variants;
+}
+
+static double build_all(const LogicalDevice &device,
+                        const std::vector<create_graphics_pipeline> &variants,
+                        VkPipelineCache cache)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Pipeline> pipelines;
+    pipelines.reserve(variants.size());
+    for (const auto &variant : variants)
+        pipelines.emplace_back(variant.build(device, cache));
+    const auto end = std::chrono::steady_clock::now();
+    for (const auto &pipeline : pipelines)
+        MCS_ASSERT(pipeline);
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+try
+{
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_pipeline_cache",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    structure_chain<VkPhysicalDeviceFeatures2, VkPhysicalDeviceVulkan13Features>
+        enablefeatureChain = {{}, {.dynamicRendering = VK_TRUE}};
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    std::println("device: {}", physical_device.getProperties().deviceName);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.pNext = make_pNext(enablefeatureChain),
+                 .queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    auto pipelineLayout = create_pipeline_layout{}
+                              .setCreateInfo({.setLayouts = {}, .pushConstantRanges = {}})
+                              .build(device);
+    const auto variants = make_variants(*pipelineLayout);
+    const auto path =
+        (std::filesystem::temp_directory_path() / "mcs_pipeline_cache.bin").string();
+    std::filesystem::remove(path);
+
+    // 1. 冷启动：没有缓存文件，析构时写回
+    double cold_ms = 0;
+    {
+        auto cache =
+            create_pipeline_cache{}.setCreateInfo({.filePath = path}).build(device);
+        MCS_ASSERT(cache && !cache.loaded());
+        cold_ms = build_all(device, variants, *cache);
+    }
+    MCS_ASSERT(std::filesystem::exists(path));
+    MCS_ASSERT(!std::filesystem::exists(path + ".tmp"));
+
+    // 2. 热启动：读入上次写回的文件
+    double warm_ms = 0;
+    {
+        auto cache =
+            create_pipeline_cache{}.setCreateInfo({.filePath = path}).build(device);
+        MCS_ASSERT(cache.loaded());
+        warm_ms = build_all(device, variants, *cache);
+    }
+    const double none_ms = build_all(device, variants, VK_NULL_HANDLE);
+    std::println("[BENCH] {} pipelines: no cache {:.2f} ms, cold cache {:.2f} ms, "
+                 "warm cache {:.2f} ms ({:.2f}x)",
+                 variants.size(), none_ms, cold_ms, warm_ms, cold_ms / warm_ms);
+
+    // 3. 头部与设备不符(驱动升级、换卡)时丢弃旧数据，从空缓存开始
+    {
+        std::vector<uint8_t> bytes;
+        {
+            std::ifstream in{path, std::ios::binary};
+            bytes.assign(std::istreambuf_iterator<char>{in}, {});
+        }
+        MCS_ASSERT(PipelineCache::compatible(physical_device, bytes));
+        bytes[offsetof(VkPipelineCacheHeaderVersionOne, pipelineCacheUUID)] ^= 0xFFU;
+        MCS_ASSERT(!PipelineCache::compatible(physical_device, bytes));
+        bytes.resize(8);
+        MCS_ASSERT(!PipelineCache::compatible(physical_device, bytes));
+        {
+            std::ofstream out{path, std::ios::binary | std::ios::trunc};
+            out.write(reinterpret_cast<const char *>(bytes.data()), // NOLINT
+                      static_cast<std::streamsize>(bytes.size()));
+        }
+        const auto cache = create_pipeline_cache{}.setCreateInfo({}).build(device);
+        MCS_ASSERT(cache && !cache.loaded() && cache.path().empty());
+        auto stale =
+            create_pipeline_cache{}.setCreateInfo({.filePath = path}).build(device);
+        MCS_ASSERT(stale && !stale.loaded());
+    }
+
+    // 4. 合并：各自编译一半，合并后的缓存能热启动全部管线
+    {
+        auto first = create_pipeline_cache{}.setCreateInfo({}).build(device);
+        auto second = create_pipeline_cache{}.setCreateInfo({}).build(device);
+        const size_t half = variants.size() / 2;
+        for (size_t i = 0; i < variants.size(); ++i)
+            (void)variants[i].build(device, i < half ? *first : *second);
+        auto merged =
+            create_pipeline_cache{}.setCreateInfo({.filePath = path}).build(device);
+        const std::array sources{*first, *second};
+        merged.merge(sources);
+        MCS_ASSERT(merged.data().size() >= first.data().size());
+        merged.save(path);
+        auto reloaded =
+            create_pipeline_cache{}.setCreateInfo({.filePath = path}).build(device);
+        MCS_ASSERT(reloaded.loaded());
+        std::println("[BENCH] merged cache: {:.2f} ms",
+                     build_all(device, variants, *reloaded));
+    }
+
+    std::filesystem::remove(path);
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../head.hpp"
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_descriptor_set_layout;
+using mcs::vulkan::tool::create_descriptor_pool;
+using mcs::vulkan::tool::create_sampler;
+using mcs::vulkan::tool::resource_manager;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::Sampler;
+using mcs::vulkan::MCS_ASSERT;
+
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr uint32_t MAX_TEXTURES = 4096;
+constexpr uint32_t CHURN_ROUNDS = 64;
+constexpr uint32_t SAMPLER_COUNT = 64;
+
+// NOTE: 对照：改动前的做法，过滤状态数组找空闲槽，逐个比较 key
+struct linear_manager
+{
+    std::array<uint32_t, MAX_TEXTURES> slot_status{};
+    std::array<std::string, MAX_TEXTURES> resources_key;
+
+    [[nodiscard]] std::optional<uint32_t> first_free() const noexcept
+    {
+        const auto it = std::ranges::find(slot_status, 0U);
+        if (it == slot_status.end())
+            return std::nullopt;
+        return static_cast<uint32_t>(it - slot_status.begin());
+    }
+    [[nodiscard]] std::optional<uint32_t> find_slot_by_name(
+        const std::string &key) const noexcept
+    {
+        for (uint32_t i = 0; i < resources_key.size(); ++i)
+        {
+            if (resources_key[i] == key)
+                return i;
+        }
+        return std::nullopt;
+    }
+};
+
+static std::string make_key(uint32_t i)
+{
+    return "texture_" + std::to_string(i);
+}
+
+// NOTE: 每轮释放一半，按名字查询全部，再占满。返回每次操作的平均 ns
+template <typename Use, typename Free, typename Find>
+static double churn(const std::vector<uint32_t> &order, Use &&use, Free &&free,
+                    Find &&find)
+{
+    const auto start = std::chrono::steady_clock::now();
+    size_t ops = 0;
+    for (uint32_t round = 0; round < CHURN_ROUNDS; ++round)
+    {
+        for (size_t i = 0; i < order.size() / 2; ++i, ++ops)
+            free(order[(i + round) % order.size()]);
+        for (uint32_t i = 0; i < MAX_TEXTURES; i += 4, ++ops)
+            (void)find(make_key(i));
+        for (size_t i = 0; i < order.size() / 2; ++i, ++ops)
+            use(order[(i + round) % order.size()]);
+    }
+    const auto time = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(time).count() /
+           static_cast<double>(ops);
+}
+
+int main()
+try
+{
+    // 1. 空闲链表、名字索引与计数
+    {
+        auto managerPtr = std::make_unique<resource_manager<int, MAX_TEXTURES>>();
+        auto &manager = *managerPtr;
+        MCS_ASSERT(manager.free_count() == MAX_TEXTURES && manager.used_count() == 0);
+        MCS_ASSERT(*manager.view_free_indexes().begin() == 0);
+
+        // NOTE: 遍历空闲槽的同时占用它们(与 dod 测试中的上传方式一致)
+        std::vector<int> upload(8);
+        std::vector<std::string> keys;
+        for (uint32_t i = 0; i < upload.size(); ++i)
+            keys.emplace_back(make_key(i));
+        for (auto [resource, index, key] :
+             std::views::zip(upload, manager.view_free_indexes(), keys))
+            manager.use_slot(index, resource, std::move(key));
+        MCS_ASSERT(manager.used_count() == 8 && manager.free_count() == MAX_TEXTURES - 8);
+        MCS_ASSERT(*manager.view_free_indexes().begin() == 8);
+        for (uint32_t i = 0; i < 8; ++i)
+            MCS_ASSERT(manager.find_slot_by_name(make_key(i)) == i);
+        MCS_ASSERT(!manager.find_slot_by_name(std::string_view{"missing"}));
+
+        // NOTE: 释放的槽最先被复用，名字随之失效
+        manager.free_slot(3);
+        manager.free_slot(5);
+        MCS_ASSERT(!manager.find_slot_by_name(make_key(3)));
+        MCS_ASSERT(manager.used_count() == 6);
+        MCS_ASSERT(std::ranges::equal(manager.view_free_indexes() | std::views::take(3),
+                                      std::array{5U, 3U, 8U}));
+        MCS_ASSERT(manager.use_slot(7, "reused") == 5U);
+        MCS_ASSERT(manager.find_slot_by_name("reused") == 5U);
+
+        // NOTE: 任意位置的空闲槽都能直接占用
+        manager.use_slot(100, 1, "middle");
+        MCS_ASSERT(!manager.is_free(100));
+        MCS_ASSERT(std::ranges::count(manager.view_free_indexes(), 100U) == 0);
+        MCS_ASSERT(std::ranges::distance(manager.view_free_indexes()) ==
+                   static_cast<std::ptrdiff_t>(manager.free_count()));
+
+        // NOTE: 重名时与按下标顺序查找一致：返回下标最小的仍被占用的槽
+        manager.use_slot(101, 2, "middle");
+        manager.free_slot(101);
+        MCS_ASSERT(manager.find_slot_by_name("middle") == 100U);
+        manager.use_slot(150, 2, "dup");
+        manager.use_slot(120, 2, "dup");
+        manager.use_slot(140, 2, "dup");
+        MCS_ASSERT(manager.find_slot_by_name("dup") == 120U);
+        manager.free_slot(120);
+        MCS_ASSERT(manager.find_slot_by_name("dup") == 140U);
+        manager.free_slot(150);
+        MCS_ASSERT(manager.find_slot_by_name("dup") == 140U);
+        manager.free_slot(140);
+        MCS_ASSERT(!manager.find_slot_by_name("dup"));
+        {
+            using auto_free = resource_manager<int, MAX_TEXTURES>::auto_free_slot_type;
+            manager.use_slot(200, 3, "scoped");
+            auto_free guard{manager, 200};
+        }
+        MCS_ASSERT(manager.is_free(200) && !manager.find_slot_by_name("scoped"));
+
+        // NOTE: 占用后又释放的槽不算脏，同一个槽只记录一次
+        manager.clear_dirty();
+        manager.use_slot(300, 0, "a");
+        manager.free_slot(300);
+        manager.use_slot(300, 0, "b");
+        MCS_ASSERT(manager.dirty_indexes().size() == 1);
+
+        while (manager.use_slot(0, {}))
+            ;
+        MCS_ASSERT(manager.free_count() == 0 && manager.view_free_indexes().empty());
+    }
+
+    // 2. 对照：全量扫描 vs 空闲链表 + 哈希索引
+    {
+        std::vector<uint32_t> order(MAX_TEXTURES);
+        std::ranges::iota(order, 0U);
+        std::ranges::shuffle(order, std::mt19937{42});
+
+        auto linearPtr = std::make_unique<linear_manager>();
+        auto &linear = *linearPtr;
+        for (uint32_t i = 0; i < MAX_TEXTURES; ++i)
+        {
+            linear.slot_status[i] = 1;
+            linear.resources_key[i] = make_key(i);
+        }
+        const double linear_ns = churn(
+            order,
+            [&](uint32_t i) {
+                const uint32_t slot = *linear.first_free();
+                linear.slot_status[slot] = 1;
+                linear.resources_key[slot] = make_key(i);
+            },
+            [&](uint32_t slot) {
+                linear.slot_status[slot] = 0;
+                linear.resources_key[slot] = {};
+            },
+            [&](const std::string &key) { return linear.find_slot_by_name(key); });
+
+        auto managerPtr = std::make_unique<resource_manager<int, MAX_TEXTURES>>();
+        auto &manager = *managerPtr;
+        for (uint32_t i = 0; i < MAX_TEXTURES; ++i)
+            manager.use_slot(i, 0, make_key(i));
+        const double indexed_ns = churn(
+            order,
+            [&](uint32_t i) {
+                MCS_ASSERT(manager.use_slot(0, make_key(i)).has_value());
+            },
+            [&](uint32_t slot) { manager.free_slot(slot); },
+            [&](const std::string &key) { return manager.find_slot_by_name(key); });
+        MCS_ASSERT(manager.free_count() == 0);
+        std::println("[BENCH] {} slots: linear scan {:.1f} ns/op, "
+                     "free list + hash index {:.1f} ns/op ({:.1f}x)",
+                     MAX_TEXTURES, linear_ns, indexed_ns, linear_ns / indexed_ns);
+    }
+
+    // 3. 新占用的槽合并成连续区间写入描述符
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_resource_manager",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    auto setLayout =
+        create_descriptor_set_layout{}
+            .setCreateInfo({.bindings = {{.binding = 0,
+                                          .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                                          .descriptorCount = SAMPLER_COUNT,
+                                          .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT}}})
+            .build(device);
+    auto pool =
+        create_descriptor_pool{}
+            .setCreateInfo(
+                {.maxSets = 2,
+                 .poolSizes = {{VK_DESCRIPTOR_TYPE_SAMPLER, 2 * SAMPLER_COUNT}}})
+            .build(device);
+    const std::array layouts{*setLayout, *setLayout};
+    const auto sets = device.allocateDescriptorSets(VkDescriptorSetAllocateInfo{
+        .sType = mcs::vulkan::tool::sType<VkDescriptorSetAllocateInfo>(),
+        .descriptorPool = *pool,
+        .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+        .pSetLayouts = layouts.data()});
+
+    auto samplerManagerPtr = std::make_unique<resource_manager<Sampler, SAMPLER_COUNT>>();
+    auto &samplerManager = *samplerManagerPtr;
+    const auto write = [&] {
+        samplerManager.write_descriptors(device, sets, 0, VK_DESCRIPTOR_TYPE_SAMPLER,
+                                         [](const Sampler &sampler) {
+                                             return VkDescriptorImageInfo{
+                                                 .sampler = *sampler};
+                                         });
+    };
+    for (uint32_t i = 0; i < SAMPLER_COUNT; ++i)
+    {
+        auto sampler = create_sampler{}
+                           .setCreateInfo(create_sampler::templateNearest())
+                           .build(device);
+        (void)samplerManager.use_slot(std::move(sampler), "sampler_" + std::to_string(i));
+    }
+    MCS_ASSERT(samplerManager.dirty_indexes().size() == SAMPLER_COUNT);
+    write();
+    MCS_ASSERT(samplerManager.dirty_indexes().empty());
+
+    // NOTE: 替换其中几个，只重写这几个
+    for (const uint32_t index : {2U, 3U, 40U})
+    {
+        samplerManager.free_slot(index);
+        samplerManager.use_slot(index,
+                                create_sampler{}
+                                    .setCreateInfo(create_sampler::templateLinear())
+                                    .build(device),
+                                "replaced_" + std::to_string(index));
+    }
+    MCS_ASSERT(samplerManager.dirty_indexes().size() == 3);
+    write();
+    MCS_ASSERT(samplerManager.dirty_indexes().empty());
+    MCS_ASSERT(samplerManager.find_slot_by_name("replaced_40") == 40U);
+
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
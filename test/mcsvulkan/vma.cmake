@@ -15,6 +15,12 @@ macro(add_vulkan_vma_test fileName)
 endmacro()
 
 add_vulkan_vma_test(test_raii_vma)
+add_vulkan_vma_test(test_upload_queue)
+add_vulkan_vma_test(test_ktx2_texture)
+add_vulkan_vma_test(test_asset_decode)
+ADD_MSDF_DEF(${TAGET_NAME})
+add_vulkan_vma_test(test_mip_chain)
+add_vulkan_vma_test(test_memory_arena)
 
 # end
 unset(BASE_LIBS)
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "../head.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_command_pool;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::Queue;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::CommandPool;
+using mcs::vulkan::MCS_ASSERT;
+using mcs::vulkan::thread_pool;
+
+using raii_vma = mcs::vulkan::raii_vma;
+using mcs::vulkan::vma::create_image;
+using mcs::vulkan::vma::create_texture_image;
+using mcs::vulkan::vma::upload_queue;
+using mcs::vulkan::load::decode_queue;
+using mcs::vulkan::load::raw_stbi_image;
+
+namespace font = mcs::vulkan::font;
+
+// NOTE: 不需要窗口，可以在 lavapipe 上运行。
+// 启动场景：30 个字体(图集 JSON + 1024² 图集 PNG + 字体文件) 与 100 张 512² 纹理
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr uint32_t FONT_COUNT = 30;
+constexpr uint32_t ATLAS_SIZE = 1024;
+constexpr uint32_t TEXTURE_COUNT = 100;
+constexpr uint32_t TEXTURE_SIZE = 512;
+
+// NOTE: 渐变 + 噪声，PNG 不会压得过小，解码时间接近真实素材
+static std::vector<uint8_t> make_image(uint32_t size, uint32_t seed)
+{
+    std::vector<uint8_t> pixels(size_t{size} * size * 4);
+    uint32_t noise = seed + 12345;
+    for (uint32_t y = 0; y < size; ++y)
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            noise = (noise * 1103515245U) + 12345U;
+            auto *p = &pixels[((size_t{y} * size) + x) * 4];
+            p[0] = static_cast<uint8_t>(x * 255 / size);
+            p[1] = static_cast<uint8_t>(y * 255 / size);
+            p[2] = static_cast<uint8_t>((noise >> 16U) & 0x3FU);
+            p[3] = static_cast<uint8_t>(seed);
+        }
+    return pixels;
+}
+
+static void write_png(const std::string &path, uint32_t size, uint32_t seed)
+{
+    const auto pixels = make_image(size, seed);
+    const auto stride = static_cast<int>(size * 4);
+    MCS_ASSERT(::stbi_write_png(path.c_str(), static_cast<int>(size),
+                                static_cast<int>(size), 4, pixels.data(),
+                                stride) != 0);
+}
+
+// NOTE: msdf-atlas-gen 格式的图集描述，每个 glyph 按 index 给出
+static void write_atlas_json(const std::string &path, long glyph_count)
+{
+    std::string json = std::format(
+        R"({{"atlas":{{"type":"msdf","distanceRange":4,"distanceRangeMiddle":0,)"
+        R"("size":32,"width":{0},"height":{0},"yOrigin":"bottom"}},)"
+        R"("metrics":{{"emSize":1,"lineHeight":1.2,"ascender":0.9,"descender":-0.3,)"
+        R"("underlineY":-0.1,"underlineThickness":0.05}},"glyphs":[)",
+        ATLAS_SIZE);
+    for (long i = 0; i < glyph_count; ++i)
+    {
+        const auto x = static_cast<double>((i * 32) % ATLAS_SIZE);
+        const auto y = static_cast<double>((i * 32) / ATLAS_SIZE * 32);
+        json += std::format(
+            R"({}{{"index":{},"advance":0.5,)"
+            R"("planeBounds":{{"left":0.01,"bottom":-0.2,"right":0.49,"top":0.8}},)"
+            R"("atlasBounds":{{"left":{},"bottom":{},"right":{},"top":{}}}}})",
+            i == 0 ? "" : ",", i, x, y, x + 31, y + 31);
+    }
+    json += "]}";
+    std::ofstream{path, std::ios::binary} << json;
+}
+
+static create_image make_creator(const LogicalDevice &device, VmaAllocator allocator,
+                                 uint32_t width, uint32_t height)
+{
+    return create_image{device, allocator}
+        .setCreateInfo({.imageType = VK_IMAGE_TYPE_2D,
+                        .format = VK_FORMAT_R8G8B8A8_UNORM,
+                        .extent = {.width = width, .height = height, .depth = 1},
+                        .mipLevels = 1,
+                        .arrayLayers = 1,
+                        .samples = VK_SAMPLE_COUNT_1_BIT,
+                        .tiling = VK_IMAGE_TILING_OPTIMAL,
+                        .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                 VK_IMAGE_USAGE_SAMPLED_BIT,
+                        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                        .allocationCreateInfo = {.usage = VMA_MEMORY_USAGE_AUTO}})
+        .setViewCreateInfo(
+            {.viewType = VK_IMAGE_VIEW_TYPE_2D,
+             .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                  .baseMipLevel = 0,
+                                  .levelCount = 1,
+                                  .baseArrayLayer = 0,
+                                  .layerCount = 1}});
+}
+
+int main()
+try
+{
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_asset_decode",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    std::println("device: {}", physical_device.getProperties().deviceName);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    const auto GRAPHICS = Queue(
+        device, {.queue_family_index = GRAPHICS_QUEUE_FAMILY_IDX, .queue_index = 0});
+    raii_vma vma{{.physicalDevice = *physical_device,
+                  .device = *device,
+                  .instance = *instance,
+                  .vulkanApiVersion = APIVERSION}};
+    VmaAllocator allocator = vma.allocator();
+    CommandPool commandPool =
+        create_command_pool{}
+            .setCreateInfo({.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                            .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX})
+            .build(device);
+    const font::FontAllocationContext allocation{.allocator = allocator,
+                                                 .device = &device,
+                                                 .pool = &commandPool,
+                                                 .queue = &GRAPHICS};
+    font::freetype::loader library;
+
+    // 1. 生成素材：每个字体一份字体文件拷贝、图集 JSON 与图集 PNG
+    const auto dir = std::filesystem::temp_directory_path() / "mcsvulkan_assets";
+    std::filesystem::create_directories(dir);
+    const std::string font_src = FONT_INPUT_DIR "/TiroBangla-Regular.ttf";
+    const long glyph_count = [&] {
+        const font::freetype::face face{*library, font_src};
+        return (*face)->num_glyphs;
+    }();
+    std::vector<font::font_registration> registrations;
+    for (uint32_t i = 0; i < FONT_COUNT; ++i)
+    {
+        const auto stem = (dir / std::format("font{}", i)).string();
+        std::filesystem::copy_file(font_src, stem + ".ttf",
+                                   std::filesystem::copy_options::overwrite_existing);
+        write_atlas_json(stem + ".json", glyph_count);
+        write_png(stem + ".png", ATLAS_SIZE, i);
+        registrations.emplace_back(font::font_registration{
+            .font_path = stem + ".ttf",
+            .json_path = stem + ".json",
+            .type = font::FontType::eMSDF,
+            .texture_info = {.bind = {.texture_index = i, .sampler_index = 0},
+                             .image_variant = font::texture_info::stbi_image_type{
+                                 .image_format = STBI_rgb_alpha,
+                                 .image_path = stem + ".png"}}});
+    }
+    std::vector<std::string> textures;
+    for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        textures.emplace_back((dir / std::format("texture{}.png", i)).string());
+        write_png(textures.back(), TEXTURE_SIZE, i);
+    }
+    const auto make_infos = [&] {
+        std::vector<font::FontInfo> infos;
+        for (const auto &registration : registrations)
+            infos.emplace_back(font::FontInfo{.registration = registration,
+                                              .meta_data = {.face_index = 0}});
+        return infos;
+    };
+
+    using clock = std::chrono::steady_clock;
+    const auto elapsed_ms = [](clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+
+    // 2. 基准：逐个解码，每个字体/纹理单独上传
+    double serial_ms = 0;
+    {
+        const auto start = clock::now();
+        font::FontFactory factory{allocation, *library};
+        for (auto &info : make_infos())
+            MCS_ASSERT(factory.make(std::move(info)) != nullptr);
+        std::vector<mcs::vulkan::vma::resource> uploaded;
+        for (const auto &path : textures)
+        {
+            const raw_stbi_image img{path.c_str()};
+            uploaded.emplace_back(
+                create_texture_image{commandPool, GRAPHICS,
+                                     make_creator(device, allocator, TEXTURE_SIZE,
+                                                  TEXTURE_SIZE)}
+                    .build({img.data(), img.size()}));
+        }
+        serial_ms = elapsed_ms(start);
+        std::println("[BENCH] serial: {} fonts + {} textures, {:.2f} ms", FONT_COUNT,
+                     TEXTURE_COUNT, serial_ms);
+    }
+
+    // 3. 线程池解码，纹理按完成顺序分批交给 upload_queue
+    const size_t cores = std::max(1U, std::thread::hardware_concurrency());
+    for (size_t threads = 1;; threads = std::min(threads * 2, cores))
+    {
+        thread_pool pool{threads};
+        const auto start = clock::now();
+
+        decode_queue<raw_stbi_image> decoder{pool};
+        for (const auto &path : textures)
+            decoder.submit([&path] { return raw_stbi_image{path.c_str()}; });
+
+        font::FontFactory factory{allocation, *library};
+        auto selector =
+            font::FontSelector{&factory, "bn"}.load(make_infos(), pool);
+        MCS_ASSERT(std::ranges::size(selector.getTextureImageBases()) == FONT_COUNT);
+
+        std::vector<mcs::vulkan::vma::resource> uploaded(TEXTURE_COUNT);
+        upload_queue uploads{commandPool, GRAPHICS, allocator};
+        size_t batches = 0;
+        while (!decoder.empty())
+        {
+            for (auto &[index, img] : decoder.take())
+            {
+                auto creator = make_creator(device, allocator, TEXTURE_SIZE,
+                                            TEXTURE_SIZE);
+                uploaded[index] = uploads.texture(
+                    creator, std::span<const uint8_t>{img.data(), img.size()});
+            }
+            (void)uploads.submit();
+            ++batches;
+        }
+        uploads.flush();
+        for (const auto &texture : uploaded)
+            MCS_ASSERT(texture.image() != VK_NULL_HANDLE);
+
+        const double ms = elapsed_ms(start);
+        std::println("[BENCH] {} threads: {:.2f} ms ({:.2f}x), {} texture batches, "
+                     "{} submits",
+                     threads, ms, serial_ms / ms, batches, uploads.submit_count());
+        if (threads == cores)
+            break;
+    }
+
+    // 4. 解码失败经 take() 抛出，其余结果不受影响
+    {
+        thread_pool pool{2};
+        decode_queue<raw_stbi_image> decoder{pool};
+        decoder.submit([&] { return raw_stbi_image{textures[0].c_str()}; });
+        decoder.submit([&] { return raw_stbi_image{(dir / "missing.png").c_str()}; });
+        size_t decoded = 0;
+        size_t failed = 0;
+        while (!decoder.empty())
+        {
+            try
+            {
+                decoded += decoder.take().size();
+            }
+            catch (const std::exception &)
+            {
+                ++failed;
+            }
+        }
+        MCS_ASSERT(decoded == 1 && failed == 1);
+    }
+
+    std::filesystem::remove_all(dir);
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
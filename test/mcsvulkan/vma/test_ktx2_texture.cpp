@@ -0,0 +1,238 @@
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <vector>
+
+#include "../head.hpp"
+#include "../../tool/ktx2_writer.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_command_pool;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::Queue;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::CommandPool;
+using mcs::vulkan::MCS_ASSERT;
+
+using raii_vma = mcs::vulkan::raii_vma;
+using mcs::vulkan::vma::create_image;
+using mcs::vulkan::vma::create_texture_image;
+using mcs::vulkan::load::ktx2_image;
+
+// NOTE: 不需要窗口，可以在 lavapipe 上运行。
+// 参数可以给一个现成的 KTX2(例如 BC7 + mip 链)，额外测一次块压缩格式的上传
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr uint32_t IMAGE_SIZE = 1024;
+constexpr int ROUNDS = 10;
+
+// NOTE: 平滑渐变 + 噪声，PNG 不会压得过小
+static std::vector<uint8_t> make_image(uint32_t size)
+{
+    std::vector<uint8_t> pixels(size_t{size} * size * 4);
+    uint32_t noise = 12345;
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            noise = (noise * 1103515245U) + 12345U;
+            auto *p = &pixels[((size_t{y} * size) + x) * 4];
+            p[0] = static_cast<uint8_t>(x * 255 / size);
+            p[1] = static_cast<uint8_t>(y * 255 / size);
+            p[2] = static_cast<uint8_t>((noise >> 16U) & 0x3FU);
+            p[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+// NOTE: 2x2 box filter，离线工具生成 mip 链的做法
+static std::vector<std::vector<uint8_t>> make_mip_chain(std::vector<uint8_t> base,
+                                                        uint32_t size)
+{
+    std::vector<std::vector<uint8_t>> levels;
+    levels.emplace_back(std::move(base));
+    while (size > 1)
+    {
+        const uint32_t half = size / 2;
+        const auto &src = levels.back();
+        std::vector<uint8_t> dst(size_t{half} * half * 4);
+        for (uint32_t y = 0; y < half; ++y)
+            for (uint32_t x = 0; x < half; ++x)
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    auto at = [&](uint32_t sx, uint32_t sy) {
+                        return uint32_t{src[((size_t{sy} * size) + sx) * 4 + c]};
+                    };
+                    dst[((size_t{y} * half) + x) * 4 + c] = static_cast<uint8_t>(
+                        (at(2 * x, 2 * y) + at(2 * x + 1, 2 * y) + at(2 * x, 2 * y + 1) +
+                         at(2 * x + 1, 2 * y + 1) + 2) /
+                        4);
+                }
+        levels.emplace_back(std::move(dst));
+        size = half;
+    }
+    return levels;
+}
+
+static VkDeviceSize allocated_bytes(VmaAllocator allocator)
+{
+    VmaTotalStatistics stats{};
+    ::vmaCalculateStatistics(allocator, &stats);
+    return stats.total.statistics.allocationBytes;
+}
+
+int main(int argc, char **argv)
+try
+{
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_ktx2_texture",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    std::println("device: {}", physical_device.getProperties().deviceName);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    const auto GRAPHICS = Queue(
+        device, {.queue_family_index = GRAPHICS_QUEUE_FAMILY_IDX, .queue_index = 0});
+    raii_vma vma{{.physicalDevice = *physical_device,
+                  .device = *device,
+                  .instance = *instance,
+                  .vulkanApiVersion = APIVERSION}};
+    VmaAllocator allocator = vma.allocator();
+    CommandPool commandPool =
+        create_command_pool{}
+            .setCreateInfo({.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                            .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX})
+            .build(device);
+
+    using clock = std::chrono::steady_clock;
+    const auto dir = std::filesystem::temp_directory_path() / "mcsvulkan_ktx2";
+    std::filesystem::create_directories(dir);
+    const auto png_path = (dir / "bench.png").string();
+    const auto ktx2_path = (dir / "bench.ktx2").string();
+
+    // 1. 同一张图写成 PNG(运行时 blit 生成 mip)与 KTX2(预生成 mip 链)
+    {
+        auto base = make_image(IMAGE_SIZE);
+        MCS_ASSERT(::stbi_write_png(png_path.c_str(), IMAGE_SIZE, IMAGE_SIZE, 4,
+                                    base.data(), IMAGE_SIZE * 4) != 0);
+        const auto levels = make_mip_chain(std::move(base), IMAGE_SIZE);
+        std::vector<std::span<const uint8_t>> views(levels.begin(), levels.end());
+        const auto file = ktx2::encode_rgba8_levels(IMAGE_SIZE, IMAGE_SIZE, views);
+        std::ofstream{ktx2_path, std::ios::binary}.write(
+            reinterpret_cast<const char *>(file.data()), // NOLINT
+            static_cast<std::streamsize>(file.size()));
+    }
+
+    // 2. ktx2_image 读出完整的 mip 链
+    {
+        const ktx2_image img{ktx2_path.c_str()};
+        const auto mip_levels =
+            create_texture_image::getMipLevels(IMAGE_SIZE, IMAGE_SIZE);
+        MCS_ASSERT(img.level_count() == mip_levels);
+        MCS_ASSERT(img.format() == VK_FORMAT_R8G8B8A8_UNORM);
+        MCS_ASSERT(!img.block_compressed());
+        for (uint32_t i = 0; i < img.level_count(); ++i)
+        {
+            const auto &level = img.levels()[i];
+            MCS_ASSERT(level.width == std::max(IMAGE_SIZE >> i, 1U));
+            MCS_ASSERT(level.size == size_t{level.width} * level.height * 4);
+            MCS_ASSERT(level.offset + level.size <= img.all_data().size());
+        }
+        MCS_ASSERT(img.levels()[0].size == img.size());
+    }
+
+    create_texture_image loader{
+        commandPool, GRAPHICS, create_image{device, allocator}};
+    auto bench = [&](const char *name, auto &&load) {
+        const VkDeviceSize before = allocated_bytes(allocator);
+        VkDeviceSize vram = 0;
+        const auto start = clock::now();
+        for (int i = 0; i < ROUNDS; ++i)
+        {
+            auto texture = load();
+            vram = allocated_bytes(allocator) - before;
+        }
+        const double ms =
+            std::chrono::duration<double, std::milli>(clock::now() - start).count() /
+            ROUNDS;
+        std::println("[BENCH] {:>6}: {:.2f} ms/texture, {:.2f} MiB VRAM", name, ms,
+                     static_cast<double>(vram) / (1024.0 * 1024.0));
+    };
+
+    // 3. PNG：解码 + 单级拷贝 + 运行时 blit；KTX2：读文件 + 每级一个拷贝区域
+    bench("png", [&] { return loader.templateForImage2d(png_path, true); });
+    bench("ktx2", [&] { return loader.templateForKtx2(ktx2_path); });
+    if (argc > 1)
+    {
+        const ktx2_image img{argv[1]};
+        std::println("{}: format {}, {} levels, block compressed {}", argv[1],
+                     static_cast<int>(img.format()), img.level_count(),
+                     img.block_compressed());
+        bench("user", [&] { return loader.templateForKtx2(img); });
+    }
+
+    std::filesystem::remove_all(dir);
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
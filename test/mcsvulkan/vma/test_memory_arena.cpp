@@ -0,0 +1,279 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <print>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../head.hpp"
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::structure_chain;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::make_pNext;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::MCS_ASSERT;
+
+using mcs::vulkan::memory::auto_map_buffer;
+using mcs::vulkan::memory::buffer_base;
+using mcs::vulkan::memory::create_buffer;
+using mcs::vulkan::memory::create_image;
+using mcs::vulkan::memory::create_simple_buffer;
+using mcs::vulkan::memory::device_memory_arena;
+using mcs::vulkan::memory::gen_memory_allocate_info;
+using mcs::vulkan::memory::image_base;
+using mcs::vulkan::memory::tlsf_allocator;
+
+// NOTE: 不需要窗口，可以在 lavapipe 上运行
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr uint32_t BENCH_COUNT = 1024; // 低于 maxMemoryAllocationCount(至少 4096)
+constexpr VkDeviceSize BENCH_SIZE = VkDeviceSize{64} << 10U;
+
+static create_buffer make_buffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                                 VkMemoryPropertyFlags properties)
+{
+    return create_buffer{
+        {.size = size, .usage = usage, .sharingMode = VK_SHARING_MODE_EXCLUSIVE},
+        gen_memory_allocate_info(properties)};
+}
+
+static create_image make_image(uint32_t extent, VkImageTiling tiling)
+{
+    create_image create;
+    create.setCreateInfo({.imageType = VK_IMAGE_TYPE_2D,
+                          .format = VK_FORMAT_R8G8B8A8_UNORM,
+                          .extent = {.width = extent, .height = extent, .depth = 1},
+                          .mipLevels = 1,
+                          .arrayLayers = 1,
+                          .samples = VK_SAMPLE_COUNT_1_BIT,
+                          .tiling = tiling,
+                          .usage = VK_IMAGE_USAGE_SAMPLED_BIT,
+                          .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                          .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED})
+        .setGenMemoryAllocateInfo(
+            gen_memory_allocate_info(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+    return create;
+}
+
+static void print_stats(const char *label, const device_memory_arena &arena)
+{
+    const auto stats = arena.stats();
+    std::println("{}: {} blocks ({} KiB), {} allocations ({} KiB used), "
+                 "{} free regions, largest {} KiB, fragmentation {:.3f}, "
+                 "vkAllocateMemory x{}",
+                 label, stats.blockCount, stats.blockBytes >> 10U,
+                 stats.allocationCount, stats.usedBytes >> 10U, stats.freeRegionCount,
+                 stats.largestFreeRegion >> 10U, stats.fragmentation(),
+                 stats.deviceAllocations);
+}
+
+int main()
+try
+{
+    // 1. 偏移分配器本身：对齐、合并、统计
+    {
+        tlsf_allocator allocator{VkDeviceSize{1} << 20U};
+        const auto a = allocator.allocate(100, 256);
+        const auto b = allocator.allocate(1000, 4096);
+        const auto c = allocator.allocate(10, 1);
+        MCS_ASSERT(a && b && c);
+        MCS_ASSERT(a->offset % 256 == 0 && b->offset % 4096 == 0);
+        MCS_ASSERT(b->offset >= a->offset + a->size);
+        allocator.free(b->node);
+        MCS_ASSERT(allocator.stats().freeRegionCount >= 2);
+        allocator.free(a->node);
+        allocator.free(c->node);
+        const auto stats = allocator.stats();
+        MCS_ASSERT(allocator.empty() && stats.freeRegionCount == 1 &&
+                   stats.largestFreeRegion == allocator.capacity());
+        MCS_ASSERT(allocator.allocate(allocator.capacity()).has_value());
+        MCS_ASSERT(!allocator.allocate(1).has_value());
+    }
+
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_memory_arena",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    structure_chain<VkPhysicalDeviceFeatures2, VkPhysicalDeviceVulkan12Features>
+        enablefeatureChain = {{}, {.bufferDeviceAddress = VK_TRUE}};
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    const auto limits = physical_device.getProperties().limits;
+    std::println("device: {}, bufferImageGranularity {}",
+                 physical_device.getProperties().deviceName,
+                 limits.bufferImageGranularity);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.pNext = make_pNext(enablefeatureChain),
+                 .queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    device_memory_arena arena{
+        device, {.allocateFlags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT}};
+
+    // 2. 缓冲区与最优排布的图像交错分配：对齐满足要求，granularity > 1 时分到不同的块
+    {
+        std::vector<buffer_base> buffers;
+        std::vector<image_base> images;
+        const auto vertex = make_buffer(1000, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        const auto optimal = make_image(64, VK_IMAGE_TILING_OPTIMAL);
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            buffers.emplace_back(vertex.build(arena));
+            images.emplace_back(optimal.build(arena));
+        }
+        for (const auto &image : images)
+        {
+            const auto requirements = device.getImageMemoryRequirements(image.image());
+            MCS_ASSERT(image.memoryOffset() % requirements.alignment == 0);
+            for (const auto &buffer : buffers)
+            {
+                if (limits.bufferImageGranularity > 1)
+                    MCS_ASSERT(buffer.bufferMemory() != image.imageMemory());
+            }
+        }
+        print_stats("mixed", arena);
+        MCS_ASSERT(arena.stats().deviceAllocations <= 2);
+    }
+
+    // 3. HOST_VISIBLE 缓冲区：块持久映射，auto_map_buffer 直接拿到块内地址
+    {
+        constexpr VkMemoryPropertyFlags HOST =
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        auto first = auto_map_buffer{
+            create_simple_buffer(arena,
+                                 {.size = 256,
+                                  .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                           VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                  .sharingMode = VK_SHARING_MODE_EXCLUSIVE},
+                                 HOST),
+            256};
+        auto second = auto_map_buffer{
+            create_simple_buffer(arena,
+                                 {.size = 256,
+                                  .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                  .sharingMode = VK_SHARING_MODE_EXCLUSIVE},
+                                 HOST),
+            256};
+        MCS_ASSERT(first.bufferMemory() == second.bufferMemory());
+        MCS_ASSERT(first.mapPtr() != second.mapPtr());
+        std::memset(first.mapPtr(), 0xAB, 256);
+        std::memset(second.mapPtr(), 0xCD, 256);
+        MCS_ASSERT(static_cast<const uint8_t *>(first.mapPtr())[255] == 0xAB);
+        MCS_ASSERT(device.getBufferDeviceAddress(
+                       {.sType = mcs::vulkan::tool::sType<VkBufferDeviceAddressInfo>(),
+                        .buffer = first.buffer()}) != 0);
+    }
+
+    // 4. 随机释放一半后的碎片情况，再分配时复用空洞而不是新建块
+    {
+        std::vector<buffer_base> buffers;
+        std::mt19937 rng{7};
+        for (uint32_t i = 0; i < 512; ++i)
+            buffers.emplace_back(make_buffer(VkDeviceSize{1024} << (rng() % 7),
+                                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+                                     .build(arena));
+        for (size_t i = 0; i < buffers.size(); i += 2)
+            buffers[i].destroy();
+        print_stats("after freeing every other buffer", arena);
+        const auto blocks = arena.stats().blockCount;
+        for (size_t i = 0; i < buffers.size(); i += 2)
+            buffers[i] = make_buffer(1024, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+                             .build(arena);
+        MCS_ASSERT(arena.stats().blockCount == blocks);
+        print_stats("after refilling the holes", arena);
+    }
+
+    // 5. 对照：每个资源一次 vkAllocateMemory vs 从 arena 子分配
+    {
+        using clock = std::chrono::steady_clock;
+        const auto create = make_buffer(BENCH_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        std::vector<buffer_base> buffers;
+        buffers.reserve(BENCH_COUNT);
+
+        auto start = clock::now();
+        for (uint32_t i = 0; i < BENCH_COUNT; ++i)
+            buffers.emplace_back(create.build(device));
+        buffers.clear();
+        const auto dedicated = clock::now() - start;
+
+        start = clock::now();
+        for (uint32_t i = 0; i < BENCH_COUNT; ++i)
+            buffers.emplace_back(create.build(arena));
+        buffers.clear();
+        const auto arena_time = clock::now() - start;
+
+        const auto us_per = [](clock::duration time) {
+            return std::chrono::duration<double, std::micro>(time).count() /
+                   double{BENCH_COUNT};
+        };
+        std::println("[BENCH] {} x {} KiB buffers (create + destroy): "
+                     "vkAllocateMemory per buffer {:.2f} us, arena {:.2f} us ({:.1f}x)",
+                     BENCH_COUNT, BENCH_SIZE >> 10U, us_per(dedicated),
+                     us_per(arena_time), us_per(dedicated) / us_per(arena_time));
+        print_stats("after benchmark", arena);
+    }
+
+    // NOTE: 资源都已销毁，每个池只保留一个空块
+    const auto stats = arena.stats();
+    MCS_ASSERT(stats.allocationCount == 0 && stats.usedBytes == 0);
+
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
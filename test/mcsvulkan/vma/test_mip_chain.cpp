@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "../head.hpp"
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_command_pool;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::Queue;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::CommandPool;
+using mcs::vulkan::MCS_ASSERT;
+using mcs::vulkan::thread_pool;
+using mcs::vulkan::get_mip_levels;
+
+using raii_vma = mcs::vulkan::raii_vma;
+using mcs::vulkan::vma::create_image;
+using mcs::vulkan::vma::create_texture_image;
+using mcs::vulkan::load::mip_chain;
+using mcs::vulkan::load::mip_filter;
+using mcs::vulkan::load::mip_options;
+
+// NOTE: 不需要窗口，可以在 lavapipe 上运行
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr uint32_t BENCH_SIZE = 2048;
+
+static std::vector<uint8_t> make_noise(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::vector<uint8_t> pixels(size_t{width} * height * 4);
+    uint32_t noise = seed;
+    for (auto &texel : pixels)
+    {
+        noise = (noise * 1103515245U) + 12345U;
+        texel = static_cast<uint8_t>(noise >> 16U);
+    }
+    return pixels;
+}
+
+// 1. 纯色图像的每一级都与第 0 级相同，包括非 2 的幂尺寸
+static void test_constant()
+{
+    constexpr uint32_t WIDTH = 37;
+    constexpr uint32_t HEIGHT = 20;
+    std::vector<uint8_t> pixels(size_t{WIDTH} * HEIGHT * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4)
+    {
+        pixels[i] = 200;
+        pixels[i + 1] = 10;
+        pixels[i + 2] = 128;
+        pixels[i + 3] = 255;
+    }
+    for (const auto filter : {mip_filter::eBox, mip_filter::eKaiser})
+        for (const bool srgb : {false, true})
+        {
+            const mip_chain chain{pixels, WIDTH, HEIGHT,
+                                  mip_options{.filter = filter, .srgb = srgb}};
+            MCS_ASSERT(chain.level_count() == get_mip_levels(WIDTH, HEIGHT));
+            MCS_ASSERT(chain.levels().back().width == 1 &&
+                       chain.levels().back().height == 1);
+            for (uint32_t i = 0; i < chain.level_count(); ++i)
+            {
+                const auto level = chain.level(i);
+                for (size_t j = 0; j < level.size(); ++j)
+                    MCS_ASSERT(level[j] == pixels[j % 4]);
+            }
+        }
+}
+
+// 2. 黑白棋盘格：线性空间平均为 0.5，sRGB 编码后为 188 而不是 128
+static void test_srgb()
+{
+    std::vector<uint8_t> pixels(size_t{4} * 4 * 4);
+    for (uint32_t y = 0; y < 4; ++y)
+        for (uint32_t x = 0; x < 4; ++x)
+        {
+            const uint8_t value = ((x + y) & 1U) != 0 ? 255 : 0;
+            auto *p = &pixels[((size_t{y} * 4) + x) * 4];
+            p[0] = p[1] = p[2] = value;
+            p[3] = 255;
+        }
+    const mip_chain srgb{pixels, 4, 4, mip_options{.srgb = true}};
+    const mip_chain unorm{pixels, 4, 4, mip_options{.srgb = false}};
+    MCS_ASSERT(srgb.level(1)[0] == 188);
+    MCS_ASSERT(unorm.level(1)[0] == 128);
+}
+
+// 3. 按 alpha 加权：透明像素的颜色不渗入结果
+static void test_alpha_weighting()
+{
+    const std::vector<uint8_t> pixels = {255, 0, 0, 255, 0, 255, 0, 0,
+                                         255, 0, 0, 255, 0, 255, 0, 0};
+    const mip_chain chain{pixels, 2, 2};
+    const auto level = chain.level(1);
+    MCS_ASSERT(level[0] == 255 && level[1] == 0 && level[2] == 0 && level[3] == 128);
+
+    const mip_chain premultiplied{pixels, 2, 2, mip_options{.premultiplied = true}};
+    MCS_ASSERT(premultiplied.level(1)[1] == 128);
+}
+
+// 4. alpha test 覆盖率在各级保持接近第 0 级
+static void test_coverage()
+{
+    constexpr uint32_t SIZE = 256;
+    constexpr float CUTOFF = 0.5F;
+    const auto pixels = make_noise(SIZE, SIZE, 1);
+    const mip_chain plain{pixels, SIZE, SIZE};
+    const mip_chain kept{pixels, SIZE, SIZE, mip_options{.alpha_cutoff = CUTOFF}};
+    const float base = kept.coverage(0, CUTOFF);
+    for (uint32_t i = 1; i < 5; ++i)
+    {
+        const float plain_error = std::abs(plain.coverage(i, CUTOFF) - base);
+        const float kept_error = std::abs(kept.coverage(i, CUTOFF) - base);
+        std::println("level {}: coverage {:.3f} (without cutoff {:.3f}, base {:.3f})", i,
+                     kept.coverage(i, CUTOFF), plain.coverage(i, CUTOFF), base);
+        MCS_ASSERT(kept_error <= plain_error && kept_error < 0.02F);
+    }
+}
+
+// 5. 线程池分块的结果与单线程逐字节相同
+static void test_pool()
+{
+    const auto pixels = make_noise(301, 173, 7);
+    thread_pool pool{4};
+    for (const auto filter : {mip_filter::eBox, mip_filter::eKaiser})
+    {
+        const mip_options options{.filter = filter, .srgb = true, .alpha_cutoff = 0.3F};
+        const mip_chain serial{pixels, 301, 173, options};
+        const mip_chain parallel{pixels, 301, 173, options, &pool};
+        MCS_ASSERT(std::ranges::equal(serial.data(), parallel.data()));
+        MCS_ASSERT(std::ranges::equal(serial.level(0), pixels));
+    }
+}
+
+static void bench()
+{
+    using clock = std::chrono::steady_clock;
+    const auto pixels = make_noise(BENCH_SIZE, BENCH_SIZE, 3);
+    const double megapixels = double{BENCH_SIZE} * BENCH_SIZE / 1e6;
+    const size_t cores = std::max(1U, std::thread::hardware_concurrency());
+    thread_pool pool{cores};
+    for (const auto filter : {mip_filter::eBox, mip_filter::eKaiser})
+    {
+        const mip_options options{.filter = filter, .srgb = true};
+        auto start = clock::now();
+        const mip_chain serial{pixels, BENCH_SIZE, BENCH_SIZE, options};
+        const double serial_ms =
+            std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        start = clock::now();
+        const mip_chain parallel{pixels, BENCH_SIZE, BENCH_SIZE, options, &pool};
+        const double parallel_ms =
+            std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        std::println("[BENCH] {} {}x{} sRGB: 1 thread {:.2f} ms ({:.1f} MP/s), "
+                     "{} threads {:.2f} ms ({:.1f} MP/s per core)",
+                     filter == mip_filter::eBox ? "box" : "kaiser", BENCH_SIZE,
+                     BENCH_SIZE, serial_ms, megapixels * 1e3 / serial_ms, cores,
+                     parallel_ms, megapixels * 1e3 / parallel_ms / double(cores));
+    }
+}
+
+static create_image make_creator(const LogicalDevice &device, VmaAllocator allocator,
+                                 uint32_t size, VkFormat format)
+{
+    const uint32_t mipLevels = get_mip_levels(size, size);
+    return create_image{device, allocator}
+        .setCreateInfo({.imageType = VK_IMAGE_TYPE_2D,
+                        .format = format,
+                        .extent = {.width = size, .height = size, .depth = 1},
+                        .mipLevels = mipLevels,
+                        .arrayLayers = 1,
+                        .samples = VK_SAMPLE_COUNT_1_BIT,
+                        .tiling = VK_IMAGE_TILING_OPTIMAL,
+                        .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                 VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                 VK_IMAGE_USAGE_SAMPLED_BIT,
+                        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                        .allocationCreateInfo = {.usage = VMA_MEMORY_USAGE_AUTO}})
+        .setViewCreateInfo(
+            {.viewType = VK_IMAGE_VIEW_TYPE_2D,
+             .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                  .baseMipLevel = 0,
+                                  .levelCount = mipLevels,
+                                  .baseArrayLayer = 0,
+                                  .layerCount = 1}});
+}
+
+int main()
+try
+{
+    test_constant();
+    test_srgb();
+    test_alpha_weighting();
+    test_coverage();
+    test_pool();
+    bench();
+
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_mip_chain",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    std::println("device: {}", physical_device.getProperties().deviceName);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    const auto GRAPHICS = Queue(
+        device, {.queue_family_index = GRAPHICS_QUEUE_FAMILY_IDX, .queue_index = 0});
+    raii_vma vma{{.physicalDevice = *physical_device,
+                  .device = *device,
+                  .instance = *instance,
+                  .vulkanApiVersion = APIVERSION}};
+    VmaAllocator allocator = vma.allocator();
+    CommandPool commandPool =
+        create_command_pool{}
+            .setCreateInfo({.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                            .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX})
+            .build(device);
+
+    // 6. CPU 生成的 mip 链直接上传，与 vkCmdBlitImage 对比端到端耗时
+    using clock = std::chrono::steady_clock;
+    const auto pixels = make_noise(BENCH_SIZE, BENCH_SIZE, 5);
+    for (const VkFormat format : {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_SRGB})
+    {
+        auto start = clock::now();
+        auto cpu = create_texture_image{commandPool, GRAPHICS,
+                                        make_creator(device, allocator, BENCH_SIZE,
+                                                     format)}
+                       .build(pixels, mip_options{.srgb = create_texture_image::isSrgb(
+                                                      format)});
+        const double cpu_ms =
+            std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        MCS_ASSERT(cpu.image() != VK_NULL_HANDLE);
+
+        if (!create_texture_image::supportsLinearBlit(device, format))
+        {
+            std::println("[BENCH] format {}: no linear blit, cpu mips {:.2f} ms",
+                         static_cast<int>(format), cpu_ms);
+            continue;
+        }
+        start = clock::now();
+        auto blit = create_texture_image{commandPool, GRAPHICS,
+                                         make_creator(device, allocator, BENCH_SIZE,
+                                                      format)}
+                        .build(pixels);
+        const double blit_ms =
+            std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        MCS_ASSERT(blit.image() != VK_NULL_HANDLE);
+        std::println("[BENCH] format {}: cpu mips + upload {:.2f} ms, blit {:.2f} ms",
+                     static_cast<int>(format), cpu_ms, blit_ms);
+    }
+
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
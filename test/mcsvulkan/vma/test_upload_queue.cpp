@@ -0,0 +1,233 @@
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <print>
+#include <vector>
+
+#include "../head.hpp"
+
+using Instance = mcs::vulkan::Instance;
+using create_instance = mcs::vulkan::tool::create_instance;
+using physical_device_selector = mcs::vulkan::tool::physical_device_selector;
+using mcs::vulkan::vkMakeVersion;
+
+using mcs::vulkan::tool::enable_intance_build;
+using mcs::vulkan::tool::queue_family_index_selector;
+using mcs::vulkan::tool::create_logical_device;
+using mcs::vulkan::tool::create_command_pool;
+
+using mcs::vulkan::raii_vulkan;
+using mcs::vulkan::Queue;
+using mcs::vulkan::LogicalDevice;
+using mcs::vulkan::CommandPool;
+using mcs::vulkan::MCS_ASSERT;
+
+using raii_vma = mcs::vulkan::raii_vma;
+using mcs::vulkan::vma::create_buffer;
+using mcs::vulkan::vma::create_image;
+using mcs::vulkan::vma::create_texture_image;
+using mcs::vulkan::vma::upload_queue;
+
+// NOTE: 不需要窗口，可以在 lavapipe(VK_ICD_FILENAMES=lvp_icd.json)上运行
+constexpr auto APIVERSION = VK_API_VERSION_1_3;
+constexpr uint32_t TEXTURE_COUNT = 500;
+constexpr uint32_t TEXTURE_SIZE = 64;
+
+// NOTE: 暂存偏移按 lcm(texel 块大小, 4) 对齐，依赖这些块大小
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_R8G8B8A8_UNORM) == 4);
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_B8G8R8_SRGB) == 3);
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_R16G16B16_SFLOAT) == 6);
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_R32G32B32_SFLOAT) == 12);
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_BC1_RGB_UNORM_BLOCK) == 8);
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_BC7_SRGB_BLOCK) == 16);
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_ASTC_4x4_UNORM_BLOCK) == 16);
+static_assert(create_texture_image::texelBlockSize(VK_FORMAT_D16_UNORM_S8_UINT) == 0);
+
+static create_image make_creator(const LogicalDevice &device, VmaAllocator allocator,
+                                 uint32_t width, uint32_t height, uint32_t mipLevels)
+{
+    return create_image{device, allocator}
+        .setCreateInfo({.imageType = VK_IMAGE_TYPE_2D,
+                        .format = VK_FORMAT_R8G8B8A8_UNORM,
+                        .extent = {.width = width, .height = height, .depth = 1},
+                        .mipLevels = mipLevels,
+                        .arrayLayers = 1,
+                        .samples = VK_SAMPLE_COUNT_1_BIT,
+                        .tiling = VK_IMAGE_TILING_OPTIMAL,
+                        .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                 VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                 VK_IMAGE_USAGE_SAMPLED_BIT,
+                        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                        .allocationCreateInfo = {.usage = VMA_MEMORY_USAGE_AUTO}})
+        .setViewCreateInfo(
+            {.viewType = VK_IMAGE_VIEW_TYPE_2D,
+             .subresourceRange = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                  .baseMipLevel = 0,
+                                  .levelCount = mipLevels,
+                                  .baseArrayLayer = 0,
+                                  .layerCount = 1}});
+}
+
+static std::vector<uint8_t> make_pixels(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::vector<uint8_t> pixels(size_t{width} * height * 4);
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = static_cast<uint8_t>((i * 31) + seed);
+    return pixels;
+}
+
+int main()
+try
+{
+    raii_vulkan ctx{};
+    auto enables = enable_intance_build{};
+    enables.check();
+
+    Instance instance =
+        create_instance{}
+            .setCreateInfo(
+                {.applicationInfo = {.pApplicationName = "test_upload_queue",
+                                     .applicationVersion = vkMakeVersion(1, 0, 0),
+                                     .pEngineName = "No Engine",
+                                     .engineVersion = vkMakeVersion(1, 0, 0),
+                                     .apiVersion = APIVERSION},
+                 .enabledLayers = enables.enabledLayers(),
+                 .enabledExtensions = enables.enabledExtensions()})
+            .build();
+
+    auto [id [[maybe_unused]], physical_device] =
+        physical_device_selector{instance}
+            .requiredProperties([](const VkPhysicalDeviceProperties
+                                       &device_properties) constexpr noexcept {
+                return device_properties.apiVersion >= VK_API_VERSION_1_3;
+            })
+            .requiredQueueFamily(
+                [](const VkQueueFamilyProperties &qfp) constexpr noexcept {
+                    return !!(qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                })
+            .select()[0];
+    std::println("device: {}", physical_device.getProperties().deviceName);
+
+    const uint32_t GRAPHICS_QUEUE_FAMILY_IDX =
+        queue_family_index_selector{physical_device}
+            .requiredQueueFamily(
+                [&](const VkQueueFamilyProperties &qfp, uint32_t) -> bool {
+                    return (qfp.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                })
+            .select()[0];
+
+    LogicalDevice device =
+        create_logical_device{}
+            .setCreateInfo(
+                {.queueCreateInfos = create_logical_device::makeQueueCreateInfos(
+                     create_logical_device::queue_create_info{
+                         .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX,
+                         .queueCount = 1,
+                         .queuePrioritie = 1.0})})
+            .build(physical_device);
+    MCS_ASSERT(device);
+
+    const auto GRAPHICS = Queue(
+        device, {.queue_family_index = GRAPHICS_QUEUE_FAMILY_IDX, .queue_index = 0});
+    raii_vma vma{{.physicalDevice = *physical_device,
+                  .device = *device,
+                  .instance = *instance,
+                  .vulkanApiVersion = APIVERSION}};
+    VmaAllocator allocator = vma.allocator();
+    CommandPool commandPool =
+        create_command_pool{}
+            .setCreateInfo({.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                            .queueFamilyIndex = GRAPHICS_QUEUE_FAMILY_IDX})
+            .build(device);
+
+    using clock = std::chrono::steady_clock;
+    const auto mip_levels =
+        create_texture_image::getMipLevels(TEXTURE_SIZE, TEXTURE_SIZE);
+
+    // 1. 500 个纹理(一半带 mip 链)，4 MiB 环形缓冲区
+    std::vector<mcs::vulkan::vma::resource> textures;
+    textures.reserve(TEXTURE_COUNT + 1);
+    constexpr size_t RING_SIZE = size_t{4} << 20U;
+    upload_queue uploads{commandPool, GRAPHICS, allocator, RING_SIZE};
+    auto start = clock::now();
+    for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        auto creator = make_creator(device, allocator, TEXTURE_SIZE, TEXTURE_SIZE,
+                                    i % 2 == 0 ? mip_levels : 1);
+        const auto pixels = make_pixels(TEXTURE_SIZE, TEXTURE_SIZE, i);
+        textures.emplace_back(uploads.texture(creator, pixels));
+    }
+    // 超过环形缓冲区一半的数据走单独的暂存缓冲
+    {
+        auto creator = make_creator(device, allocator, 2048, 1024, 1); // NOLINT
+        textures.emplace_back(uploads.texture(creator, make_pixels(2048, 1024, 7)));
+    }
+    const uint64_t ticket = uploads.submit();
+    uploads.wait(ticket);
+    const double batched_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    MCS_ASSERT(uploads.completed(ticket));
+    MCS_ASSERT(uploads.in_flight() == 0);
+    // NOTE: 8 MB 的暂存数据经过 4 MiB 的环形缓冲区，只有写满时的自动提交 + 最后一次
+    MCS_ASSERT(uploads.submit_count() <= 4);
+    std::println("[BENCH] upload_queue: {} textures, {} submits, {:.2f} ms",
+                 textures.size(), uploads.submit_count(), batched_ms);
+
+    // 2. 缓冲上传：写入 host 可见的缓冲再读回比较
+    {
+        constexpr size_t BYTES = size_t{4} << 20U;
+        auto readback = create_buffer(
+            allocator,
+            {.sType = mcs::vulkan::tool::sType<VkBufferCreateInfo>(),
+             .size = BYTES,
+             .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+             .sharingMode = VK_SHARING_MODE_EXCLUSIVE},
+            {.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+             .usage = VMA_MEMORY_USAGE_AUTO});
+        const auto data = make_pixels(BYTES / 4, 1, 3);
+        // 两段：一段走环形缓冲区，一段(超过一半)走单独的暂存缓冲
+        constexpr size_t SPLIT = size_t{1} << 20U;
+        uploads.buffer(*readback, 0, std::span{data}.first(SPLIT));
+        uploads.buffer(*readback, SPLIT, std::span{data}.subspan(SPLIT));
+        const uint64_t pending = uploads.pending_ticket();
+        MCS_ASSERT(!uploads.completed(pending));
+        uploads.flush();
+        MCS_ASSERT(uploads.completed(pending));
+
+        mcs::vulkan::check_vkresult(::vmaInvalidateAllocation(
+            allocator, readback.allocation(), 0, VK_WHOLE_SIZE));
+        void *mapped = readback.map();
+        MCS_ASSERT(std::memcmp(mapped, data.data(), BYTES) == 0);
+        readback.unmap();
+    }
+
+    // 3. 对照：create_texture_image::build 每个纹理一次提交 + 等待
+    std::vector<mcs::vulkan::vma::resource> reference;
+    reference.reserve(TEXTURE_COUNT);
+    start = clock::now();
+    for (uint32_t i = 0; i < TEXTURE_COUNT; ++i)
+    {
+        const auto pixels = make_pixels(TEXTURE_SIZE, TEXTURE_SIZE, i);
+        reference.emplace_back(
+            create_texture_image{commandPool, GRAPHICS,
+                                 make_creator(device, allocator, TEXTURE_SIZE,
+                                              TEXTURE_SIZE, i % 2 == 0 ? mip_levels : 1)}
+                .build(pixels));
+    }
+    const double single_ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    std::println("[BENCH] create_texture_image::build: {} textures, {} submits, "
+                 "{:.2f} ms",
+                 reference.size(), reference.size(), single_ms);
+
+    std::cout << "main done\n";
+    return 0;
+}
+catch (std::exception &e)
+{
+    std::println("main catch exception: {}", e.what());
+    return 1;
+}
@@ -28,9 +28,13 @@ set(EMOJI_ATLAS_EXE "${TOOL_OUTPUT_DIR}/${EMOJI_ATLAS_NAME}${CMAKE_EXECUTABLE_SU
 set(MSDF_ATLAS_NAME msdf-atlas-gen)
 set(MSDF_ATLAS_EXE "${TOOL_OUTPUT_DIR}/${MSDF_ATLAS_NAME}${CMAKE_EXECUTABLE_SUFFIX}")
 
+set(MSDF_BATCH_ATLAS_NAME msdf_batch_atlas)
+set(MSDF_BATCH_ATLAS_EXE "${TOOL_OUTPUT_DIR}/${MSDF_BATCH_ATLAS_NAME}${CMAKE_EXECUTABLE_SUFFIX}")
+
 list(APPEND EXTERNAL_CMAKE_ARGS "-DHB_SUBSET_TOOL_NAME=${HB_SUBSET_TOOL_NAME}")
 list(APPEND EXTERNAL_CMAKE_ARGS "-DEMOJI_ATLAS_NAME=${EMOJI_ATLAS_NAME}")
 list(APPEND EXTERNAL_CMAKE_ARGS "-DMSDF_ATLAS_NAME=${MSDF_ATLAS_NAME}")
+list(APPEND EXTERNAL_CMAKE_ARGS "-DMSDF_BATCH_ATLAS_NAME=${MSDF_BATCH_ATLAS_NAME}")
 
 include(ExternalProject)
 ExternalProject_Add(my_tool_external
@@ -44,6 +48,7 @@ ExternalProject_Add(my_tool_external
     ${HB_SUBSET_TOOL_EXE}
     ${EMOJI_ATLAS_EXE}
     ${MSDF_ATLAS_EXE}
+    ${MSDF_BATCH_ATLAS_EXE}
 )
 
 # # 现在可以在自定义命令或自定义目标中依赖这些文件
@@ -307,11 +312,237 @@ add_msdf_atlas_target(
     EXTRA_ARGS -yorigin top
 )
 
+# ------------------------------------------ subset + atlas ----------------------------------------------------------
+# NOTE: 一步生成 子集字体 + 对应的 msdf 图集(png/json) + 展开后的字符集。
+# 字符集由 hb_subset_tool 解析(支持 @include)，展开结果交给 msdf-atlas-gen，两者覆盖的字符一致。
+# 增量：hb_subset_tool 输出 depfile(含 @include 的文件)，并且内容不变时不改写输出，
+# 所以只 touch 字符集、或者改了注释，不会重新生成图集。
+function(add_font_subset_target TARGET_NAME)
+    set(prefix ARG)
+    set(noValues "")
+    set(singleValues FONT_PATH CHARSET OUTPUT_NAME TYPE SIZE PX_RANGE FORMAT OUTPUT_DIR)
+    set(multiValues EXTRA_ARGS)
+    cmake_parse_arguments(${prefix} "${noValues}" "${singleValues}" "${multiValues}" ${ARGN})
+
+    if(NOT ARG_FONT_PATH OR NOT ARG_CHARSET OR NOT ARG_OUTPUT_NAME)
+        message(FATAL_ERROR "add_font_subset_target: FONT_PATH, CHARSET and OUTPUT_NAME are required")
+    endif()
+
+    if(NOT ARG_OUTPUT_DIR)
+        set(ARG_OUTPUT_DIR "${MSDF_OUTPUT_DIR}")
+    endif()
+
+    if(NOT ARG_TYPE)
+        set(ARG_TYPE "msdf")
+    endif()
+
+    if(NOT ARG_SIZE)
+        set(ARG_SIZE "32")
+    endif()
+
+    if(NOT ARG_PX_RANGE)
+        set(ARG_PX_RANGE "2")
+    endif()
+
+    if(NOT ARG_FORMAT)
+        set(ARG_FORMAT "png")
+    endif()
+
+    get_filename_component(FONT_EXT "${ARG_FONT_PATH}" LAST_EXT)
+    set(SUBSET_FONT_PATH "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}${FONT_EXT}")
+    set(RESOLVED_CHARSET "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}.charset.txt")
+    set(PNG_FILE "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}.${ARG_FORMAT}")
+    set(JSON_FILE "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}.json")
+    set(STAMP_FILE "${CMAKE_CURRENT_BINARY_DIR}/${ARG_OUTPUT_NAME}.subset.stamp")
+    set(DEP_FILE "${CMAKE_CURRENT_BINARY_DIR}/${ARG_OUTPUT_NAME}.subset.d")
+
+    # ----- 子集化：stamp 每次运行都会更新，真正的产物内容不变时保留 mtime -----
+    set(SUBSET_CMD_ARGS
+        ${HB_SUBSET_TOOL_EXE}
+        -font "${ARG_FONT_PATH}"
+        -charset "${ARG_CHARSET}"
+        -out "${SUBSET_FONT_PATH}"
+        -charset-out "${RESOLVED_CHARSET}"
+        -depfile "${DEP_FILE}"
+        -stamp "${STAMP_FILE}"
+    )
+    string(JOIN " " SUBSET_CMD_DISPLAY ${SUBSET_CMD_ARGS})
+
+    add_custom_command(
+        OUTPUT ${STAMP_FILE}
+        BYPRODUCTS ${SUBSET_FONT_PATH} ${RESOLVED_CHARSET}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${ARG_OUTPUT_DIR}
+        COMMAND ${CMAKE_COMMAND} -E echo "cmd: ${SUBSET_CMD_DISPLAY}"
+        COMMAND ${SUBSET_CMD_ARGS}
+        DEPENDS
+        ${HB_SUBSET_TOOL_EXE}
+        "${ARG_FONT_PATH}"
+        "${ARG_CHARSET}"
+        DEPFILE ${DEP_FILE}
+        COMMENT "Subsetting font for ${ARG_OUTPUT_NAME}"
+        VERBATIM
+        COMMAND_EXPAND_LISTS
+    )
+
+    # ----- 图集：用子集字体 + 展开后的字符集 -----
+    set(ATLAS_CMD_ARGS
+        ${MSDF_ATLAS_EXE}
+        -font "${SUBSET_FONT_PATH}"
+        -charset "${RESOLVED_CHARSET}"
+        -type "${ARG_TYPE}"
+        -size "${ARG_SIZE}"
+        -pxrange "${ARG_PX_RANGE}"
+        -imageout "${PNG_FILE}"
+        -format "${ARG_FORMAT}"
+        -json "${JSON_FILE}"
+    )
+
+    if(ARG_EXTRA_ARGS)
+        list(APPEND ATLAS_CMD_ARGS ${ARG_EXTRA_ARGS})
+    endif()
+
+    string(JOIN " " ATLAS_CMD_DISPLAY ${ATLAS_CMD_ARGS})
+
+    add_custom_command(
+        OUTPUT ${PNG_FILE} ${JSON_FILE}
+        COMMAND ${CMAKE_COMMAND} -E echo "cmd: ${ATLAS_CMD_DISPLAY}"
+        COMMAND ${ATLAS_CMD_ARGS}
+        # NOTE: 不依赖 stamp，子集化产物内容不变时(Ninja restat)图集不会重新生成
+        DEPENDS
+        ${MSDF_ATLAS_EXE}
+        ${SUBSET_FONT_PATH}
+        ${RESOLVED_CHARSET}
+        COMMENT "Generating MSDF atlas from subset: ${ARG_OUTPUT_NAME}"
+        VERBATIM
+        COMMAND_EXPAND_LISTS
+    )
+
+    add_custom_target(${TARGET_NAME} ALL DEPENDS ${PNG_FILE} ${JSON_FILE} ${STAMP_FILE})
+
+    if(TARGET msdf-atlas-gen-standalone)
+        add_dependencies(${TARGET_NAME} msdf-atlas-gen-standalone)
+    endif()
+
+    if(TARGET ${HB_SUBSET_TOOL_NAME})
+        add_dependencies(${TARGET_NAME} ${HB_SUBSET_TOOL_NAME})
+    endif()
+endfunction()
+
+add_font_subset_target(
+    generate_bengali_subset
+    FONT_PATH "${FONT_INPUT_DIR}/TiroBangla-Regular.ttf"
+    CHARSET "${CHASET_INPUT_DIR}/bengali_basic.txt"
+    OUTPUT_NAME "tirobangla_basic"
+    EXTRA_ARGS -yorigin top
+)
+
+# ------------------------------------------ batch msdf atlas ----------------------------------------------------------
+# NOTE: 一条命令并行生成多个字体的 msdf 图集(png/json，格式同 msdf-atlas-gen)。
+# 每个字形的 MSDF 按 (轮廓哈希, size, pxrange) 缓存在 CACHE_DIR，字体或字符集只改了几个字时，
+# 只重新生成这几个字形再重新打包；输出内容不变时不改写(保留 mtime)。
+# FONTS / CHARSETS / OUTPUT_NAMES 一一对应。
+function(add_msdf_batch_atlas_target TARGET_NAME)
+    set(prefix ARG)
+    set(noValues "")
+    set(singleValues SIZE PX_RANGE OUTPUT_DIR CACHE_DIR THREADS)
+    set(multiValues FONTS CHARSETS OUTPUT_NAMES EXTRA_ARGS)
+    cmake_parse_arguments(${prefix} "${noValues}" "${singleValues}" "${multiValues}" ${ARGN})
+
+    list(LENGTH ARG_FONTS font_count)
+    list(LENGTH ARG_CHARSETS charset_count)
+    list(LENGTH ARG_OUTPUT_NAMES output_count)
+
+    if(font_count EQUAL 0 OR NOT font_count EQUAL charset_count OR NOT font_count EQUAL output_count)
+        message(FATAL_ERROR "add_msdf_batch_atlas_target: FONTS, CHARSETS and OUTPUT_NAMES must have the same length")
+    endif()
+
+    if(NOT ARG_OUTPUT_DIR)
+        set(ARG_OUTPUT_DIR "${MSDF_OUTPUT_DIR}")
+    endif()
+
+    if(NOT ARG_CACHE_DIR)
+        set(ARG_CACHE_DIR "${CMAKE_BINARY_DIR}/msdf_glyph_cache")
+    endif()
+
+    if(NOT ARG_SIZE)
+        set(ARG_SIZE "32")
+    endif()
+
+    if(NOT ARG_PX_RANGE)
+        set(ARG_PX_RANGE "2")
+    endif()
+
+    set(STAMP_FILE "${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}.batch.stamp")
+    set(DEP_FILE "${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}.batch.d")
+
+    set(BATCH_CMD_ARGS
+        ${MSDF_BATCH_ATLAS_EXE}
+        -size "${ARG_SIZE}"
+        -pxrange "${ARG_PX_RANGE}"
+        -cache "${ARG_CACHE_DIR}"
+        -depfile "${DEP_FILE}"
+        -stamp "${STAMP_FILE}"
+    )
+
+    if(ARG_THREADS)
+        list(APPEND BATCH_CMD_ARGS -threads "${ARG_THREADS}")
+    endif()
+
+    set(OUTPUT_FILES "")
+    math(EXPR last "${font_count} - 1")
+
+    foreach(i RANGE ${last})
+        list(GET ARG_FONTS ${i} font)
+        list(GET ARG_CHARSETS ${i} charset)
+        list(GET ARG_OUTPUT_NAMES ${i} name)
+        list(APPEND BATCH_CMD_ARGS -font "${font}" -charset "${charset}" -out "${ARG_OUTPUT_DIR}/${name}")
+        list(APPEND OUTPUT_FILES "${ARG_OUTPUT_DIR}/${name}.png" "${ARG_OUTPUT_DIR}/${name}.json")
+    endforeach()
+
+    if(ARG_EXTRA_ARGS)
+        list(APPEND BATCH_CMD_ARGS ${ARG_EXTRA_ARGS})
+    endif()
+
+    string(JOIN " " BATCH_CMD_DISPLAY ${BATCH_CMD_ARGS})
+
+    # NOTE: 同 add_font_subset_target：stamp 每次更新，真正的产物内容不变时保留 mtime
+    add_custom_command(
+        OUTPUT ${STAMP_FILE}
+        BYPRODUCTS ${OUTPUT_FILES}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${ARG_OUTPUT_DIR}
+        COMMAND ${CMAKE_COMMAND} -E echo "cmd: ${BATCH_CMD_DISPLAY}"
+        COMMAND ${BATCH_CMD_ARGS}
+        DEPENDS
+        ${MSDF_BATCH_ATLAS_EXE}
+        ${ARG_FONTS}
+        ${ARG_CHARSETS}
+        DEPFILE ${DEP_FILE}
+        COMMENT "Generating batch MSDF atlases: ${ARG_OUTPUT_NAMES}"
+        VERBATIM
+        COMMAND_EXPAND_LISTS
+    )
+
+    add_custom_target(${TARGET_NAME} ALL DEPENDS ${STAMP_FILE})
+endfunction()
+
+add_msdf_batch_atlas_target(
+    generate_batch_atlases
+    FONTS
+    "${FONT_INPUT_DIR}/TiroBangla-Regular.ttf"
+    "C:/Windows/Fonts/segoeui.ttf"
+    CHARSETS
+    "${CHASET_INPUT_DIR}/bengali_basic.txt"
+    "${CHASET_INPUT_DIR}/arabic_charset.txt"
+    OUTPUT_NAMES "tirobangla_batch" "segoe_arabic_batch"
+    SIZE 64
+    EXTRA_ARGS -yorigin top
+)
+
 # ------------------------------------------ bitmap ----------------------------------------------------------
 function(add_emoji_atlas_target TARGET_NAME)
     # 解析命名参数
     set(options "")
-    set(oneValueArgs EXECUTABLE FONT_PATH CHARSET OUTPUT_NAME SIZE PADDING MAX_SIZE OUTPUT_DIR)
+    set(oneValueArgs EXECUTABLE FONT_PATH CHARSET OUTPUT_NAME SIZE PADDING MAX_SIZE OUTPUT_DIR FORMAT ZSTD THREADS)
     set(multiValueArgs DIMENSIONS EXTRA_ARGS) # 增加 EXTRA_ARGS 以支持类似 -allglyphs 等选项
     cmake_parse_arguments(ARG "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
 
@@ -355,6 +586,15 @@ function(add_emoji_atlas_target TARGET_NAME)
         set(ARG_MAX_SIZE "4096")
     endif()
 
+    # NOTE: FORMAT ktx2 时运行时直接上传(FontTexture::ktx2_info)，ZSTD 为超压缩等级
+    if(NOT ARG_FORMAT)
+        set(ARG_FORMAT "png")
+    endif()
+
+    if(NOT ARG_FORMAT STREQUAL "png" AND NOT ARG_FORMAT STREQUAL "ktx2")
+        message(FATAL_ERROR "add_emoji_atlas_target: FORMAT must be png or ktx2")
+    endif()
+
     # ----- 子集化判断（与 add_msdf_atlas_target 逻辑一致） -----
     set(SUBSET_FONT_PATH "")
     set(SHOULD_SUBSET FALSE)
@@ -420,8 +660,8 @@ function(add_emoji_atlas_target TARGET_NAME)
         set(USED_FONT_PATH "${ARG_FONT_PATH}")
     endif()
 
-    # ----- 图集生成命令（始终生成 PNG 和 JSON） -----
-    set(PNG_FILE "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}.png")
+    # ----- 图集生成命令（PNG 或 KTX2，以及 JSON） -----
+    set(PNG_FILE "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}.${ARG_FORMAT}")
     set(JSON_FILE "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}.json")
 
     set(ATLAS_CMD_ARGS
@@ -431,8 +671,17 @@ function(add_emoji_atlas_target TARGET_NAME)
         -size "${ARG_SIZE}"
         -padding "${ARG_PADDING}"
         -file_name "${ARG_OUTPUT_DIR}/${ARG_OUTPUT_NAME}"
+        -format "${ARG_FORMAT}"
     )
 
+    if(ARG_ZSTD)
+        list(APPEND ATLAS_CMD_ARGS -zstd "${ARG_ZSTD}")
+    endif()
+
+    if(ARG_THREADS)
+        list(APPEND ATLAS_CMD_ARGS -threads "${ARG_THREADS}")
+    endif()
+
     if(ARG_DIMENSIONS)
         list(LENGTH ARG_DIMENSIONS DIM_LEN)
 
@@ -503,6 +752,19 @@ add_emoji_atlas_target(
     EXTRA_ARGS -yorigin top
 )
 
+# 同一图集输出为 KTX2(zstd 超压缩)，运行时用 texture_info::ktx2_image_type 加载
+add_emoji_atlas_target(
+    generate_emoji_atlas_ktx2
+    FONT_PATH "C:/Windows/Fonts/seguiemj.ttf"
+    CHARSET "${CHASET_INPUT_DIR}/small_emoji.txt"
+    OUTPUT_NAME "emoji_ktx2"
+    SIZE 96
+    PADDING 2
+    FORMAT ktx2
+    ZSTD 19
+    EXTRA_ARGS -yorigin top
+)
+
 # -----------------------------------测试-----------------------------------
 # 测试单个字符格式（三种表示法）
 add_msdf_atlas_target(
@@ -6,6 +6,9 @@
 #include <cstring>
 #include <optional>
 #include <cctype>
+#include <chrono>
+#include <memory>
+#include <thread>
 
 // FreeType
 #include <ft2build.h>
@@ -24,6 +27,9 @@ using json = nlohmann::json;
 
 #include <cuchar> // std::mbrtoc32, std::mbstate_t
 
+#include "ktx2_writer.hpp"
+#include "../../include/detail/utils/thread_pool.hpp"
+
 struct GlyphInfo
 {
     uint32_t unicode;
@@ -196,6 +202,79 @@ std::vector<uint32_t> readCharset(const std::string &filename)
     return result;
 }
 
+// NOTE: FT_Face 不是线程安全的：每个工作线程一份 FT_Library + FT_Face
+struct FaceDeleter
+{
+    void operator()(FT_Face face) const noexcept
+    {
+        FT_Library library = face->glyph->library;
+        FT_Done_Face(face);
+        FT_Done_FreeType(library);
+    }
+};
+using FacePtr = std::unique_ptr<FT_FaceRec_, FaceDeleter>;
+
+FacePtr openFace(const std::string &fontPath, int fontSize)
+{
+    FT_Library library;
+    if (FT_Init_FreeType(&library))
+        return nullptr;
+    FT_Face face;
+    if (FT_New_Face(library, fontPath.c_str(), 0, &face))
+    {
+        FT_Done_FreeType(library);
+        return nullptr;
+    }
+    FT_Set_Pixel_Sizes(face, 0, fontSize);
+    return FacePtr{face};
+}
+
+// 渲染一个彩色字形，BGRA -> RGBA
+std::optional<GlyphInfo> renderGlyph(FT_Face face, uint32_t ch)
+{
+    FT_UInt idx = FT_Get_Char_Index(face, ch);
+    if (idx == 0)
+    {
+        std::cerr << "Glyph not found: U+" << std::hex << ch << std::dec << "\n";
+        return std::nullopt;
+    }
+    if (FT_Load_Glyph(face, idx, FT_LOAD_COLOR | FT_LOAD_RENDER))
+    {
+        std::cerr << "Failed to load glyph: U+" << std::hex << ch << std::dec << "\n";
+        return std::nullopt;
+    }
+    FT_Bitmap &bmp = face->glyph->bitmap;
+    if (bmp.pixel_mode != FT_PIXEL_MODE_BGRA)
+    {
+        std::cerr << "Skipping non-color glyph: U+" << std::hex << ch << std::dec << "\n";
+        return std::nullopt;
+    }
+
+    GlyphInfo info;
+    info.unicode = ch;
+    info.width = bmp.width;
+    info.height = bmp.rows;
+    info.bearingX = face->glyph->bitmap_left;
+    info.bearingY = face->glyph->bitmap_top;
+
+    // === 关键修改：使用线性 advance（16.16 格式）获取未舍入的像素值 ===
+    info.advance = face->glyph->linearHoriAdvance / 65536.0;
+
+    info.bitmap.resize(info.width * info.height * 4);
+    uint8_t *dst = info.bitmap.data();
+    const uint8_t *src = bmp.buffer;
+    for (int i = 0; i < info.width * info.height; ++i)
+    {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+        dst[3] = src[3];
+        dst += 4;
+        src += 4;
+    }
+    return info;
+}
+
 int main(int argc, char *argv[])
 {
     std::ignore = std::setlocale(LC_ALL, "en_US.utf8");
@@ -219,6 +298,10 @@ int main(int argc, char *argv[])
     int fixedWidth = -1;
     int fixedHeight = -1;
 
+    bool ktx2Output = false; // -format ktx2：运行时直接上传，免去 PNG 解码
+    int zstdLevel = 0;       // > 0 时 KTX2 使用 zstd 超压缩
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
     // 新增枚举或使用 bool 表示 Y 方向（true = top origin, false = bottom origin）
     bool yDown = false; // 默认为 bottom (Y_UPWARD)
 
@@ -254,6 +337,25 @@ int main(int argc, char *argv[])
         else if (arg == "-max-size" && i + 1 < argc)
         {
             MAX_SIZE = std::stoi(argv[++i]);
+        }
+        else if (arg == "-format" && i + 1 < argc)
+        {
+            std::string format = argv[++i];
+            if (format != "png" && format != "ktx2")
+            {
+                std::cerr << "Invalid -format value: " << format
+                          << " (must be 'png' or 'ktx2')\n";
+                return 1;
+            }
+            ktx2Output = format == "ktx2";
+        }
+        else if (arg == "-zstd" && i + 1 < argc)
+        {
+            zstdLevel = std::stoi(argv[++i]);
+        }
+        else if (arg == "-threads" && i + 1 < argc)
+        {
+            threads = std::max(1, std::stoi(argv[++i]));
         } // ==== 新增 -yorigin 参数解析 ====
         else if (arg == "-yorigin" && i + 1 < argc)
         {
@@ -278,6 +380,9 @@ int main(int argc, char *argv[])
                       << "  -padding <pixels>     Padding (default: 1)\n"
                       << "  -output <prefix>      Output prefix (default: emoji)\n"
                       << "  -dimensions <w> <h>   Fixed atlas size (default: auto)\n"
+                      << "  -format png|ktx2      Atlas image format (default: png)\n"
+                      << "  -zstd <level>         KTX2 zstd level (default: 0, none)\n"
+                      << "  -threads <n>          Render threads (default: hardware)\n"
                       << "  -help                 This help\n";
             return 0;
         }
@@ -327,53 +432,36 @@ int main(int argc, char *argv[])
     }
     FT_Set_Pixel_Sizes(face, 0, fontSize);
 
-    // 加载每个字形
-    std::vector<GlyphInfo> glyphs;
-    for (uint32_t ch : charset)
+    // NOTE: 并行渲染，结果按字符集顺序收集，输出与串行一致
+    const auto renderStart = std::chrono::steady_clock::now();
+    mcs::vulkan::thread_pool pool{threads};
+    std::vector<FacePtr> faces(pool.size());
+    for (auto &workerFace : faces)
     {
-        FT_UInt idx = FT_Get_Char_Index(face, ch);
-        if (idx == 0)
-        {
-            std::cerr << "Glyph not found: U+" << std::hex << ch << std::dec << "\n";
-            continue;
-        }
-        if (FT_Load_Glyph(face, idx, FT_LOAD_COLOR | FT_LOAD_RENDER))
-        {
-            std::cerr << "Failed to load glyph: U+" << std::hex << ch << std::dec << "\n";
-            continue;
-        }
-        FT_Bitmap &bmp = face->glyph->bitmap;
-        if (bmp.pixel_mode != FT_PIXEL_MODE_BGRA)
-        {
-            std::cerr << "Skipping non-color glyph: U+" << std::hex << ch << std::dec
-                      << "\n";
-            continue;
-        }
-
-        GlyphInfo info;
-        info.unicode = ch;
-        info.width = bmp.width;
-        info.height = bmp.rows;
-        info.bearingX = face->glyph->bitmap_left;
-        info.bearingY = face->glyph->bitmap_top;
-
-        // === 关键修改：使用线性 advance（16.16 格式）获取未舍入的像素值 ===
-        info.advance = face->glyph->linearHoriAdvance / 65536.0;
-
-        info.bitmap.resize(info.width * info.height * 4);
-        uint8_t *dst = info.bitmap.data();
-        uint8_t *src = bmp.buffer;
-        for (int i = 0; i < info.width * info.height; ++i)
+        workerFace = openFace(fontPath, fontSize);
+        if (!workerFace)
         {
-            dst[0] = src[2];
-            dst[1] = src[1];
-            dst[2] = src[0];
-            dst[3] = src[3];
-            dst += 4;
-            src += 4;
+            std::cerr << "Failed to load font: " << fontPath << "\n";
+            FT_Done_Face(face);
+            FT_Done_FreeType(ft);
+            return 1;
         }
-        glyphs.push_back(std::move(info));
     }
+    std::vector<std::optional<GlyphInfo>> rendered(charset.size());
+    pool.for_each_index(charset.size(), [&](size_t i) {
+        rendered[i] = renderGlyph(faces[mcs::vulkan::thread_pool::current_worker()].get(),
+                                  charset[i]);
+    });
+    std::vector<GlyphInfo> glyphs;
+    for (auto &g : rendered)
+        if (g)
+            glyphs.push_back(std::move(*g));
+    std::cout << "Rendered " << glyphs.size() << " glyphs on " << pool.size()
+              << " threads in "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - renderStart)
+                     .count()
+              << " ms\n";
 
     if (glyphs.empty())
     {
@@ -435,10 +523,30 @@ int main(int argc, char *argv[])
         }
     }
 
-    // 保存 PNG
-    std::string pngFile = file_name + ".png";
-    stbi_write_png(pngFile.c_str(), w, h, 4, atlas.data(), w * 4);
-    std::cout << "Saved " << pngFile << "\n";
+    if (ktx2Output)
+    {
+        // 保存 KTX2(R8G8B8A8_UNORM，与 PNG 路径的纹理格式一致)
+        std::string ktxFile = file_name + ".ktx2";
+        auto bytes =
+            ktx2::encode_rgba8(w, h, atlas, zstdLevel, "mcsvulkan gen_emoji_atlas");
+        std::ofstream ktxOut(ktxFile, std::ios::binary | std::ios::trunc);
+        if (bytes.empty() ||
+            !ktxOut.write(reinterpret_cast<const char *>(bytes.data()), bytes.size()))
+        {
+            std::cerr << "Failed to write " << ktxFile << "\n";
+            FT_Done_Face(face);
+            FT_Done_FreeType(ft);
+            return 1;
+        }
+        std::cout << "Saved " << ktxFile << " (" << bytes.size() << " bytes)\n";
+    }
+    else
+    {
+        // 保存 PNG
+        std::string pngFile = file_name + ".png";
+        stbi_write_png(pngFile.c_str(), w, h, 4, atlas.data(), w * 4);
+        std::cout << "Saved " << pngFile << "\n";
+    }
 
     // ---------- 生成 JSON ----------
     json j;
@@ -20,379 +20,11 @@
 #include <set>
 #include <stack>
 #include <filesystem>
-namespace fs = std::filesystem;
+#include <format>
+#include <iterator>
+#include <string_view>
 
-// 去除 UTF-8 BOM
-std::string removeBOM(const std::string &line)
-{
-    if (line.size() >= 3 && (unsigned char)line[0] == 0xEF &&
-        (unsigned char)line[1] == 0xBB && (unsigned char)line[2] == 0xBF)
-        return line.substr(3);
-    return line;
-}
-
-// 将 UTF-8 字符转换为 Unicode 码点
-std::optional<uint32_t> utf8_to_codepoint(const char *&str)
-{
-    if (!str || !*str)
-        return std::nullopt;
-    std::mbstate_t state{};
-    char32_t cp = 0;
-    std::size_t result = std::mbrtoc32(&cp, str, 5, &state);
-    if (result == (std::size_t)-1 || result == (std::size_t)-3)
-        return std::nullopt;
-    if (result == (std::size_t)-2)
-        return std::nullopt;
-    str += (result > 0 ? result : 1);
-    return static_cast<uint32_t>(cp);
-}
-
-// 解析转义序列（返回转义后的字符，并移动指针）
-char parseEscape(const char *&p)
-{
-    if (*p != '\\')
-        return 0;
-    ++p;
-    char c = *p++;
-    switch (c)
-    {
-    case '\\':
-        return '\\';
-    case '\'':
-        return '\'';
-    case '"':
-        return '"';
-    case 'n':
-        return '\n';
-    case 't':
-        return '\t';
-    case 'r':
-        return '\r';
-    default:
-        return c;
-    }
-}
-
-// 解析单个字符字面量（例如 'A' 或 '\''），返回码点，p 指向结束后的位置
-std::optional<uint32_t> parseCharLiteral(const char *&p)
-{
-    if (*p != '\'')
-        return std::nullopt;
-    ++p; // 跳过 '
-    std::string literal;
-    while (*p && *p != '\'')
-    {
-        if (*p == '\\')
-            literal.push_back(parseEscape(p));
-        else
-            literal.push_back(*p++);
-    }
-    if (*p != '\'')
-        return std::nullopt;
-    ++p; // 跳过结束的 '
-    const char *tmp = literal.c_str();
-    if (auto cp = utf8_to_codepoint(tmp))
-        return *cp;
-    return std::nullopt;
-}
-
-// 解析字符串字面量（例如 "ABC"），返回所有码点，p 指向结束后的位置
-std::vector<uint32_t> parseStringLiteral(const char *&p)
-{
-    std::vector<uint32_t> result;
-    if (*p != '"')
-        return result;
-    ++p; // 跳过 "
-    std::string literal;
-    while (*p && *p != '"')
-    {
-        if (*p == '\\')
-            literal.push_back(parseEscape(p));
-        else
-            literal.push_back(*p++);
-    }
-    if (*p != '"')
-    {
-        result.clear();
-        return result;
-    }
-    ++p; // 跳过 "
-    const char *tmp = literal.c_str();
-    while (*tmp)
-    {
-        if (auto cp = utf8_to_codepoint(tmp))
-            result.push_back(*cp);
-        else
-            break;
-    }
-    return result;
-}
-
-// 解析数字（十进制或十六进制）
-std::optional<uint32_t> parseNumber(const char *&p)
-{
-    char *end;
-    long val = strtol(p, &end, 0);
-    if (end == p)
-        return std::nullopt;
-    p = end;
-    return static_cast<uint32_t>(val);
-}
-
-// 解析范围 [start, end]（返回起始和结束码点），p 指向结束后的位置
-std::optional<std::pair<uint32_t, uint32_t>> parseRange(const char *&p)
-{
-    if (*p != '[')
-        return std::nullopt;
-    ++p; // 跳过 [
-    // 跳过空白
-    while (std::isspace(*p))
-        ++p;
-
-    std::optional<uint32_t> start;
-    if (*p == '\'')
-        start = parseCharLiteral(p);
-    else
-        start = parseNumber(p);
-    if (!start)
-        return std::nullopt;
-
-    while (std::isspace(*p))
-        ++p;
-    if (*p != ',')
-        return std::nullopt;
-    ++p; // 跳过 ,
-    while (std::isspace(*p))
-        ++p;
-
-    std::optional<uint32_t> end;
-    if (*p == '\'')
-        end = parseCharLiteral(p);
-    else
-        end = parseNumber(p);
-    if (!end)
-        return std::nullopt;
-
-    while (std::isspace(*p))
-        ++p;
-    if (*p != ']')
-        return std::nullopt;
-    ++p; // 跳过 ]
-    return std::make_pair(*start, *end);
-}
-
-// 解析一行字符集描述（来自文件或直接字符串），line_num 用于打印信息（-1 时不打印）
-void parseLine(const std::string &line, std::vector<uint32_t> &out, int line_num = -1)
-{
-    const char *p = line.c_str();
-    size_t before = out.size();
-
-    while (*p)
-    {
-        // 跳过空白和逗号
-        while (*p && (std::isspace(*p) || *p == ','))
-            ++p;
-        if (!*p)
-            break;
-
-        if (*p == '\'')
-        {
-            if (auto cp = parseCharLiteral(p))
-                out.push_back(*cp);
-            else
-                std::cerr << "Warning: invalid character literal"
-                          << (line_num > 0 ? " at line " + std::to_string(line_num) : "")
-                          << "\n";
-        }
-        else if (*p == '"')
-        {
-            auto chars = parseStringLiteral(p);
-            out.insert(out.end(), chars.begin(), chars.end());
-        }
-        else if (*p == '[')
-        {
-            auto range = parseRange(p);
-            if (range)
-            {
-                uint32_t start = range->first, end = range->second;
-                if (start <= end)
-                {
-                    for (uint32_t cp = start; cp <= end; ++cp)
-                        out.push_back(cp);
-                }
-                else
-                {
-                    std::cerr << "Warning: invalid range start > end"
-                              << (line_num > 0 ? " at line " + std::to_string(line_num)
-                                               : "")
-                              << "\n";
-                }
-            }
-            else
-            {
-                std::cerr << "Warning: invalid range"
-                          << (line_num > 0 ? " at line " + std::to_string(line_num) : "")
-                          << "\n";
-            }
-        }
-        else
-        {
-            const char *numStart = p;
-            if (auto num = parseNumber(p))
-            {
-                out.push_back(*num);
-            }
-            else
-            {
-                // 无法识别，跳过当前 token
-                while (*p && !std::isspace(*p) && *p != ',')
-                    ++p;
-                std::cerr << "Warning: unrecognized token"
-                          << (line_num > 0 ? " at line " + std::to_string(line_num) : "")
-                          << "\n";
-            }
-        }
-    }
-
-    if (line_num > 0 && out.size() > before)
-    {
-        std::println("Line {}: parsed {} characters", line_num, out.size() - before);
-    }
-}
-
-// 递归解析字符集文件（支持 @include）
-void parseCharsetFile(const std::string &filename, std::vector<uint32_t> &out,
-                      std::set<std::string> &included, int &lineCounter)
-{
-    fs::path canonical = fs::weakly_canonical(filename);
-    std::string canonStr = canonical.string();
-    if (included.count(canonStr))
-    {
-        std::cerr << "Warning: recursive @include detected: " << filename << "\n";
-        return;
-    }
-    included.insert(canonStr);
-
-    std::ifstream file(filename);
-    if (!file.is_open())
-        throw std::runtime_error("Cannot open charset file: " + filename);
-
-    std::string line;
-    while (std::getline(file, line))
-    {
-        ++lineCounter;
-        line = removeBOM(line);
-        size_t start = line.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos)
-            continue;
-        size_t end = line.find_last_not_of(" \t\r\n");
-        line = line.substr(start, end - start + 1);
-        if (line.empty() || line[0] == '#')
-            continue;
-
-        // 处理 @include
-        if (line.compare(0, 8, "@include") == 0 && line.size() > 8 &&
-            std::isspace(line[8]))
-        {
-            size_t quoteStart = line.find('"', 8);
-            if (quoteStart == std::string::npos)
-            {
-                std::cerr << "Warning: invalid @include syntax at line " << lineCounter
-                          << "\n";
-                continue;
-            }
-            size_t quoteEnd = line.find('"', quoteStart + 1);
-            if (quoteEnd == std::string::npos)
-            {
-                std::cerr << "Warning: invalid @include syntax at line " << lineCounter
-                          << "\n";
-                continue;
-            }
-            std::string includeFile =
-                line.substr(quoteStart + 1, quoteEnd - quoteStart - 1);
-            fs::path baseDir = fs::path(filename).parent_path();
-            fs::path includePath = baseDir / includeFile;
-            parseCharsetFile(includePath.string(), out, included, lineCounter);
-            continue;
-        }
-
-        parseLine(line, out, lineCounter);
-    }
-}
-
-// 从文件读取字符集
-std::vector<uint32_t> readCharsetFromFile(const std::string &filename)
-{
-    std::vector<uint32_t> result;
-    std::set<std::string> included;
-    int lineCounter = 0;
-    parseCharsetFile(filename, result, included, lineCounter);
-    return result;
-}
-
-// 从字符串解析字符集
-std::vector<uint32_t> readCharsetFromString(const std::string &str)
-{
-    std::vector<uint32_t> result;
-    parseLine(str, result, 1); // 视为第一行
-    return result;
-}
-
-// 新增：从字符串解析字形索引集（仅支持数字和范围，不支持引号）
-std::vector<uint32_t> readGlyphsFromString(const std::string &str)
-{
-    std::vector<uint32_t> result;
-    const char *p = str.c_str();
-    while (*p)
-    {
-        // 跳过空白和逗号
-        while (*p && (std::isspace(*p) || *p == ','))
-            ++p;
-        if (!*p)
-            break;
-
-        if (*p == '[')
-        {
-            auto range = parseRange(p);
-            if (range)
-            {
-                uint32_t start = range->first, end = range->second;
-                if (start <= end)
-                {
-                    for (uint32_t idx = start; idx <= end; ++idx)
-                        result.push_back(idx);
-                }
-                else
-                {
-                    std::cerr << "Warning: invalid range start > end\n";
-                }
-            }
-            else
-            {
-                std::cerr << "Warning: invalid range\n";
-            }
-        }
-        else if (*p == '\'' || *p == '"')
-        {
-            std::cerr << "Error: character literals or strings not allowed for -glyphs\n";
-            return {};
-        }
-        else
-        {
-            if (auto num = parseNumber(p))
-            {
-                result.push_back(*num);
-            }
-            else
-            {
-                std::cerr << "Warning: unrecognized token\n";
-                while (*p && !std::isspace(*p) && *p != ',')
-                    ++p;
-            }
-        }
-    }
-    return result;
-}
+#include "charset.hpp"
 
 int main(int argc, char *argv[])
 {
@@ -403,6 +35,9 @@ int main(int argc, char *argv[])
     std::string charset_file;
     std::string charset_string;
     std::string glyphs_string; // 新增
+    std::string charset_out;   // 展开后的字符集
+    std::string depfile;       // 字符集文件依赖(含 @include)
+    std::string stamp;         // 每次运行都会更新的时间戳文件，depfile 的 target
 
     // 解析命令行
     if (argc == 4 && argv[1][0] != '-')
@@ -438,6 +73,18 @@ int main(int argc, char *argv[])
             {
                 glyphs_string = argv[++i];
             }
+            else if (arg == "-charset-out" && i + 1 < argc)
+            {
+                charset_out = argv[++i];
+            }
+            else if (arg == "-depfile" && i + 1 < argc)
+            {
+                depfile = argv[++i];
+            }
+            else if (arg == "-stamp" && i + 1 < argc)
+            {
+                stamp = argv[++i];
+            }
             else if (arg == "-help" || arg == "--help")
             {
                 std::println(
@@ -449,6 +96,9 @@ int main(int argc, char *argv[])
                     "  -chars <string>          Character set specification in-line\n"
                     "  -glyphs <string>         Glyph index set in-line (numbers and "
                     "ranges only)\n"
+                    "  -charset-out <file>      Write the resolved charset (no @include)\n"
+                    "  -depfile <file>          Write charset dependencies for -stamp\n"
+                    "  -stamp <file>            Touched on success\n"
                     "  Legacy: <input_font> <output_font> <charset.txt>\n",
                     argv[0]);
                 return 0;
@@ -487,6 +137,7 @@ int main(int argc, char *argv[])
     }
 
     std::vector<uint32_t> indices; // 存储 Unicode 码点或字形索引
+    std::set<std::string> charset_files;
     bool isGlyphMode = !glyphs_string.empty();
 
     if (isGlyphMode)
@@ -506,7 +157,7 @@ int main(int argc, char *argv[])
     {
         try
         {
-            indices = readCharsetFromFile(charset_file);
+            indices = readCharsetFromFile(charset_file, &charset_files);
         }
         catch (const std::exception &e)
         {
@@ -604,23 +255,38 @@ int main(int argc, char *argv[])
     }
 
     hb_blob_t *subset_blob = hb_face_reference_blob(subset_face);
-    std::ofstream out(output_path, std::ios::binary);
-    if (!out)
+    unsigned int length;
+    const char *data = hb_blob_get_data(subset_blob, &length);
+    if (!writeIfDifferent(output_path, {data, length}))
     {
         std::cerr << "Cannot open output file: " << output_path << "\n";
         hb_blob_destroy(subset_blob);
         hb_face_destroy(subset_face);
         return 1;
     }
-    unsigned int length;
-    const char *data = hb_blob_get_data(subset_blob, &length);
-    out.write(data, length);
-    out.close();
 
     hb_blob_destroy(subset_blob);
     hb_face_destroy(subset_face);
 
     std::println("Subset font saved to {} ({} bytes, {} {})", output_path, length,
                  indices.size(), isGlyphMode ? "glyph indices" : "characters");
+
+    if (!charset_out.empty() && !isGlyphMode &&
+        !writeIfDifferent(charset_out, formatCharset(indices)))
+    {
+        std::cerr << "Cannot write charset: " << charset_out << "\n";
+        return 1;
+    }
+    if (!depfile.empty() && !stamp.empty() &&
+        !writeIfDifferent(depfile, formatDepfile(stamp, charset_files)))
+    {
+        std::cerr << "Cannot write depfile: " << depfile << "\n";
+        return 1;
+    }
+    if (!stamp.empty())
+    {
+        std::ofstream touch(stamp, std::ios::trunc);
+        touch << output_path << "\n";
+    }
     return 0;
 }
\ No newline at end of file
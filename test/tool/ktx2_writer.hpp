@@ -0,0 +1,161 @@
+#pragma once
+
+// NOTE: 最小的 KTX2 写入(单层、R8G8B8A8，可带预生成的 mip 链)，可选 zstd 超压缩。
+// 主项目的 libktx 以 KTX_FEATURE_WRITE=0 构建，所以这里按规范直接写：
+// https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+
+#include <zstd.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace ktx2
+{
+    constexpr uint32_t VK_FORMAT_R8G8B8A8_UNORM = 37;
+    constexpr uint32_t SUPERCOMPRESSION_NONE = 0;
+    constexpr uint32_t SUPERCOMPRESSION_ZSTD = 2;
+
+    namespace detail
+    {
+        inline void put32(std::vector<uint8_t> &out, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+        inline void set32(std::vector<uint8_t> &out, size_t at, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                out[at + i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        inline void set64(std::vector<uint8_t> &out, size_t at, uint64_t value)
+        {
+            set32(out, at, static_cast<uint32_t>(value));
+            set32(out, at + 4, static_cast<uint32_t>(value >> 32U));
+        }
+        inline void pad4(std::vector<uint8_t> &out)
+        {
+            while (out.size() % 4 != 0)
+                out.push_back(0);
+        }
+
+        // Basic Data Format Descriptor：RGBSDA、BT709、线性、非预乘 alpha，每通道 8 位
+        inline void put_dfd_rgba8(std::vector<uint8_t> &out)
+        {
+            constexpr uint32_t SAMPLES = 4;
+            constexpr uint32_t BLOCK_SIZE = 24 + (16 * SAMPLES);
+            put32(out, 4 + BLOCK_SIZE);           // dfdTotalSize
+            put32(out, 0);                        // vendorId = Khronos, basic
+            put32(out, 2U | (BLOCK_SIZE << 16U)); // versionNumber = 2
+            put32(out, 1U | (1U << 8U) | (1U << 16U)); // RGBSDA, BT709, LINEAR, flags = 0
+            put32(out, 0);                             // texelBlockDimension 1x1x1x1
+            put32(out, 4);                             // bytesPlane0
+            put32(out, 0);
+            constexpr std::array<uint32_t, SAMPLES> CHANNELS{0, 1, 2, 15}; // R G B A
+            for (uint32_t i = 0; i < SAMPLES; ++i)
+            {
+                put32(out, (i * 8) | (7U << 16U) | (CHANNELS[i] << 24U));
+                put32(out, 0);   // samplePosition
+                put32(out, 0);   // sampleLower
+                put32(out, 255); // sampleUpper
+            }
+        }
+
+        inline void put_kv(std::vector<uint8_t> &out, std::string_view key,
+                           std::string_view value)
+        {
+            put32(out, static_cast<uint32_t>(key.size() + 1 + value.size() + 1));
+            out.insert(out.end(), key.begin(), key.end());
+            out.push_back(0);
+            out.insert(out.end(), value.begin(), value.end());
+            out.push_back(0);
+            pad4(out);
+        }
+    }; // namespace detail
+
+    /**
+     * @brief 编码为 KTX2，zstd_level 为 0 时不超压缩
+     * levels[0] 为 width x height，之后每级宽高减半(最小为 1)
+     * 像素为行优先、左上角为原点(KTXorientation = "rd")
+     */
+    inline std::vector<uint8_t> encode_rgba8_levels(
+        uint32_t width, uint32_t height, std::span<const std::span<const uint8_t>> levels,
+        int zstd_level = 0, std::string_view writer = "")
+    {
+        using namespace detail;
+        std::vector<std::vector<uint8_t>> compressed(levels.size());
+        if (zstd_level > 0)
+        {
+            for (size_t i = 0; i < levels.size(); ++i)
+            {
+                auto &level = compressed[i];
+                level.resize(ZSTD_compressBound(levels[i].size()));
+                const size_t n = ZSTD_compress(level.data(), level.size(),
+                                               levels[i].data(), levels[i].size(),
+                                               zstd_level);
+                if (ZSTD_isError(n) != 0)
+                    return {};
+                level.resize(n);
+            }
+        }
+
+        constexpr std::array<uint8_t, 12> IDENTIFIER{0xAB, 'K',  'T',  'X', ' ',  '2',
+                                                     '0',  0xBB, '\r', '\n', 0x1A, '\n'};
+        std::vector<uint8_t> out(IDENTIFIER.begin(), IDENTIFIER.end());
+        put32(out, VK_FORMAT_R8G8B8A8_UNORM);
+        put32(out, 1); // typeSize
+        put32(out, width);
+        put32(out, height);
+        put32(out, 0); // pixelDepth
+        put32(out, 0); // layerCount
+        put32(out, 1); // faceCount
+        put32(out, static_cast<uint32_t>(levels.size())); // levelCount
+        put32(out, zstd_level > 0 ? SUPERCOMPRESSION_ZSTD : SUPERCOMPRESSION_NONE);
+
+        const size_t index = out.size(); // dfd/kvd/sgd 偏移，最后回填
+        out.resize(out.size() + (4 * 4) + (2 * 8));
+        const size_t level_index = out.size();
+        out.resize(out.size() + (levels.size() * 3 * 8));
+
+        const size_t dfd = out.size();
+        put_dfd_rgba8(out);
+        const size_t kvd = out.size();
+        put_kv(out, "KTXorientation", "rd"); // 键按字节序排列
+        if (!writer.empty())
+            put_kv(out, "KTXwriter", writer);
+        const size_t kvd_end = out.size();
+
+        // NOTE: 数据按从小到大(最后一级在前)存放；未超压缩时按 texel 大小(4)对齐
+        for (size_t i = levels.size(); i-- > 0;)
+        {
+            if (zstd_level == 0)
+                pad4(out);
+            const auto &level = zstd_level > 0 ? std::span<const uint8_t>{compressed[i]}
+                                               : levels[i];
+            const size_t data = out.size();
+            out.insert(out.end(), level.begin(), level.end());
+            set64(out, level_index + (i * 24), data);
+            set64(out, level_index + (i * 24) + 8, level.size());
+            set64(out, level_index + (i * 24) + 16, levels[i].size());
+        }
+
+        set32(out, index, static_cast<uint32_t>(dfd));
+        set32(out, index + 4, static_cast<uint32_t>(kvd - dfd));
+        set32(out, index + 8, static_cast<uint32_t>(kvd));
+        set32(out, index + 12, static_cast<uint32_t>(kvd_end - kvd));
+        set64(out, index + 16, 0); // sgd
+        set64(out, index + 24, 0);
+        return out;
+    }
+
+    inline std::vector<uint8_t> encode_rgba8(uint32_t width, uint32_t height,
+                                             std::span<const uint8_t> rgba,
+                                             int zstd_level = 0,
+                                             std::string_view writer = "")
+    {
+        const std::array<std::span<const uint8_t>, 1> levels{rgba};
+        return encode_rgba8_levels(width, height, levels, zstd_level, writer);
+    }
+}; // namespace ktx2
@@ -0,0 +1,722 @@
+// NOTE: 多字体并行、增量的 MSDF 图集生成(输出与 msdf-atlas-gen 的 png/json 格式兼容)
+// - 每个字形的 MSDF 按 (轮廓哈希, advance, size, pxrange, angle) 缓存到磁盘，
+//   字体里只改了一个字形，或者字符集里加了一个字，只重新生成这几个字形
+// - 缓存未命中的字形在线程池里生成；之后每个图集独立打包、写出，也是并行的
+// - 打包顺序固定，输出内容不变时不改写文件(保留 mtime)
+// - 字距只在不同字形之间计算，按行分给线程池，结果按 (字体内容, 字形集合) 缓存
+
+#include "../../include/detail/font/msdf/generate_glyph.hpp"
+#include "../../include/detail/font/msdf/shelf_packer.hpp"
+#include "../../include/detail/utils/thread_pool.hpp"
+
+#include "charset.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <clocale>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <print>
+#include <thread>
+
+using json = nlohmann::ordered_json;
+namespace msdf = mcs::vulkan::font::msdf;
+
+namespace
+{
+    constexpr uint32_t CACHE_MAGIC = 0x4744534D;   // "MSDG"
+    constexpr uint32_t KERNING_MAGIC = 0x4B44534D; // "MSDK"
+    constexpr uint32_t CACHE_VERSION = 1;        // 生成算法变化时递增，旧缓存自动失效
+    constexpr int MAX_ATLAS_SIZE = 16384;
+
+    // FNV-1a 64
+    constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+    uint64_t hash_bytes(uint64_t h, const void *data, size_t size) noexcept
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i)
+            h = (h ^ p[i]) * 0x100000001B3ULL;
+        return h;
+    }
+    template <typename T>
+    uint64_t hash_value(uint64_t h, const T &value) noexcept
+    {
+        return hash_bytes(h, &value, sizeof(value));
+    }
+
+    // NOTE: 按轮廓而不是整个字体文件做键：字体只改了一个字形时其余缓存仍然有效
+    uint64_t shape_key(const msdfgen::Shape &shape, double advance,
+                       const msdf::glyph_params &params)
+    {
+        uint64_t h = hash_value(FNV_OFFSET, CACHE_VERSION);
+        h = hash_value(h, params.glyph_size);
+        h = hash_value(h, params.px_range);
+        h = hash_value(h, params.angle_threshold);
+        h = hash_value(h, advance);
+        for (const auto &contour : shape.contours)
+        {
+            h = hash_value(h, contour.edges.size());
+            for (const auto &edge : contour.edges)
+            {
+                const int points = edge->type() + 1; // 线段 2 个控制点，二次 3，三次 4
+                h = hash_value(h, points);
+                const auto *p = edge->controlPoints();
+                for (int i = 0; i < points; ++i)
+                {
+                    h = hash_value(h, p[i].x);
+                    h = hash_value(h, p[i].y);
+                }
+            }
+        }
+        return h;
+    }
+
+    struct cache_header // NOLINTBEGIN
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t width;
+        int32_t height;
+        msdf::glyph_bounds plane_bounds;
+        double advance;
+    }; // NOLINTEND
+
+    fs::path cache_path(const fs::path &dir, uint64_t key,
+                        std::string_view extension = ".msdf")
+    {
+        const auto name = std::format("{:016x}", key);
+        return dir / name.substr(0, 2) / (name + std::string{extension});
+    }
+
+    std::optional<msdf::glyph_bitmap> read_cache(const fs::path &path)
+    {
+        std::ifstream in{path, std::ios::binary};
+        if (!in)
+            return std::nullopt;
+        cache_header header{};
+        in.read(reinterpret_cast<char *>(&header), sizeof(header)); // NOLINT
+        if (!in || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+            header.width < 0 || header.height < 0)
+            return std::nullopt;
+        msdf::glyph_bitmap ret{.width = header.width,
+                               .height = header.height,
+                               .plane_bounds = header.plane_bounds,
+                               .advance = header.advance,
+                               .rgba = {}};
+        ret.rgba.resize(static_cast<size_t>(header.width) *
+                        static_cast<size_t>(header.height) * msdf::GLYPH_CHANNELS);
+        in.read(reinterpret_cast<char *>(ret.rgba.data()), // NOLINT
+                static_cast<std::streamsize>(ret.rgba.size()));
+        if (!in)
+            return std::nullopt;
+        return ret;
+    }
+
+    // NOTE: 先写临时文件再 rename，并行构建或中断时不会留下半个文件
+    template <typename F>
+    void write_atomically(const fs::path &path, F &&write)
+    {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        const auto tmp = fs::path{path}.concat(std::format(
+            ".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())));
+        {
+            std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+            if (!out)
+                return;
+            write(out);
+            if (!out)
+                return;
+        }
+        fs::rename(tmp, path, ec);
+        if (ec)
+            fs::remove(tmp, ec);
+    }
+
+    void write_cache(const fs::path &path, const msdf::glyph_bitmap &bitmap)
+    {
+        write_atomically(path, [&](std::ofstream &out) {
+            const cache_header header{.magic = CACHE_MAGIC,
+                                      .version = CACHE_VERSION,
+                                      .width = bitmap.width,
+                                      .height = bitmap.height,
+                                      .plane_bounds = bitmap.plane_bounds,
+                                      .advance = bitmap.advance};
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header)); // NOLINT
+            out.write(reinterpret_cast<const char *>(bitmap.rgba.data()),      // NOLINT
+                      static_cast<std::streamsize>(bitmap.rgba.size()));
+        });
+    }
+
+    struct glyph_kerning // NOLINTBEGIN
+    {
+        uint32_t index1;
+        uint32_t index2;
+        double advance;
+    }; // NOLINTEND
+    struct kerning_header // NOLINTBEGIN
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t count;
+    }; // NOLINTEND
+
+    std::optional<std::vector<glyph_kerning>> read_kerning_cache(const fs::path &path)
+    {
+        std::ifstream in{path, std::ios::binary};
+        if (!in)
+            return std::nullopt;
+        kerning_header header{};
+        in.read(reinterpret_cast<char *>(&header), sizeof(header)); // NOLINT
+        if (!in || header.magic != KERNING_MAGIC || header.version != CACHE_VERSION)
+            return std::nullopt;
+        std::vector<glyph_kerning> ret(header.count);
+        in.read(reinterpret_cast<char *>(ret.data()), // NOLINT
+                static_cast<std::streamsize>(ret.size() * sizeof(glyph_kerning)));
+        if (!in)
+            return std::nullopt;
+        return ret;
+    }
+
+    void write_kerning_cache(const fs::path &path,
+                             const std::vector<glyph_kerning> &pairs)
+    {
+        write_atomically(path, [&](std::ofstream &out) {
+            const kerning_header header{
+                .magic = KERNING_MAGIC, .version = CACHE_VERSION, .count = pairs.size()};
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header)); // NOLINT
+            out.write(reinterpret_cast<const char *>(pairs.data()),            // NOLINT
+                      static_cast<std::streamsize>(pairs.size() * sizeof(glyph_kerning)));
+        });
+    }
+
+    using FreetypePtr = std::unique_ptr<msdfgen::FreetypeHandle,
+                                        decltype([](msdfgen::FreetypeHandle *value) {
+                                            msdfgen::deinitializeFreetype(value);
+                                        })>;
+    using FontPtr = std::unique_ptr<msdfgen::FontHandle,
+                                    decltype([](msdfgen::FontHandle *value) {
+                                        msdfgen::destroyFont(value);
+                                    })>;
+
+    struct glyph_ref // NOLINTBEGIN
+    {
+        uint32_t unicode;
+        uint32_t index;
+        size_t slot; // bitmaps 中的位置
+    }; // NOLINTEND
+
+    struct kerning_pair // NOLINTBEGIN
+    {
+        uint32_t unicode1;
+        uint32_t unicode2;
+        double advance;
+    }; // NOLINTEND
+
+    struct atlas_job // NOLINTBEGIN
+    {
+        std::string font_path;
+        std::string charset_path;
+        std::string out_prefix;
+        std::vector<uint8_t> font_data; // FontHandle 引用这块内存
+        FontPtr font;
+        msdfgen::FontMetrics metrics{};
+        std::vector<glyph_ref> glyphs;
+        std::vector<kerning_pair> kerning;
+    }; // NOLINTEND
+
+    // NOTE: 生成任务：shape 在主线程取出(FT_Face 不是线程安全的)
+    struct glyph_task // NOLINTBEGIN
+    {
+        size_t slot;
+        msdfgen::Shape shape;
+        double advance;
+        fs::path cache;
+    }; // NOLINTEND
+
+    struct options // NOLINTBEGIN
+    {
+        std::vector<atlas_job> jobs;
+        msdf::glyph_params params{};
+        int padding = 1;
+        bool y_top = false;
+        bool kerning = true;
+        size_t threads = 0;
+        std::string cache_dir;
+        std::string depfile;
+        std::string stamp;
+    }; // NOLINTEND
+
+    // NOTE: 字距只取决于字体内容和参与的字形，与字号、pxrange 无关
+    uint64_t kerning_key(const atlas_job &job, const std::vector<uint32_t> &indices)
+    {
+        uint64_t h = hash_value(FNV_OFFSET, CACHE_VERSION);
+        h = hash_bytes(h, job.font_data.data(), job.font_data.size());
+        return hash_bytes(h, indices.data(), indices.size() * sizeof(uint32_t));
+    }
+
+    /**
+     * NOTE: 计算 job 的字距对。
+     * 在去重后的字形之间按行并行计算，再展开到码点(多个码点可能共用一个字形)；
+     * cache_root 非空时结果缓存在 cache_root/kerning 下，字体和字符集都没变时直接读取
+     */
+    bool kern_job(atlas_job &job, msdfgen::FreetypeHandle *freetype,
+                  mcs::vulkan::thread_pool &pool, const fs::path &cache_root)
+    {
+        std::vector<uint32_t> indices;
+        indices.reserve(job.glyphs.size());
+        for (const auto &g : job.glyphs)
+            indices.emplace_back(g.index);
+        std::ranges::sort(indices);
+        const auto [first, last] = std::ranges::unique(indices);
+        indices.erase(first, last);
+
+        fs::path path;
+        if (!cache_root.empty())
+            path = cache_path(cache_root / "kerning", kerning_key(job, indices), ".kern");
+        std::vector<glyph_kerning> pairs;
+        if (auto cached = path.empty() ? std::nullopt : read_kerning_cache(path))
+            pairs = std::move(*cached);
+        else
+        {
+            // NOTE: FT_Face 不是线程安全的：每个工作线程一个 FontHandle，在主线程创建
+            std::vector<FontPtr> fonts(pool.size());
+            for (auto &font : fonts)
+            {
+                font.reset(msdfgen::loadFontData(freetype, job.font_data.data(),
+                                                 static_cast<int>(job.font_data.size())));
+                if (!font)
+                {
+                    std::println(stderr, "Failed to load font: {}", job.font_path);
+                    return false;
+                }
+            }
+            std::vector<std::vector<glyph_kerning>> rows(indices.size());
+            pool.for_each_index(indices.size(), [&](size_t row) {
+                auto *font = fonts[mcs::vulkan::thread_pool::current_worker()].get();
+                for (const uint32_t second : indices)
+                {
+                    double kern = 0.0;
+                    if (msdfgen::getKerning(kern, font, msdfgen::GlyphIndex(indices[row]),
+                                            msdfgen::GlyphIndex(second),
+                                            msdfgen::FONT_SCALING_EM_NORMALIZED) &&
+                        kern != 0.0)
+                        rows[row].emplace_back(glyph_kerning{indices[row], second, kern});
+                }
+            });
+            for (const auto &row : rows)
+                pairs.insert(pairs.end(), row.begin(), row.end());
+            if (!path.empty())
+                write_kerning_cache(path, pairs);
+        }
+
+        std::map<uint32_t, std::vector<uint32_t>> unicodes; // 字形 -> 码点
+        for (const auto &g : job.glyphs)
+            unicodes[g.index].emplace_back(g.unicode);
+        for (const auto &k : pairs)
+            for (const uint32_t u1 : unicodes[k.index1])
+                for (const uint32_t u2 : unicodes[k.index2])
+                    job.kerning.emplace_back(kerning_pair{u1, u2, k.advance});
+        // NOTE: 与逐码点计算时的顺序一致，输出不变
+        std::ranges::sort(job.kerning, {}, [](const kerning_pair &k) {
+            return std::pair{k.unicode1, k.unicode2};
+        });
+        return true;
+    }
+
+    std::string png_bytes(int width, int height, const std::vector<uint8_t> &rgb)
+    {
+        std::string ret;
+        stbi_write_png_to_func(
+            [](void *context, void *data, int size) {
+                static_cast<std::string *>(context)->append(static_cast<char *>(data),
+                                                            static_cast<size_t>(size));
+            },
+            &ret, width, height, 3, rgb.data(), width * 3);
+        return ret;
+    }
+
+    /**
+     * NOTE: 打包一个图集并写出 png/json。
+     * 按高度降序(同高按宽度、字形索引)放入 shelf_packer，从面积估算的 2 的幂开始，放不下就翻倍
+     */
+    bool write_atlas(atlas_job &job, const std::vector<msdf::glyph_bitmap> &bitmaps,
+                     const options &opt)
+    {
+        std::vector<size_t> order;
+        std::set<size_t> seen;
+        size_t area = 0;
+        for (size_t i = 0; i < job.glyphs.size(); ++i)
+        {
+            const auto &bmp = bitmaps[job.glyphs[i].slot];
+            if (bmp.width == 0)
+                continue;
+            // 同一个字形可能对应多个码点，只放一次
+            if (!seen.emplace(job.glyphs[i].slot).second)
+                continue;
+            order.emplace_back(i);
+            area += static_cast<size_t>(bmp.width + opt.padding) *
+                    static_cast<size_t>(bmp.height + opt.padding);
+        }
+        std::ranges::sort(order, [&](size_t a, size_t b) {
+            const auto &l = bitmaps[job.glyphs[a].slot];
+            const auto &r = bitmaps[job.glyphs[b].slot];
+            if (l.height != r.height)
+                return l.height > r.height;
+            if (l.width != r.width)
+                return l.width > r.width;
+            return job.glyphs[a].index < job.glyphs[b].index;
+        });
+
+        int size = 1;
+        while (static_cast<size_t>(size) * static_cast<size_t>(size) < area)
+            size *= 2;
+        std::map<size_t, msdf::atlas_rect> placed; // slot -> rect
+        for (;; size *= 2)
+        {
+            if (size > MAX_ATLAS_SIZE)
+            {
+                std::println(stderr, "{}: glyphs do not fit in {}x{}", job.out_prefix,
+                             MAX_ATLAS_SIZE, MAX_ATLAS_SIZE);
+                return false;
+            }
+            placed.clear();
+            msdf::shelf_packer packer{size, size, opt.padding};
+            bool ok = true;
+            for (size_t i : order)
+            {
+                const auto &bmp = bitmaps[job.glyphs[i].slot];
+                auto rect = packer.alloc(bmp.width, bmp.height);
+                if (!rect)
+                {
+                    ok = false;
+                    break;
+                }
+                placed.emplace(job.glyphs[i].slot, *rect);
+            }
+            if (ok)
+                break;
+        }
+
+        // NOTE: msdf-atlas-gen 的 msdf png 是 RGB
+        const auto pixels = static_cast<size_t>(size) * static_cast<size_t>(size);
+        std::vector<uint8_t> rgb(pixels * 3);
+        for (const auto &[slot, rect] : placed)
+        {
+            const auto &bmp = bitmaps[slot];
+            for (int y = 0; y < rect.h; ++y)
+            {
+                const auto *src = bmp.rgba.data() + (static_cast<size_t>(y) * rect.w *
+                                                     msdf::GLYPH_CHANNELS);
+                auto *dst = rgb.data() +
+                            (((static_cast<size_t>(rect.y + y) * size) + rect.x) * 3);
+                for (int x = 0; x < rect.w; ++x, src += msdf::GLYPH_CHANNELS, dst += 3)
+                    std::memcpy(dst, src, 3);
+            }
+        }
+
+        // NOTE: 与 msdf-atlas-gen 一致：yOrigin top 时 y 相关的度量取反，atlasBounds 从上往下
+        const double y_factor = opt.y_top ? -1.0 : 1.0;
+        const double h = size;
+        json glyphs = json::array();
+        for (const auto &g : job.glyphs)
+        {
+            const auto &bmp = bitmaps[g.slot];
+            json glyph{{"unicode", g.unicode}, {"advance", bmp.advance}};
+            if (bmp.width != 0)
+            {
+                const auto &pb = bmp.plane_bounds;
+                const auto &rect = placed.at(g.slot);
+                const double top = rect.y + 0.5;
+                const double bottom = rect.y + rect.h - 0.5;
+                glyph["planeBounds"] = {{"left", pb.left},
+                                        {"bottom", y_factor * pb.bottom},
+                                        {"right", pb.right},
+                                        {"top", y_factor * pb.top}};
+                glyph["atlasBounds"] = {{"left", rect.x + 0.5},
+                                        {"bottom", opt.y_top ? bottom : h - bottom},
+                                        {"right", rect.x + rect.w - 0.5},
+                                        {"top", opt.y_top ? top : h - top}};
+            }
+            glyphs.emplace_back(std::move(glyph));
+        }
+        json kerning = json::array();
+        for (const auto &k : job.kerning)
+            kerning.emplace_back(json{{"unicode1", k.unicode1},
+                                      {"unicode2", k.unicode2},
+                                      {"advance", k.advance}});
+
+        const auto &m = job.metrics;
+        const json root{
+            {"atlas",
+             {{"type", "msdf"},
+              {"distanceRange", opt.params.px_range},
+              {"distanceRangeMiddle", 0},
+              {"size", opt.params.glyph_size},
+              {"width", size},
+              {"height", size},
+              {"yOrigin", opt.y_top ? "top" : "bottom"}}},
+            {"metrics",
+             {{"emSize", 1},
+              {"lineHeight", m.lineHeight},
+              {"ascender", y_factor * m.ascenderY},
+              {"descender", y_factor * m.descenderY},
+              {"underlineY", y_factor * m.underlineY},
+              {"underlineThickness", m.underlineThickness}}},
+            {"glyphs", std::move(glyphs)},
+            {"kerning", std::move(kerning)}};
+
+        return writeIfDifferent(job.out_prefix + ".png", png_bytes(size, size, rgb)) &&
+               writeIfDifferent(job.out_prefix + ".json", root.dump());
+    }
+
+    std::optional<options> parse_options(int argc, char *argv[])
+    {
+        options opt;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (arg == "-font" && has_value)
+                opt.jobs.emplace_back().font_path = argv[++i];
+            else if ((arg == "-charset" || arg == "-out") && has_value)
+            {
+                if (opt.jobs.empty())
+                {
+                    std::println(stderr, "{} must follow -font", arg);
+                    return std::nullopt;
+                }
+                (arg == "-charset" ? opt.jobs.back().charset_path
+                                   : opt.jobs.back().out_prefix) = argv[++i];
+            }
+            else if (arg == "-size" && has_value)
+                opt.params.glyph_size = std::stod(argv[++i]);
+            else if (arg == "-pxrange" && has_value)
+                opt.params.px_range = std::stod(argv[++i]);
+            else if (arg == "-angle" && has_value)
+                opt.params.angle_threshold = std::stod(argv[++i]);
+            else if (arg == "-padding" && has_value)
+                opt.padding = std::stoi(argv[++i]);
+            else if (arg == "-threads" && has_value)
+                opt.threads = std::stoul(argv[++i]);
+            else if (arg == "-cache" && has_value)
+                opt.cache_dir = argv[++i];
+            else if (arg == "-depfile" && has_value)
+                opt.depfile = argv[++i];
+            else if (arg == "-stamp" && has_value)
+                opt.stamp = argv[++i];
+            else if (arg == "-nokerning")
+                opt.kerning = false;
+            else if (arg == "-yorigin" && has_value)
+            {
+                const std::string origin = argv[++i];
+                if (origin != "top" && origin != "bottom")
+                {
+                    std::println(stderr, "Invalid -yorigin value: {}", origin);
+                    return std::nullopt;
+                }
+                opt.y_top = origin == "top";
+            }
+            else if (arg == "-help" || arg == "--help")
+            {
+                std::println(
+                    "Usage: {} (-font <font> -charset <file> -out <prefix>)... "
+                    "[options]\n"
+                    "  -size <px>          Pixels per em (default: 32)\n"
+                    "  -pxrange <px>       Distance range in pixels (default: 4)\n"
+                    "  -angle <rad>        Edge coloring angle threshold (default: 3)\n"
+                    "  -padding <px>       Space between glyphs (default: 1)\n"
+                    "  -yorigin top|bottom (default: bottom)\n"
+                    "  -cache <dir>        Per-glyph MSDF cache directory\n"
+                    "  -threads <n>        Worker threads (default: hardware)\n"
+                    "  -nokerning          Do not write kerning pairs\n"
+                    "  -depfile <file>     Write charset dependencies for -stamp\n"
+                    "  -stamp <file>       Touched on success",
+                    argv[0]);
+                std::exit(0); // NOLINT
+            }
+            else
+            {
+                std::println(stderr, "Unknown argument: {}", arg);
+                return std::nullopt;
+            }
+        }
+        if (opt.jobs.empty())
+        {
+            std::println(stderr, "No -font given");
+            return std::nullopt;
+        }
+        for (const auto &job : opt.jobs)
+        {
+            if (job.charset_path.empty() || job.out_prefix.empty())
+            {
+                std::println(stderr, "{}: -charset and -out are required", job.font_path);
+                return std::nullopt;
+            }
+        }
+        return opt;
+    }
+
+    std::vector<uint8_t> read_file(const std::string &path)
+    {
+        std::ifstream in{path, std::ios::binary};
+        if (!in)
+            return {};
+        return {std::istreambuf_iterator<char>{in}, {}};
+    }
+}; // namespace
+
+int main(int argc, char *argv[])
+{
+    std::ignore = std::setlocale(LC_ALL, "en_US.utf8");
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    auto parsed = parse_options(argc, argv);
+    if (!parsed)
+        return 1;
+    auto &opt = *parsed;
+    const fs::path cache_root =
+        opt.cache_dir.empty()
+            ? fs::path{}
+            : fs::path{opt.cache_dir} /
+                  std::format("s{}_r{}", opt.params.glyph_size, opt.params.px_range);
+
+    FreetypePtr freetype{msdfgen::initializeFreetype()};
+    if (!freetype)
+    {
+        std::println(stderr, "Failed to initialize FreeType");
+        return 1;
+    }
+
+    // ----- 主线程：加载字体、解析字符集、取出轮廓、查缓存 -----
+    std::vector<msdf::glyph_bitmap> bitmaps;
+    std::vector<glyph_task> tasks;
+    std::map<uint64_t, size_t> slots; // 轮廓键 -> bitmaps，多个字体/图集共用
+    std::set<std::string> deps;
+    size_t hits = 0;
+    for (auto &job : opt.jobs)
+    {
+        job.font_data = read_file(job.font_path);
+        job.font.reset(msdfgen::loadFontData(freetype.get(), job.font_data.data(),
+                                             static_cast<int>(job.font_data.size())));
+        if (!job.font)
+        {
+            std::println(stderr, "Failed to load font: {}", job.font_path);
+            return 1;
+        }
+        msdfgen::getFontMetrics(job.metrics, job.font.get(),
+                                msdfgen::FONT_SCALING_EM_NORMALIZED);
+
+        std::set<std::string> files;
+        std::vector<uint32_t> codepoints;
+        try
+        {
+            codepoints = readCharsetFromFile(job.charset_path, &files);
+        }
+        catch (const std::exception &e)
+        {
+            std::println(stderr, "Error reading charset {}: {}", job.charset_path,
+                         e.what());
+            return 1;
+        }
+        deps.insert(files.begin(), files.end());
+        deps.insert(job.font_path);
+        std::ranges::sort(codepoints);
+        const auto [first, last] = std::ranges::unique(codepoints);
+        codepoints.erase(first, last);
+
+        std::map<uint32_t, size_t> by_index; // 同一字体内的字形 -> slot
+        for (const uint32_t cp : codepoints)
+        {
+            msdfgen::GlyphIndex index;
+            if (!msdfgen::getGlyphIndex(index, job.font.get(), cp) ||
+                index.getIndex() == 0)
+            {
+                std::println(stderr, "{}: missing U+{:04X}", job.font_path, cp);
+                continue;
+            }
+            const uint32_t glyph = index.getIndex();
+            if (auto it = by_index.find(glyph); it != by_index.end())
+            {
+                job.glyphs.emplace_back(glyph_ref{cp, glyph, it->second});
+                continue;
+            }
+            double advance = 0.0;
+            auto shape = msdf::load_glyph_shape(job.font.get(), glyph, advance);
+            const uint64_t key = shape_key(shape, advance, opt.params);
+            auto [it, inserted] = slots.emplace(key, bitmaps.size());
+            if (inserted)
+            {
+                const auto path =
+                    cache_root.empty() ? fs::path{} : cache_path(cache_root, key);
+                if (auto cached = path.empty() ? std::nullopt : read_cache(path))
+                {
+                    bitmaps.emplace_back(std::move(*cached));
+                    ++hits;
+                }
+                else
+                {
+                    bitmaps.emplace_back();
+                    tasks.emplace_back(glyph_task{.slot = it->second,
+                                                  .shape = std::move(shape),
+                                                  .advance = advance,
+                                                  .cache = path});
+                }
+            }
+            by_index.emplace(glyph, it->second);
+            job.glyphs.emplace_back(glyph_ref{cp, glyph, it->second});
+        }
+    }
+    const auto loaded = clock::now();
+
+    // ----- 线程池：字距、生成缓存未命中的字形，然后每个图集并行打包写出 -----
+    mcs::vulkan::thread_pool pool{
+        opt.threads != 0 ? opt.threads
+                         : std::max<size_t>(1, std::thread::hardware_concurrency())};
+    if (opt.kerning)
+        for (auto &job : opt.jobs)
+            if (!kern_job(job, freetype.get(), pool, cache_root))
+                return 1;
+    const auto kerned = clock::now();
+
+    pool.for_each_index(tasks.size(), [&](size_t i) {
+        auto &task = tasks[i];
+        bitmaps[task.slot] = msdf::generate_glyph(task.shape, task.advance, opt.params);
+        if (!task.cache.empty())
+            write_cache(task.cache, bitmaps[task.slot]);
+    });
+    const auto generated = clock::now();
+
+    std::atomic<bool> ok{true};
+    pool.for_each_index(opt.jobs.size(), [&](size_t i) {
+        if (!write_atlas(opt.jobs[i], bitmaps, opt))
+            ok = false;
+    });
+    if (!ok)
+        return 1;
+
+    if (!opt.depfile.empty() && !opt.stamp.empty() &&
+        !writeIfDifferent(opt.depfile, formatDepfile(opt.stamp, deps)))
+    {
+        std::println(stderr, "Failed to write depfile: {}", opt.depfile);
+        return 1;
+    }
+    if (!opt.stamp.empty())
+        std::ofstream{opt.stamp, std::ios::trunc} << "ok\n";
+
+    using ms = std::chrono::duration<double, std::milli>;
+    std::println("{} atlases, {} glyphs: {} cached, {} generated on {} threads | "
+                 "load {:.1f} ms, kerning {:.1f} ms, generate {:.1f} ms, "
+                 "pack+write {:.1f} ms",
+                 opt.jobs.size(), bitmaps.size(), hits, tasks.size(), pool.size(),
+                 ms(loaded - start).count(), ms(kerned - loaded).count(),
+                 ms(generated - kerned).count(),
+                 ms(clock::now() - generated).count());
+    return 0;
+}